@@ -31,53 +31,137 @@ EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.// Copyright (c) 2015 Xilinx,
 
 using namespace hls;
 
-void ack_delay(	stream<extendedEvent>&	input,
-				stream<extendedEvent>&	output,
-				stream<ap_uint<1> >&	readCountFifo,
-				stream<ap_uint<1> >&	writeCountFifo)
+/** @ingroup ack_delay
+ *  ACK events of received data are coalesced per session. The ACK is sent once TCP_ACK_SEGMENTS segments or
+ *  TCP_ACK_BYTES bytes are unacknowledged, the byte count is carried in the length of the event. Otherwise the
+ *  @ref timing_wheel sends it after TCP_ACK_DELAY_MIN without further data, at the latest TCP_ACK_DELAY_MAX after the
+ *  first held segment. In quick-ACK mode, set by the SYN and SYN-ACK of a session, every segment is ACKed right away.
+ *  Every other event passes through and carries the pending ACK with it.
+ *  @param[in]		input
+ *  @param[in]		wheel2ackDelay_expired
+ *  @param[out]		ackDelay2wheel_op
+ *  @param[out]		output
+ */
+void ackDelayControl(	stream<extendedEvent>&		input,
+						stream<timerWheelExpiry>&	wheel2ackDelay_expired,
+						stream<timerWheelOp>&		ackDelay2wheel_op,
+						stream<extendedEvent>&		output,
+						stream<ap_uint<1> >&		readCountFifo,
+						stream<ap_uint<1> >&		writeCountFifo)
 {
+#pragma HLS INLINE off
 #pragma HLS PIPELINE II=1
 
-	static ap_uint<12> ack_table[MAX_SESSIONS]; //TODO why is it 12
-	#pragma HLS RESOURCE variable=ack_table core=RAM_2P_BRAM
+	static ack_delay_entry ack_table[MAX_SESSIONS];
+	SESSION_TABLE_RESOURCE(ack_table, RAM_2P_BRAM)
+	#pragma HLS DATA_PACK variable=ack_table
 	#pragma HLS DEPENDENCE variable=ack_table inter false
-	static ap_uint<16>	ad_pointer = 0;
-	//static ap_uint<4>	ad_readCounter = 0;
+	// Held ACKs are stamped with timer ticks, see TIMER_TICK_CYCLES
+	static ap_uint<32> ad_cycles = 0;
+	static ap_uint<16> ad_ticks = 0;
 	extendedEvent ev;
+	ack_delay_entry entry;
+	timerWheelExpiry expired;
+	ap_uint<16> held;
+	ap_uint<32> delay;
+	bool bounded;
+
+	if (ad_cycles == TIMER_TICK_CYCLES-1)
+	{
+		ad_cycles = 0;
+		ad_ticks++;
+	}
+	else
+	{
+		ad_cycles++;
+	}
 
-	if (!input.empty())
+	if (!input.empty() && !ackDelay2wheel_op.full())
 	{
 		input.read(ev);
 		readCountFifo.write(1);
-		// Check if there is a delayed ACK
-		if (ev.type == ACK && ack_table[ev.sessionID] == 0)
+		entry = ack_table[ev.sessionID];
+		// The delay restarts with every held segment, but does not extend beyond the upper bound
+		held = ad_ticks - entry.start;
+		bounded = (entry.pending && held + TCP_ACK_DELAY_MIN >= TCP_ACK_DELAY_MAX);
+		delay = bounded ? (ap_uint<32>) (TCP_ACK_DELAY_MAX - held) : TCP_ACK_DELAY_MIN;
+		// Events without a session, SYN cookies, RSTs to unknown tuples and ACKs of TIME-WAIT records, carry ID 0 and pass untouched
+		if (ev.type == SYN_COOKIE || (ev.type == RST && !rstEvent(ev).hasSessionID())
+				|| (ev.type == TIME_WAIT_ACK && !timeWaitEvent(ev).hasSessionID()))
 		{
-			ack_table[ev.sessionID] = TIME_64us;
+			output.write(ev);
+			writeCountFifo.write(1);
+		}
+		// ACK of received data, held back until enough data is unacknowledged
+		else if (ev.type == ACK && entry.quickAcks == 0 && !(bounded && held >= TCP_ACK_DELAY_MAX)
+					&& entry.segments+1 < TCP_ACK_SEGMENTS && entry.bytes+ev.length < TCP_ACK_BYTES)
+		{
+			if (!entry.pending)
+			{
+				entry.start = ad_ticks;
+			}
+			entry.tag++;
+			entry.pending = true;
+			entry.segments++;
+			entry.bytes += ev.length;
+			ackDelay2wheel_op.write(timerWheelOp(ev.sessionID, delay, entry.tag));
+			ack_table[ev.sessionID] = entry;
 		}
 		else
 		{
-			// Assumption no SYN/RST
-			ack_table[ev.sessionID] = 0;
+			if (entry.pending)
+			{
+				ackDelay2wheel_op.write(timerWheelOp(ev.sessionID));
+			}
+			if (ev.type == SYN || ev.type == SYN_ACK)
+			{
+				entry.quickAcks = TCP_QUICKACK_SEGMENTS;
+			}
+			else if (ev.type == ACK && entry.quickAcks != 0)
+			{
+				entry.quickAcks--;
+			}
+			entry.pending = false;
+			entry.segments = 0;
+			entry.bytes = 0;
 			output.write(ev);
 			writeCountFifo.write(1);
+			ack_table[ev.sessionID] = entry;
 		}
 	}
-	else
+	else if (!wheel2ackDelay_expired.empty() && !output.full())
 	{
-		if (ack_table[ad_pointer] > 0 && !output.full())
+		wheel2ackDelay_expired.read(expired);
+		entry = ack_table[expired.sessionID];
+		if (entry.pending && entry.tag == expired.tag)
 		{
-			if (ack_table[ad_pointer] == 1)
-			{
-				output.write(event(ACK, ad_pointer));
-				writeCountFifo.write(1);
-			}
-			// Decrease value
-			ack_table[ad_pointer] -= 1;
-		}
-		ad_pointer++;
-		if (ad_pointer == MAX_SESSIONS)
-		{
-			ad_pointer = 0;
+			output.write(event(ACK, expired.sessionID));
+			writeCountFifo.write(1);
+			entry.pending = false;
+			entry.segments = 0;
+			entry.bytes = 0;
+			ack_table[expired.sessionID] = entry;
 		}
 	}
 }
+
+/** @ingroup ack_delay
+ *  Connects the @ref ackDelayControl to its @ref timing_wheel.
+ */
+void ack_delay(	stream<extendedEvent>&	input,
+				stream<extendedEvent>&	output,
+				stream<ap_uint<1> >&	readCountFifo,
+				stream<ap_uint<1> >&	writeCountFifo)
+{
+#pragma HLS INLINE
+
+	static stream<timerWheelOp>		ackDelay2wheel_op("ackDelay2wheel_op");
+	static stream<timerWheelExpiry>	wheel2ackDelay_expired("wheel2ackDelay_expired");
+	#pragma HLS stream variable=ackDelay2wheel_op		depth=4
+	#pragma HLS stream variable=wheel2ackDelay_expired	depth=4
+	#pragma HLS DATA_PACK variable=ackDelay2wheel_op
+	#pragma HLS DATA_PACK variable=wheel2ackDelay_expired
+
+	ackDelayControl(input, wheel2ackDelay_expired, ackDelay2wheel_op, output, readCountFifo, writeCountFifo);
+	timing_wheel<3>(ackDelay2wheel_op, wheel2ackDelay_expired);
+}
@@ -27,9 +27,23 @@ OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF
 EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.// Copyright (c) 2015 Xilinx, Inc.
 ************************************************/
 #include "../toe.hpp"
+#include "../timing_wheel/timing_wheel.hpp"
 
 using namespace hls;
 
+/** @ingroup ack_delay
+ *
+ */
+struct ack_delay_entry
+{
+	ap_uint<8>		tag;
+	bool			pending;
+	ap_uint<8>		segments;	// Data segments received since the last ACK
+	ap_uint<20>		bytes;
+	ap_uint<16>		start;		// Tick of the first unacknowledged segment, bounds the delay to 2^16 ticks
+	ap_uint<8>		quickAcks;	// Remaining segments of the quick-ACK mode
+};
+
 void ack_delay(	stream<extendedEvent>&	input,
 				stream<extendedEvent>&	output,
 				stream<ap_uint<1> >&	readCountFifo,
@@ -31,39 +31,112 @@ EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.// Copyright (c) 2015 Xilinx,
 
 using namespace hls;
 
+stream<extendedEvent>	input;
+stream<extendedEvent>	output;
+stream<ap_uint<1> >		readCount;
+stream<ap_uint<1> >		writeCount;
 
-int main()
-{
-	stream<extendedEvent> input;
-	stream<extendedEvent> output;
+int ackCount = 0;
+int otherCount = 0;
 
+void runDelay(uint32_t cycles)
+{
 	extendedEvent ev;
-
-	int count = 0;
-	int inCount = 0;
-	int outCount = 0;
-	while (count < 1000000)
+	for (uint32_t i = 0; i < cycles; i++)
 	{
-		if (count == 5)
+		ack_delay(input, output, readCount, writeCount);
+		if (!output.empty())
 		{
-			input.write(event(SYN, 2));
+			output.read(ev);
+			if (ev.type == ACK)
+			{
+				ackCount++;
+			}
+			else
+			{
+				otherCount++;
+			}
 		}
-		if (count % 10 == 0 && inCount < 19)
+		while (!readCount.empty())
 		{
-			input.write(event(ACK, 2));
-			inCount++;
+			readCount.read();
 		}
+		while (!writeCount.empty())
+		{
+			writeCount.read();
+		}
+	}
+}
+
+int main()
+{
+	int errCount = 0;
+
+	// Quick-ACK mode after the SYN, every segment is ACKed right away
+	input.write(event(SYN, 2));
+	runDelay(1000);
+	for (int i = 0; i < TCP_QUICKACK_SEGMENTS; i++)
+	{
+		input.write(event(ACK, 2, 0, 100));
+		runDelay(5);
+	}
+	if (otherCount != 1 || ackCount != TCP_QUICKACK_SEGMENTS)
+	{
+		std::cout << "Quick-ACK, events: " << otherCount << " ACKs: " << ackCount << std::endl;
+		errCount++;
+	}
+
+	// A single small segment is held back until the delay runs out
+	ackCount = 0;
+	input.write(event(ACK, 2, 0, 100));
+	runDelay(5);
+	if (ackCount != 0)
+	{
+		std::cout << "ACK was not delayed" << std::endl;
+		errCount++;
+	}
+	runDelay(TIMER_TICK_CYCLES*(TCP_ACK_DELAY_MIN+1));
+	if (ackCount != 1)
+	{
+		std::cout << "Delayed ACK, ACKs: " << ackCount << std::endl;
+		errCount++;
+	}
 
-		ack_delay(input, output);
-		count++;
+	// Every TCP_ACK_SEGMENTS segments are ACKed without delay
+	ackCount = 0;
+	for (int i = 0; i < TCP_ACK_SEGMENTS; i++)
+	{
+		input.write(event(ACK, 2, 0, 100));
+	}
+	runDelay(10);
+	if (ackCount != 1)
+	{
+		std::cout << "Segment count, ACKs: " << ackCount << std::endl;
+		errCount++;
 	}
 
-	while (!output.empty())
+	// As are TCP_ACK_BYTES bytes
+	ackCount = 0;
+	input.write(event(ACK, 2, 0, TCP_ACK_BYTES));
+	runDelay(5);
+	if (ackCount != 1)
 	{
-		output.read(ev);
-		std::cout << "Event: " << ev.type << std::endl;
-		outCount++;
+		std::cout << "Byte count, ACKs: " << ackCount << std::endl;
+		errCount++;
 	}
-	std::cout << "ins: " << inCount << " outs: " << outCount << std::endl;
-	return 0;
+
+	// Any other event carries the held ACK
+	ackCount = 0;
+	otherCount = 0;
+	input.write(event(ACK, 2, 0, 100));
+	input.write(event(TX, 2, 0, 1000));
+	runDelay(TIMER_TICK_CYCLES*(TCP_ACK_DELAY_MAX+2));
+	if (ackCount != 0 || otherCount != 1)
+	{
+		std::cout << "Piggybacked, events: " << otherCount << " ACKs: " << ackCount << std::endl;
+		errCount++;
+	}
+
+	std::cout << "Errors: " << errCount << std::endl;
+	return errCount;
 }
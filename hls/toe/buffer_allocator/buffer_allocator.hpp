@@ -0,0 +1,124 @@
+/************************************************
+Copyright (c) 2016, Xilinx, Inc.
+All rights reserved.
+
+Redistribution and use in source and binary forms, with or without modification, 
+are permitted provided that the following conditions are met:
+
+1. Redistributions of source code must retain the above copyright notice, 
+this list of conditions and the following disclaimer.
+
+2. Redistributions in binary form must reproduce the above copyright notice, 
+this list of conditions and the following disclaimer in the documentation 
+and/or other materials provided with the distribution.
+
+3. Neither the name of the copyright holder nor the names of its contributors 
+may be used to endorse or promote products derived from this software 
+without specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND 
+ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, 
+THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED. 
+IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, 
+INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, 
+PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) 
+HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, 
+OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, 
+EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.// Copyright (c) 2015 Xilinx, Inc.
+************************************************/
+#ifndef BUFFER_ALLOCATOR_HPP_INCLUDED
+#define BUFFER_ALLOCATOR_HPP_INCLUDED
+
+#include "../toe.hpp"
+
+using namespace hls;
+
+/** @defgroup buffer_allocator Buffer Allocator
+ *  @ingroup tcp_module
+ *  Assigns the DDR buffers of the sessions, it is part of the table that owns the buffers of a direction.
+ *  Every size class keeps a FIFO of the released slots, slots that were never used are handed out by a counter.
+ *  An allocation takes a buffer of the requested class, otherwise the next smaller and then the next larger one.
+ *  Each instance has its own state, ALLOCATOR_ID only has to be unique per instance.
+ *  @param[in]		release, returns buffer to its pool instead of allocating one
+ *  @param[in]		sizeClass, preferred class of an allocation
+ *  @param[in,out]	buffer, allocated or released buffer
+ *  @return			false if an allocation found all pools exhausted
+ */
+template <int ALLOCATOR_ID>
+bool buffer_allocator(bool release, ap_uint<2> sizeClass, sessionBuffer& buffer)
+{
+#pragma HLS INLINE
+
+	static ap_uint<BUFFER_SLOT_BITS> ba_freeList[BUFFER_CLASSES << BUFFER_SLOT_BITS];
+	SESSION_TABLE_RESOURCE(ba_freeList, RAM_T2P_BRAM)
+	static ap_uint<BUFFER_SLOT_BITS+1> ba_head[BUFFER_CLASSES];
+	static ap_uint<BUFFER_SLOT_BITS+1> ba_tail[BUFFER_CLASSES];
+	static ap_uint<BUFFER_SLOT_BITS+1> ba_unused[BUFFER_CLASSES];
+	#pragma HLS ARRAY_PARTITION variable=ba_head complete
+	#pragma HLS ARRAY_PARTITION variable=ba_tail complete
+	#pragma HLS ARRAY_PARTITION variable=ba_unused complete
+
+	bool available[BUFFER_CLASSES];
+	#pragma HLS ARRAY_PARTITION variable=available complete
+	bool smallerFound = false;
+	bool largerFound = false;
+	ap_uint<2> smallerClass = 0;
+	ap_uint<2> largerClass = 0;
+	ap_uint<2> candidate;
+	ap_uint<BUFFER_SLOT_BITS+2> index;
+
+	if (release)
+	{
+		index = (((ap_uint<BUFFER_SLOT_BITS+2>) buffer.sizeClass) << BUFFER_SLOT_BITS) + ba_tail[buffer.sizeClass](BUFFER_SLOT_BITS-1, 0);
+		ba_freeList[index] = buffer.slot;
+		ba_tail[buffer.sizeClass]++;
+		return true;
+	}
+
+	for (uint8_t i = 0; i < BUFFER_CLASSES; i++)
+	{
+	#pragma HLS UNROLL
+		available[i] = (ba_head[i] != ba_tail[i] || ba_unused[i] < BUFFER_CLASS_SLOTS[i]);
+	}
+	// The requested class or the closest one with smaller buffers, the first match wins
+	for (uint8_t i = 0; i < BUFFER_CLASSES; i++)
+	{
+	#pragma HLS UNROLL
+		if (available[i] && i >= sizeClass && !smallerFound)
+		{
+			smallerClass = i;
+			smallerFound = true;
+		}
+	}
+	// The closest class with larger buffers
+	for (uint8_t i = 0; i < BUFFER_CLASSES; i++)
+	{
+	#pragma HLS UNROLL
+		if (available[i] && i < sizeClass)
+		{
+			largerClass = i;
+			largerFound = true;
+		}
+	}
+	if (!smallerFound && !largerFound)
+	{
+		return false;
+	}
+
+	candidate = smallerFound ? smallerClass : largerClass;
+	buffer.sizeClass = candidate;
+	if (ba_head[candidate] != ba_tail[candidate])
+	{
+		index = (((ap_uint<BUFFER_SLOT_BITS+2>) candidate) << BUFFER_SLOT_BITS) + ba_head[candidate](BUFFER_SLOT_BITS-1, 0);
+		buffer.slot = ba_freeList[index];
+		ba_head[candidate]++;
+	}
+	else
+	{
+		buffer.slot = ba_unused[candidate];
+		ba_unused[candidate]++;
+	}
+	return true;
+}
+
+#endif
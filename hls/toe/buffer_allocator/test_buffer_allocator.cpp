@@ -0,0 +1,95 @@
+/************************************************
+Copyright (c) 2016, Xilinx, Inc.
+All rights reserved.
+
+Redistribution and use in source and binary forms, with or without modification, 
+are permitted provided that the following conditions are met:
+
+1. Redistributions of source code must retain the above copyright notice, 
+this list of conditions and the following disclaimer.
+
+2. Redistributions in binary form must reproduce the above copyright notice, 
+this list of conditions and the following disclaimer in the documentation 
+and/or other materials provided with the distribution.
+
+3. Neither the name of the copyright holder nor the names of its contributors 
+may be used to endorse or promote products derived from this software 
+without specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND 
+ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, 
+THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED. 
+IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, 
+INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, 
+PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) 
+HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, 
+OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, 
+EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.// Copyright (c) 2015 Xilinx, Inc.
+************************************************/
+#include "buffer_allocator.hpp"
+#include <iostream>
+
+using namespace hls;
+
+int main()
+{
+	sessionBuffer buffer;
+	sessionBuffer first;
+	int errCount = 0;
+
+	// Requested class
+	buffer_allocator<0>(false, 1, first);
+	if (first.sizeClass != 1 || first.slot != 0 || first.size() != (BUFFER_SIZE >> TCP_BUFFER_CLASS_SHIFT_1))
+	{
+		std::cerr << "First allocation: class " << std::dec << first.sizeClass << " slot " << first.slot << std::endl;
+		errCount++;
+	}
+	// Buffers are aligned to their size and the offset wraps around
+	if (first.address(first.size() + 5) != first.address(5) || first.address(0) % first.size() != 0)
+	{
+		std::cerr << "Address: " << std::hex << first.address(0) << std::endl;
+		errCount++;
+	}
+	// Exhaust the smallest class, the allocation falls back to the next larger buffers
+	for (int i = 0; i < BUFFER_CLASS_SLOTS[2]; i++)
+	{
+		buffer_allocator<0>(false, 2, buffer);
+		if (buffer.sizeClass != 2)
+		{
+			std::cerr << "Class 2 allocation " << std::dec << i << " returned class " << buffer.sizeClass << std::endl;
+			errCount++;
+			break;
+		}
+	}
+	buffer_allocator<0>(false, 2, buffer);
+	if (buffer.sizeClass != 1 || buffer.slot != 1)
+	{
+		std::cerr << "Fallback: class " << std::dec << buffer.sizeClass << " slot " << buffer.slot << std::endl;
+		errCount++;
+	}
+	// A released buffer is handed out again
+	buffer = sessionBuffer(2, 42);
+	buffer_allocator<0>(true, 0, buffer);
+	buffer_allocator<0>(false, 2, buffer);
+	if (buffer.sizeClass != 2 || buffer.slot != 42)
+	{
+		std::cerr << "Reuse: class " << std::dec << buffer.sizeClass << " slot " << buffer.slot << std::endl;
+		errCount++;
+	}
+	// Pools of different classes do not overlap
+	if (sessionBuffer(0, BUFFER_CLASS_SLOTS[0]-1).address(BUFFER_SIZE-1) >= sessionBuffer(1, 0).address(0)
+			|| sessionBuffer(1, BUFFER_CLASS_SLOTS[1]-1).address(BUFFER_SIZE-1) >= sessionBuffer(2, 0).address(0))
+	{
+		std::cerr << "Overlapping pools" << std::endl;
+		errCount++;
+	}
+	// The pools fit into the 1GB region, also with window scaling
+	if (BUFFER_CLASS_BASE[2] + ((uint64_t) BUFFER_CLASS_SLOTS[2] << BUFFER_CLASS_BITS[2]) > (1UL << 30))
+	{
+		std::cerr << "Pools exceed 1GB" << std::endl;
+		errCount++;
+	}
+
+	std::cout << "Errors: " << std::dec << errCount << std::endl;
+	return errCount;
+}
@@ -32,67 +32,132 @@ EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.// Copyright (c) 2015 Xilinx,
 using namespace hls;
 
 /** @ingroup close_timer
- *  Reads in Session-IDs, the corresponding is kept in the TIME-WAIT state for 60s before
- *  it gets closed by writing its ID into the closeTimerReleaseFifo.
- *  @param[in]		timer2closeTimer_setTimer, FIFO containing Session-ID of the sessions which are in the TIME-WAIT state
- *  @param[out]		timer2stateTable_releaseState, write Sessions which are closed into this FIFO
+ *  Bucket of a tuple, its bits are folded by XOR
  */
-void close_timer(	stream<ap_uint<16> >&		rxEng2timer_setCloseTimer,
-					stream<ap_uint<16> >&		closeTimer2stateTable_releaseState)
+ap_uint<TIME_WAIT_BITS> timeWaitHash(fourTuple tuple)
+{
+#pragma HLS INLINE
+	ap_uint<32> fold = tuple.srcIp ^ tuple.dstIp ^ (tuple.srcPort, tuple.dstPort);
+	ap_uint<TIME_WAIT_BITS> index = 0;
+	for (int i = 0; i < 32; i += TIME_WAIT_BITS)
+	{
+	#pragma HLS UNROLL
+		index ^= (ap_uint<TIME_WAIT_BITS>) (fold >> i);
+	}
+	return index;
+}
+
+/** @ingroup close_timer
+ *  Keeps a compact record of every session in TIME-WAIT for 60s, the session itself is released by the
+ *  @ref rx_engine as soon as it enters TIME-WAIT. The @ref rx_engine looks up segments which do not
+ *  belong to a session, on a hit they are answered with the ACK of the record. SYNs are looked up on a
+ *  second port at the same time as their session lookup, the @ref rx_engine only accepts them if their
+ *  ISN is beyond the ACK of the record.
+ *  Records are kept in a hash table indexed by the tuple. A session entering TIME-WAIT replaces the record
+ *  of its bucket, this way a full table shortens the TIME-WAIT of the oldest sessions instead of blocking
+ *  new ones. Expired records are ignored by the lookups and cleared in idle cycles, one bucket per cycle.
+ *  @param[in]		rxEng2timer_setCloseTimer
+ *  @param[in]		rxEng2timer_timeWaitQuery
+ *  @param[in]		rxEng2timer_synQuery
+ *  @param[out]		timer2rxEng_timeWaitRsp
+ *  @param[out]		timer2rxEng_synRsp
+ */
+void close_timer(	stream<timeWaitEntry>&		rxEng2timer_setCloseTimer,
+					stream<timeWaitQuery>&		rxEng2timer_timeWaitQuery,
+					stream<timeWaitQuery>&		rxEng2timer_synQuery,
+					stream<timeWaitReply>&		timer2rxEng_timeWaitRsp,
+					stream<timeWaitReply>&		timer2rxEng_synRsp)
 {
 #pragma HLS PIPELINE II=1
 
 #pragma HLS DATA_PACK variable=rxEng2timer_setCloseTimer
-#pragma HLS DATA_PACK variable=closeTimer2stateTable_releaseState
+#pragma HLS DATA_PACK variable=rxEng2timer_timeWaitQuery
+#pragma HLS DATA_PACK variable=rxEng2timer_synQuery
+#pragma HLS DATA_PACK variable=timer2rxEng_timeWaitRsp
+#pragma HLS DATA_PACK variable=timer2rxEng_synRsp
 
-	static close_timer_entry closeTimerTable[MAX_SESSIONS];
-	#pragma HLS RESOURCE variable=closeTimerTable core=RAM_T2P_BRAM
-	#pragma HLS DATA_PACK variable=closeTimerTable
-	#pragma HLS DEPENDENCE variable=closeTimerTable inter false
+	static timeWaitRecord tw_table[TIME_WAIT_ENTRIES];
+	SESSION_TABLE_RESOURCE(tw_table, RAM_2P_BRAM)
+	#pragma HLS DATA_PACK variable=tw_table
+	#pragma HLS DEPENDENCE variable=tw_table inter false
+	// Records are stamped with timer ticks, see TIMER_TICK_CYCLES
+	static ap_uint<32> ct_cycles = 0;
+	static ap_uint<32> ct_ticks = 0;
+	static ap_uint<TIME_WAIT_BITS> ct_scrubIndex = 0;
 
-	static ap_uint<16>	ct_currSessionID = 0;
-	static ap_uint<16>	ct_setSessionID = 0;
-	static ap_uint<16>	ct_prevSessionID = 0;
-	static bool			ct_waitForWrite = false;
-	//ap_uint<16> sessionID;
+	timeWaitEntry entry;
+	timeWaitQuery query;
+	timeWaitReply reply;
+	timeWaitRecord record;
+	ap_uint<TIME_WAIT_BITS> index;
+	bool alive;
+	bool synQuery;
 
-	if (ct_waitForWrite)
+	if (ct_cycles == TIMER_TICK_CYCLES-1)
 	{
-		if (ct_setSessionID != ct_prevSessionID)
-		{
-			closeTimerTable[ct_setSessionID].time = TIME_60s;
-			closeTimerTable[ct_setSessionID].active = true;
-			ct_waitForWrite = false;
-		}
-		ct_prevSessionID--;
+		ct_cycles = 0;
+		ct_ticks++;
 	}
-	else if (!rxEng2timer_setCloseTimer.empty())
+	else
 	{
-		rxEng2timer_setCloseTimer.read(ct_setSessionID);
-		ct_waitForWrite = true;
+		ct_cycles++;
 	}
-	else
+
+	if (!rxEng2timer_timeWaitQuery.empty() || !rxEng2timer_synQuery.empty())
 	{
-		ct_prevSessionID = ct_currSessionID;
-		// Check if 0, otherwise decrement
-		if (closeTimerTable[ct_currSessionID].active)
+		// Segments without a session go first, their query waited for the session lookup
+		synQuery = rxEng2timer_timeWaitQuery.empty();
+		if (synQuery)
 		{
-			if (closeTimerTable[ct_currSessionID].time > 0)
-			{
-				closeTimerTable[ct_currSessionID].time -= 1;
-			}
-			else
+			rxEng2timer_synQuery.read(query);
+		}
+		else
+		{
+			rxEng2timer_timeWaitQuery.read(query);
+		}
+		index = timeWaitHash(query.tuple);
+		record = tw_table[index];
+		alive = (record.valid && ((ap_uint<32>) (ct_ticks - record.stamp)) < TIME_60s);
+		reply = timeWaitReply(false, 0, 0, query.tag);
+		if (alive && record.tuple.srcIp == query.tuple.srcIp && record.tuple.dstIp == query.tuple.dstIp
+				&& record.tuple.srcPort == query.tuple.srcPort && record.tuple.dstPort == query.tuple.dstPort)
+		{
+			reply = timeWaitReply(true, record.seqNumb, record.ackNumb, query.tag);
+			// A retransmitted FIN restarts the TIME-WAIT
+			if (query.fin)
 			{
-				closeTimerTable[ct_currSessionID].time = 0;
-				closeTimerTable[ct_currSessionID].active = false;
-				closeTimer2stateTable_releaseState.write(ct_currSessionID);
+				record.stamp = ct_ticks;
+				tw_table[index] = record;
 			}
 		}
-
-		ct_currSessionID++;
-		if (ct_currSessionID == MAX_SESSIONS)
+		if (synQuery)
+		{
+			timer2rxEng_synRsp.write(reply);
+		}
+		else
+		{
+			timer2rxEng_timeWaitRsp.write(reply);
+		}
+	}
+	else if (!rxEng2timer_setCloseTimer.empty())
+	{
+		rxEng2timer_setCloseTimer.read(entry);
+		record.tuple = entry.tuple;
+		record.seqNumb = entry.seqNumb;
+		record.ackNumb = entry.ackNumb;
+		record.stamp = ct_ticks;
+		record.valid = true;
+		tw_table[timeWaitHash(entry.tuple)] = record;
+	}
+	else
+	{
+		// Clearing expired records keeps them from coming alive again once the tick counter wrapped
+		record = tw_table[ct_scrubIndex];
+		if (record.valid && ((ap_uint<32>) (ct_ticks - record.stamp)) >= TIME_60s)
 		{
-			ct_currSessionID = 0;
+			record.valid = false;
+			tw_table[ct_scrubIndex] = record;
 		}
+		ct_scrubIndex++;
 	}
 }
@@ -30,17 +30,28 @@ EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.// Copyright (c) 2015 Xilinx,
 
 using namespace hls;
 
+// One record per hash bucket, a colliding session entering TIME-WAIT replaces the older record
+static const uint8_t TIME_WAIT_BITS = SESSION_ID_BITS;
+static const uint32_t TIME_WAIT_ENTRIES = 1 << TIME_WAIT_BITS;
+
 /** @ingroup close_timer
- *
+ *  TIME-WAIT record of a closed session, stamp is the timer tick it was entered or restarted
  */
-struct close_timer_entry
+struct timeWaitRecord
 {
-	ap_uint<32> time;
-	bool		active;
+	fourTuple	tuple;
+	ap_uint<32>	seqNumb;
+	ap_uint<32>	ackNumb;
+	ap_uint<32>	stamp;
+	bool		valid;
+	timeWaitRecord() {}
 };
 
 /** @defgroup close_timer Close Timer
  *
  */
-void close_timer(	stream<ap_uint<16> >&		rxEng2timer_setCloseTimer,
-					stream<ap_uint<16> >&		closeTimer2stateTable_releaseState);
+void close_timer(	stream<timeWaitEntry>&		rxEng2timer_setCloseTimer,
+					stream<timeWaitQuery>&		rxEng2timer_timeWaitQuery,
+					stream<timeWaitQuery>&		rxEng2timer_synQuery,
+					stream<timeWaitReply>&		timer2rxEng_timeWaitRsp,
+					stream<timeWaitReply>&		timer2rxEng_synRsp);
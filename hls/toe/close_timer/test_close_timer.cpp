@@ -27,61 +27,122 @@ OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF
 EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.// Copyright (c) 2015 Xilinx, Inc.
 ************************************************/
 #include "close_timer.hpp"
+#include <iostream>
 
 using namespace hls;
 
+stream<timeWaitEntry>	setFifo;
+stream<timeWaitQuery>	queryFifo;
+stream<timeWaitReply>	replyFifo;
+stream<timeWaitQuery>	synQueryFifo;
+stream<timeWaitReply>	synReplyFifo;
+
+timeWaitReply query(fourTuple tuple, bool fin)
+{
+	timeWaitReply reply(false, 0, 0);
+	queryFifo.write(timeWaitQuery(tuple, fin));
+	close_timer(setFifo, queryFifo, synQueryFifo, replyFifo, synReplyFifo);
+	if (!replyFifo.empty())
+	{
+		replyFifo.read(reply);
+	}
+	return reply;
+}
+
 int main()
 {
-#pragma HLS inline region off
-	//axiWord inData;
-	ap_uint<16> outData;
-	stream<ap_uint<16> > timeWaitFifo;
-	stream<ap_uint<16> > sessionReleaseFifo;
+	fourTuple tuple1(0x0a010101, 0x0a010102, 0xc350, 80);
+	fourTuple tuple2(0x0a010103, 0x0a010102, 0xc351, 80);
+	timeWaitReply reply;
+	int errCount = 0;
 
-	//std::ifstream inputFile;
-	std::ofstream outputFile;
+	setFifo.write(timeWaitEntry(tuple1, 0x1000, 0x2000));
+	close_timer(setFifo, queryFifo, synQueryFifo, replyFifo, synReplyFifo);
 
-	/*inputFile.open("/home/dsidler/workspace/toe/retransmit_timer/in.dat");
+	// Stray segment of the record is answered
+	reply = query(tuple1, false);
+	if (!reply.hit || reply.seqNumb != 0x1000 || reply.ackNumb != 0x2000)
+	{
+		std::cout << "Record not found, seq: " << std::hex << reply.seqNumb << " ack: " << reply.ackNumb << std::endl;
+		errCount++;
+	}
+	// Other tuples are not
+	reply = query(tuple2, false);
+	if (reply.hit)
+	{
+		std::cout << "Unknown tuple hit" << std::endl;
+		errCount++;
+	}
 
-	if (!inputFile)
+	// SYNs are answered on their own port with their tag, even if a stray segment is queried at the same time
+	synQueryFifo.write(timeWaitQuery(tuple1, false, 5));
+	synQueryFifo.write(timeWaitQuery(tuple2, false, 6));
+	queryFifo.write(timeWaitQuery(tuple1, false));
+	for (int i = 0; i < 4; i++)
+	{
+		close_timer(setFifo, queryFifo, synQueryFifo, replyFifo, synReplyFifo);
+	}
+	if (replyFifo.empty() || !replyFifo.read().hit)
+	{
+		std::cout << "Stray segment not answered next to SYNs" << std::endl;
+		errCount++;
+	}
+	reply = timeWaitReply(false, 0, 0);
+	if (!synReplyFifo.empty())
+	{
+		synReplyFifo.read(reply);
+	}
+	if (!reply.hit || reply.tag != 5 || reply.ackNumb != 0x2000)
 	{
-		std::cout << "Error: could not open test input file." << std::endl;
-		return -1;
-	}*/
-	outputFile.open("/home/dasidler/toe/hls/toe/close_timer/out.dat");
-	if (!outputFile)
+		std::cout << "SYN record not found, tag: " << reply.tag << std::endl;
+		errCount++;
+	}
+	reply = timeWaitReply(true, 0, 0);
+	if (!synReplyFifo.empty())
+	{
+		synReplyFifo.read(reply);
+	}
+	if (reply.hit || reply.tag != 6)
 	{
-		std::cout << "Error: could not open test output file." << std::endl;
+		std::cout << "Unknown SYN tuple hit, tag: " << reply.tag << std::endl;
+		errCount++;
 	}
 
+	// A retransmitted FIN half way restarts the TIME-WAIT
 	uint32_t count = 0;
-	uint32_t setCount = 0;
-	timeWaitFifo.write(1);
-	timeWaitFifo.write(2);
-	while (count < 2147483647)
+	while (count < TIMER_TICK_CYCLES*(TIME_60s/2))
 	{
-
-		if ((count % 1000000000) == 0)
-		{
-			outputFile << "set new timer, count: " << count << std::endl;
-			timeWaitFifo.write(1);
-			setCount = count;
-		}
-
-		close_timer(timeWaitFifo, sessionReleaseFifo);
-		while(!sessionReleaseFifo.empty())
-		{
-			double dbcount = count - setCount;
-			sessionReleaseFifo.read(outData);
-			outputFile << "Event fired at count: " << count;
-			outputFile << " ID: " << outData;// << std::endl;
-			outputFile << " Time[s]: " << ((dbcount * 6.66) /1000000000) << std::endl;
-		}
+		close_timer(setFifo, queryFifo, synQueryFifo, replyFifo, synReplyFifo);
 		count++;
 	}
+	reply = query(tuple1, true);
+	count = 0;
+	while (count < TIMER_TICK_CYCLES*(TIME_60s-2))
+	{
+		close_timer(setFifo, queryFifo, synQueryFifo, replyFifo, synReplyFifo);
+		count++;
+	}
+	reply = query(tuple1, false);
+	if (!reply.hit)
+	{
+		std::cout << "TIME-WAIT was not restarted" << std::endl;
+		errCount++;
+	}
 
+	// Record expires and is cleared
+	count = 0;
+	while (count < TIMER_TICK_CYCLES*2 + TIME_WAIT_ENTRIES)
+	{
+		close_timer(setFifo, queryFifo, synQueryFifo, replyFifo, synReplyFifo);
+		count++;
+	}
+	reply = query(tuple1, false);
+	if (reply.hit)
+	{
+		std::cout << "Record did not expire" << std::endl;
+		errCount++;
+	}
 
-	//should return comparison
-
-	return 0;
+	std::cout << "Errors: " << errCount << std::endl;
+	return errCount;
 }
@@ -0,0 +1,290 @@
+/************************************************
+Copyright (c) 2016, Xilinx, Inc.
+All rights reserved.
+
+Redistribution and use in source and binary forms, with or without modification, 
+are permitted provided that the following conditions are met:
+
+1. Redistributions of source code must retain the above copyright notice, 
+this list of conditions and the following disclaimer.
+
+2. Redistributions in binary form must reproduce the above copyright notice, 
+this list of conditions and the following disclaimer in the documentation 
+and/or other materials provided with the distribution.
+
+3. Neither the name of the copyright holder nor the names of its contributors 
+may be used to endorse or promote products derived from this software 
+without specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND 
+ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, 
+THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED. 
+IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, 
+INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, 
+PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) 
+HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, 
+OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, 
+EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.// Copyright (c) 2015 Xilinx, Inc.
+************************************************/
+
+#include "congestion_control.hpp"
+
+using namespace hls;
+
+/** @ingroup congestion_control
+ *  Computes the CUBIC K = cbrt(reduction / C) in CUBIC time units. K is found bit by bit,
+ *  the largest K with K^3 <= reduction / C
+ *  @param[in]		reduction, W_max minus the window after the reduction
+ */
+ap_uint<20> ccCubicK(ap_uint<WINDOW_BITS> reduction)
+{
+#pragma HLS INLINE
+
+	ap_uint<64> kCube = ((ap_uint<64>) reduction) * CUBIC_K_FACTOR;
+	ap_uint<20> k = 0;
+	ap_uint<20> kCandidate;
+
+	for (int i = 19; i >= 0; i--)
+	{
+	#pragma HLS UNROLL
+		kCandidate = k;
+		kCandidate[i] = 1;
+		if (((ap_uint<64>) kCandidate * kCandidate * kCandidate) <= kCube)
+		{
+			k = kCandidate;
+		}
+	}
+	return k;
+}
+
+/** @ingroup congestion_control
+ *  Window growth on a new ACK. Slow start increases by the acknowledged bytes, at most 2 * MSS (RFC 3465).
+ *  In congestion avoidance the acknowledged bytes are counted, once a full window was acknowledged (one RTT)
+ *  Reno increases the window by one MSS and CUBIC moves it to its target W_cubic(t), RFC 8312 4.1,
+ *  never below the window Reno would have (TCP-friendly region) and at most to 1.5 * cong_window.
+ *  @param[in,out]	cong_window
+ *  @param[in]		slowstart_threshold
+ *  @param[in,out]	cc
+ *  @param[in]		ackedBytes, newly acknowledged bytes
+ *  @param[in]		elapsed, clock cycles since the CUBIC epoch started
+ */
+void ccAckReceived(	ap_uint<WINDOW_BITS>&	cong_window,
+					ap_uint<WINDOW_BITS>	slowstart_threshold,
+					congestionState&		cc,
+					ap_uint<WINDOW_BITS>	ackedBytes,
+					ap_uint<32>				elapsed)
+{
+#pragma HLS INLINE
+
+	ap_uint<WINDOW_BITS+1> newWindow = cong_window;
+	ap_uint<WINDOW_BITS+1> maxWindow = cong_window + (cong_window >> 1);
+	ap_uint<WINDOW_BITS+2> target;
+	ap_uint<WINDOW_BITS+1> ackedSum;
+	ap_uint<32> t = elapsed >> CUBIC_TIME_SHIFT;
+	ap_uint<32> distance;
+	ap_uint<12> offset;
+	ap_uint<64> delta;
+
+	if (cong_window < slowstart_threshold)
+	{
+		newWindow += (ackedBytes < 2*MSS) ? ackedBytes : (ap_uint<WINDOW_BITS>) (2*MSS);
+		cc.bytes_acked = 0;
+	}
+	else
+	{
+		ackedSum = cc.bytes_acked + ackedBytes;
+		if (ackedSum >= cong_window)
+		{
+			ackedSum -= cong_window;
+			if (cc.algorithm == CC_CUBIC)
+			{
+				// W_cubic(t) = C * (t - K)^3 + W_max
+				distance = (t > cc.k) ? (ap_uint<32>) (t - cc.k) : (ap_uint<32>) (cc.k - t);
+				offset = (distance < 0xFFF) ? (ap_uint<12>) distance : (ap_uint<12>) 0xFFF;
+				delta = (((ap_uint<64>) offset * offset * offset) * CUBIC_C_MSS) >> 30;
+				if (t > cc.k)
+				{
+					target = (delta < maxWindow) ? (ap_uint<WINDOW_BITS+2>) (cc.w_max + delta) : (ap_uint<WINDOW_BITS+2>) maxWindow;
+				}
+				else
+				{
+					target = (delta < cc.w_max) ? (ap_uint<WINDOW_BITS+2>) (cc.w_max - delta) : (ap_uint<WINDOW_BITS+2>) 0;
+				}
+				cc.w_est += CUBIC_ALPHA_MSS;
+				if (target < cc.w_est)
+				{
+					target = cc.w_est;
+				}
+				if (target > maxWindow)
+				{
+					target = maxWindow;
+				}
+				if (target > newWindow)
+				{
+					newWindow = target;
+				}
+			}
+			else // CC_RENO
+			{
+				newWindow += MSS;
+			}
+		}
+		cc.bytes_acked = (ackedSum < BUFFER_SIZE) ? (ap_uint<WINDOW_BITS>) ackedSum : (ap_uint<WINDOW_BITS>) (BUFFER_SIZE-1);
+	}
+	cong_window = (newWindow < BUFFER_SIZE) ? (ap_uint<WINDOW_BITS>) newWindow : (ap_uint<WINDOW_BITS>) (BUFFER_SIZE-1);
+}
+
+/** @ingroup congestion_control
+ *  Window reduction on a loss. Reno halves the flight size (RFC 5681 3.1), CUBIC reduces the window
+ *  by 0.7, remembers it as W_max (with fast convergence) and computes K = cbrt(W_max * (1 - 0.7) / C).
+ *  After a fast retransmit the window is set to the new threshold, after a timeout to one MSS.
+ *  The caller restarts the CUBIC epoch.
+ *  @param[in,out]	cong_window
+ *  @param[in,out]	slowstart_threshold
+ *  @param[in,out]	cc
+ *  @param[in]		flightSize, outstanding bytes
+ *  @param[in]		timeout, loss was detected by the retransmit timer
+ */
+void ccLossDetected(ap_uint<WINDOW_BITS>&	cong_window,
+					ap_uint<WINDOW_BITS>&	slowstart_threshold,
+					congestionState&		cc,
+					ap_uint<WINDOW_BITS>	flightSize,
+					bool					timeout)
+{
+#pragma HLS INLINE
+
+	ap_uint<WINDOW_BITS> threshold;
+
+	if (cc.algorithm == CC_CUBIC)
+	{
+		if (cong_window < cc.w_max)
+		{
+			cc.w_max = (cong_window * CUBIC_FAST_CONVERGENCE) >> 8;
+		}
+		else
+		{
+			cc.w_max = cong_window;
+		}
+		threshold = (cong_window * CUBIC_BETA) >> 8;
+		cc.k = ccCubicK(cc.w_max - threshold);
+	}
+	else // CC_RENO
+	{
+		threshold = flightSize >> 1;
+	}
+	if (threshold < 2*MSS)
+	{
+		threshold = 2*MSS;
+	}
+	slowstart_threshold = threshold;
+	cc.w_est = threshold;
+	cc.bytes_acked = 0;
+	if (timeout)
+	{
+		cong_window = MSS;
+	}
+	else
+	{
+		cong_window = threshold;
+	}
+}
+
+/** @ingroup congestion_control
+ *  ECN response of the sender, RFC 8257 3.3. The acknowledged and the ECE marked bytes are counted,
+ *  once per window of data the marked fraction F updates alpha = (1 - g) * alpha + g * F.
+ *  The first ECE of a window reduces the window by alpha / 2, further marks are ignored until
+ *  the data sent before the reduction is acknowledged. CUBIC restarts its epoch from the old window.
+ *  @param[in,out]	cong_window
+ *  @param[in,out]	slowstart_threshold
+ *  @param[in,out]	cc
+ *  @param[in]		ackedBytes, newly acknowledged bytes
+ *  @param[in]		ece, ECE flag of the ACK
+ *  @param[in]		ackNumb
+ *  @param[in]		nextByte, next sequence number to be sent
+ *  @return			true if the window was reduced, CWR has to be sent and the caller restarts the epoch
+ */
+bool ccEcnEchoReceived(	ap_uint<WINDOW_BITS>&	cong_window,
+						ap_uint<WINDOW_BITS>&	slowstart_threshold,
+						congestionState&		cc,
+						ap_uint<WINDOW_BITS>	ackedBytes,
+						bool					ece,
+						ap_uint<32>				ackNumb,
+						ap_uint<32>				nextByte)
+{
+#pragma HLS INLINE
+
+	ap_uint<WINDOW_BITS+12> remainder;
+	ap_uint<11> fraction = 0;
+	ap_uint<WINDOW_BITS+12> reduction;
+	ap_uint<WINDOW_BITS> threshold;
+	bool reduced = false;
+
+	cc.ecn_acked += ackedBytes;
+	if (ece)
+	{
+		cc.ecn_marked += ackedBytes;
+	}
+	if (((ap_uint<32>) (ackNumb - cc.ecn_windowEnd)) < 0x80000000)
+	{
+		// F = ecn_marked / ecn_acked scaled by 2^10, computed bit by bit
+		remainder = ((ap_uint<WINDOW_BITS+12>) cc.ecn_marked) << 10;
+		for (int i = 10; i >= 0; i--)
+		{
+		#pragma HLS UNROLL
+			if (cc.ecn_acked != 0 && remainder >= (((ap_uint<WINDOW_BITS+12>) cc.ecn_acked) << i))
+			{
+				remainder -= ((ap_uint<WINDOW_BITS+12>) cc.ecn_acked) << i;
+				fraction[i] = 1;
+			}
+		}
+		if (fraction > DCTCP_ALPHA_INIT)
+		{
+			fraction = DCTCP_ALPHA_INIT;
+		}
+		cc.ecn_alpha = cc.ecn_alpha - (cc.ecn_alpha >> DCTCP_G_SHIFT) + (fraction >> DCTCP_G_SHIFT);
+		cc.ecn_acked = 0;
+		cc.ecn_marked = 0;
+		cc.ecn_windowEnd = nextByte;
+	}
+	if (ece && ((ap_uint<32>) (ackNumb - cc.ecn_recoveryEnd)) < 0x80000000)
+	{
+		reduction = (((ap_uint<WINDOW_BITS+12>) cong_window) * cc.ecn_alpha) >> 11;
+		threshold = cong_window - reduction;
+		if (threshold < 2*MSS)
+		{
+			threshold = 2*MSS;
+		}
+		if (cc.algorithm == CC_CUBIC)
+		{
+			cc.w_max = cong_window;
+			cc.k = ccCubicK(cong_window - threshold);
+		}
+		slowstart_threshold = threshold;
+		cong_window = threshold;
+		cc.w_est = threshold;
+		cc.bytes_acked = 0;
+		cc.ecn_recoveryEnd = nextByte;
+		reduced = true;
+	}
+	return reduced;
+}
+
+/** @ingroup congestion_control
+ *  Resets the state of a new session
+ *  @param[in]		seqNumb, initial sequence number of the session
+ */
+void ccInit(congestionState& cc, ap_uint<32> seqNumb)
+{
+#pragma HLS INLINE
+
+	cc.bytes_acked = 0;
+	cc.w_max = 0;
+	cc.w_est = 0;
+	cc.k = 0;
+	cc.algorithm = TCP_CC_DEFAULT;
+	cc.ecn_acked = 0;
+	cc.ecn_marked = 0;
+	cc.ecn_alpha = DCTCP_ALPHA_INIT;
+	cc.ecn_windowEnd = seqNumb;
+	cc.ecn_recoveryEnd = seqNumb;
+}
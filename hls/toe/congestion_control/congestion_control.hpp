@@ -0,0 +1,79 @@
+/************************************************
+Copyright (c) 2016, Xilinx, Inc.
+All rights reserved.
+
+Redistribution and use in source and binary forms, with or without modification, 
+are permitted provided that the following conditions are met:
+
+1. Redistributions of source code must retain the above copyright notice, 
+this list of conditions and the following disclaimer.
+
+2. Redistributions in binary form must reproduce the above copyright notice, 
+this list of conditions and the following disclaimer in the documentation 
+and/or other materials provided with the distribution.
+
+3. Neither the name of the copyright holder nor the names of its contributors 
+may be used to endorse or promote products derived from this software 
+without specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND 
+ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, 
+THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED. 
+IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, 
+INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, 
+PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) 
+HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, 
+OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, 
+EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.// Copyright (c) 2015 Xilinx, Inc.
+************************************************/
+#ifndef CONGESTION_CONTROL_HPP_INCLUDED
+#define CONGESTION_CONTROL_HPP_INCLUDED
+
+#include "../toe.hpp"
+
+using namespace hls;
+
+// CUBIC time unit, t is counted in units of 2^CUBIC_TIME_SHIFT clock cycles (~0.84ms)
+static const uint8_t CUBIC_TIME_SHIFT = 17;
+// C * MSS scaled by 2^30 and converted to CUBIC time units, C = 0.4 segments/s^3, RFC 8312 5.1
+static const ap_uint<16> CUBIC_C_MSS = 370;
+// 2^30 / CUBIC_C_MSS, used to compute K
+static const ap_uint<32> CUBIC_K_FACTOR = 2901941;
+// Multiplicative decrease of 0.7 and the fast convergence factor of 0.85, both scaled by 2^8
+static const ap_uint<9> CUBIC_BETA = 179;
+static const ap_uint<9> CUBIC_FAST_CONVERGENCE = 218;
+// Reno increase per RTT in the TCP-friendly region, 3 * (1 - 0.7) / (1 + 0.7) * MSS
+static const ap_uint<16> CUBIC_ALPHA_MSS = (MSS * 135) >> 8;
+// DCTCP estimation gain g = 1/2^DCTCP_G_SHIFT and initial alpha of 1.0 scaled by 2^10, RFC 8257 4.2
+static const uint8_t DCTCP_G_SHIFT = 4;
+static const ap_uint<11> DCTCP_ALPHA_INIT = 1024;
+
+/** @defgroup congestion_control Congestion Control
+ *  @ingroup tcp_module
+ *  Window growth and loss response of the @ref rx_engine and @ref session_context_table. The algorithm
+ *  is selected per session through congestionState::algorithm, new sessions get TCP_CC_DEFAULT.
+ *  ECN marks are answered by all algorithms with the proportional reduction of DCTCP
+ */
+void ccAckReceived(	ap_uint<WINDOW_BITS>&	cong_window,
+					ap_uint<WINDOW_BITS>	slowstart_threshold,
+					congestionState&		cc,
+					ap_uint<WINDOW_BITS>	ackedBytes,
+					ap_uint<32>				elapsed);
+
+void ccLossDetected(ap_uint<WINDOW_BITS>&	cong_window,
+					ap_uint<WINDOW_BITS>&	slowstart_threshold,
+					congestionState&		cc,
+					ap_uint<WINDOW_BITS>	flightSize,
+					bool					timeout);
+
+bool ccEcnEchoReceived(	ap_uint<WINDOW_BITS>&	cong_window,
+						ap_uint<WINDOW_BITS>&	slowstart_threshold,
+						congestionState&		cc,
+						ap_uint<WINDOW_BITS>	ackedBytes,
+						bool					ece,
+						ap_uint<32>				ackNumb,
+						ap_uint<32>				nextByte);
+
+void ccInit(congestionState& cc, ap_uint<32> seqNumb);
+
+#endif
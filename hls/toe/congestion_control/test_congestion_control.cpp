@@ -0,0 +1,153 @@
+/************************************************
+Copyright (c) 2016, Xilinx, Inc.
+All rights reserved.
+
+Redistribution and use in source and binary forms, with or without modification, 
+are permitted provided that the following conditions are met:
+
+1. Redistributions of source code must retain the above copyright notice, 
+this list of conditions and the following disclaimer.
+
+2. Redistributions in binary form must reproduce the above copyright notice, 
+this list of conditions and the following disclaimer in the documentation 
+and/or other materials provided with the distribution.
+
+3. Neither the name of the copyright holder nor the names of its contributors 
+may be used to endorse or promote products derived from this software 
+without specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND 
+ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, 
+THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED. 
+IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, 
+INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, 
+PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) 
+HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, 
+OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, 
+EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.// Copyright (c) 2015 Xilinx, Inc.
+************************************************/
+#include "congestion_control.hpp"
+#include <iostream>
+
+using namespace hls;
+
+int main()
+{
+	ap_uint<WINDOW_BITS> cong_window;
+	ap_uint<WINDOW_BITS> slowstart_threshold;
+	congestionState cc;
+	ap_uint<32> elapsed;
+	int errCount = 0;
+
+	// Reno
+	ccInit(cc, 0);
+	cc.algorithm = CC_RENO;
+	cong_window = 10*MSS;
+	slowstart_threshold = 20*MSS;
+	// Slow start, at most 2 MSS per ACK
+	ccAckReceived(cong_window, slowstart_threshold, cc, 4*MSS, 0);
+	if (cong_window != 12*MSS)
+	{
+		std::cerr << "Reno slow start: " << std::dec << cong_window << std::endl;
+		errCount++;
+	}
+	// Congestion avoidance, one MSS per window
+	cong_window = 20*MSS;
+	for (int i = 0; i < 20; i++)
+	{
+		ccAckReceived(cong_window, slowstart_threshold, cc, MSS, 0);
+	}
+	if (cong_window != 21*MSS)
+	{
+		std::cerr << "Reno congestion avoidance: " << std::dec << cong_window << std::endl;
+		errCount++;
+	}
+	// Fast retransmit and timeout
+	ccLossDetected(cong_window, slowstart_threshold, cc, 16*MSS, false);
+	if (slowstart_threshold != 8*MSS || cong_window != 8*MSS)
+	{
+		std::cerr << "Reno fast retransmit: " << std::dec << slowstart_threshold << " " << cong_window << std::endl;
+		errCount++;
+	}
+	ccLossDetected(cong_window, slowstart_threshold, cc, 2*MSS, true);
+	if (slowstart_threshold != 2*MSS || cong_window != MSS)
+	{
+		std::cerr << "Reno timeout: " << std::dec << slowstart_threshold << " " << cong_window << std::endl;
+		errCount++;
+	}
+
+	// CUBIC
+	ccInit(cc, 0);
+	cc.algorithm = CC_CUBIC;
+	cong_window = 40*MSS;
+	slowstart_threshold = 20*MSS;
+	ccLossDetected(cong_window, slowstart_threshold, cc, 40*MSS, false);
+	std::cout << "CUBIC loss: ssthresh " << std::dec << slowstart_threshold << " W_max " << cc.w_max << " K " << cc.k << std::endl;
+	if (cc.w_max != 40*MSS || cong_window != slowstart_threshold || cong_window > 28*MSS)
+	{
+		errCount++;
+	}
+	// The window is concave below W_max and convex above, it must never shrink
+	ap_uint<WINDOW_BITS> prevWindow = cong_window;
+	for (elapsed = 0; elapsed < (cc.k * 2) << CUBIC_TIME_SHIFT; elapsed += (ap_uint<32>) 1 << (CUBIC_TIME_SHIFT+3))
+	{
+		for (int i = 0; i < 40; i++)
+		{
+			ccAckReceived(cong_window, slowstart_threshold, cc, MSS, elapsed);
+		}
+		if (cong_window < prevWindow)
+		{
+			std::cerr << "CUBIC window decreased at " << std::dec << elapsed << std::endl;
+			errCount++;
+		}
+		prevWindow = cong_window;
+	}
+	std::cout << "CUBIC window after 2K: " << std::dec << cong_window << std::endl;
+	if (cong_window <= cc.w_max)
+	{
+		errCount++;
+	}
+
+	// DCTCP, the first window reduces by alpha / 2 = 1/2, further marks of the same window are ignored
+	ap_uint<32> ackNumb = 2*MSS;
+	ccInit(cc, 0);
+	cc.algorithm = CC_RENO;
+	cong_window = 40*MSS;
+	slowstart_threshold = 20*MSS;
+	if (!ccEcnEchoReceived(cong_window, slowstart_threshold, cc, MSS, true, MSS, 40*MSS) || cong_window != 20*MSS)
+	{
+		std::cerr << "DCTCP first reduction: " << std::dec << cong_window << std::endl;
+		errCount++;
+	}
+	if (ccEcnEchoReceived(cong_window, slowstart_threshold, cc, MSS, true, 2*MSS, 41*MSS))
+	{
+		std::cerr << "DCTCP reduced twice in one window" << std::endl;
+		errCount++;
+	}
+	// Without marks alpha decays, 10 windows leave (15/16)^10 of it
+	for (int i = 0; i < 10; i++)
+	{
+		ackNumb += 40*MSS;
+		ccEcnEchoReceived(cong_window, slowstart_threshold, cc, 40*MSS, false, ackNumb, ackNumb + 40*MSS);
+	}
+	std::cout << "DCTCP alpha after 10 unmarked windows: " << std::dec << cc.ecn_alpha << std::endl;
+	if (cc.ecn_alpha > 550 || cc.ecn_alpha < 500)
+	{
+		errCount++;
+	}
+	// A reduction with the decayed alpha is proportionally smaller
+	ap_uint<WINDOW_BITS> windowBefore = cong_window;
+	ackNumb += MSS;
+	ccEcnEchoReceived(cong_window, slowstart_threshold, cc, MSS, true, ackNumb, ackNumb + 40*MSS);
+	std::cout << "DCTCP reduction: " << std::dec << windowBefore << " -> " << cong_window << std::endl;
+	if (cong_window <= windowBefore/2 || cong_window >= windowBefore)
+	{
+		errCount++;
+	}
+
+	if (errCount == 0)
+	{
+		std::cout << "Test passed." << std::endl;
+	}
+	return errCount;
+}
@@ -0,0 +1,225 @@
+/************************************************
+Copyright (c) 2016, Xilinx, Inc.
+All rights reserved.
+
+Redistribution and use in source and binary forms, with or without modification, 
+are permitted provided that the following conditions are met:
+
+1. Redistributions of source code must retain the above copyright notice, 
+this list of conditions and the following disclaimer.
+
+2. Redistributions in binary form must reproduce the above copyright notice, 
+this list of conditions and the following disclaimer in the documentation 
+and/or other materials provided with the distribution.
+
+3. Neither the name of the copyright holder nor the names of its contributors 
+may be used to endorse or promote products derived from this software 
+without specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND 
+ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, 
+THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED. 
+IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, 
+INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, 
+PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) 
+HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, 
+OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, 
+EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.// Copyright (c) 2015 Xilinx, Inc.
+************************************************/
+
+#ifndef CONTEXT_CACHE_HPP_INCLUDED
+#define CONTEXT_CACHE_HPP_INCLUDED
+
+#include "../toe.hpp"
+
+using namespace hls;
+
+/** @ingroup context_cache
+ *  CTX_ACCESS looks up the context of a table request, CTX_PREFETCH only loads it,
+ *  CTX_FILL installs the line returned by the memory read, CTX_WRITE_DONE retires the
+ *  oldest write back once its write status returned
+ */
+enum ctxCacheOp {CTX_ACCESS, CTX_PREFETCH, CTX_FILL, CTX_WRITE_DONE};
+
+/** @ingroup context_cache
+ *  On a hit the table accesses its entry at slot. A miss writes back the victim line
+ *  of evictID if evict is set and fetches the line of the session if fetch is set
+ */
+struct ctxCacheResult
+{
+	bool		hit;
+	ap_uint<16>	slot;
+	bool		evict;
+	ap_uint<16>	evictID;
+	bool		fetch;
+	ctxCacheResult()
+		:hit(false), slot(0), evict(false), evictID(0), fetch(false) {}
+};
+
+/** @defgroup context_cache Context Cache
+ *  @ingroup tcp_module
+ *  Tag store of the on-chip part of a session table whose contexts live in DDR, it is part of the table it serves.
+ *  CTX_CACHE_WAYS ways of CTX_CACHE_SETS lines, the set is given by the lower bits of the session ID and
+ *  the victim of a full set is chosen round robin. Lines are written back when a dirty victim is evicted.
+ *  Only one fetch is outstanding, a miss during a fetch is not served: an access has to be retried
+ *  and a prefetch is dropped. The same holds for a miss on a session whose write back has not completed,
+ *  its line would be read before it landed in DDR, and for a dirty eviction while CTX_WRITEBACK_SLOTS
+ *  write backs are outstanding. The prefetch issued on a session lookup hides the DDR latency
+ *  until the @ref rx_engine accesses the context. Without TCP_DDR_CONTEXT every access hits at slot sessionID.
+ *  Each instance has its own state, CACHE_ID only has to be unique per instance.
+ *  @param[in]		op
+ *  @param[in]		sessionID, not used by CTX_FILL and CTX_WRITE_DONE
+ *  @param[in]		write, marks the line dirty on a hit
+ *  @return			slot of the line and the memory accesses to issue
+ */
+template <int CACHE_ID>
+ctxCacheResult context_cache(ctxCacheOp op, ap_uint<16> sessionID, bool write)
+{
+#pragma HLS INLINE
+
+	ctxCacheResult result;
+#if (TCP_DDR_CONTEXT)
+	static ap_uint<16>	cc_tag[CTX_CACHE_WAYS][CTX_CACHE_SETS];
+	static bool			cc_valid[CTX_CACHE_WAYS][CTX_CACHE_SETS];
+	static bool			cc_dirty[CTX_CACHE_WAYS][CTX_CACHE_SETS];
+	#pragma HLS ARRAY_PARTITION variable=cc_tag complete dim=1
+	#pragma HLS ARRAY_PARTITION variable=cc_valid complete dim=1
+	#pragma HLS ARRAY_PARTITION variable=cc_dirty complete dim=1
+	#pragma HLS DEPENDENCE variable=cc_tag inter false
+	#pragma HLS DEPENDENCE variable=cc_valid inter false
+	#pragma HLS DEPENDENCE variable=cc_dirty inter false
+	static ap_uint<2>	cc_victim[CTX_CACHE_SETS];
+	static bool			cc_fetchPending = false;
+	static ap_uint<16>	cc_fetchSlot;
+	// Outstanding write backs in issue order, the write status returns in the same order
+	static ap_uint<16>	cc_wbID[CTX_WRITEBACK_SLOTS];
+	static bool			cc_wbValid[CTX_WRITEBACK_SLOTS] = {false};
+	#pragma HLS ARRAY_PARTITION variable=cc_wbID complete
+	#pragma HLS ARRAY_PARTITION variable=cc_wbValid complete
+	static ap_uint<2>	cc_wbHead = 0;
+	static ap_uint<2>	cc_wbTail = 0;
+	static ap_uint<3>	cc_wbCount = 0;
+
+	ap_uint<CTX_CACHE_SET_BITS> set = sessionID(CTX_CACHE_SET_BITS-1, 0);
+	ap_uint<2> way = 0;
+	ap_uint<2> freeWay = 0;
+	bool found = false;
+	bool freeFound = false;
+	bool writeBackPending = false;
+	bool evict;
+
+	if (op == CTX_FILL)
+	{
+		way = cc_fetchSlot(CTX_CACHE_SET_BITS+1, CTX_CACHE_SET_BITS);
+		set = cc_fetchSlot(CTX_CACHE_SET_BITS-1, 0);
+		cc_valid[way][set] = true;
+		cc_fetchPending = false;
+		result.slot = cc_fetchSlot;
+		return result;
+	}
+	if (op == CTX_WRITE_DONE)
+	{
+		cc_wbValid[cc_wbHead] = false;
+		cc_wbHead++;
+		cc_wbCount--;
+		return result;
+	}
+
+	for (uint8_t i = 0; i < CTX_WRITEBACK_SLOTS; i++)
+	{
+	#pragma HLS UNROLL
+		if (cc_wbValid[i] && cc_wbID[i] == sessionID)
+		{
+			writeBackPending = true;
+		}
+	}
+
+	for (uint8_t i = 0; i < CTX_CACHE_WAYS; i++)
+	{
+	#pragma HLS UNROLL
+		if (cc_valid[i][set] && cc_tag[i][set] == sessionID)
+		{
+			way = i;
+			found = true;
+		}
+		if (!cc_valid[i][set] && !freeFound)
+		{
+			freeWay = i;
+			freeFound = true;
+		}
+	}
+	if (found)
+	{
+		result.hit = true;
+		result.slot = (way, set);
+		if (op == CTX_ACCESS && write)
+		{
+			cc_dirty[way][set] = true;
+		}
+	}
+	else if (!cc_fetchPending && !writeBackPending)
+	{
+		// Empty lines are used first
+		way = freeFound ? freeWay : cc_victim[set];
+		evict = cc_valid[way][set] && cc_dirty[way][set];
+		if (!evict || cc_wbCount != CTX_WRITEBACK_SLOTS)
+		{
+			if (!freeFound)
+			{
+				cc_victim[set]++;
+			}
+			result.slot = (way, set);
+			result.evict = evict;
+			result.evictID = cc_tag[way][set];
+			result.fetch = true;
+			if (evict)
+			{
+				cc_wbID[cc_wbTail] = cc_tag[way][set];
+				cc_wbValid[cc_wbTail] = true;
+				cc_wbTail++;
+				cc_wbCount++;
+			}
+			cc_tag[way][set] = sessionID;
+			cc_valid[way][set] = false;
+			cc_dirty[way][set] = false;
+			cc_fetchPending = true;
+			cc_fetchSlot = result.slot;
+		}
+	}
+#else
+	// Every session has its own line
+	(void) op;
+	(void) write;
+	result.hit = true;
+	result.slot = sessionID;
+#endif
+	return result;
+}
+
+/** @ingroup context_cache
+ *  Issues the data mover commands of a cache miss, the table writes the evicted line to the write data stream
+ *  @param[in]		result, of @ref context_cache
+ *  @param[in]		sessionID, of the line to fetch
+ *  @param[in]		lineBytes, bytes transferred per line, at most 1 << CTX_LINE_BITS
+ *  @param[out]		contextReadCmd
+ *  @param[out]		contextWriteCmd
+ */
+static inline void contextCacheMemCmd(	ctxCacheResult			result,
+										ap_uint<16>				sessionID,
+										ap_uint<16>				lineBytes,
+										stream<mmCmd>&			contextReadCmd,
+										stream<mmCmd>&			contextWriteCmd)
+{
+#pragma HLS INLINE
+
+	if (result.evict)
+	{
+		contextWriteCmd.write(mmCmd(((ap_uint<32>) result.evictID) << CTX_LINE_BITS, lineBytes));
+	}
+	if (result.fetch)
+	{
+		contextReadCmd.write(mmCmd(((ap_uint<32>) sessionID) << CTX_LINE_BITS, lineBytes));
+	}
+}
+
+#endif
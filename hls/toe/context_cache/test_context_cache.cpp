@@ -0,0 +1,189 @@
+/************************************************
+Copyright (c) 2016, Xilinx, Inc.
+All rights reserved.
+
+Redistribution and use in source and binary forms, with or without modification, 
+are permitted provided that the following conditions are met:
+
+1. Redistributions of source code must retain the above copyright notice, 
+this list of conditions and the following disclaimer.
+
+2. Redistributions in binary form must reproduce the above copyright notice, 
+this list of conditions and the following disclaimer in the documentation 
+and/or other materials provided with the distribution.
+
+3. Neither the name of the copyright holder nor the names of its contributors 
+may be used to endorse or promote products derived from this software 
+without specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND 
+ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, 
+THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED. 
+IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, 
+INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, 
+PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) 
+HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, 
+OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, 
+EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.// Copyright (c) 2015 Xilinx, Inc.
+************************************************/
+
+// The cache is only instantiated in the DDR context build
+#define TCP_DDR_CONTEXT 1
+#include "context_cache.hpp"
+#include <iostream>
+
+using namespace hls;
+
+int main()
+{
+	stream<mmCmd> readCmd;
+	stream<mmCmd> writeCmd;
+	ctxCacheResult result;
+	ap_uint<16> slot;
+	mmCmd cmd;
+	int errCount = 0;
+
+	// Cold miss fetches the line
+	result = context_cache<0>(CTX_ACCESS, 5, false);
+	contextCacheMemCmd(result, 5, 64, readCmd, writeCmd);
+	if (result.hit || !result.fetch || result.evict || readCmd.empty() || !writeCmd.empty())
+	{
+		std::cerr << "Cold miss: hit " << result.hit << " fetch " << result.fetch << " evict " << result.evict << std::endl;
+		errCount++;
+	}
+	readCmd.read(cmd);
+	if (cmd.saddr != (5 << CTX_LINE_BITS) || cmd.bbt != 64)
+	{
+		std::cerr << "Read address: " << std::hex << cmd.saddr << std::endl;
+		errCount++;
+	}
+	slot = result.slot;
+	// Nothing else is fetched until the line was filled, the access is retried and the prefetch dropped
+	result = context_cache<0>(CTX_ACCESS, 5, false);
+	if (result.hit || result.fetch)
+	{
+		std::cerr << "Access during fetch: hit " << result.hit << " fetch " << result.fetch << std::endl;
+		errCount++;
+	}
+	result = context_cache<0>(CTX_PREFETCH, 6, false);
+	if (result.fetch)
+	{
+		std::cerr << "Prefetch during fetch was not dropped" << std::endl;
+		errCount++;
+	}
+	result = context_cache<0>(CTX_FILL, 0, false);
+	if (result.slot != slot)
+	{
+		std::cerr << "Fill slot: " << std::dec << result.slot << " expected " << slot << std::endl;
+		errCount++;
+	}
+	// Hit after the fill, the write marks the line dirty
+	result = context_cache<0>(CTX_ACCESS, 5, true);
+	if (!result.hit || result.slot != slot)
+	{
+		std::cerr << "Hit: hit " << result.hit << " slot " << std::dec << result.slot << std::endl;
+		errCount++;
+	}
+	// Sessions of the same set fill the other ways, prefetches are installed like accesses
+	for (int i = 1; i < CTX_CACHE_WAYS; i++)
+	{
+		ap_uint<16> id = 5 + i * CTX_CACHE_SETS;
+		result = context_cache<0>(CTX_PREFETCH, id, false);
+		if (result.hit || !result.fetch || result.evict || result.slot == slot)
+		{
+			std::cerr << "Prefetch " << std::dec << id << ": slot " << result.slot << " evict " << result.evict << std::endl;
+			errCount++;
+		}
+		context_cache<0>(CTX_FILL, 0, false);
+	}
+	// The set is full, the round robin victim is the dirty line of session 5 which is written back
+	result = context_cache<0>(CTX_ACCESS, 5 + CTX_CACHE_WAYS * CTX_CACHE_SETS, false);
+	contextCacheMemCmd(result, 5 + CTX_CACHE_WAYS * CTX_CACHE_SETS, 64, readCmd, writeCmd);
+	if (result.hit || !result.evict || result.evictID != 5 || result.slot != slot)
+	{
+		std::cerr << "Eviction: evict " << result.evict << " evictID " << std::dec << result.evictID << " slot " << result.slot << std::endl;
+		errCount++;
+	}
+	if (writeCmd.empty() || readCmd.empty())
+	{
+		std::cerr << "Eviction did not issue both commands" << std::endl;
+		errCount++;
+	}
+	else
+	{
+		writeCmd.read(cmd);
+		if (cmd.saddr != (5 << CTX_LINE_BITS))
+		{
+			std::cerr << "Write back address: " << std::hex << cmd.saddr << std::endl;
+			errCount++;
+		}
+		readCmd.read(cmd);
+	}
+	context_cache<0>(CTX_FILL, 0, false);
+	// Session 5 is not fetched again before its write back landed, other sessions are
+	result = context_cache<0>(CTX_ACCESS, 5, false);
+	if (result.hit || result.fetch)
+	{
+		std::cerr << "Fetch during write back: hit " << result.hit << " fetch " << result.fetch << std::endl;
+		errCount++;
+	}
+	result = context_cache<0>(CTX_PREFETCH, 5, false);
+	if (result.fetch)
+	{
+		std::cerr << "Prefetch during write back was not dropped" << std::endl;
+		errCount++;
+	}
+	// Clean lines are dropped without write back
+	result = context_cache<0>(CTX_ACCESS, 5 + (CTX_CACHE_WAYS+1) * CTX_CACHE_SETS, false);
+	if (result.hit || result.evict || !result.fetch)
+	{
+		std::cerr << "Clean eviction: evict " << result.evict << std::endl;
+		errCount++;
+	}
+	context_cache<0>(CTX_FILL, 0, false);
+	// Once the write status returned session 5 is fetched
+	context_cache<0>(CTX_WRITE_DONE, 0, false);
+	result = context_cache<0>(CTX_ACCESS, 5, false);
+	if (result.hit || !result.fetch)
+	{
+		std::cerr << "Evicted session: hit " << result.hit << " fetch " << result.fetch << std::endl;
+		errCount++;
+	}
+	context_cache<0>(CTX_FILL, 0, false);
+
+	// Dirty evictions stop once CTX_WRITEBACK_SLOTS write backs are outstanding
+	for (int i = 0; i < CTX_CACHE_WAYS; i++)
+	{
+		ap_uint<16> id = 7 + i * CTX_CACHE_SETS;
+		result = context_cache<0>(CTX_ACCESS, id, false);
+		context_cache<0>(CTX_FILL, 0, false);
+		context_cache<0>(CTX_ACCESS, id, true);
+	}
+	int writeBacks = 0;
+	for (int i = 0; i <= CTX_WRITEBACK_SLOTS; i++)
+	{
+		ap_uint<16> id = 7 + (i + CTX_CACHE_WAYS) * CTX_CACHE_SETS;
+		result = context_cache<0>(CTX_ACCESS, id, false);
+		if (result.fetch)
+		{
+			writeBacks += result.evict;
+			context_cache<0>(CTX_FILL, 0, false);
+			context_cache<0>(CTX_ACCESS, id, true);
+		}
+	}
+	if (writeBacks != CTX_WRITEBACK_SLOTS)
+	{
+		std::cerr << "Outstanding write backs: " << std::dec << writeBacks << std::endl;
+		errCount++;
+	}
+	context_cache<0>(CTX_WRITE_DONE, 0, false);
+	result = context_cache<0>(CTX_ACCESS, 7 + (2*CTX_CACHE_WAYS + 1) * CTX_CACHE_SETS, false);
+	if (!result.fetch || !result.evict)
+	{
+		std::cerr << "Eviction after write status: fetch " << result.fetch << " evict " << result.evict << std::endl;
+		errCount++;
+	}
+
+	std::cerr << "Errors: " << std::dec << errCount << std::endl;
+	return errCount != 0;
+}
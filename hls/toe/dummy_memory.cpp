@@ -38,8 +38,8 @@ EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.// Copyright (c) 2015 Xilinx,
 void dummyMemory::setReadCmd(mmCmd cmd)
 {
 //	readAddr = cmd.saddr(7, 0);
-	readAddr = cmd.saddr(15, 0);
-	readId = cmd.saddr(31, 16);
+	readAddr = cmd.saddr(WINDOW_BITS-1, 0);
+	readId = cmd.saddr(31, WINDOW_BITS);
 	uint16_t tempLen = (uint16_t) cmd.bbt(15, 0);
 	readLen = (int) tempLen;
 	//std::cout << readLen << std::endl;
@@ -48,8 +48,8 @@ void dummyMemory::setReadCmd(mmCmd cmd)
 void dummyMemory::setWriteCmd(mmCmd cmd)
 {
 //	writeAddr = cmd.saddr(7, 0);
-	writeAddr = cmd.saddr(15, 0);
-	writeId = cmd.saddr(31, 16);
+	writeAddr = cmd.saddr(WINDOW_BITS-1, 0);
+	writeId = cmd.saddr(31, WINDOW_BITS);
 }
 
 
@@ -107,7 +107,7 @@ void dummyMemory::writeWord(axiWord& word)
 
 std::map<ap_uint<16>, ap_uint<8>*>::iterator dummyMemory::createBuffer(ap_uint<16> id)
 {
-	ap_uint<8>* array = new ap_uint<8>[65536]; // [255] default
+	ap_uint<8>* array = new ap_uint<8>[BUFFER_SIZE]; // [255] default
 	std::pair<std::map<ap_uint<16>, ap_uint<8>*>::iterator, bool> ret;
 	ret = storage.insert(std::make_pair(id, array));
 	if (ret.second)
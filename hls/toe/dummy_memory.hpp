@@ -42,10 +42,10 @@ private:
 	std::map<ap_uint<16>, ap_uint<8>*>::iterator createBuffer(ap_uint<16> id);
 	void shuffleWord(ap_uint<64>& );
 	bool* getBitMask(ap_uint<4> keep);
-	ap_uint<16> readAddr; //<8>
+	ap_uint<WINDOW_BITS> readAddr; //<8>
 	ap_uint<16> readId;
 	int readLen;
-	ap_uint<16> writeAddr; //<8>
+	ap_uint<WINDOW_BITS> writeAddr; //<8>
 	ap_uint<16> writeId;
 	//ap_uint<16> writeLen;
 	std::map<ap_uint<16>, ap_uint<8>*> storage;
@@ -30,6 +30,137 @@ EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.// Copyright (c) 2015 Xilinx,
 
 using namespace hls;
 
+/** @ingroup event_engine
+ *  Deficit round robin over the sessions with pending application events. The events are kept in per-session
+ *  queues, linked through a shared pool of TX_SCHED_SLOTS slots. Each turn of a session may release TX events
+ *  worth its deficit, every round adds TX_SCHED_QUANTUM bytes. Other events of the application, SYN and FIN, keep
+ *  their place in the queue of the session and cost nothing.
+ *  A session that becomes active joins the TX_SCHED_NEW class with one quantum and is served before the
+ *  TX_SCHED_OLD class, a short request goes out right away next to bulk transfers. Once its quantum is used
+ *  up the session continues in the TX_SCHED_OLD class.
+ *  Each call either enqueues an event or takes one step of the round robin.
+ *  @param[in]		txApp2txSched_event
+ *  @param[out]		txSched2eventEng_event
+ */
+void txEventScheduler(	stream<event>&		txApp2txSched_event,
+						stream<event>&		txSched2eventEng_event)
+{
+#pragma HLS INLINE off
+#pragma HLS PIPELINE II=1
+
+	static txSchedSession ts_sessionTable[MAX_SESSIONS];
+	SESSION_TABLE_RESOURCE(ts_sessionTable, RAM_2P_BRAM)
+	#pragma HLS DATA_PACK variable=ts_sessionTable
+	#pragma HLS DEPENDENCE variable=ts_sessionTable inter false
+	static event ts_slots[TX_SCHED_SLOTS];
+	#pragma HLS RESOURCE variable=ts_slots core=RAM_2P_BRAM
+	#pragma HLS DATA_PACK variable=ts_slots
+	#pragma HLS DEPENDENCE variable=ts_slots inter false
+	static ap_uint<8> ts_next[TX_SCHED_SLOTS];
+	#pragma HLS RESOURCE variable=ts_next core=RAM_T2P_BRAM
+	#pragma HLS DEPENDENCE variable=ts_next inter false
+	// Ring of the free slots and one ring of active sessions per class
+	static ap_uint<8> ts_freeRing[TX_SCHED_SLOTS];
+	#pragma HLS RESOURCE variable=ts_freeRing core=RAM_2P_BRAM
+	#pragma HLS DEPENDENCE variable=ts_freeRing inter false
+	static ap_uint<16> ts_activeRing[2][TX_SCHED_SLOTS];
+	#pragma HLS ARRAY_PARTITION variable=ts_activeRing complete dim=1
+	#pragma HLS RESOURCE variable=ts_activeRing core=RAM_2P_BRAM
+	#pragma HLS DEPENDENCE variable=ts_activeRing inter false
+
+	static ap_uint<8>	ts_freeHead = 0;
+	static ap_uint<8>	ts_freeTail = 0;
+	static ap_uint<9>	ts_freeCount = 0;
+	// Slots that were never used, they are handed out before the free ring
+	static ap_uint<9>	ts_freshSlots = 0;
+	static ap_uint<8>	ts_activeHead[2] = {0, 0};
+	static ap_uint<8>	ts_activeTail[2] = {0, 0};
+	static ap_uint<9>	ts_activeCount[2] = {0, 0};
+	#pragma HLS ARRAY_PARTITION variable=ts_activeHead complete
+	#pragma HLS ARRAY_PARTITION variable=ts_activeTail complete
+	#pragma HLS ARRAY_PARTITION variable=ts_activeCount complete
+
+	event			ev;
+	txSchedSession	session;
+	ap_uint<16>		sessionID;
+	ap_uint<8>		slot;
+	ap_uint<1>		cls;
+	ap_uint<16>		cost;
+
+	if (!txApp2txSched_event.empty() && (ts_freeCount != 0 || ts_freshSlots != TX_SCHED_SLOTS))
+	{
+		txApp2txSched_event.read(ev);
+		if (ts_freeCount != 0)
+		{
+			slot = ts_freeRing[ts_freeHead];
+			ts_freeHead++;
+			ts_freeCount--;
+		}
+		else
+		{
+			slot = ts_freshSlots;
+			ts_freshSlots++;
+		}
+		ts_slots[slot] = ev;
+		session = ts_sessionTable[ev.sessionID];
+		if (session.queued)
+		{
+			ts_next[session.tail] = slot;
+			session.tail = slot;
+		}
+		else
+		{
+			session.head = slot;
+			session.tail = slot;
+			session.deficit = TX_SCHED_QUANTUM;
+			session.queued = true;
+			ts_activeRing[TX_SCHED_NEW][ts_activeTail[TX_SCHED_NEW]] = ev.sessionID;
+			ts_activeTail[TX_SCHED_NEW]++;
+			ts_activeCount[TX_SCHED_NEW]++;
+		}
+		ts_sessionTable[ev.sessionID] = session;
+	}
+	else if ((ts_activeCount[TX_SCHED_NEW] != 0 || ts_activeCount[TX_SCHED_OLD] != 0) && !txSched2eventEng_event.full())
+	{
+		cls = (ts_activeCount[TX_SCHED_NEW] != 0) ? TX_SCHED_NEW : TX_SCHED_OLD;
+		sessionID = ts_activeRing[cls][ts_activeHead[cls]];
+		session = ts_sessionTable[sessionID];
+		slot = session.head;
+		ev = ts_slots[slot];
+		cost = (ev.type == TX) ? ev.length : (ap_uint<16>) 0;
+		if (session.deficit >= cost)
+		{
+			txSched2eventEng_event.write(ev);
+			session.deficit -= cost;
+			ts_freeRing[ts_freeTail] = slot;
+			ts_freeTail++;
+			ts_freeCount++;
+			if (slot == session.tail)
+			{
+				// The queue ran empty, the session leaves the round robin and loses its deficit
+				session.queued = false;
+				ts_activeHead[cls]++;
+				ts_activeCount[cls]--;
+			}
+			else
+			{
+				session.head = ts_next[slot];
+			}
+		}
+		else
+		{
+			// End of the turn, the session continues in the next round
+			session.deficit += TX_SCHED_QUANTUM;
+			ts_activeHead[cls]++;
+			ts_activeCount[cls]--;
+			ts_activeRing[TX_SCHED_OLD][ts_activeTail[TX_SCHED_OLD]] = sessionID;
+			ts_activeTail[TX_SCHED_OLD]++;
+			ts_activeCount[TX_SCHED_OLD]++;
+		}
+		ts_sessionTable[sessionID] = session;
+	}
+}
+
 /** @ingroup event_engine
  *  Arbitrates between the different event source FIFOs and forwards the event to the \ref tx_engine
  *  @param[in]		txApp2eventEng_setEvent
@@ -37,13 +168,14 @@ using namespace hls;
  *  @param[in]		timer2eventEng_setEvent
  *  @param[out]		eventEng2txEng_event
  */
-void event_engine(	stream<event>&				txApp2eventEng_setEvent,
+void eventArbiter(	stream<event>&				txApp2eventEng_setEvent,
 					stream<extendedEvent>&		rxEng2eventEng_setEvent,
 					stream<event>&				timer2eventEng_setEvent,
 					stream<extendedEvent>&		eventEng2txEng_event,
 					stream<ap_uint<1> >&		ackDelayFifoReadCount,
 					stream<ap_uint<1> >&		ackDelayFifoWriteCount,
 					stream<ap_uint<1> >&		txEngFifoReadCount) {
+#pragma HLS INLINE off
 #pragma HLS PIPELINE II=1
 
 	static ap_uint<1> eventEnginePriority = 0;
@@ -114,3 +246,39 @@ void event_engine(	stream<event>&				txApp2eventEng_setEvent,
 		txEngFifoReadCount.read();
 	}
 }
+
+/** @ingroup event_engine
+ *  Connects the @ref txEventScheduler to the @ref eventArbiter, without TCP_TX_SCHEDULER the events of the
+ *  application are arbitrated in arrival order.
+ *  @param[in]		txApp2eventEng_setEvent
+ *  @param[in]		rxEng2eventEng_setEvent
+ *  @param[in]		timer2eventEng_setEvent
+ *  @param[out]		eventEng2txEng_event
+ */
+void event_engine(	stream<event>&				txApp2eventEng_setEvent,
+					stream<extendedEvent>&		rxEng2eventEng_setEvent,
+					stream<event>&				timer2eventEng_setEvent,
+					stream<extendedEvent>&		eventEng2txEng_event,
+					stream<ap_uint<1> >&		ackDelayFifoReadCount,
+					stream<ap_uint<1> >&		ackDelayFifoWriteCount,
+					stream<ap_uint<1> >&		txEngFifoReadCount)
+{
+#pragma HLS INLINE
+
+#if (TCP_TX_SCHEDULER)
+	static stream<event>		txSched2eventEng_event("txSched2eventEng_event");
+	#pragma HLS stream variable=txSched2eventEng_event	depth=2
+	#pragma HLS DATA_PACK variable=txSched2eventEng_event
+
+	txEventScheduler(txApp2eventEng_setEvent, txSched2eventEng_event);
+	eventArbiter(	txSched2eventEng_event,
+#else
+	eventArbiter(	txApp2eventEng_setEvent,
+#endif
+					rxEng2eventEng_setEvent,
+					timer2eventEng_setEvent,
+					eventEng2txEng_event,
+					ackDelayFifoReadCount,
+					ackDelayFifoWriteCount,
+					txEngFifoReadCount);
+}
@@ -30,6 +30,29 @@ EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.// Copyright (c) 2015 Xilinx,
 
 using namespace hls;
 
+/** @ingroup event_engine
+ *  Number of application events the TX scheduler buffers, TX_SCHED_SLOTS bounds the active sessions as well.
+ *  Every round a session may send TX_SCHED_QUANTUM bytes
+ */
+static const uint16_t TX_SCHED_SLOTS = 256;
+static const ap_uint<16> TX_SCHED_QUANTUM = MSS;
+
+/** @ingroup event_engine
+ *  Classes of the active sessions, a session that just became active is served before the others for one quantum
+ */
+enum txSchedClass {TX_SCHED_NEW, TX_SCHED_OLD};
+
+/** @ingroup event_engine
+ *  Queue of a session in the TX scheduler, the events are linked through their slots
+ */
+struct txSchedSession
+{
+	ap_uint<8>	head;
+	ap_uint<8>	tail;
+	ap_uint<17>	deficit;
+	bool		queued;
+};
+
 /** @defgroup event_engine Event Engine
  *  @ingroup tcp_module
  */
@@ -28,42 +28,121 @@ EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.// Copyright (c) 2015 Xilinx,
 ************************************************/
 #include "event_engine.hpp"
 #include <iostream>
+#include <vector>
 
 using namespace hls;
 
-int main()
-{
-	stream<event>				txApp2eventEng_setEvent;
-	stream<extendedEvent>		rxEng2eventEng_setEvent;
-	stream<event>				timer2eventEng_setEvent;
-	stream<extendedEvent>		eventEng2txEng_event;
+stream<event>				txApp2eventEng_setEvent;
+stream<extendedEvent>		rxEng2eventEng_setEvent;
+stream<event>				timer2eventEng_setEvent;
+stream<extendedEvent>		eventEng2txEng_event;
+stream<ap_uint<1> >			ackDelayFifoReadCount;
+stream<ap_uint<1> >			ackDelayFifoWriteCount;
+stream<ap_uint<1> >			txEngFifoReadCount;
+
+std::vector<extendedEvent> outEvents;
 
+void runEngine(int cycles)
+{
 	extendedEvent ev;
-	int count=0;
-	while (count < 50)
+	for (int i = 0; i < cycles; i++)
 	{
 		event_engine(	txApp2eventEng_setEvent,
 						rxEng2eventEng_setEvent,
 						timer2eventEng_setEvent,
-						eventEng2txEng_event);
+						eventEng2txEng_event,
+						ackDelayFifoReadCount,
+						ackDelayFifoWriteCount,
+						txEngFifoReadCount);
+		// The ack_delay and the tx_engine consume every event right away
+		if (!eventEng2txEng_event.empty())
+		{
+			eventEng2txEng_event.read(ev);
+			outEvents.push_back(ev);
+			ackDelayFifoReadCount.write(1);
+			ackDelayFifoWriteCount.write(1);
+			txEngFifoReadCount.write(1);
+		}
+	}
+}
 
-		if (count == 20)
+int main()
+{
+	fourTuple tuple(0x0101010a, 0x0101010b, 12, 80);
+	int errCount = 0;
+
+	// RX events go first, then the timers, then the application
+	txApp2eventEng_setEvent.write(event(TX, 23, 0, 100));
+	rxEng2eventEng_setEvent.write(extendedEvent(rstEvent(0x82934790), tuple));
+	timer2eventEng_setEvent.write(event(RT, 22));
+	runEngine(50);
+	if (outEvents.size() != 3 || outEvents[0].type != RST || outEvents[1].type != RT || outEvents[2].type != TX)
+	{
+		std::cout << "Priority, events: " << outEvents.size() << std::endl;
+		errCount++;
+	}
+
+#if (TCP_TX_SCHEDULER)
+	// A bulk session does not hold back a short request that arrives after it
+	outEvents.clear();
+	for (int i = 0; i < 40; i++)
+	{
+		txApp2eventEng_setEvent.write(event(TX, 1, i*MSS, MSS));
+	}
+	runEngine(45);
+	txApp2eventEng_setEvent.write(event(TX, 2, 0, 64));
+	txApp2eventEng_setEvent.write(event(FIN, 2));
+	runEngine(400);
+	int rpcPosition = -1;
+	int finPosition = -1;
+	int bulkCount = 0;
+	for (int i = 0; i < outEvents.size(); i++)
+	{
+		if (outEvents[i].sessionID == 2 && outEvents[i].type == TX)
 		{
-			fourTuple tuple;
-			tuple.srcIp = 0x0101010a;
-			tuple.srcPort = 12;
-			tuple.dstIp = 0x0101010b;
-			tuple.dstPort = 788789;
-			txApp2eventEng_setEvent.write(event(TX, 23));
-			rxEng2eventEng_setEvent.write(extendedEvent(rstEvent(0x8293479023), tuple));
-			timer2eventEng_setEvent.write(event(RT, 22));
+			rpcPosition = i;
 		}
-		if (!eventEng2txEng_event.empty())
+		else if (outEvents[i].sessionID == 2 && outEvents[i].type == FIN)
 		{
-			eventEng2txEng_event.read(ev);
-			std::cout << ev.type << std::endl;
+			finPosition = i;
+		}
+		else if (outEvents[i].sessionID == 1)
+		{
+			bulkCount++;
+		}
+	}
+	if (bulkCount != 40 || rpcPosition < 0 || rpcPosition > 10 || finPosition != rpcPosition+1)
+	{
+		std::cout << "Scheduler, bulk: " << bulkCount << " request at: " << rpcPosition << " FIN at: " << finPosition << std::endl;
+		errCount++;
+	}
+
+	// Two bulk sessions alternate segment by segment
+	outEvents.clear();
+	for (int i = 0; i < 8; i++)
+	{
+		txApp2eventEng_setEvent.write(event(TX, 3, i*MSS, MSS));
+	}
+	for (int i = 0; i < 8; i++)
+	{
+		txApp2eventEng_setEvent.write(event(TX, 4, i*MSS, MSS));
+	}
+	runEngine(200);
+	int switches = 0;
+	for (int i = 1; i < outEvents.size(); i++)
+	{
+		if (outEvents[i].sessionID != outEvents[i-1].sessionID)
+		{
+			switches++;
 		}
-		count++;
 	}
-	return 0;
+	if (outEvents.size() != 16 || switches < 12)
+	{
+		std::cout << "Round robin, events: " << outEvents.size() << " switches: " << switches << std::endl;
+		errCount++;
+	}
+#endif
+
+	std::cout << "Errors: " << errCount << std::endl;
+	return errCount;
 }
@@ -0,0 +1,160 @@
+/************************************************
+Copyright (c) 2016, Xilinx, Inc.
+All rights reserved.
+
+Redistribution and use in source and binary forms, with or without modification, 
+are permitted provided that the following conditions are met:
+
+1. Redistributions of source code must retain the above copyright notice, 
+this list of conditions and the following disclaimer.
+
+2. Redistributions in binary form must reproduce the above copyright notice, 
+this list of conditions and the following disclaimer in the documentation 
+and/or other materials provided with the distribution.
+
+3. Neither the name of the copyright holder nor the names of its contributors 
+may be used to endorse or promote products derived from this software 
+without specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND 
+ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, 
+THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED. 
+IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, 
+INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, 
+PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) 
+HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, 
+OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, 
+EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.// Copyright (c) 2015 Xilinx, Inc.
+************************************************/
+
+#include "keepalive_timer.hpp"
+
+using namespace hls;
+
+/** @ingroup keepalive_timer
+ *  Every segment the @ref rx_engine receives on a synchronized session restarts its timer with TCP_KEEPALIVE_IDLE.
+ *  When the timer expires a KEEP_ALIVE Event is fired to the @ref tx_engine and the timer is re-armed with
+ *  TCP_KEEPALIVE_INTERVAL. If the timer expires again after TCP_KEEPALIVE_PROBES unanswered probes the session is released
+ *  and the application is notified, as on a time-out of the @ref retransmit_timer.
+ *  The releases of the @ref retransmit_timer pass through here, they stop the timer of the session.
+ *	@param[in]		rxEng2timer_setKeepAlive
+ *	@param[in]		rtTimer2stateTable_releaseState
+ *	@param[in]		wheel2keepAlive_expired
+ *	@param[out]		keepAlive2wheel_op
+ *	@param[out]		keepAlive2eventEng_setEvent
+ *	@param[out]		keepAlive2rxApp_notification
+ *	@param[out]		timer2stateTable_releaseState
+ */
+void keepAliveControl(	stream<keepAliveUpdate>&	rxEng2timer_setKeepAlive,
+						stream<ap_uint<16> >&		rtTimer2stateTable_releaseState,
+						stream<timerWheelExpiry>&	wheel2keepAlive_expired,
+						stream<timerWheelOp>&		keepAlive2wheel_op,
+						stream<event>&				keepAlive2eventEng_setEvent,
+						stream<appNotification>&	keepAlive2rxApp_notification,
+						stream<ap_uint<16> >&		timer2stateTable_releaseState)
+{
+#pragma HLS INLINE off
+#pragma HLS PIPELINE II=1
+
+	static keepalive_timer_entry keepAliveTable[MAX_SESSIONS];
+	SESSION_TABLE_RESOURCE(keepAliveTable, RAM_T2P_BRAM)
+	#pragma HLS DATA_PACK variable=keepAliveTable
+	#pragma HLS DEPENDENCE variable=keepAliveTable inter false
+
+	ap_uint<16>				sessionID;
+	keepAliveUpdate			update;
+	keepalive_timer_entry	currEntry;
+	timerWheelExpiry		expired;
+
+	if (!rtTimer2stateTable_releaseState.empty() && !keepAlive2wheel_op.full() && !timer2stateTable_releaseState.full())
+	{
+		rtTimer2stateTable_releaseState.read(sessionID);
+		currEntry = keepAliveTable[sessionID];
+		if (currEntry.active)
+		{
+			keepAlive2wheel_op.write(timerWheelOp(sessionID));
+		}
+		currEntry.active = false;
+		keepAliveTable[sessionID] = currEntry;
+		timer2stateTable_releaseState.write(sessionID);
+	}
+	else if (!rxEng2timer_setKeepAlive.empty() && !keepAlive2wheel_op.full())
+	{
+		rxEng2timer_setKeepAlive.read(update);
+		currEntry = keepAliveTable[update.sessionID];
+		if (!update.stop)
+		{
+			currEntry.tag++;
+			currEntry.probes = 0;
+			currEntry.active = true;
+			keepAlive2wheel_op.write(timerWheelOp(update.sessionID, TCP_KEEPALIVE_IDLE, currEntry.tag));
+		}
+		else if (currEntry.active)
+		{
+			keepAlive2wheel_op.write(timerWheelOp(update.sessionID));
+			currEntry.active = false;
+		}
+		keepAliveTable[update.sessionID] = currEntry;
+	}
+	else if (!wheel2keepAlive_expired.empty() && !keepAlive2wheel_op.full()
+				&& !keepAlive2eventEng_setEvent.full() && !keepAlive2rxApp_notification.full() && !timer2stateTable_releaseState.full())
+	{
+		wheel2keepAlive_expired.read(expired);
+		sessionID = expired.sessionID;
+		currEntry = keepAliveTable[sessionID];
+		// Expirations of a timer that was restarted or stopped in the meantime are discarded
+		if (currEntry.active && currEntry.tag == expired.tag)
+		{
+			if (currEntry.probes == TCP_KEEPALIVE_PROBES)
+			{
+				currEntry.active = false;
+				timer2stateTable_releaseState.write(sessionID);
+				keepAlive2rxApp_notification.write(appNotification(sessionID, true)); //TIME_OUT
+			}
+			else
+			{
+				currEntry.probes++;
+				keepAlive2wheel_op.write(timerWheelOp(sessionID, TCP_KEEPALIVE_INTERVAL, currEntry.tag));
+				keepAlive2eventEng_setEvent.write(event(KEEP_ALIVE, sessionID));
+			}
+			keepAliveTable[sessionID] = currEntry;
+		}
+	}
+}
+
+/** @ingroup keepalive_timer
+ *  Connects the @ref keepAliveControl to its @ref timing_wheel.
+ *	@param[in]		rxEng2timer_setKeepAlive
+ *	@param[in]		rtTimer2stateTable_releaseState
+ *	@param[out]		keepAlive2eventEng_setEvent
+ *	@param[out]		keepAlive2rxApp_notification
+ *	@param[out]		timer2stateTable_releaseState
+ */
+void keepalive_timer(	stream<keepAliveUpdate>&		rxEng2timer_setKeepAlive,
+						stream<ap_uint<16> >&			rtTimer2stateTable_releaseState,
+						stream<event>&					keepAlive2eventEng_setEvent,
+						stream<appNotification>&		keepAlive2rxApp_notification,
+						stream<ap_uint<16> >&			timer2stateTable_releaseState)
+{
+#pragma HLS INLINE
+
+#pragma HLS DATA_PACK variable=rxEng2timer_setKeepAlive
+#pragma HLS DATA_PACK variable=keepAlive2eventEng_setEvent
+#pragma HLS DATA_PACK variable=keepAlive2rxApp_notification
+
+	static stream<timerWheelOp>		keepAlive2wheel_op("keepAlive2wheel_op");
+	static stream<timerWheelExpiry>	wheel2keepAlive_expired("wheel2keepAlive_expired");
+	#pragma HLS stream variable=keepAlive2wheel_op		depth=4
+	#pragma HLS stream variable=wheel2keepAlive_expired	depth=4
+	#pragma HLS DATA_PACK variable=keepAlive2wheel_op
+	#pragma HLS DATA_PACK variable=wheel2keepAlive_expired
+
+	keepAliveControl(	rxEng2timer_setKeepAlive,
+						rtTimer2stateTable_releaseState,
+						wheel2keepAlive_expired,
+						keepAlive2wheel_op,
+						keepAlive2eventEng_setEvent,
+						keepAlive2rxApp_notification,
+						timer2stateTable_releaseState);
+	timing_wheel<2>(keepAlive2wheel_op, wheel2keepAlive_expired);
+}
@@ -27,16 +27,25 @@ OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF
 EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.// Copyright (c) 2015 Xilinx, Inc.
 ************************************************/
 #include "../toe.hpp"
+#include "../timing_wheel/timing_wheel.hpp"
 
 using namespace hls;
 
-/** @defgroup rx_sar_table RX SAR Table
- *  @ingroup tcp_module
- *  @TODO rename why SAR
+/** @ingroup keepalive_timer
+ *
  */
-void rx_sar_table(	stream<rxSarRecvd>&			rxEng2rxSar_upd_req,
-					stream<rxSarAppd>&			rxApp2rxSar_upd_req,
-					stream<ap_uint<16> >&		txEng2rxSar_req, //read only
-					stream<rxSarEntry>&			rxSar2rxEng_upd_rsp,
-					stream<rxSarAppd>&			rxSar2rxApp_upd_rsp,
-					stream<rxSarEntry>&			rxSar2txEng_rsp);
+struct keepalive_timer_entry
+{
+	ap_uint<8>		tag;
+	ap_uint<4>		probes;		// Probes sent since the last segment was received
+	bool			active;
+};
+
+/** @defgroup keepalive_timer Keep-Alive Timer
+ *
+ */
+void keepalive_timer(	stream<keepAliveUpdate>&		rxEng2timer_setKeepAlive,
+						stream<ap_uint<16> >&			rtTimer2stateTable_releaseState,
+						stream<event>&					keepAlive2eventEng_setEvent,
+						stream<appNotification>&		keepAlive2rxApp_notification,
+						stream<ap_uint<16> >&			timer2stateTable_releaseState);
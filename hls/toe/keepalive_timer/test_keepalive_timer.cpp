@@ -0,0 +1,136 @@
+/************************************************
+Copyright (c) 2016, Xilinx, Inc.
+All rights reserved.
+
+Redistribution and use in source and binary forms, with or without modification, 
+are permitted provided that the following conditions are met:
+
+1. Redistributions of source code must retain the above copyright notice, 
+this list of conditions and the following disclaimer.
+
+2. Redistributions in binary form must reproduce the above copyright notice, 
+this list of conditions and the following disclaimer in the documentation 
+and/or other materials provided with the distribution.
+
+3. Neither the name of the copyright holder nor the names of its contributors 
+may be used to endorse or promote products derived from this software 
+without specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND 
+ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, 
+THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED. 
+IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, 
+INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, 
+PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) 
+HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, 
+OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, 
+EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.// Copyright (c) 2015 Xilinx, Inc.
+************************************************/
+#include "keepalive_timer.hpp"
+#include <iostream>
+
+using namespace hls;
+
+stream<keepAliveUpdate>	updateFifo;
+stream<ap_uint<16> >	rtReleaseFifo;
+stream<event>			eventFifo;
+stream<appNotification>	notificationFifo;
+stream<ap_uint<16> >	releaseFifo;
+
+int probeCount = 0;
+int releaseCount = 0;
+int notificationCount = 0;
+
+void runTimer(uint32_t ticks)
+{
+	event ev;
+	ap_uint<16> sessionID;
+	appNotification notification;
+	for (uint32_t i = 0; i < TIMER_TICK_CYCLES*ticks; i++)
+	{
+		keepalive_timer(updateFifo, rtReleaseFifo, eventFifo, notificationFifo, releaseFifo);
+		if (!eventFifo.empty())
+		{
+			eventFifo.read(ev);
+			if (ev.type == KEEP_ALIVE && ev.sessionID == 7)
+			{
+				probeCount++;
+			}
+		}
+		if (!releaseFifo.empty())
+		{
+			releaseFifo.read(sessionID);
+			releaseCount++;
+		}
+		if (!notificationFifo.empty())
+		{
+			notificationFifo.read(notification);
+			if (notification.sessionID == 7 && notification.closed)
+			{
+				notificationCount++;
+			}
+		}
+	}
+}
+
+int main()
+{
+	int errCount = 0;
+
+	// Nothing fires before the idle time
+	updateFifo.write(keepAliveUpdate(7));
+	runTimer(TCP_KEEPALIVE_IDLE-2);
+	if (probeCount != 0)
+	{
+		std::cout << "Probe before the idle time" << std::endl;
+		errCount++;
+	}
+
+	// A received segment restarts the idle time
+	updateFifo.write(keepAliveUpdate(7));
+	runTimer(TCP_KEEPALIVE_IDLE-2);
+	if (probeCount != 0)
+	{
+		std::cout << "Probe although the session was active" << std::endl;
+		errCount++;
+	}
+
+	// Probes every interval, the session is released after the last one went unanswered and the application is told
+	runTimer(2 + TCP_KEEPALIVE_PROBES*TCP_KEEPALIVE_INTERVAL + 2);
+	if (probeCount != TCP_KEEPALIVE_PROBES || releaseCount != 1 || notificationCount != 1)
+	{
+		std::cout << "Probes: " << probeCount << " releases: " << releaseCount << " notifications: " << notificationCount << std::endl;
+		errCount++;
+	}
+
+	// An answered probe restarts the idle time
+	probeCount = 0;
+	releaseCount = 0;
+	updateFifo.write(keepAliveUpdate(7));
+	runTimer(TCP_KEEPALIVE_IDLE + 1);
+	updateFifo.write(keepAliveUpdate(7));
+	runTimer(TCP_KEEPALIVE_IDLE + 1);
+	if (probeCount != 2 || releaseCount != 0)
+	{
+		std::cout << "Answered probes: " << probeCount << " releases: " << releaseCount << std::endl;
+		errCount++;
+	}
+
+	// A closed session and a release of the retransmit timer stop the timer, the release is passed on
+	// without a notification, the retransmit timer sends its own
+	probeCount = 0;
+	notificationCount = 0;
+	updateFifo.write(keepAliveUpdate(7, true));
+	updateFifo.write(keepAliveUpdate(9));
+	runTimer(1);
+	rtReleaseFifo.write(9);
+	runTimer(TCP_KEEPALIVE_IDLE + TCP_KEEPALIVE_PROBES*TCP_KEEPALIVE_INTERVAL + 4);
+	if (probeCount != 0 || releaseCount != 1 || notificationCount != 0 || !notificationFifo.empty())
+	{
+		std::cout << "Stopped timer, probes: " << probeCount << " releases: " << releaseCount << " notifications: " << notificationCount << std::endl;
+		errCount++;
+	}
+
+	std::cout << "Errors: " << errCount << std::endl;
+	return errCount;
+}
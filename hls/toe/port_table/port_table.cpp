@@ -37,6 +37,8 @@ using namespace hls;
  *  txApp: read -> write
  *  If read and write operation on same address occur at the same time,
  *  read should get the old value, either way it doesn't matter
+ *  Bit 15 of a listen request selects TCP_BUFFER_CLASS_SMALL for the sessions accepted on the port,
+ *  otherwise they get TCP_BUFFER_CLASS_ACCEPT. The class is returned with each check.
  *  @param[in]		rxApp2portTable_listen_req
  *  @param[in]		pt_portCheckListening_req_fifo
  *  @param[out]		portTable2rxApp_listen_rsp
@@ -45,7 +47,7 @@ using namespace hls;
 void listening_port_table(	stream<ap_uint<16> >&	rxApp2portTable_listen_req,
 							stream<ap_uint<15> >&	pt_portCheckListening_req_fifo,
 							stream<bool>&			portTable2rxApp_listen_rsp,
-							stream<bool>&			pt_portCheckListening_rsp_fifo)
+							stream<portCheckReply>&	pt_portCheckListening_rsp_fifo)
 {
 #pragma HLS PIPELINE II=1
 #pragma HLS INLINE off
@@ -53,15 +55,20 @@ void listening_port_table(	stream<ap_uint<16> >&	rxApp2portTable_listen_req,
 	static bool listeningPortTable[32768];
 	#pragma HLS RESOURCE variable=listeningPortTable core=RAM_T2P_BRAM
 	#pragma HLS DEPENDENCE variable=listeningPortTable inter false
+	static ap_uint<2> listeningClassTable[32768];
+	#pragma HLS RESOURCE variable=listeningClassTable core=RAM_T2P_BRAM
+	#pragma HLS DEPENDENCE variable=listeningClassTable inter false
 
 	ap_uint<16> currPort;
+	ap_uint<15> checkPort;
 
 	if (!rxApp2portTable_listen_req.empty()) //check range, TODO make sure currPort is not equal in 2 consecutive cycles
 	{
 		rxApp2portTable_listen_req.read(currPort);
-		if (!listeningPortTable[currPort(14, 0)] && currPort < 32768)
+		if (!listeningPortTable[currPort(14, 0)])
 		{
-			listeningPortTable[currPort] = true;
+			listeningPortTable[currPort(14, 0)] = true;
+			listeningClassTable[currPort(14, 0)] = currPort[15] ? TCP_BUFFER_CLASS_SMALL : TCP_BUFFER_CLASS_ACCEPT;
 			portTable2rxApp_listen_rsp.write(true);
 		}
 		else
@@ -71,9 +78,8 @@ void listening_port_table(	stream<ap_uint<16> >&	rxApp2portTable_listen_req,
 	}
 	else if (!pt_portCheckListening_req_fifo.empty())
 	{
-		//pt_portCheckListening_req_fifo.read(checkPort15);
-		//pt_portCheckListening_rsp_fifo.write(listeningPortTable[checkPort15]);
-		pt_portCheckListening_rsp_fifo.write(listeningPortTable[pt_portCheckListening_req_fifo.read()]);
+		pt_portCheckListening_req_fifo.read(checkPort);
+		pt_portCheckListening_rsp_fifo.write(portCheckReply(listeningPortTable[checkPort], listeningClassTable[checkPort]));
 	}
 }
 /** @ingroup port_table
@@ -90,7 +96,7 @@ void listening_port_table(	stream<ap_uint<16> >&	rxApp2portTable_listen_req,
 void free_port_table(	stream<ap_uint<16> >&	sLookup2portTable_releasePort,
 						stream<ap_uint<15> >&	pt_portCheckUsed_req_fifo,
 						//stream<ap_uint<1> >&	txApp2portTable_port_req,
-						stream<bool>&			pt_portCheckUsed_rsp_fifo,
+						stream<portCheckReply>&	pt_portCheckUsed_rsp_fifo,
 						stream<ap_uint<16> >&	portTable2txApp_port_rsp)
 {
 #pragma HLS PIPELINE II=1
@@ -120,7 +126,7 @@ void free_port_table(	stream<ap_uint<16> >&	sLookup2portTable_releasePort,
 	}
 	else if (!pt_portCheckUsed_req_fifo.empty())
 	{
-		pt_portCheckUsed_rsp_fifo.write(freePortTable[pt_portCheckUsed_req_fifo.read()]);
+		pt_portCheckUsed_rsp_fifo.write(portCheckReply(freePortTable[pt_portCheckUsed_req_fifo.read()], TCP_BUFFER_CLASS_OPEN));
 	}
 	else
 	{
@@ -178,9 +184,9 @@ void check_in_multiplexer(	stream<ap_uint<16> >&		rxEng2portTable_check_req,
  *
  */
 void check_out_multiplexer(	stream<bool>&				pt_dstFifoIn,
-							stream<bool>&				pt_portCheckListening_rsp_fifo,
-							stream<bool>&				pt_portCheckUsed_rsp_fifo,
-							stream<bool>&				portTable2rxEng_check_rsp)
+							stream<portCheckReply>&		pt_portCheckListening_rsp_fifo,
+							stream<portCheckReply>&		pt_portCheckUsed_rsp_fifo,
+							stream<portCheckReply>&		portTable2rxEng_check_rsp)
 {
 #pragma HLS PIPELINE II=1
 #pragma HLS INLINE off
@@ -248,7 +254,7 @@ void port_table(stream<ap_uint<16> >&		rxEng2portTable_check_req,
 				stream<ap_uint<16> >&		rxApp2portTable_listen_req,
 				//stream<ap_uint<1> >&		txApp2portTable_port_req,
 				stream<ap_uint<16> >&		sLookup2portTable_releasePort,
-				stream<bool>&				portTable2rxEng_check_rsp,
+				stream<portCheckReply>&		portTable2rxEng_check_rsp,
 				stream<bool>&				portTable2rxApp_listen_rsp,
 				stream<ap_uint<16> >&		portTable2txApp_port_rsp)
 {
@@ -270,10 +276,12 @@ void port_table(stream<ap_uint<16> >&		rxEng2portTable_check_req,
 	#pragma HLS STREAM variable=pt_portCheckListening_req_fifo depth=2
 	#pragma HLS STREAM variable=pt_portCheckUsed_req_fifo depth=2
 
-	static stream<bool> pt_portCheckListening_rsp_fifo("pt_portCheckListening_rsp_fifo");
-	static stream<bool> pt_portCheckUsed_rsp_fifo("pt_portCheckUsed_rsp_fifo");
+	static stream<portCheckReply> pt_portCheckListening_rsp_fifo("pt_portCheckListening_rsp_fifo");
+	static stream<portCheckReply> pt_portCheckUsed_rsp_fifo("pt_portCheckUsed_rsp_fifo");
 	#pragma HLS STREAM variable=pt_portCheckListening_rsp_fifo depth=2
 	#pragma HLS STREAM variable=pt_portCheckUsed_rsp_fifo depth=2
+	#pragma HLS DATA_PACK variable=pt_portCheckListening_rsp_fifo
+	#pragma HLS DATA_PACK variable=pt_portCheckUsed_rsp_fifo
 
 	static stream<bool> pt_dstFifo("pt_dstFifo");
 	#pragma HLS STREAM variable=pt_dstFifo depth=4
@@ -45,7 +45,7 @@ int main()
 
 
 	stream<ap_uint<16> > rxPortTableIn("rxPortTableIn");
-	stream<bool> rxPortTableOut("rxPortTableOut");
+	stream<portCheckReply> rxPortTableOut("rxPortTableOut");
 	stream<ap_uint<16> > rxAppListenIn("rxAppListenIn");
 	stream<bool> rxAppListenOut("rxAppListenOut");
 	//stream<ap_uint<16> > rxAppCloseIn("rxAppCloseIn");
@@ -89,6 +89,9 @@ int main()
 	}*/
 
 	bool currBool = false;
+	portCheckReply checkReply;
+	int errCount = 0;
+	int checkCount = 0;
 	ap_uint<16> currPort = 0;
 	ap_uint<16> port;
 	bool isOpen = false;
@@ -132,9 +135,16 @@ int main()
 					rxPortTableOut, rxAppListenOut,txAppGetPortOut);
 		if (!rxPortTableOut.empty())
 		{
-			rxPortTableOut.read(currBool);
-			outputFile << "Port 80 is open: " << (currBool ? "yes" : "no");
+			rxPortTableOut.read(checkReply);
+			outputFile << "Port is open: " << (checkReply.open ? "yes" : "no");
 			outputFile << std::endl;
+			// Port 7 is accepted with the default class, port 8 asked for small buffers
+			if (!checkReply.open || checkReply.bufferClass != ((checkCount == 0) ? TCP_BUFFER_CLASS_ACCEPT : TCP_BUFFER_CLASS_SMALL))
+			{
+				std::cout << "ERROR: check " << checkCount << " returned " << checkReply.open << " class " << checkReply.bufferClass << std::endl;
+				errCount++;
+			}
+			checkCount++;
 		}
 		if (!rxAppListenOut.empty())
 		{
@@ -151,16 +161,27 @@ int main()
 		{
 			rxAppListenIn.write(0x0007);
 		}
+		if (count == 30)
+		{
+			rxAppListenIn.write(0x8008);
+		}
 		if (count == 40)
 		{
 			rxPortTableIn.write(0x0700);
 		}
+		if (count == 50)
+		{
+			rxPortTableIn.write(0x0800);
+		}
 		count++;
 	}
 
+	if (checkCount != 2)
+	{
+		std::cout << "ERROR: " << checkCount << " of 2 port checks answered" << std::endl;
+		errCount++;
+	}
+	std::cout << "Errors: " << errCount << std::endl;
 
-
-	//should return comparison
-
-	return 0;
+	return (errCount != 0);
 }
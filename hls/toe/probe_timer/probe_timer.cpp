@@ -32,89 +32,101 @@ EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.// Copyright (c) 2015 Xilinx,
 using namespace hls;
 
 /** @ingroup probe_timer
- *  Reads in the Session-ID and activates. a timer with an interval of 5 seconds. When the timer times out
+ *  Reads in the Session-ID and activates. a timer with an interval of 50 milliseconds. When the timer times out
  *  a RT Event is fired to the @ref tx_engine. In case of a zero-window (or too small window) an RT Event
  *  will generate a packet without payload which is the same as a probing packet.
+ *  A clear from the @ref rx_engine fires the event of an active timer immediately.
+ *	@param[in]		rxEng2timer_clearProbeTimer
  *	@param[in]		txEng2timer_setProbeTimer
+ *	@param[in]		wheel2probeTimer_expired
+ *	@param[out]		probeTimer2wheel_op
  *	@param[out]		probeTimer2eventEng_setEvent
  */
-void probe_timer(	stream<ap_uint<16> >&		rxEng2timer_clearProbeTimer,
-					stream<ap_uint<16> >&		txEng2timer_setProbeTimer,
-					stream<event>&				probeTimer2eventEng_setEvent)
+void probeTimerControl(	stream<ap_uint<16> >&		rxEng2timer_clearProbeTimer,
+						stream<ap_uint<16> >&		txEng2timer_setProbeTimer,
+						stream<timerWheelExpiry>&	wheel2probeTimer_expired,
+						stream<timerWheelOp>&		probeTimer2wheel_op,
+						stream<event>&				probeTimer2eventEng_setEvent)
 {
-#pragma HLS DATA_PACK variable=txEng2timer_setProbeTimer
-#pragma HLS DATA_PACK variable=probeTimer2eventEng_setEvent
-
+#pragma HLS INLINE off
 #pragma HLS PIPELINE II=1
 
 	static probe_timer_entry probeTimerTable[MAX_SESSIONS];
-	#pragma HLS RESOURCE variable=probeTimerTable core=RAM_T2P_BRAM
+	SESSION_TABLE_RESOURCE(probeTimerTable, RAM_T2P_BRAM)
 	#pragma HLS DATA_PACK variable=probeTimerTable
 	#pragma HLS DEPENDENCE variable=probeTimerTable inter false
 
-	static ap_uint<16>		pt_currSessionID = 0;
-	static ap_uint<16>		pt_updSessionID = 0;
-	static ap_uint<16>		pt_prevSessionID = 0;
-	static bool				pt_WaitForWrite = false;
-
-	ap_uint<16> checkID;
-	bool		fastResume = false;
+	ap_uint<16>			sessionID;
+	probe_timer_entry	currEntry;
+	timerWheelExpiry	expired;
+	bool				fire = false;
 
-	if (pt_WaitForWrite)
+	if (!txEng2timer_setProbeTimer.empty() && !probeTimer2wheel_op.full())
+	{
+		txEng2timer_setProbeTimer.read(sessionID);
+		currEntry = probeTimerTable[sessionID];
+		currEntry.tag++;
+		currEntry.active = true;
+		probeTimer2wheel_op.write(timerWheelOp(sessionID, TIME_50ms, currEntry.tag));
+		probeTimerTable[sessionID] = currEntry;
+	}
+	else if (!rxEng2timer_clearProbeTimer.empty() && !probeTimer2wheel_op.full() && !probeTimer2eventEng_setEvent.full())
 	{
-		if (pt_updSessionID != pt_prevSessionID)
+		rxEng2timer_clearProbeTimer.read(sessionID);
+		currEntry = probeTimerTable[sessionID];
+		if (currEntry.active)
 		{
-			probeTimerTable[pt_updSessionID].time = TIME_50ms;
-			probeTimerTable[pt_updSessionID].active = true;
-			pt_WaitForWrite = false;
+			probeTimer2wheel_op.write(timerWheelOp(sessionID));
+			fire = true;
 		}
-		pt_prevSessionID--;
 	}
-	else if (!txEng2timer_setProbeTimer.empty())
+	else if (!wheel2probeTimer_expired.empty() && !probeTimer2eventEng_setEvent.full())
 	{
-		txEng2timer_setProbeTimer.read(pt_updSessionID);
-		pt_WaitForWrite = true;
+		wheel2probeTimer_expired.read(expired);
+		sessionID = expired.sessionID;
+		currEntry = probeTimerTable[sessionID];
+		fire = (currEntry.active && currEntry.tag == expired.tag);
 	}
-	// too restrictive FIXME
-	else// if (!probeTimer2eventEng_setEvent.full()) this leads to II=2
-	{
-		//pt_prevSessionID = pt_currSessionID;
-		checkID = pt_currSessionID;
-
-		if (!rxEng2timer_clearProbeTimer.empty())
-		{
-			rxEng2timer_clearProbeTimer.read(checkID);
-			fastResume = true;
-		}
-		else
-		{
-			pt_currSessionID++;
-			if (pt_currSessionID == MAX_SESSIONS)
-			{
-				pt_currSessionID = 0;
-			}
-		}
 
-		// Check if 0, otherwise decrement
-		if (probeTimerTable[checkID].active && !probeTimer2eventEng_setEvent.full())
-		{
-			if (probeTimerTable[checkID].time == 0 || fastResume)
-			{
-				probeTimerTable[checkID].time = 0;
-				probeTimerTable[checkID].active = false;
-				// It's not an RT, we want to resume TX
+	if (fire)
+	{
+		currEntry.active = false;
+		probeTimerTable[sessionID] = currEntry;
+		// It's not an RT, we want to resume TX
 #if !(TCP_NODELAY)
-				probeTimer2eventEng_setEvent.write(event(TX, checkID));
+		probeTimer2eventEng_setEvent.write(event(TX, sessionID));
 #else
-				probeTimer2eventEng_setEvent.write(event(RT, checkID));
+		probeTimer2eventEng_setEvent.write(event(RT, sessionID));
 #endif
-				fastResume = false;
-			}
-			else
-			{
-				probeTimerTable[checkID].time -= 1;
-			}
-		}
-		pt_prevSessionID = checkID;
 	}
 }
+
+/** @ingroup probe_timer
+ *  Connects the @ref probeTimerControl to its @ref timing_wheel.
+ *	@param[in]		rxEng2timer_clearProbeTimer
+ *	@param[in]		txEng2timer_setProbeTimer
+ *	@param[out]		probeTimer2eventEng_setEvent
+ */
+void probe_timer(	stream<ap_uint<16> >&		rxEng2timer_clearProbeTimer,
+					stream<ap_uint<16> >&		txEng2timer_setProbeTimer,
+					stream<event>&				probeTimer2eventEng_setEvent)
+{
+#pragma HLS INLINE
+
+#pragma HLS DATA_PACK variable=txEng2timer_setProbeTimer
+#pragma HLS DATA_PACK variable=probeTimer2eventEng_setEvent
+
+	static stream<timerWheelOp>		probeTimer2wheel_op("probeTimer2wheel_op");
+	static stream<timerWheelExpiry>	wheel2probeTimer_expired("wheel2probeTimer_expired");
+	#pragma HLS stream variable=probeTimer2wheel_op			depth=4
+	#pragma HLS stream variable=wheel2probeTimer_expired	depth=4
+	#pragma HLS DATA_PACK variable=probeTimer2wheel_op
+	#pragma HLS DATA_PACK variable=wheel2probeTimer_expired
+
+	probeTimerControl(	rxEng2timer_clearProbeTimer,
+						txEng2timer_setProbeTimer,
+						wheel2probeTimer_expired,
+						probeTimer2wheel_op,
+						probeTimer2eventEng_setEvent);
+	timing_wheel<1>(probeTimer2wheel_op, wheel2probeTimer_expired);
+}
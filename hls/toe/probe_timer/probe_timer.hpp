@@ -27,6 +27,7 @@ OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF
 EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.// Copyright (c) 2015 Xilinx, Inc.
 ************************************************/
 #include "../toe.hpp"
+#include "../timing_wheel/timing_wheel.hpp"
 
 using namespace hls;
 
@@ -35,7 +36,7 @@ using namespace hls;
  */
 struct probe_timer_entry
 {
-	ap_uint<32>		time;
+	ap_uint<8>		tag;
 	bool			active;
 };
 
@@ -33,160 +33,177 @@ using namespace hls;
 
 /** @ingroup retransmit_timer
  *  The @ref tx_engine sends the Session-ID and Eventy type through the @param txRetransmitTimerFifoIn.
- *  If the timer is unactivated for this session it is activated, the time-out interval is set depending on
- *  how often the session already time-outed.
- *  The @ref rx_engine indicates when a timer for a specific session has to be stopped.
+ *  If the timer is unactivated for this session it is activated, the time-out interval is the RTO of the session
+ *  doubled for every time-out in a row, RFC 6298 5.5.
+ *  A data timer without time-outs is first armed with the shorter PTO of the session. Its expiry fires a TLP Event,
+ *  the @ref tx_engine resends the last segment to elicit an ACK, and the timer is re-armed with the RTO, RFC 8985 7.
+ *  The @ref rx_engine indicates when a timer for a specific session has to be stopped or restarted with the current RTO.
+ *	The timers themselves are kept in a @ref timing_wheel, every arm gets a new tag so expirations of a timer
+ *	that was stopped or restarted in the meantime are discarded.
  *	If a timer times-out the corresponding EVent is fired back to the @ref tx_engine. If a session times-out more than 4 times
  *	in a row, it is aborted. The session is released through @param retransmitTimerReleaseFifoOut and the application is
  *	notified through @param timerNotificationFifoOut.
- *	Currently the II is 2 which means that the interval take twice as much time as defined.
  *  @param[in]		rxEng2timer_clearRetransmitTimer
  *  @param[in]		txEng2timer_setRetransmitTimer
+ *  @param[in]		wheel2rtTimer_expired
+ *  @param[out]		rtTimer2wheel_op
  *  @param[out]		rtTimer2eventEng_setEvent
  *  @param[out]		rtTimer2stateTable_releaseState
  *  @param[out]		rtTimer2rxApp_notification
  */
-void retransmit_timer(	stream<rxRetransmitTimerUpdate>&	rxEng2timer_clearRetransmitTimer,
-						stream<txRetransmitTimerSet>&		txEng2timer_setRetransmitTimer,
-						stream<event>&						rtTimer2eventEng_setEvent,
-						stream<ap_uint<16> >&				rtTimer2stateTable_releaseState,
-						stream<appNotification>&			rtTimer2rxApp_notification,
-						stream<openStatus>&					rtTimer2txApp_notification)
+void retransmitTimerControl(stream<rxRetransmitTimerUpdate>&	rxEng2timer_clearRetransmitTimer,
+							stream<txRetransmitTimerSet>&		txEng2timer_setRetransmitTimer,
+							stream<timerWheelExpiry>&			wheel2rtTimer_expired,
+							stream<timerWheelOp>&				rtTimer2wheel_op,
+							stream<event>&						rtTimer2eventEng_setEvent,
+							stream<ap_uint<16> >&				rtTimer2stateTable_releaseState,
+							stream<appNotification>&			rtTimer2rxApp_notification,
+							stream<openStatus>&					rtTimer2txApp_notification)
 {
+#pragma HLS INLINE off
 #pragma HLS PIPELINE II=1
-//#pragma HLS INLINE
-
-#pragma HLS DATA_PACK variable=rxEng2timer_clearRetransmitTimer
-#pragma HLS DATA_PACK variable=txEng2timer_setRetransmitTimer
-#pragma HLS DATA_PACK variable=rtTimer2eventEng_setEvent
-#pragma HLS DATA_PACK variable=rtTimer2stateTable_releaseState
-#pragma HLS DATA_PACK variable=rtTimer2rxApp_notification
 
 	static retransmitTimerEntry retransmitTimerTable[MAX_SESSIONS];
-	#pragma HLS RESOURCE variable=retransmitTimerTable core=RAM_T2P_BRAM
+	SESSION_TABLE_RESOURCE(retransmitTimerTable, RAM_T2P_BRAM)
 	#pragma HLS DATA_PACK variable=retransmitTimerTable
 	#pragma HLS DEPENDENCE variable=retransmitTimerTable inter false
 
-	static ap_uint<16>			rt_position = 0;
-	static bool							rt_waitForWrite = false;
-	static ap_uint<16>					rt_prevPosition = 0;
-	static rxRetransmitTimerUpdate	rt_update;
-
 	retransmitTimerEntry	currEntry;
-	ap_uint<1> operationSwitch = 0;
+	rxRetransmitTimerUpdate	update;
 	txRetransmitTimerSet	set;
-	ap_uint<16>				currID;
+	timerWheelExpiry		expired;
+	ap_uint<32>				timeout;
 
-	if (rt_waitForWrite && rt_update.sessionID != rt_prevPosition) //TODO maybe prevprev too
+	if (!rxEng2timer_clearRetransmitTimer.empty() && !rtTimer2wheel_op.full()) //FIXME rx path has priority over tx path
 	{
-		if (!rt_update.stop)
+		rxEng2timer_clearRetransmitTimer.read(update);
+		currEntry = retransmitTimerTable[update.sessionID];
+		if (!update.stop)
 		{
-			retransmitTimerTable[rt_update.sessionID].time = TIME_1s;
+			if (currEntry.active)
+			{
+				currEntry.tag++;
+				currEntry.probe = (currEntry.type == RT && update.pto < update.rto);
+				currEntry.rto = update.rto;
+				timeout = currEntry.probe ? update.pto : update.rto;
+				rtTimer2wheel_op.write(timerWheelOp(update.sessionID, timeout, currEntry.tag));
+			}
 		}
 		else
 		{
-			retransmitTimerTable[rt_update.sessionID].time = 0;
-			retransmitTimerTable[rt_update.sessionID].active = false;
+			if (currEntry.active)
+			{
+				rtTimer2wheel_op.write(timerWheelOp(update.sessionID));
+			}
+			currEntry.active = false;
 		}
-		retransmitTimerTable[rt_update.sessionID].retries = 0;
-		rt_waitForWrite = false;
+		currEntry.retries = 0;
+		retransmitTimerTable[update.sessionID] = currEntry;
 	}
-	else if (!rxEng2timer_clearRetransmitTimer.empty() && !rt_waitForWrite) //FIXME rx path has priority over tx path
+	else if (!txEng2timer_setRetransmitTimer.empty() && !rtTimer2wheel_op.full())
 	{
-		rxEng2timer_clearRetransmitTimer.read(rt_update);
-		rt_waitForWrite = true;
-	}
-	else
-	{
-		currID = rt_position;
-
-		if (!txEng2timer_setRetransmitTimer.empty())
+		txEng2timer_setRetransmitTimer.read(set);
+		currEntry = retransmitTimerTable[set.sessionID];
+		currEntry.type = set.type;
+		if (!currEntry.active)
 		{
-			txEng2timer_setRetransmitTimer.read(set);
-			currID = set.sessionID;
-			operationSwitch = 1;
-			if (set.sessionID-3 < rt_position && rt_position <= set.sessionID)
+			// Back off the timer
+			timeout = set.rto << currEntry.retries;
+			if (timeout > TCP_RTO_MAX)
 			{
-				rt_position += 5;
+				timeout = TCP_RTO_MAX;
 			}
-		}
-		else
-		{
-			// increment position
-			rt_position++;
-			if (rt_position >= MAX_SESSIONS)
+			currEntry.rto = timeout;
+			// The probe is only sent before the first time-out
+			currEntry.probe = (set.type == RT && currEntry.retries == 0 && set.pto < set.rto);
+			if (currEntry.probe)
 			{
-				rt_position = 0;
+				timeout = set.pto;
 			}
-			operationSwitch = 0;
+			currEntry.tag++;
+			rtTimer2wheel_op.write(timerWheelOp(set.sessionID, timeout, currEntry.tag));
 		}
-
-		// Get entry from table
-		currEntry = retransmitTimerTable[currID];
-		switch (operationSwitch)
+		currEntry.active = true;
+		retransmitTimerTable[set.sessionID] = currEntry;
+	}
+	// We need to check if we can generate another event, otherwise we might end up in a Deadlock,
+	// since the TX Engine will not be able to set new retransmit timers
+	else if (!wheel2rtTimer_expired.empty() && !rtTimer2eventEng_setEvent.full() && !rtTimer2wheel_op.full())
+	{
+		wheel2rtTimer_expired.read(expired);
+		currEntry = retransmitTimerTable[expired.sessionID];
+		if (currEntry.active && currEntry.tag == expired.tag && currEntry.probe)
+		{
+			// PTO expired, the timer keeps running with the RTO
+			currEntry.probe = false;
+			currEntry.tag++;
+			rtTimer2eventEng_setEvent.write(event(TLP, expired.sessionID));
+			rtTimer2wheel_op.write(timerWheelOp(expired.sessionID, currEntry.rto, currEntry.tag));
+			retransmitTimerTable[expired.sessionID] = currEntry;
+		}
+		else if (currEntry.active && currEntry.tag == expired.tag)
 		{
-		case 1:
-			currEntry.type = set.type;
-			if (!currEntry.active)
+			currEntry.active = false;
+			if (currEntry.retries < 4)
 			{
-				switch(currEntry.retries)
-				{
-				case 0:
-					currEntry.time = TIME_1s; //TIME_5s;
-					break;
-				case 1:
-					currEntry.time = TIME_5s; //TIME_7s;
-					break;
-				case 2:
-					currEntry.time = TIME_10s; //TIME_15s;
-					break;
-				case 3:
-					currEntry.time = TIME_15s; //TIME_20s;
-					break;
-				default:
-					currEntry.time = TIME_30s; //TIME_30s;
-					break;
-				}
+				currEntry.retries++;
+				rtTimer2eventEng_setEvent.write(event(currEntry.type, expired.sessionID, currEntry.retries));
 			}
-			currEntry.active = true;
-			break;
-		case 0:
-			if (currEntry.active)
+			else
 			{
-				if (currEntry.time > 0)
+				currEntry.retries = 0;
+				rtTimer2stateTable_releaseState.write(expired.sessionID);
+				if (currEntry.type == SYN)
 				{
-					currEntry.time--;
+					rtTimer2txApp_notification.write(openStatus(expired.sessionID, false));
 				}
-				// We need to check if we can generate another event, otherwise we might end up in a Deadlock,
-				// since the TX Engine will not be able to set new retransmit timers
-				else if (!rtTimer2eventEng_setEvent.full())
+				else
 				{
-					currEntry.time = 0;
-					currEntry.active = false;
-					if (currEntry.retries < 4)
-					{
-						currEntry.retries++;
-						rtTimer2eventEng_setEvent.write(event(currEntry.type, currID, currEntry.retries));
-					}
-					else
-					{
-						currEntry.retries = 0;
-						rtTimer2stateTable_releaseState.write(currID);
-						if (currEntry.type == SYN)
-						{
-							rtTimer2txApp_notification.write(openStatus(currID, false));
-						}
-						else
-						{
-							rtTimer2rxApp_notification.write(appNotification(currID, true)); //TIME_OUT
-						}
-					}
+					rtTimer2rxApp_notification.write(appNotification(expired.sessionID, true)); //TIME_OUT
 				}
-			} //if active
-			break;
-		} //switch
-		// write entry back
-		retransmitTimerTable[currID] = currEntry;
-		rt_prevPosition = currID;
+			}
+			retransmitTimerTable[expired.sessionID] = currEntry;
+		}
 	}
 }
+
+/** @ingroup retransmit_timer
+ *  Connects the @ref retransmitTimerControl to its @ref timing_wheel.
+ *  @param[in]		rxEng2timer_clearRetransmitTimer
+ *  @param[in]		txEng2timer_setRetransmitTimer
+ *  @param[out]		rtTimer2eventEng_setEvent
+ *  @param[out]		rtTimer2stateTable_releaseState
+ *  @param[out]		rtTimer2rxApp_notification
+ */
+void retransmit_timer(	stream<rxRetransmitTimerUpdate>&	rxEng2timer_clearRetransmitTimer,
+						stream<txRetransmitTimerSet>&		txEng2timer_setRetransmitTimer,
+						stream<event>&						rtTimer2eventEng_setEvent,
+						stream<ap_uint<16> >&				rtTimer2stateTable_releaseState,
+						stream<appNotification>&			rtTimer2rxApp_notification,
+						stream<openStatus>&					rtTimer2txApp_notification)
+{
+#pragma HLS INLINE
+
+#pragma HLS DATA_PACK variable=rxEng2timer_clearRetransmitTimer
+#pragma HLS DATA_PACK variable=txEng2timer_setRetransmitTimer
+#pragma HLS DATA_PACK variable=rtTimer2eventEng_setEvent
+#pragma HLS DATA_PACK variable=rtTimer2stateTable_releaseState
+#pragma HLS DATA_PACK variable=rtTimer2rxApp_notification
+
+	static stream<timerWheelOp>		rtTimer2wheel_op("rtTimer2wheel_op");
+	static stream<timerWheelExpiry>	wheel2rtTimer_expired("wheel2rtTimer_expired");
+	#pragma HLS stream variable=rtTimer2wheel_op		depth=4
+	#pragma HLS stream variable=wheel2rtTimer_expired	depth=4
+	#pragma HLS DATA_PACK variable=rtTimer2wheel_op
+	#pragma HLS DATA_PACK variable=wheel2rtTimer_expired
+
+	retransmitTimerControl(	rxEng2timer_clearRetransmitTimer,
+							txEng2timer_setRetransmitTimer,
+							wheel2rtTimer_expired,
+							rtTimer2wheel_op,
+							rtTimer2eventEng_setEvent,
+							rtTimer2stateTable_releaseState,
+							rtTimer2rxApp_notification,
+							rtTimer2txApp_notification);
+	timing_wheel<0>(rtTimer2wheel_op, wheel2rtTimer_expired);
+}
@@ -27,6 +27,7 @@ OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF
 EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.// Copyright (c) 2015 Xilinx, Inc.
 ************************************************/
 #include "../toe.hpp"
+#include "../timing_wheel/timing_wheel.hpp"
 
 using namespace hls;
 
@@ -35,10 +36,12 @@ using namespace hls;
  */
 struct retransmitTimerEntry
 {
-	ap_uint<32>		time;
+	ap_uint<8>		tag;
 	ap_uint<3>		retries;
 	bool			active;
+	bool			probe;		// Armed with the PTO, the expiry sends a tail loss probe
 	eventType		type;
+	ap_uint<32>		rto;		// Re-armed with this timeout after the probe
 };
 
 /** @ingroup retransmit_timer
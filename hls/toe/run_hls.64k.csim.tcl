@@ -0,0 +1,35 @@
+open_project toe_64k_prj
+
+set_top session_lookup_controller
+
+set cflags "-DTCP_64K_SESSIONS=1"
+
+add_files session_lookup_controller/session_lookup_controller.cpp -cflags $cflags
+add_files -tb session_lookup_controller/test_session_lookup_controller.cpp -cflags $cflags
+
+open_solution "solution1"
+set_part {xcvu9p-flga2104-2L-e}
+create_clock -period 6.66 -name default
+
+# Opens all 65535 sessions, looks each of them up again, drives them through the reverse lookup
+# and reopens half of them after a release
+csim_design -clean
+close_project
+
+open_project toe_64k_lifecycle_prj
+
+set_top session_lookup_controller
+
+add_files session_lookup_controller/session_lookup_controller.cpp -cflags $cflags
+add_files state_table/state_table.cpp -cflags $cflags
+add_files retransmit_timer/retransmit_timer.cpp -cflags $cflags
+add_files -tb session_lookup_controller/test_session_lifecycle.cpp -cflags $cflags
+
+open_solution "solution1"
+set_part {xcvu9p-flga2104-2L-e}
+create_clock -period 6.66 -name default
+
+# Opens all 65535 sessions with the state table and the retransmit timer attached, every session times out
+# and is released through the state table, then all of them are opened again on the released IDs
+csim_design -clean
+exit
@@ -4,6 +4,8 @@ set_top toe
 
 add_files ack_delay/ack_delay.cpp
 add_files close_timer/close_timer.cpp
+add_files keepalive_timer/keepalive_timer.cpp
+add_files congestion_control/congestion_control.cpp
 add_files event_engine/event_engine.cpp
 add_files port_table/port_table.cpp
 add_files probe_timer/probe_timer.cpp
@@ -11,15 +13,15 @@ add_files retransmit_timer/retransmit_timer.cpp
 add_files rx_app_if/rx_app_if.cpp
 add_files rx_app_stream_if/rx_app_stream_if.cpp
 add_files rx_engine/rx_engine.cpp
-add_files rx_sar_table/rx_sar_table.cpp
 add_files session_lookup_controller/session_lookup_controller.cpp
+add_files session_context_table/session_context_table.cpp
 #add_files session_lookup_controller/session_lookup_controller/stub_session_lookup.cpp
 add_files state_table/state_table.cpp
 add_files tx_app_if/tx_app_if.cpp
 add_files tx_app_stream_if/tx_app_stream_if.cpp
 add_files tx_engine/tx_engine.cpp
-add_files tx_sar_table/tx_sar_table.cpp
 add_files tx_app_interface/tx_app_interface.cpp
+add_files tx_pacer/tx_pacer.cpp
 add_files dummy_memory.cpp
 add_files toe.cpp
 add_files -tb toe_tb.cpp
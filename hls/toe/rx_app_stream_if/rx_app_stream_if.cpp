@@ -47,7 +47,7 @@ void rx_app_stream_if(stream<appReadRequest>&		appRxDataReq,
 					  stream<ap_uint<16> >&			appRxDataRspMetadata,
 					  stream<rxSarAppd>&			rxApp2rxSar_upd_req,
 #if !(RX_DDR_BYPASS)
-					  stream<mmCmd>&				rxBufferReadCmd)
+					  stream<mmBufferCmd>&			rxBufferReadCmd)
 #else
 					  stream<ap_uint<1> >&			rxBufferReadCmd)
 #endif
@@ -78,9 +78,8 @@ void rx_app_stream_if(stream<appReadRequest>&		appRxDataReq,
 				appRxDataRspMetadata.write(rxSar.sessionID);
 #if !(RX_DDR_BYPASS)
 				ap_uint<32> pkgAddr = 0;
-				pkgAddr(29, 16) = rxSar.sessionID(13, 0);
-				pkgAddr(15, 0) = rxSar.appd;
-				rxBufferReadCmd.write(mmCmd(pkgAddr, rasi_readLength));
+				pkgAddr(29, 0) = rxSar.buffer.address(rxSar.appd);
+				rxBufferReadCmd.write(mmBufferCmd(mmCmd(pkgAddr, rasi_readLength), rxSar.buffer));
 #else
 				rxBufferReadCmd.write(1);
 #endif
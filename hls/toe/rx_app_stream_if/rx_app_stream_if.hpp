@@ -39,7 +39,7 @@ void rx_app_stream_if(	stream<appReadRequest>&		appRxDataReq,
 						stream<ap_uint<16> >&		appRxDataRspMetadata,
 						stream<rxSarAppd>&			rxApp2rxSar_upd_req,
 #if !(RX_DDR_BYPASS)
-						stream<mmCmd>&				rxBufferReadCmd);
+						stream<mmBufferCmd>&		rxBufferReadCmd);
 #else
 						stream<ap_uint<1> >&		rxBufferReadCmd);
 #endif
@@ -38,10 +38,10 @@ int main()
 	stream<rxSarAppd>			rxSar2rxApp_upd_rsp;
 	stream<ap_uint<16> >		appRxDataRspMetadata;
 	stream<rxSarAppd>			rxApp2rxSar_upd_req;
-	stream<mmCmd>				rxBufferReadCmd;
+	stream<mmBufferCmd>			rxBufferReadCmd;
 
 	rxSarAppd req;
-	mmCmd cmd;
+	mmBufferCmd cmd;
 	ap_uint<16> meta;
 
 	int count = 0;
@@ -58,6 +58,7 @@ int main()
 			if (!req.write)
 			{
 				req.appd = 2435;
+				req.buffer = sessionBuffer(TCP_BUFFER_CLASS_ACCEPT, req.sessionID);
 				rxSar2rxApp_upd_rsp.write(req);
 			}
 		}
@@ -65,7 +66,7 @@ int main()
 		if (!rxBufferReadCmd.empty())
 		{
 			rxBufferReadCmd.read(cmd);
-			std::cout << "Cmd: " << cmd.saddr << std::endl;
+			std::cout << "Cmd: " << cmd.cmd.saddr << std::endl;
 		}
 		if (!appRxDataRspMetadata.empty())
 		{
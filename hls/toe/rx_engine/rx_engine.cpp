@@ -38,17 +38,20 @@ using namespace hls;
  * @param[in]		dataIn, incoming data stream
  * @param[out]		dataOut, outgoing data stream
  * @param[out]		tcpLenFifoOut, the TCP length is stored into this FIFO
+ * @param[out]		ceFifoOut, true if the ECN field carries Congestion Experienced, RFC 3168 5
  * @TODO maybe compute TCP length in another way!!
  */
 void rxTcpLengthExtract(stream<axiWord>&			dataIn,
 						stream<axiWord>&			dataOut,
-						stream<ap_uint<16> >&		tcpLenFifoOut)
+						stream<ap_uint<16> >&		tcpLenFifoOut,
+						stream<bool>&				ceFifoOut)
 {
 #pragma HLS INLINE off
 #pragma HLS pipeline II=1
 
 	static ap_uint<8> tle_ipHeaderLen = 0;
 	static ap_uint<16> tle_ipTotalLen = 0;
+	static ap_uint<2> tle_ecn = 0;
 	static ap_uint<4> tle_wordCount = 0;
 	static bool tle_insertWord = false;
 	static bool tle_wasLast = false;
@@ -74,6 +77,7 @@ void rxTcpLengthExtract(stream<axiWord>&			dataIn,
 		{
 		case 0:
 			tle_ipHeaderLen = currWord.data(3, 0);
+			tle_ecn = currWord.data(9, 8); // Lower two bits of the TOS byte
 			tle_ipTotalLen(7, 0) = currWord.data(31, 24);
 			tle_ipTotalLen(15, 8) = currWord.data(23, 16);
 			tle_ipTotalLen -= (tle_ipHeaderLen * 4);
@@ -85,6 +89,7 @@ void rxTcpLengthExtract(stream<axiWord>&			dataIn,
 			// -> is put into prevWord
 			// Write length
 			tcpLenFifoOut.write(tle_ipTotalLen);
+			ceFifoOut.write(tle_ecn == 0x3);
 			tle_ipHeaderLen -= 2;
 			tle_wordCount++;
 			break;
@@ -256,6 +261,7 @@ void rxInsertPseudoHeader(stream<axiWord>&				dataIn,
  *  It also sends the destination port number to the @ref port_table
  *  to check if the port is open.
  *  @param[in]		dataIn
+ *  @param[in]		ceFifoIn
  *  @param[out]		dataOut
  *  @param[out]		validFifoOut
  *  @param[out]		metaDataFifoOut
@@ -263,6 +269,7 @@ void rxInsertPseudoHeader(stream<axiWord>&				dataIn,
  *  @param[out]		portTableOut
  */
 void rxCheckTCPchecksum(stream<axiWord>&					dataIn,
+							stream<bool>&					ceFifoIn,
 							stream<axiWord>&				dataOut,
 							stream<bool>&					validFifoOut,
 							stream<rxEngineMetaData>&		metaDataFifoOut,
@@ -285,6 +292,14 @@ void rxCheckTCPchecksum(stream<axiWord>&					dataIn,
 	static ap_uint<16> csa_port;
 
 	static ap_uint<3> csa_cc_state = 0;
+	// TCP option parser, options can cross word boundaries
+	enum csaOptStateType {OPT_KIND, OPT_LENGTH, OPT_DATA, OPT_END};
+	static csaOptStateType csa_optState = OPT_KIND;
+	static ap_uint<6> csa_optBytes = 0;	// Remaining option bytes of the header
+	static ap_uint<8> csa_optKind;
+	static ap_uint<6> csa_optLength;		// Data bytes of the current option
+	static ap_uint<6> csa_optIndex;		// Position inside the option data
+	static ap_uint<32> csa_optValue;		// Last four option data bytes, network byte order
 
 	//currWord.last = 0; //mighnt no be necessary any more FIXME to you want to risk it ;)
 	if (!dataIn.empty() && !csa_checkChecksum)
@@ -295,6 +310,8 @@ void rxCheckTCPchecksum(stream<axiWord>&					dataIn,
 		case 0:
 			csa_dataOffset = 0xFF;
 			csa_shift = false;
+			// Written by rxTcpLengthExtract before the pseudo header is complete
+			ceFifoIn.read(csa_meta.ce);
 				// We don't switch bytes, internally we store it Most Significant Byte Last
 				csa_sessionTuple.srcIp = currWord.data(31, 0);
 				csa_sessionTuple.dstIp = currWord.data(63, 32);
@@ -334,17 +351,113 @@ void rxCheckTCPchecksum(stream<axiWord>&					dataIn,
 			 * [11] == PSH
 			 * [12] == ACK
 			 * [13] == URG
+			 * [14] == ECE
+			 * [15] == CWR
 			 */
 			csa_meta.ack = currWord.data[12];
 			csa_meta.rst = currWord.data[10];
 			csa_meta.syn = currWord.data[9];
 			csa_meta.fin = currWord.data[8];
+			csa_meta.ece = currWord.data[14];
+			csa_meta.cwr = currWord.data[15];
 			csa_meta.winSize(7, 0) = currWord.data(31, 24);
 			csa_meta.winSize(15, 8) = currWord.data(23, 16);
+			csa_meta.mss = DEFAULT_MSS;
+			csa_meta.winScale = 0;
+			csa_meta.winScaleValid = false;
+			csa_meta.sackPermitted = false;
+			csa_meta.sackCount = 0;
+			csa_meta.tsValid = false;
+			csa_meta.synCookie = false;
+			csa_optState = OPT_KIND;
+			csa_optBytes = (csa_dataOffset > 5) ? (ap_uint<6>) ((csa_dataOffset - 5) * 4) : (ap_uint<6>) 0;
 			// We add checksum as well and check for cs == 0
 			sendWord.last = currWord.last;
 			break;
 		default:
+			// Parse the options byte by byte, all 8 bytes of a word are evaluated in the same cycle
+			for (uint8_t i = 0; i < 8; i++)
+			{
+			#pragma HLS UNROLL
+				ap_uint<8> optByte = currWord.data(i*8+7, i*8);
+				if (i < csa_optBytes)
+				{
+					switch (csa_optState)
+					{
+					case OPT_KIND:
+						csa_optKind = optByte;
+						if (optByte == OPT_KIND_EOL)
+						{
+							csa_optState = OPT_END;
+						}
+						else if (optByte != OPT_KIND_NOP) // NOP has no length
+						{
+							csa_optState = OPT_LENGTH;
+						}
+						break;
+					case OPT_LENGTH:
+						csa_optLength = optByte - 2;
+						csa_optIndex = 0;
+						if (csa_optKind == OPT_KIND_SACK_PERMITTED)
+						{
+							csa_meta.sackPermitted = true;
+						}
+						csa_optState = (optByte > 2) ? OPT_DATA : OPT_KIND;
+						break;
+					case OPT_DATA:
+						csa_optValue = (csa_optValue(23, 0), optByte);
+						switch (csa_optKind)
+						{
+						case OPT_KIND_MSS: // RFC 793
+							if (csa_optIndex == 1)
+							{
+								csa_meta.mss = csa_optValue(15, 0);
+							}
+							break;
+						case OPT_KIND_WS: // RFC 7323 2.2
+							if (csa_optIndex == 0)
+							{
+								csa_meta.winScale = (optByte > WINDOW_SCALE_MAX) ? WINDOW_SCALE_MAX : (uint8_t) optByte;
+								csa_meta.winScaleValid = true;
+							}
+							break;
+						case OPT_KIND_SACK: // RFC 2018 3, blocks of left and right edge
+							if (csa_optIndex(2, 0) == 3 && csa_optIndex(5, 3) < TCP_SACK_BLOCKS)
+							{
+								csa_meta.sackLeft[csa_optIndex(4, 3)] = csa_optValue;
+							}
+							else if (csa_optIndex(2, 0) == 7 && csa_optIndex(5, 3) < TCP_SACK_BLOCKS)
+							{
+								csa_meta.sackRight[csa_optIndex(4, 3)] = csa_optValue;
+								csa_meta.sackCount = csa_optIndex(5, 3) + 1;
+							}
+							break;
+						case OPT_KIND_TIMESTAMP: // RFC 7323 3.2
+							if (csa_optIndex == 3)
+							{
+								csa_meta.tsVal = csa_optValue;
+							}
+							else if (csa_optIndex == 7)
+							{
+								csa_meta.tsEcr = csa_optValue;
+								csa_meta.tsValid = true;
+							}
+							break;
+						default:
+							break;
+						}
+						csa_optIndex++;
+						if (csa_optIndex == csa_optLength)
+						{
+							csa_optState = OPT_KIND;
+						}
+						break;
+					case OPT_END:
+						break;
+					}
+				}
+			}
+			csa_optBytes = (csa_optBytes > 8) ? (ap_uint<6>) (csa_optBytes - 8) : (ap_uint<6>) 0;
 			if (csa_dataOffset > 6)
 			{
 				csa_dataOffset -= 2;
@@ -549,164 +662,349 @@ void rxTcpInvalidDropper(stream<axiWord>&				dataIn,
 
 
 /** @ingroup rx_engine
- * The module contains 2 state machines nested into each other. The outer state machine
- * loads the metadata and does the session lookup. The inner state machin then evaluates all
- * this data. This inner state machine mostly represents the TCP state machine and contains
- * all the logic how to update the metadata, what events are triggered and so on. It is the key
- * part of the @ref rx_engine.
- * @param[in]	metaDataFifoIn
- * @param[in]	sLookup2rxEng_rsp
- * @param[in]	stateTable2rxEng_upd_rsp
- * @param[in]	portTable2rxEng_rsp
- * @param[in]	tupleBufferIn
- * @param[in]	rxSar2rxEng_upd_rsp
- * @param[in]	txSar2rxEng_upd_rsp
- * @param[out]	rxEng2sLookup_req
- * @param[out]	rxEng2stateTable_req
- * @param[out]	rxEng2rxSar_upd_req
- * @param[out]	rxEng2txSar_upd_req
- * @param[out]	rxEng2timer_clearRetransmitTimer
- * @param[out]	rxEng2timer_setCloseTimer
- * @param[out]	openConStatusOut
- * @param[out]	rxEng2eventEng_setEvent
- * @param[out]	dropDataFifoOut
- * @param[out]	rxBufferWriteCmd
- * @param[out]	rxEng2rxApp_notification
+ *  Tuple of a segment sent in reply to the received one
+ */
+fourTuple rxReplyTuple(fourTuple tuple)
+{
+#pragma HLS INLINE
+	return fourTuple(tuple.dstIp, tuple.srcIp, tuple.dstPort, tuple.srcPort);
+}
+
+/** @ingroup rx_engine
+ *  Issues the session lookup of every segment to an open port without waiting for the replies, the
+ *  segments are queued in issue order in front of the @ref rxLookupReplyHandler. ACKs that return a
+ *  valid SYN cookie may create their session. The TIME-WAIT lookup of a SYN is issued together with
+ *  its session lookup, both replies are joined by the @ref rxLookupReplyHandler
+ *  @param[in]	metaDataFifoIn
+ *  @param[in]	portTable2rxEng_rsp
+ *  @param[in]	tupleBufferIn
+ *  @param[out]	rxEng2sLookup_req
+ *  @param[out]	rxEng2timer_synQuery
+ *  @param[out]	lookupMetaFifo
  */
 void rxMetadataHandler(	stream<rxEngineMetaData>&				metaDataFifoIn,
-						stream<sessionLookupReply>&				sLookup2rxEng_rsp,
-						stream<bool>&							portTable2rxEng_rsp,
+						stream<portCheckReply>&					portTable2rxEng_rsp,
 						stream<fourTuple>&						tupleBufferIn,
 						stream<sessionLookupQuery>&				rxEng2sLookup_req,
-						stream<extendedEvent>&					rxEng2eventEng_setEvent,
-						stream<bool>&							dropDataFifoOut,
-						stream<rxFsmMetaData>&					fsmMetaDataFifo)
+						stream<timeWaitQuery>&					rxEng2timer_synQuery,
+						stream<rxLookupMetaData>&				lookupMetaFifo)
 {
 #pragma HLS INLINE off
 #pragma HLS pipeline II=1
 
-	static rxEngineMetaData mh_meta;
-	static sessionLookupReply mh_lup;
-	enum mhStateType {META, LOOKUP};
-	static mhStateType mh_state = META;
-	static ap_uint<32> mh_srcIpAddress;
-	static ap_uint<16> mh_dstIpPort;
+	// Free running cycle counter, its top bits are the period of the SYN cookie secret
+	static ap_uint<SYN_COOKIE_PERIOD_SHIFT+SYN_COOKIE_PERIOD_BITS> mh_clock = 0;
+	static ap_uint<3> mh_synTag = 0;
 
+	rxEngineMetaData meta;
 	fourTuple tuple;
+	portCheckReply portReply;
 	bool portIsOpen;
+	bool passiveSyn;
+	ap_uint<SYN_COOKIE_PERIOD_BITS> cookiePeriod = mh_clock(SYN_COOKIE_PERIOD_SHIFT+SYN_COOKIE_PERIOD_BITS-1, SYN_COOKIE_PERIOD_SHIFT);
+
+	mh_clock++;
+
+	if (!metaDataFifoIn.empty() && !portTable2rxEng_rsp.empty() && !tupleBufferIn.empty())
+	{
+		metaDataFifoIn.read(meta);
+		portTable2rxEng_rsp.read(portReply);
+		tupleBufferIn.read(tuple);
+		portIsOpen = portReply.open;
+		passiveSyn = (portIsOpen && meta.syn && !meta.ack && !meta.rst && !meta.fin);
+		meta.synCookie = false;
+		meta.bufferClass = portReply.bufferClass;
+		if (portIsOpen)
+		{
+#if (TCP_SYN_COOKIES)
+			// A SYN does not create a session, it is answered with a cookie. The entry is created by the ACK
+			// returning it, SEQ-1 is the ISN of the peer and ACK-1 the cookie
+			meta.synCookie = (meta.ack && !meta.syn && !meta.rst && !meta.fin
+								&& synCookieCheck(tuple.srcIp, tuple.srcPort, tuple.dstIp, tuple.dstPort,
+													meta.seqNumb-1, meta.ackNumb-1, cookiePeriod));
+			rxEng2sLookup_req.write(sessionLookupQuery(tuple, (meta.syn && meta.ack && !meta.rst && !meta.fin) || meta.synCookie));
+#else
+			// Make session lookup, only allow creation of new entry when SYN or SYN_ACK
+			rxEng2sLookup_req.write(sessionLookupQuery(tuple, (meta.syn && !meta.rst && !meta.fin)));
+#endif
+		}
+		// A SYN may reopen a connection in TIME-WAIT (RFC 1122 4.2.2.13), its record is looked up alongside
+		if (passiveSyn)
+		{
+			rxEng2timer_synQuery.write(timeWaitQuery(tuple, false, mh_synTag));
+		}
+		lookupMetaFifo.write(rxLookupMetaData(meta, tuple, cookiePeriod, portIsOpen, passiveSyn, mh_synTag));
+		if (passiveSyn)
+		{
+			mh_synTag++;
+		}
+	}
+}
 
-	switch (mh_state)
+/** @ingroup rx_engine
+ *  Takes the segments in the order the @ref rxMetadataHandler issued their lookups, the session lookup
+ *  controller answers in the same order. Segments to a closed port are answered with a RST, segments
+ *  with a session are passed on to the @ref rxFsmRequestIssuer. Segments without a session are looked
+ *  up in the TIME-WAIT records of the @ref close_timer. A SYN is joined with the reply to its own
+ *  TIME-WAIT lookup, a matching record rejects it unless its ISN is beyond the ACK of the record.
+ *  A rejected SYN without a session is answered with the ACK of the record, one that created its
+ *  session is passed on and released by the @ref rxTcpFSM.
+ *  @param[in]	lookupMetaFifo
+ *  @param[in]	sLookup2rxEng_rsp
+ *  @param[in]	timer2rxEng_timeWaitRsp
+ *  @param[in]	timer2rxEng_synRsp
+ *  @param[out]	rxEng2timer_timeWaitQuery
+ *  @param[out]	rxEng2eventEng_setEvent
+ *  @param[out]	dropDataFifoOut
+ *  @param[out]	fsmMetaDataFifo
+ */
+void rxLookupReplyHandler(	stream<rxLookupMetaData>&			lookupMetaFifo,
+							stream<sessionLookupReply>&			sLookup2rxEng_rsp,
+							stream<timeWaitReply>&				timer2rxEng_timeWaitRsp,
+							stream<timeWaitReply>&				timer2rxEng_synRsp,
+							stream<timeWaitQuery>&				rxEng2timer_timeWaitQuery,
+							stream<extendedEvent>&				rxEng2eventEng_setEvent,
+							stream<bool>&						dropDataFifoOut,
+							stream<rxFsmMetaData>&				fsmMetaDataFifo)
+{
+#pragma HLS INLINE off
+#pragma HLS pipeline II=1
+
+	static rxLookupMetaData lr_meta;
+	enum lrStateType {META, LOOKUP, TIME_WAIT_LOOKUP};
+	static lrStateType lr_state = META;
+
+	sessionLookupReply lup;
+	timeWaitReply twReply;
+	timeWaitReply synReply;
+	bool reject;
+	ap_uint<32> srcIpAddress;
+	ap_uint<16> dstIpPort;
+
+	switch (lr_state)
 	{
 	case META:
-		if (!metaDataFifoIn.empty() && !portTable2rxEng_rsp.empty() && !tupleBufferIn.empty())
+		if (!lookupMetaFifo.empty())
 		{
-			metaDataFifoIn.read(mh_meta);
-			portTable2rxEng_rsp.read(portIsOpen);
-			tupleBufferIn.read(tuple);
-			mh_srcIpAddress(7, 0) = tuple.srcIp(31, 24);
-			mh_srcIpAddress(15, 8) = tuple.srcIp(23, 16);
-			mh_srcIpAddress(23, 16) = tuple.srcIp(15, 8);
-			mh_srcIpAddress(31, 24) = tuple.srcIp(7, 0);
-			mh_dstIpPort(7, 0) = tuple.dstPort(15, 8);
-			mh_dstIpPort(15, 8) = tuple.dstPort(7, 0);
+			lookupMetaFifo.read(lr_meta);
 			// CHeck if port is closed
-			if (!portIsOpen)
+			if (!lr_meta.portOpen)
 			{
 				// SEND RST+ACK
-				if (!mh_meta.rst)
+				if (!lr_meta.meta.rst)
 				{
 					// send necesssary tuple through event
-					fourTuple switchedTuple;
-					switchedTuple.srcIp = tuple.dstIp;
-					switchedTuple.dstIp = tuple.srcIp;
-					switchedTuple.srcPort = tuple.dstPort;
-					switchedTuple.dstPort = tuple.srcPort;
-					if (mh_meta.syn || mh_meta.fin)
+					if (lr_meta.meta.syn || lr_meta.meta.fin)
 					{
-						rxEng2eventEng_setEvent.write(extendedEvent(rstEvent(mh_meta.seqNumb+mh_meta.length+1), switchedTuple)); //always 0
+						rxEng2eventEng_setEvent.write(extendedEvent(rstEvent(lr_meta.meta.seqNumb+lr_meta.meta.length+1), rxReplyTuple(lr_meta.tuple))); //always 0
 					}
 					else
 					{
-						rxEng2eventEng_setEvent.write(extendedEvent(rstEvent(mh_meta.seqNumb+mh_meta.length), switchedTuple));
+						rxEng2eventEng_setEvent.write(extendedEvent(rstEvent(lr_meta.meta.seqNumb+lr_meta.meta.length), rxReplyTuple(lr_meta.tuple)));
 					}
 				}
 				//else ignore => do nothing
-				if (mh_meta.length != 0)
+				if (lr_meta.meta.length != 0)
 				{
 					dropDataFifoOut.write(true);
 				}
 			}
 			else
 			{
-				// Make session lookup, only allow creation of new entry when SYN or SYN_ACK
-				rxEng2sLookup_req.write(sessionLookupQuery(tuple, (mh_meta.syn && !mh_meta.rst && !mh_meta.fin)));
-				mh_state = LOOKUP;
+				lr_state = LOOKUP;
 			}
 		}
 		break;
-	case LOOKUP: //BIG delay here, waiting for LOOKup
-		if (!sLookup2rxEng_rsp.empty())
+	case LOOKUP:
+		if (!sLookup2rxEng_rsp.empty() && (!lr_meta.timeWaitCheck || !timer2rxEng_synRsp.empty()))
 		{
-			sLookup2rxEng_rsp.read(mh_lup);
-			if (mh_lup.hit)
+			sLookup2rxEng_rsp.read(lup);
+			synReply = timeWaitReply(false, 0, 0);
+			if (lr_meta.timeWaitCheck)
 			{
-				//Write out lup and meta
-				fsmMetaDataFifo.write(rxFsmMetaData(mh_lup.sessionID, mh_srcIpAddress, mh_dstIpPort, mh_meta));
+				timer2rxEng_synRsp.read(synReply);
 			}
-			if (mh_meta.length != 0)
+			// RFC 1122 4.2.2.13, the new ISN has to be beyond the sequence space of the old connection
+			reject = (synReply.hit && synReply.tag == lr_meta.tag
+						&& (ap_int<32>)(lr_meta.meta.seqNumb - synReply.ackNumb) <= 0);
+			synReply.hit = reject;
+			if (lup.hit)
 			{
-				dropDataFifoOut.write(!mh_lup.hit);
+				srcIpAddress(7, 0) = lr_meta.tuple.srcIp(31, 24);
+				srcIpAddress(15, 8) = lr_meta.tuple.srcIp(23, 16);
+				srcIpAddress(23, 16) = lr_meta.tuple.srcIp(15, 8);
+				srcIpAddress(31, 24) = lr_meta.tuple.srcIp(7, 0);
+				dstIpPort(7, 0) = lr_meta.tuple.dstPort(15, 8);
+				dstIpPort(15, 8) = lr_meta.tuple.dstPort(7, 0);
+				fsmMetaDataFifo.write(rxFsmMetaData(lup.sessionID, srcIpAddress, dstIpPort, lr_meta.tuple, lr_meta.meta, synReply));
 			}
-			/*if (!mh_lup.hit)
+			else if (reject)
 			{
-				// Port is Open, but we have no sessionID, that matches or is free
-				// For SYN we should time out, for everything else sent RST TODO
-				if (mh_meta.length != 0)
-				{
-					dropDataFifoOut.write(true); // always write???
-				}
-				//mh_state = META;
+				rxEng2eventEng_setEvent.write(extendedEvent(timeWaitEvent(synReply.ackNumb), rxReplyTuple(lr_meta.tuple), synReply.seqNumb));
 			}
-			else
+#if (TCP_SYN_COOKIES)
+			else if (lr_meta.meta.syn && !lr_meta.meta.ack && !lr_meta.meta.rst && !lr_meta.meta.fin)
 			{
-				//Write out lup and meta
-				fsmMetaDataFifo.write(rxFsmMetaData(mh_lup.sessionID, mh_srcIpAddress, mh_dstIpPort, mh_meta));
-
-				// read state
-				/*rxEng2stateTable_upd_req.write(stateQuery(mh_lup.sessionID));
-				// read rxSar & txSar
-				if (!(mh_meta.syn && !mh_meta.rst && !mh_meta.fin)) // Do not read rx_sar for SYN(+ACK)(+ANYTHING) => (!syn || rst || fin
-				{
-					rxEng2rxSar_upd_req.write(rxSarRecvd(mh_lup.sessionID));
-				}
-				if (mh_meta.ack) // Do not read for SYN (ACK+ANYTHING)
-				{
-					rxEng2txSar_upd_req.write(rxTxSarQuery(mh_lup.sessionID));
-				}*/
-				//mh_state = META;
-			//}
-			mh_state = META;
+				// SYN-ACK without a session, the ISN is computed by the tx_engine
+				rxEng2eventEng_setEvent.write(extendedEvent(synCookieEvent(lr_meta.meta.seqNumb+1, lr_meta.cookiePeriod), rxReplyTuple(lr_meta.tuple)));
+			}
+#endif
+			if (lr_meta.meta.length != 0)
+			{
+				dropDataFifoOut.write(!lup.hit || reject);
+			}
+			lr_state = META;
+			// The session may have been closed, stray segments of sessions in TIME-WAIT are answered with an ACK
+			if (!lup.hit && !lr_meta.meta.syn && !lr_meta.meta.rst)
+			{
+				rxEng2timer_timeWaitQuery.write(timeWaitQuery(lr_meta.tuple, lr_meta.meta.fin));
+				lr_state = TIME_WAIT_LOOKUP;
+			}
+		}
+		break;
+	case TIME_WAIT_LOOKUP:
+		if (!timer2rxEng_timeWaitRsp.empty())
+		{
+			timer2rxEng_timeWaitRsp.read(twReply);
+			if (twReply.hit)
+			{
+				rxEng2eventEng_setEvent.write(extendedEvent(timeWaitEvent(twReply.ackNumb), rxReplyTuple(lr_meta.tuple), twReply.seqNumb));
+			}
+			lr_state = META;
 		}
-
 		break;
 	}//switch
 }
 
-void rxTcpFSM(			stream<rxFsmMetaData>&					fsmMetaDataFifo,
-						stream<sessionState>&					stateTable2rxEng_upd_rsp,
-						stream<rxSarEntry>&						rxSar2rxEng_upd_rsp,
-						stream<rxTxSarReply>&					txSar2rxEng_upd_rsp,
+/** @ingroup rx_engine
+ *  Owns the access of the RX engine to the @ref state_table and the @ref session_context_table.
+ *  It issues the table reads for new segments without waiting for the @ref rxTcpFSM to finish the
+ *  previous one, up to RX_FSM_INFLIGHT segments are in flight, and passes on the write backs of the
+ *  @ref rxTcpFSM. A segment retires when its write back is passed on, since reads and write backs
+ *  leave through the same streams a read issued afterwards always sees the update.
+ *  A segment of a session which is already in flight is a hazard. If it directly follows a segment of
+ *  the same session, the @ref rxTcpFSM forwards the values it wrote back for the previous one. The context
+ *  is still read, the fields owned by the @ref tx_engine are taken from the table. Otherwise the segment
+ *  is held back until the older one retired.
+ *  The state is read in any case, this way the session stays locked in the @ref state_table.
+ *  The write backs also report the activity of the session to the @ref keepalive_timer.
+ *  @param[in]		fsmMetaDataFifo
+ *  @param[in]		fsmWriteBackFifo
+ *  @param[out]		rxEng2stateTable_upd_req
+ *  @param[out]		rxEng2ctx_upd_req
+ *  @param[out]		rxEng2timer_setKeepAlive
+ *  @param[out]		fsmIssuedMetaFifo
+ */
+void rxFsmRequestIssuer(stream<rxFsmMetaData>&					fsmMetaDataFifo,
+						stream<rxFsmWriteBack>&					fsmWriteBackFifo,
 						stream<stateQuery>&						rxEng2stateTable_upd_req,
-						stream<rxSarRecvd>&						rxEng2rxSar_upd_req,
-						stream<rxTxSarQuery>&					rxEng2txSar_upd_req,
+						stream<rxSessionCtxQuery>&				rxEng2ctx_upd_req,
+#if (TCP_KEEPALIVE)
+						stream<keepAliveUpdate>&				rxEng2timer_setKeepAlive,
+#endif
+						stream<rxFsmIssuedMeta>&				fsmIssuedMetaFifo)
+{
+#pragma HLS INLINE off
+#pragma HLS pipeline II=1
+
+	// Ring of the session IDs in flight, the newest entry is at ri_head-1
+	static ap_uint<16>		ri_sessionID[RX_FSM_INFLIGHT];
+	#pragma HLS ARRAY_PARTITION variable=ri_sessionID complete
+	static bool				ri_synCookie[RX_FSM_INFLIGHT];
+	#pragma HLS ARRAY_PARTITION variable=ri_synCookie complete
+	static ap_uint<2>		ri_head = 0;
+	static ap_uint<3>		ri_inflightCount = 0;
+	static rxFsmMetaData	ri_meta;
+	static bool				ri_metaValid = false;
+
+	rxFsmWriteBack writeBack;
+	ap_uint<2> lastSlot = ri_head - 1;
+	bool hazard = false;
+	bool forward = false;
+
+	if (!ri_metaValid && !fsmMetaDataFifo.empty())
+	{
+		fsmMetaDataFifo.read(ri_meta);
+		ri_metaValid = true;
+	}
+
+	// Write backs have priority, segments retire in order so the oldest entry of the ring is freed
+	if (!fsmWriteBackFifo.empty())
+	{
+		fsmWriteBackFifo.read(writeBack);
+		rxEng2stateTable_upd_req.write(writeBack.state);
+		// Both parts are written with one request, the mask selects the parts that changed
+		if (writeBack.rxSar.write || writeBack.txSar.write)
+		{
+			rxEng2ctx_upd_req.write(rxSessionCtxQuery(writeBack.rxSar, writeBack.txSar));
+		}
+#if (TCP_KEEPALIVE)
+		// Any segment of a synchronized session restarts its keep-alive timer, a closed session stops it
+		if (writeBack.state.state == CLOSED)
+		{
+			rxEng2timer_setKeepAlive.write(keepAliveUpdate(writeBack.state.sessionID, true));
+		}
+		else if (writeBack.state.state >= ESTABLISHED)
+		{
+			rxEng2timer_setKeepAlive.write(keepAliveUpdate(writeBack.state.sessionID));
+		}
+#endif
+		ri_inflightCount--;
+	}
+	else if (ri_metaValid && ri_inflightCount < RX_FSM_INFLIGHT)
+	{
+		for (ap_uint<3> i = 0; i < RX_FSM_INFLIGHT; i++)
+		{
+		#pragma HLS UNROLL
+			ap_uint<2> slot = ri_head - 1 - i;
+			if (i < ri_inflightCount && ri_sessionID[slot] == ri_meta.sessionID)
+			{
+				hazard = true;
+			}
+		}
+		// The newest segment in flight belongs to the same session. The buffers of a session opened by a SYN cookie
+		// are only assigned by its write back, the next segment has to read the context
+		forward = (ri_inflightCount != 0 && ri_sessionID[lastSlot] == ri_meta.sessionID && !ri_synCookie[lastSlot]);
+
+		if (!hazard || forward)
+		{
+			rxEng2stateTable_upd_req.write(stateQuery(ri_meta.sessionID));
+			// One read returns rxSar and txSar, even though not required for SYN-ACK. A forwarded segment
+			// needs the current values of the fields the tx_engine updates
+			rxEng2ctx_upd_req.write(rxSessionCtxQuery(ri_meta.sessionID));
+			fsmIssuedMetaFifo.write(rxFsmIssuedMeta(ri_meta, forward));
+			ri_sessionID[ri_head] = ri_meta.sessionID;
+			ri_synCookie[ri_head] = ri_meta.meta.synCookie;
+			ri_head++;
+			ri_inflightCount++;
+			ri_metaValid = false;
+		}
+	}
+}
+
+/** @ingroup rx_engine
+ *  Main TCP state machine, evaluates one segment per cycle as soon as the table replies for the
+ *  oldest segment in flight are available. For forwarded segments the values written back by
+ *  the previous segment of the same session are used instead of the table reply, except for the
+ *  fields the @ref tx_engine owns: the next sequence number, the timed segment and the clocks.
+ *  All table updates of a segment are collected in a single write back, it always contains
+ *  the state, which releases the lock in the @ref state_table.
+ */
+void rxTcpFSM(			stream<rxFsmIssuedMeta>&				fsmIssuedMetaFifo,
+						stream<sessionState>&					stateTable2rxEng_upd_rsp,
+						stream<rxSessionCtxReply>&				ctx2rxEng_upd_rsp,
+						stream<rxFsmWriteBack>&					fsmWriteBackFifo,
 						stream<rxRetransmitTimerUpdate>&		rxEng2timer_clearRetransmitTimer,
 						stream<ap_uint<16> >&					rxEng2timer_clearProbeTimer,
-						stream<ap_uint<16> >&					rxEng2timer_setCloseTimer,
+						stream<timeWaitEntry>&					rxEng2timer_setCloseTimer,
+#if (TCP_PACING)
+						stream<pacerRateUpdate>&				rxEng2pacer_setRate,
+#endif
 						stream<openStatus>&						openConStatusOut,
-						stream<event>&							rxEng2eventEng_setEvent,
+						stream<extendedEvent>&					rxEng2eventEng_setEvent,
 						stream<bool>&							dropDataFifoOut,
 #if !(RX_DDR_BYPASS)
-						stream<mmCmd>&							rxBufferWriteCmd,
+						stream<mmBufferCmd>&					rxBufferWriteCmd,
 						stream<appNotification>&				rxEng2rxApp_notification)
 #else
 						stream<appNotification>&				rxEng2rxApp_notification,
@@ -717,46 +1015,191 @@ void rxTcpFSM(			stream<rxFsmMetaData>&					fsmMetaDataFifo,
 #pragma HLS INLINE off
 #pragma HLS pipeline II=1
 
-
-	enum fsmStateType {LOAD, TRANSITION};
-	static fsmStateType fsm_state = LOAD;
-
 	static rxFsmMetaData fsm_meta;
-	static bool fsm_txSarRequest = false;
-
-
+	static bool fsm_metaValid = false;
+	static bool fsm_forward = false;
+	// Values written back by the last segment, forwarded to the next one if it belongs to the same session
+	static sessionState fsm_fwdState;
+	static rxSarEntry fsm_fwdRxSar;
+	static rxTxSarReply fsm_fwdTxSar;
+	// The previous segment ended the RTT measurement or started a new CUBIC epoch, the table only knows after its write back
+	static bool fsm_fwdRttEnded = false;
+	static bool fsm_fwdNewEpoch = false;
+
+	rxFsmIssuedMeta issuedMeta;
+	rxFsmWriteBack writeBack;
 	ap_uint<4> control_bits = 0;
+	ap_uint<32> scaledWindow;
+	ap_uint<WINDOW_BITS> recvWindow;
+	ap_uint<4> rxWinShift;
+	ap_uint<4> txWinShift;
+	bool sackOk;
+	bool ecnOk;
+	bool ceState;
+	bool tsOk;
+	bool tsNewer;
+	bool pawsReject;
+	ap_uint<32> tsRecent;
+	ap_uint<32> tsDelta;
+	bool ecnReduced = false;
+	bool fastRetransmit = false;
+	bool partialAck = false;
+	ap_uint<WINDOW_BITS> ackedBytes;
+	ap_uint<WINDOW_BITS+1> newWindow;
+	bool rttSampleValid;
+	bool ccNewEpoch = false;
+	ap_uint<32> rttSample;
+	ap_uint<32> rttDelta;
+	ap_uint<32> srtt;
+	ap_uint<32> rttvar;
+	ap_uint<34> rto;
+	ap_uint<34> pto;
 	sessionState tcpState;
+	sessionState nextState;
 	rxSarEntry rxSar;
 	rxTxSarReply txSar;
+	rxSessionCtxReply ctxReply;
 
+	if (!fsm_metaValid && !fsmIssuedMetaFifo.empty())
+	{
+		fsmIssuedMetaFifo.read(issuedMeta);
+		fsm_meta = issuedMeta.fsm;
+		fsm_forward = issuedMeta.forward;
+		fsm_metaValid = true;
+	}
 
-	switch(fsm_state)
+	if (fsm_metaValid && !stateTable2rxEng_upd_rsp.empty() && !ctx2rxEng_upd_rsp.empty())
 	{
-	case LOAD:
-		if (!fsmMetaDataFifo.empty())
+		// State and context are read for every segment, on a forward the values the RX engine owns are outdated
+		stateTable2rxEng_upd_rsp.read(tcpState);
+		ctx2rxEng_upd_rsp.read(ctxReply);
+		rxSar = ctxReply.rxSar;
+		txSar = ctxReply.txSar;
+		if (fsm_forward)
 		{
-			fsmMetaDataFifo.read(fsm_meta);
-			// read state
-			rxEng2stateTable_upd_req.write(stateQuery(fsm_meta.sessionID));
-			// Always read rxSar, even though not required for SYN-ACK
-			rxEng2rxSar_upd_req.write(rxSarRecvd(fsm_meta.sessionID));
-			// read txSar
-			if (fsm_meta.meta.ack) // Do not read for SYN (ACK+ANYTHING)
+			tcpState = fsm_fwdState;
+			rxSar = fsm_fwdRxSar;
+			txSar.prevAck = fsm_fwdTxSar.prevAck;
+			txSar.cong_window = fsm_fwdTxSar.cong_window;
+			txSar.slowstart_threshold = fsm_fwdTxSar.slowstart_threshold;
+			txSar.win_shift = fsm_fwdTxSar.win_shift;
+			txSar.count = fsm_fwdTxSar.count;
+			txSar.fastRetransmitted = fsm_fwdTxSar.fastRetransmitted;
+			txSar.recover = fsm_fwdTxSar.recover;
+			txSar.cc = fsm_fwdTxSar.cc;
+			txSar.srtt = fsm_fwdTxSar.srtt;
+			txSar.rttvar = fsm_fwdTxSar.rttvar;
+			txSar.rto = fsm_fwdTxSar.rto;
+			if (fsm_fwdNewEpoch)
 			{
-				rxEng2txSar_upd_req.write(rxTxSarQuery(fsm_meta.sessionID));
-				fsm_txSarRequest  = true;
+				txSar.cc_elapsed = 0;
+			}
+			// The timed segment is only replaced by the tx_engine once the table cleared it
+			if (fsm_fwdRttEnded && txSar.rtt_seq == fsm_fwdTxSar.rtt_seq)
+			{
+				txSar.rtt_active = false;
 			}
-			fsm_state = TRANSITION;
 		}
-		break;
-	case TRANSITION:
-		// Check if transition to LOAD occurs
-		if (!stateTable2rxEng_upd_rsp.empty() && !rxSar2rxEng_upd_rsp.empty()
-						&& !(fsm_txSarRequest && txSar2rxEng_upd_rsp.empty()))
+		nextState = tcpState;
+		writeBack = rxFsmWriteBack(fsm_meta.sessionID);
+		fsm_fwdRxSar = rxSar;
+		fsm_fwdTxSar = txSar;
+		fsm_fwdRttEnded = false;
+		fsm_fwdNewEpoch = false;
+
+		// Windows of synchronized segments are scaled by the shift the peer announced,
+		// anything beyond our own buffer can not be used anyway
+		scaledWindow = ((ap_uint<32>) fsm_meta.meta.winSize) << txSar.win_shift;
+		recvWindow = (scaledWindow < BUFFER_SIZE) ? (ap_uint<WINDOW_BITS>) scaledWindow : (ap_uint<WINDOW_BITS>) (BUFFER_SIZE-1);
+		// Scaling is only in effect if both sides sent the option, we only send it if WINDOW_SCALE_BITS != 0
+		rxWinShift = 0;
+		txWinShift = 0;
+		if (fsm_meta.meta.winScaleValid && WINDOW_SCALE_BITS != 0)
+		{
+			rxWinShift = WINDOW_SCALE_BITS;
+			txWinShift = fsm_meta.meta.winScale;
+		}
+		sackOk = (fsm_meta.meta.sackPermitted && TCP_SACK);
+		// ECN-setup SYN has ECE and CWR set, ECN-setup SYN-ACK only ECE, RFC 3168 6.1.1
+		ecnOk = (TCP_ECN && fsm_meta.meta.ece && (fsm_meta.meta.cwr != fsm_meta.meta.ack));
+		// Timestamps are used if the SYN and the SYN-ACK carried the option, RFC 7323 3.2
+		tsOk = (TCP_TIMESTAMPS && fsm_meta.meta.tsValid);
+		// PAWS, RFC 7323 5.3. A segment of a synchronized session with a TSval older than TS.Recent is an old duplicate
+		tsNewer = ((ap_uint<32>) (fsm_meta.meta.tsVal - rxSar.ts_recent)) < 0x80000000;
+		pawsReject = (rxSar.ts_ok && fsm_meta.meta.tsValid && !tsNewer && !fsm_meta.meta.rst
+						&& tcpState != CLOSED && tcpState != SYN_SENT);
+		// TS.Recent is taken from segments starting at or before the sequence number we acknowledge, RFC 7323 4.3
+		tsRecent = rxSar.ts_recent;
+		if (rxSar.ts_ok && fsm_meta.meta.tsValid && tsNewer
+				&& ((ap_uint<32>) (rxSar.recvd - fsm_meta.meta.seqNumb)) < 0x80000000)
+		{
+			tsRecent = fsm_meta.meta.tsVal;
+		}
+		// CE state of the last data segment, ACKs echo it with ECE, RFC 8257 3.2
+		ceState = (fsm_meta.meta.length != 0) ? fsm_meta.meta.ce : rxSar.ce;
+
+		// RTT estimation, RFC 6298. The sample is taken once the segment timed by the session_context_table is acknowledged
+		srtt = txSar.srtt;
+		rttvar = txSar.rttvar;
+		rto = txSar.rto;
+		rttSampleValid = (fsm_meta.meta.ack && txSar.rtt_active
+							&& ((ap_uint<32>) (fsm_meta.meta.ackNumb - txSar.rtt_seq)) <= ((ap_uint<32>) (txSar.nextByte - txSar.rtt_seq)));
+		rttSample = (txSar.rtt_elapsed != 0) ? txSar.rtt_elapsed : (ap_uint<32>) 1;
+#if TCP_TIMESTAMPS
+		// With timestamps every ACK of new data is a sample, retransmissions included, RFC 7323 4.1.
+		// The TSecr is only trusted if the sample fits into 32 bits of clock cycles
+		tsDelta = txSar.ts_clock - fsm_meta.meta.tsEcr;
+		if (rxSar.ts_ok && fsm_meta.meta.tsValid && fsm_meta.meta.ack && !pawsReject
+				&& fsm_meta.meta.ackNumb != txSar.prevAck
+				&& ((ap_uint<32>) (fsm_meta.meta.ackNumb - txSar.prevAck)) <= ((ap_uint<32>) (txSar.nextByte - txSar.prevAck))
+				&& tsDelta(31, 32-TS_CLOCK_SHIFT) == 0)
+		{
+			rttSampleValid = true;
+			rttSample = tsDelta << TS_CLOCK_SHIFT;
+			if (rttSample == 0)
+			{
+				rttSample = 1;
+			}
+		}
+#endif
+		if (rttSampleValid)
+		{
+			if (txSar.srtt == 0) // First measurement
+			{
+				srtt = rttSample;
+				rttvar = rttSample / 2;
+			}
+			else
+			{
+				rttDelta = (txSar.srtt > rttSample) ? (ap_uint<32>) (txSar.srtt - rttSample) : (ap_uint<32>) (rttSample - txSar.srtt);
+				// RTTVAR = 3/4 * RTTVAR + 1/4 * |SRTT - R'|, SRTT = 7/8 * SRTT + 1/8 * R'
+				rttvar = txSar.rttvar - (txSar.rttvar >> 2) + (rttDelta >> 2);
+				srtt = txSar.srtt - (txSar.srtt >> 3) + (rttSample >> 3);
+			}
+			// RTO = SRTT + max(G, 4 * RTTVAR), the clock granularity G is one timer tick
+			rto = ((ap_uint<34>) rttvar) << 2;
+			if (rto < RTT_CYCLES_PER_TICK)
+			{
+				rto = RTT_CYCLES_PER_TICK;
+			}
+			rto = ((rto + srtt) / RTT_CYCLES_PER_TICK) + 1;
+			if (rto < TCP_RTO_MIN)
+			{
+				rto = TCP_RTO_MIN;
+			}
+			else if (rto > TCP_RTO_MAX)
+			{
+				rto = TCP_RTO_MAX;
+			}
+		}
+		// Probe timeout of the tail loss probe, RFC 8985 7.2. Without an SRTT it equals the initial RTO and no probe is sent
+		if (srtt == 0)
+		{
+			pto = TCP_RTO_INIT;
+		}
+		else
 		{
-			fsm_state = LOAD;
-			fsm_txSarRequest = false;
+			pto = ((((ap_uint<34>) srtt) << 1) / RTT_CYCLES_PER_TICK) + TCP_TLP_ACK_DELAY;
 		}
 
 		control_bits[0] = fsm_meta.meta.ack;
@@ -766,284 +1209,479 @@ void rxTcpFSM(			stream<rxFsmMetaData>&					fsmMetaDataFifo,
 		switch (control_bits)
 		{
 		case 1: //ACK
-			//if (!rxSar2rxEng_upd_rsp.empty() && !stateTable2rxEng_upd_rsp.empty() && !txSar2rxEng_upd_rsp.empty())
-			if (fsm_state == LOAD)
+#if (TCP_SYN_COOKIES)
+			// Completes a handshake answered with a SYN cookie, the session goes to ESTABLISHED right away.
+			// The options of the SYN are lost, data of the ACK is dropped and retransmitted by the peer
+			if (fsm_meta.meta.synCookie && tcpState == CLOSED)
 			{
-				stateTable2rxEng_upd_rsp.read(tcpState);
-				rxSar2rxEng_upd_rsp.read(rxSar);
-				txSar2rxEng_upd_rsp.read(txSar);
-				rxEng2timer_clearRetransmitTimer.write(rxRetransmitTimerUpdate(fsm_meta.sessionID, (fsm_meta.meta.ackNumb == txSar.nextByte)));
-				if (tcpState == ESTABLISHED || tcpState == SYN_RECEIVED || tcpState == FIN_WAIT_1 || tcpState == CLOSING || tcpState == LAST_ACK)
+				writeBack.rxSar = rxSarRecvd(fsm_meta.sessionID, fsm_meta.meta.seqNumb, 1, 1);
+				writeBack.txSar = rxTxSarQuery(fsm_meta.sessionID, fsm_meta.meta.ackNumb, fsm_meta.meta.winSize, txSar.cong_window, txSar.slowstart_threshold, 0, 0, false);
+				writeBack.txSar.init = true;
+				if (fsm_meta.meta.length != 0)
 				{
-					// Check if new ACK arrived
-					if (fsm_meta.meta.ackNumb == txSar.prevAck && txSar.prevAck != txSar.nextByte)
+					dropDataFifoOut.write(true);
+				}
+				nextState = ESTABLISHED;
+				break;
+			}
+#endif
+#if TCP_TIMESTAMPS
+			if (pawsReject)
+			{
+				// Old duplicate, dropped and answered with an ACK, RFC 7323 5.3 R1
+				rxEng2eventEng_setEvent.write(event(ACK_NODELAY, fsm_meta.sessionID));
+				if (fsm_meta.meta.length != 0)
+				{
+					dropDataFifoOut.write(true);
+				}
+				break;
+			}
+#endif
+			rxEng2timer_clearRetransmitTimer.write(rxRetransmitTimerUpdate(fsm_meta.sessionID, (fsm_meta.meta.ackNumb == txSar.nextByte), rto, pto));
+			if (tcpState == ESTABLISHED || tcpState == SYN_RECEIVED || tcpState == FIN_WAIT_1 || tcpState == CLOSING || tcpState == LAST_ACK)
+			{
+				// Check if new ACK arrived
+				if (fsm_meta.meta.ackNumb == txSar.prevAck && txSar.prevAck != txSar.nextByte)
+				{
+					// Not new ACK increase counter only if it does not contain data
+					if (fsm_meta.meta.length == 0 && txSar.count != 3)
 					{
-						// Not new ACK increase counter only if it does not contain data
-						if (fsm_meta.meta.length == 0)
-						{
-							txSar.count++;
-						}
+						txSar.count++;
+					}
+#if FAST_RETRANSMIT
+					// NewReno fast retransmit, RFC 6582 3.2. Duplicate ACKs of data sent before the last
+					// recovery or timeout ended do not start another one
+					if (txSar.count == 3 && !txSar.fastRetransmitted
+							&& ((ap_uint<32>) (fsm_meta.meta.ackNumb - txSar.recover)) < 0x80000000)
+					{
+						ccLossDetected(txSar.cong_window, txSar.slowstart_threshold, txSar.cc, txSar.nextByte - txSar.prevAck, false);
+						ccNewEpoch = true;
+						// The three duplicate ACKs were caused by segments that left the network
+						newWindow = txSar.cong_window + 3*MSS;
+						txSar.recover = txSar.nextByte;
+						txSar.fastRetransmitted = true;
+						fastRetransmit = true;
+					}
+					else if (txSar.fastRetransmitted && fsm_meta.meta.length == 0)
+					{
+						// Each further duplicate ACK inflates the window by one segment
+						newWindow = txSar.cong_window + MSS;
 					}
 					else
 					{
-						// Notify probeTimer about new ACK
-						rxEng2timer_clearProbeTimer.write(fsm_meta.sessionID);
-						// Check for SlowStart & Increase Congestion Window
-						if (txSar.cong_window <= (txSar.slowstart_threshold-MSS))
+						newWindow = txSar.cong_window;
+					}
+					txSar.cong_window = (newWindow < BUFFER_SIZE) ? (ap_uint<WINDOW_BITS>) newWindow : (ap_uint<WINDOW_BITS>) (BUFFER_SIZE-1);
+#endif
+				}
+				else
+				{
+					// Notify probeTimer about new ACK
+					rxEng2timer_clearProbeTimer.write(fsm_meta.sessionID);
+					ackedBytes = fsm_meta.meta.ackNumb - txSar.prevAck;
+					if (txSar.fastRetransmitted)
+					{
+						if (((ap_uint<32>) (fsm_meta.meta.ackNumb - txSar.recover)) >= 0x80000000)
 						{
-							txSar.cong_window += MSS;
+							// Partial ACK, the next hole is resent right away. The window is deflated by the
+							// acknowledged data and one segment is added back, RFC 6582 3.2 step 5
+							newWindow = (txSar.cong_window > ackedBytes) ? (ap_uint<WINDOW_BITS>) (txSar.cong_window - ackedBytes) : (ap_uint<WINDOW_BITS>) 0;
+							if (ackedBytes >= MSS)
+							{
+								newWindow += MSS;
+							}
+							if (newWindow < MSS)
+							{
+								newWindow = MSS;
+							}
+							partialAck = true;
 						}
-						else if (txSar.cong_window <= 0xF7FF)
+						else
+						{
+							// Full ACK, recovery ends with min(ssthresh, FlightSize + MSS), RFC 6582 3.2 step 6
+							newWindow = ((ap_uint<WINDOW_BITS>) (txSar.nextByte - fsm_meta.meta.ackNumb)) + MSS;
+							if (newWindow > txSar.slowstart_threshold)
+							{
+								newWindow = txSar.slowstart_threshold;
+							}
+							txSar.fastRetransmitted = false;
+						}
+						txSar.cong_window = (newWindow < BUFFER_SIZE) ? (ap_uint<WINDOW_BITS>) newWindow : (ap_uint<WINDOW_BITS>) (BUFFER_SIZE-1);
+					}
+					else
+					{
+						// Increase Congestion Window
+						ccAckReceived(txSar.cong_window, txSar.slowstart_threshold, txSar.cc, ackedBytes, txSar.cc_elapsed);
+#if TCP_ECN
+						if (rxSar.ecn_ok)
 						{
-							txSar.cong_window += 365; //TODO replace by approx. of (MSS x MSS) / cong_window
+							ecnReduced = ccEcnEchoReceived(txSar.cong_window, txSar.slowstart_threshold, txSar.cc, ackedBytes,
+															fsm_meta.meta.ece, fsm_meta.meta.ackNumb, txSar.nextByte);
+							ccNewEpoch = ecnReduced;
 						}
-						txSar.count = 0;
-						txSar.fastRetransmitted = false;
+#endif
 					}
-					// TX SAR
-					if ((txSar.prevAck <= fsm_meta.meta.ackNumb && fsm_meta.meta.ackNumb <= txSar.nextByte)
-							|| ((txSar.prevAck <= fsm_meta.meta.ackNumb || fsm_meta.meta.ackNumb <= txSar.nextByte) && txSar.nextByte < txSar.prevAck))
+					txSar.count = 0;
+				}
+				// TX SAR
+				if ((txSar.prevAck <= fsm_meta.meta.ackNumb && fsm_meta.meta.ackNumb <= txSar.nextByte)
+						|| ((txSar.prevAck <= fsm_meta.meta.ackNumb || fsm_meta.meta.ackNumb <= txSar.nextByte) && txSar.nextByte < txSar.prevAck))
+				{
+					writeBack.txSar = rxTxSarQuery(fsm_meta.sessionID, fsm_meta.meta.ackNumb, recvWindow, txSar.cong_window, txSar.slowstart_threshold, txSar.win_shift, txSar.count, txSar.fastRetransmitted);
+					// Every ACK replaces the SACK scoreboard, an ACK without blocks clears it
+					for (int i = 0; i < TCP_SACK_BLOCKS; i++)
 					{
-						rxEng2txSar_upd_req.write((rxTxSarQuery(fsm_meta.sessionID, fsm_meta.meta.ackNumb, fsm_meta.meta.winSize, txSar.cong_window, txSar.count, ((txSar.count == 3) || txSar.fastRetransmitted))));
+					#pragma HLS UNROLL
+						writeBack.txSar.sackBoard.left[i] = fsm_meta.meta.sackLeft[i](WINDOW_BITS-1, 0);
+						writeBack.txSar.sackBoard.right[i] = fsm_meta.meta.sackRight[i](WINDOW_BITS-1, 0);
 					}
+					writeBack.txSar.sackBoard.count = fsm_meta.meta.sackCount;
+					fsm_fwdTxSar = rxTxSarReply(fsm_meta.meta.ackNumb, txSar.nextByte, txSar.cong_window, txSar.slowstart_threshold, txSar.win_shift, txSar.count, txSar.fastRetransmitted);
+				}
 
-					// Check if packet contains payload
-					if (fsm_meta.meta.length != 0)
-					{
-						ap_uint<32> newRecvd = fsm_meta.meta.seqNumb+fsm_meta.meta.length;
-						// Second part makes sure that app pointer is not overtaken
+				// Out-of-order arrivals and filled holes are ACKed immediately, RFC 5681 4.2
+				bool ackNoDelay = false;
+				// Check if packet contains payload
+				if (fsm_meta.meta.length != 0)
+				{
+					ap_uint<32> newRecvd = fsm_meta.meta.seqNumb+fsm_meta.meta.length;
+					// Build memory address
+					ap_uint<32> pkgAddr;
+					pkgAddr(31, 30) = 0x0;
+					pkgAddr(29, 0) = rxSar.buffer.address(fsm_meta.meta.seqNumb(WINDOW_BITS-1, 0));
+					// Second part makes sure that app pointer is not overtaken
 #if !(RX_DDR_BYPASS)
-						ap_uint<16> free_space = ((rxSar.appd - rxSar.recvd(15, 0)) - 1);
-						// Check if segment in order and if enough free space is available
-						if ((fsm_meta.meta.seqNumb == rxSar.recvd) && (free_space > fsm_meta.meta.length))
+					ap_uint<WINDOW_BITS> free_space = ((rxSar.appd - rxSar.recvd(WINDOW_BITS-1, 0)) - 1) & rxSar.buffer.mask();
+					// All offsets are relative to recvd, this way sequence number wrap around is handled implicitly
+					ap_uint<32> segStart = fsm_meta.meta.seqNumb - rxSar.recvd;
+					ap_uint<32> segEnd = segStart + fsm_meta.meta.length;
+					ap_uint<32> oooStart = rxSar.ooo_head - rxSar.recvd;
+					ap_uint<32> oooEnd = oooStart + rxSar.ooo_length;
+					// Check if segment in order and if enough free space is available
+					if ((fsm_meta.meta.seqNumb == rxSar.recvd) && (free_space > fsm_meta.meta.length))
 #else
-						if ((fsm_meta.meta.seqNumb == rxSar.recvd) && ((rxbuffer_max_data_count - rxbuffer_data_count) > 375))
+					if ((fsm_meta.meta.seqNumb == rxSar.recvd) && ((rxbuffer_max_data_count - rxbuffer_data_count) > 375))
 #endif
-						{
-							rxEng2rxSar_upd_req.write(rxSarRecvd(fsm_meta.sessionID, newRecvd, 1));
-							// Build memory address
-							ap_uint<32> pkgAddr;
-							pkgAddr(31, 30) = 0x0;
-							pkgAddr(29, 16) = fsm_meta.sessionID(13, 0);
-							pkgAddr(15, 0) = fsm_meta.meta.seqNumb(15, 0);
+					{
 #if !(RX_DDR_BYPASS)
-							rxBufferWriteCmd.write(mmCmd(pkgAddr, fsm_meta.meta.length));
-#endif
-							// Only notify about  new data available
-							rxEng2rxApp_notification.write(appNotification(fsm_meta.sessionID, fsm_meta.meta.length, fsm_meta.srcIpAddress, fsm_meta.dstIpPort));
-							dropDataFifoOut.write(false);
-						}
-						else
+						ap_uint<16> notifyLength = fsm_meta.meta.length;
+						bool oooValid = rxSar.ooo_valid;
+						// Check if segment closes the hole in front of the out-of-order interval
+						if (rxSar.ooo_valid && segEnd >= oooStart)
 						{
-							dropDataFifoOut.write(true);
+							// Advance over the already buffered data in one step
+							if (oooEnd > segEnd)
+							{
+								newRecvd = rxSar.ooo_head + rxSar.ooo_length;
+								notifyLength = oooEnd(15, 0);
+							}
+							oooValid = false;
+							ackNoDelay = true;
 						}
-
-						// Sent ACK
-						//rxEng2eventEng_setEvent.write(event(ACK, fsm_meta.sessionID));
-					}
-#if FAST_RETRANSMIT
-					if (txSar.count == 3 && !txSar.fastRetransmitted)
-					{
-						rxEng2eventEng_setEvent.write(event(RT, fsm_meta.sessionID));
-					}
-					else if (fsm_meta.meta.length != 0)
+						writeBack.rxSar = rxSarRecvd(fsm_meta.sessionID, newRecvd, rxSar.ooo_head, rxSar.ooo_length, oooValid);
+						fsm_fwdRxSar.recvd = newRecvd;
+						fsm_fwdRxSar.ooo_valid = oooValid;
+						rxBufferWriteCmd.write(mmBufferCmd(mmCmd(pkgAddr, fsm_meta.meta.length), rxSar.buffer));
+						// Only notify about  new data available
+						rxEng2rxApp_notification.write(appNotification(fsm_meta.sessionID, notifyLength, fsm_meta.srcIpAddress, fsm_meta.dstIpPort));
 #else
-					if (fsm_meta.meta.length != 0)
+						writeBack.rxSar = rxSarRecvd(fsm_meta.sessionID, newRecvd, 1);
+						fsm_fwdRxSar.recvd = newRecvd;
+						// Only notify about  new data available
+						rxEng2rxApp_notification.write(appNotification(fsm_meta.sessionID, fsm_meta.meta.length, fsm_meta.srcIpAddress, fsm_meta.dstIpPort));
 #endif
-					{
-						rxEng2eventEng_setEvent.write(event(ACK, fsm_meta.sessionID));
+						dropDataFifoOut.write(false);
 					}
-
-
-					// Reset Retransmit Timer
-					//rxEng2timer_clearRetransmitTimer.write(rxRetransmitTimerUpdate(fsm_meta.sessionID, (mh_meta.ackNumb == txSarNextByte)));
-					if (fsm_meta.meta.ackNumb == txSar.nextByte)
+#if !(RX_DDR_BYPASS)
+					// Segment is ahead of recvd but fits into the window, store it at its final position
+					// Out-of-order data is only tracked within 64KB of recvd, the application notification is limited to 16 bits
+					else if (segStart < free_space && segEnd < free_space && segEnd <= 0xFFFF)
 					{
-						switch (tcpState)
+						ap_uint<32> newOooStart = segStart;
+						ap_uint<32> newOooEnd = segEnd;
+						bool accept = true;
+						if (rxSar.ooo_valid)
 						{
-						case SYN_RECEIVED:
-							rxEng2stateTable_upd_req.write(stateQuery(fsm_meta.sessionID, ESTABLISHED, 1)); //TODO MAYBE REARRANGE
-							break;
-						case CLOSING:
-							rxEng2stateTable_upd_req.write(stateQuery(fsm_meta.sessionID, TIME_WAIT, 1));
-							rxEng2timer_setCloseTimer.write(fsm_meta.sessionID);
-							break;
-						case LAST_ACK:
-							rxEng2stateTable_upd_req.write(stateQuery(fsm_meta.sessionID, CLOSED, 1));
-							break;
-						default:
-							rxEng2stateTable_upd_req.write(stateQuery(fsm_meta.sessionID, tcpState, 1));
-							break;
+							// Only a single interval is tracked, segment has to overlap or touch it
+							if (segStart <= oooEnd && segEnd >= oooStart)
+							{
+								if (oooStart < segStart)
+								{
+									newOooStart = oooStart;
+								}
+								if (oooEnd > segEnd)
+								{
+									newOooEnd = oooEnd;
+								}
+							}
+							else
+							{
+								accept = false;
+							}
+						}
+						if (accept)
+						{
+							writeBack.rxSar = rxSarRecvd(fsm_meta.sessionID, rxSar.recvd, rxSar.recvd + newOooStart, newOooEnd - newOooStart, true);
+							fsm_fwdRxSar.ooo_head = rxSar.recvd + newOooStart;
+							fsm_fwdRxSar.ooo_length = newOooEnd - newOooStart;
+							fsm_fwdRxSar.ooo_valid = true;
+							rxBufferWriteCmd.write(mmBufferCmd(mmCmd(pkgAddr, fsm_meta.meta.length, RX_OOO_WRITE_TAG), rxSar.buffer));
 						}
+						dropDataFifoOut.write(!accept);
+						ackNoDelay = true;
 					}
-					else //we have to release the lock
+#endif
+					else
 					{
-						//reset rtTimer
-						//rtTimer.write(rxRetransmitTimerUpdate(fsm_meta.sessionID));
-						rxEng2stateTable_upd_req.write(stateQuery(fsm_meta.sessionID, tcpState, 1)); // or ESTABLISHED
+						dropDataFifoOut.write(true);
 					}
-				} //end state if
-				// TODO if timewait just send ACK, can it be time wait??
-				else // state == (CLOSED || SYN_SENT || CLOSE_WAIT || FIN_WAIT_2 || TIME_WAIT)
-				{
-					// SENT RST, RFC 793: fig.11
-					rxEng2eventEng_setEvent.write(rstEvent(fsm_meta.sessionID, fsm_meta.meta.seqNumb+fsm_meta.meta.length)); // noACK ?
-					// if data is in the pipe it needs to be droppped
-					if (fsm_meta.meta.length != 0)
+
+					// A change of the CE state is ACKed immediately, the delayed ACK would hide it, RFC 8257 3.2
+					if (rxSar.ecn_ok && fsm_meta.meta.ce != rxSar.ce)
 					{
-						dropDataFifoOut.write(true);
+						ackNoDelay = true;
 					}
-					rxEng2stateTable_upd_req.write(stateQuery(fsm_meta.sessionID, tcpState, 1));
+					// Sent ACK
+					//rxEng2eventEng_setEvent.write(event(ACK, fsm_meta.sessionID));
 				}
-				//fsm_state = LOAD;
-			}
-			break;
-		case 2: //SYN
-			//if (!stateTable2rxEng_upd_rsp.empty())
-			if (fsm_state == LOAD)
-			{
-				stateTable2rxEng_upd_rsp.read(tcpState);
-				rxSar2rxEng_upd_rsp.read(rxSar);
-				if (tcpState == CLOSED || tcpState == SYN_SENT) // Actually this is LISTEN || SYN_SENT
+#if FAST_RETRANSMIT
+				if (fastRetransmit || partialAck)
+				{
+					// The length limits the retransmission to the first unacknowledged segment
+					rxEng2eventEng_setEvent.write(event(RT, fsm_meta.sessionID, 0, MSS));
+				}
+				else if (ackNoDelay)
+#else
+				if (ackNoDelay)
+#endif
 				{
-					// Initialize rxSar, SEQ + phantom byte, last '1' for makes sure appd is initialized
-					rxEng2rxSar_upd_req.write(rxSarRecvd(fsm_meta.sessionID, fsm_meta.meta.seqNumb+1, 1, 1));
-					// Initialize receive window
-					rxEng2txSar_upd_req.write((rxTxSarQuery(fsm_meta.sessionID, 0, fsm_meta.meta.winSize, txSar.cong_window, 0, false))); //TODO maybe include count check
-					// Set SYN_ACK event
-					rxEng2eventEng_setEvent.write(event(SYN_ACK, fsm_meta.sessionID));
-					// Change State to SYN_RECEIVED
-					rxEng2stateTable_upd_req.write(stateQuery(fsm_meta.sessionID, SYN_RECEIVED, 1));
+					rxEng2eventEng_setEvent.write(event(ACK_NODELAY, fsm_meta.sessionID));
 				}
-				else if (tcpState == SYN_RECEIVED)// && mh_meta.seqNumb+1 == rxSar.recvd) // Maybe Check for seq
+				else if (fsm_meta.meta.length != 0)
 				{
-					// If it is the same SYN, we resent SYN-ACK, almost like quick RT, we could also wait for RT timer
-					if (fsm_meta.meta.seqNumb+1 == rxSar.recvd)
-					{
-						// Retransmit SYN_ACK
-						rxEng2eventEng_setEvent.write(event(SYN_ACK, fsm_meta.sessionID, 1));
-						rxEng2stateTable_upd_req.write(stateQuery(fsm_meta.sessionID, tcpState, 1));
-					}
-					else // Sent RST, RFC 793: fig.9 (old) duplicate SYN(+ACK)
+					// The length lets the ack_delay count the unacknowledged bytes
+					rxEng2eventEng_setEvent.write(event(ACK, fsm_meta.sessionID, 0, fsm_meta.meta.length));
+				}
+
+
+				// Reset Retransmit Timer
+				//rxEng2timer_clearRetransmitTimer.write(rxRetransmitTimerUpdate(fsm_meta.sessionID, (mh_meta.ackNumb == txSarNextByte)));
+				if (fsm_meta.meta.ackNumb == txSar.nextByte)
+				{
+					switch (tcpState)
 					{
-						rxEng2eventEng_setEvent.write(rstEvent(fsm_meta.sessionID, fsm_meta.meta.seqNumb+1)); //length == 0
-						rxEng2stateTable_upd_req.write(stateQuery(fsm_meta.sessionID, CLOSED, 1));
+					case SYN_RECEIVED:
+						nextState = ESTABLISHED; //TODO MAYBE REARRANGE
+						break;
+					case CLOSING:
+						// TIME-WAIT is kept by the close_timer, the session is released right away
+						nextState = CLOSED;
+						rxEng2timer_setCloseTimer.write(timeWaitEntry(fsm_meta.tuple, txSar.nextByte, fsm_fwdRxSar.recvd));
+						break;
+					case LAST_ACK:
+						nextState = CLOSED;
+						break;
+					default:
+						nextState = tcpState;
+						break;
 					}
 				}
-				else // Any synchronized state
+				else //we have to release the lock
 				{
-					// Unexpected SYN arrived, reply with normal ACK, RFC 793: fig.10
-					rxEng2eventEng_setEvent.write(event(ACK_NODELAY, fsm_meta.sessionID));
-					// TODo send RST, has no ACK??
-					// Respond with RST, no ACK, seq ==
-					//eventEngine.write(rstEvent(mh_meta.seqNumb, mh_meta.length, true));
-					rxEng2stateTable_upd_req.write(stateQuery(fsm_meta.sessionID, tcpState, 1));
+					//reset rtTimer
+					//rtTimer.write(rxRetransmitTimerUpdate(fsm_meta.sessionID));
+					nextState = tcpState; // or ESTABLISHED
 				}
-			}
-			break;
-		case 3: //SYN_ACK
-			//if (!stateTable2rxEng_upd_rsp.empty() && !txSar2rxEng_upd_rsp.empty())
-			if (fsm_state == LOAD)
+			} //end state if
+			// TODO if timewait just send ACK, can it be time wait??
+			else // state == (CLOSED || SYN_SENT || CLOSE_WAIT || FIN_WAIT_2 || TIME_WAIT)
 			{
-				stateTable2rxEng_upd_rsp.read(tcpState);
-				rxSar2rxEng_upd_rsp.read(rxSar);
-				txSar2rxEng_upd_rsp.read(txSar);
-				rxEng2timer_clearRetransmitTimer.write(rxRetransmitTimerUpdate(fsm_meta.sessionID, (fsm_meta.meta.ackNumb == txSar.nextByte)));
-				if ((tcpState == SYN_SENT) && (fsm_meta.meta.ackNumb == txSar.nextByte))// && !mh_lup.created)
+				// SENT RST, RFC 793: fig.11
+				rxEng2eventEng_setEvent.write(rstEvent(fsm_meta.sessionID, fsm_meta.meta.seqNumb+fsm_meta.meta.length)); // noACK ?
+				// if data is in the pipe it needs to be droppped
+				if (fsm_meta.meta.length != 0)
 				{
-					//initialize rx_sar, SEQ + phantom byte, last '1' for appd init
-					rxEng2rxSar_upd_req.write(rxSarRecvd(fsm_meta.sessionID, fsm_meta.meta.seqNumb+1, 1, 1));
-
-					rxEng2txSar_upd_req.write((rxTxSarQuery(fsm_meta.sessionID, fsm_meta.meta.ackNumb, fsm_meta.meta.winSize, txSar.cong_window, 0, false))); //TODO maybe include count check
-
-					// set ACK event
-					rxEng2eventEng_setEvent.write(event(ACK_NODELAY, fsm_meta.sessionID));
-
-					rxEng2stateTable_upd_req.write(stateQuery(fsm_meta.sessionID, ESTABLISHED, 1));
-					openConStatusOut.write(openStatus(fsm_meta.sessionID, true));
+					dropDataFifoOut.write(true);
 				}
-				else if (tcpState == SYN_SENT) //TODO correct answer?
+				nextState = tcpState;
+			}
+			break;
+		case 2: //SYN
+			if (tcpState == CLOSED && fsm_meta.timeWait.hit)
+			{
+				// Old duplicate of a connection in TIME-WAIT, answered with the ACK of its record. The
+				// session created by the lookup is released again
+				rxEng2eventEng_setEvent.write(extendedEvent(timeWaitEvent(fsm_meta.timeWait.ackNumb),
+															rxReplyTuple(fsm_meta.tuple), fsm_meta.timeWait.seqNumb));
+				nextState = CLOSED;
+			}
+			else if (tcpState == CLOSED || tcpState == SYN_SENT) // Actually this is LISTEN || SYN_SENT
+			{
+				// Initialize rxSar, SEQ + phantom byte, last '1' for makes sure appd is initialized
+				writeBack.rxSar = rxSarRecvd(fsm_meta.sessionID, fsm_meta.meta.seqNumb+1, 1, 1, rxWinShift, sackOk, ecnOk);
+				// The listening port picks the buffer class, a simultaneous open keeps the one of our SYN
+				writeBack.rxSar.bufferClass = (tcpState == SYN_SENT) ? (ap_uint<2>) TCP_BUFFER_CLASS_OPEN : fsm_meta.meta.bufferClass;
+				fsm_fwdRxSar.recvd = fsm_meta.meta.seqNumb+1;
+				fsm_fwdRxSar.appd = fsm_meta.meta.seqNumb+1;
+				fsm_fwdRxSar.ooo_valid = false;
+				fsm_fwdRxSar.win_shift = rxWinShift;
+				fsm_fwdRxSar.sack_ok = sackOk;
+				fsm_fwdRxSar.ecn_ok = ecnOk;
+				writeBack.rxSar.ts_ok = tsOk;
+				writeBack.rxSar.ts_recent = fsm_meta.meta.tsVal;
+				fsm_fwdRxSar.ts_ok = tsOk;
+				fsm_fwdRxSar.ts_recent = fsm_meta.meta.tsVal;
+				// Initialize receive window, the window of a SYN is never scaled
+				writeBack.txSar = rxTxSarQuery(fsm_meta.sessionID, 0, fsm_meta.meta.winSize, txSar.cong_window, txSar.slowstart_threshold, txWinShift, 0, false); //TODO maybe include count check
+				// Set SYN_ACK event
+				rxEng2eventEng_setEvent.write(event(SYN_ACK, fsm_meta.sessionID));
+				// Change State to SYN_RECEIVED
+				nextState = SYN_RECEIVED;
+			}
+			else if (tcpState == SYN_RECEIVED)// && mh_meta.seqNumb+1 == rxSar.recvd) // Maybe Check for seq
+			{
+				// If it is the same SYN, we resent SYN-ACK, almost like quick RT, we could also wait for RT timer
+				if (fsm_meta.meta.seqNumb+1 == rxSar.recvd)
 				{
-					// Sent RST, RFC 793: fig.9 (old) duplicate SYN(+ACK)
-					rxEng2eventEng_setEvent.write(rstEvent(fsm_meta.sessionID, fsm_meta.meta.seqNumb+fsm_meta.meta.length+1));
-					rxEng2stateTable_upd_req.write(stateQuery(fsm_meta.sessionID, CLOSED, 1));
+					// Retransmit SYN_ACK
+					rxEng2eventEng_setEvent.write(event(SYN_ACK, fsm_meta.sessionID, 1));
+					nextState = tcpState;
 				}
-				else
+				else // Sent RST, RFC 793: fig.9 (old) duplicate SYN(+ACK)
 				{
-					// Unexpected SYN arrived, reply with normal ACK, RFC 793: fig.10
-					rxEng2eventEng_setEvent.write(event(ACK_NODELAY, fsm_meta.sessionID));
-					rxEng2stateTable_upd_req.write(stateQuery(fsm_meta.sessionID, tcpState, 1));
+					rxEng2eventEng_setEvent.write(rstEvent(fsm_meta.sessionID, fsm_meta.meta.seqNumb+1)); //length == 0
+					nextState = CLOSED;
 				}
 			}
+			else // Any synchronized state
+			{
+				// Unexpected SYN arrived, reply with normal ACK, RFC 793: fig.10
+				rxEng2eventEng_setEvent.write(event(ACK_NODELAY, fsm_meta.sessionID));
+				// TODo send RST, has no ACK??
+				// Respond with RST, no ACK, seq ==
+				//eventEngine.write(rstEvent(mh_meta.seqNumb, mh_meta.length, true));
+				nextState = tcpState;
+			}
+			break;
+		case 3: //SYN_ACK
+			rxEng2timer_clearRetransmitTimer.write(rxRetransmitTimerUpdate(fsm_meta.sessionID, (fsm_meta.meta.ackNumb == txSar.nextByte), rto, pto));
+			if ((tcpState == SYN_SENT) && (fsm_meta.meta.ackNumb == txSar.nextByte))// && !mh_lup.created)
+			{
+				//initialize rx_sar, SEQ + phantom byte, last '1' for appd init
+				writeBack.rxSar = rxSarRecvd(fsm_meta.sessionID, fsm_meta.meta.seqNumb+1, 1, 1, rxWinShift, sackOk, ecnOk);
+				writeBack.rxSar.bufferClass = TCP_BUFFER_CLASS_OPEN;
+				fsm_fwdRxSar.recvd = fsm_meta.meta.seqNumb+1;
+				fsm_fwdRxSar.appd = fsm_meta.meta.seqNumb+1;
+				fsm_fwdRxSar.ooo_valid = false;
+				fsm_fwdRxSar.win_shift = rxWinShift;
+				fsm_fwdRxSar.sack_ok = sackOk;
+				fsm_fwdRxSar.ecn_ok = ecnOk;
+				writeBack.rxSar.ts_ok = tsOk;
+				writeBack.rxSar.ts_recent = fsm_meta.meta.tsVal;
+				fsm_fwdRxSar.ts_ok = tsOk;
+				fsm_fwdRxSar.ts_recent = fsm_meta.meta.tsVal;
+
+				writeBack.txSar = rxTxSarQuery(fsm_meta.sessionID, fsm_meta.meta.ackNumb, fsm_meta.meta.winSize, txSar.cong_window, txSar.slowstart_threshold, txWinShift, 0, false); //TODO maybe include count check
+				fsm_fwdTxSar = rxTxSarReply(fsm_meta.meta.ackNumb, txSar.nextByte, txSar.cong_window, txSar.slowstart_threshold, txWinShift, 0, false);
+
+				// set ACK event
+				rxEng2eventEng_setEvent.write(event(ACK_NODELAY, fsm_meta.sessionID));
+
+				nextState = ESTABLISHED;
+				openConStatusOut.write(openStatus(fsm_meta.sessionID, true));
+			}
+			else if (tcpState == SYN_SENT) //TODO correct answer?
+			{
+				// Sent RST, RFC 793: fig.9 (old) duplicate SYN(+ACK)
+				rxEng2eventEng_setEvent.write(rstEvent(fsm_meta.sessionID, fsm_meta.meta.seqNumb+fsm_meta.meta.length+1));
+				nextState = CLOSED;
+			}
+			else
+			{
+				// Unexpected SYN arrived, reply with normal ACK, RFC 793: fig.10
+				rxEng2eventEng_setEvent.write(event(ACK_NODELAY, fsm_meta.sessionID));
+				nextState = tcpState;
+			}
 			break;
 		case 5: //FIN (_ACK)
-			//if (!rxSar2rxEng_upd_rsp.empty() && !stateTable2rxEng_upd_rsp.empty() && !txSar2rxEng_upd_rsp.empty())
-			if (fsm_state == LOAD)
+#if TCP_TIMESTAMPS
+			if (pawsReject)
 			{
-				stateTable2rxEng_upd_rsp.read(tcpState);
-				rxSar2rxEng_upd_rsp.read(rxSar);
-				txSar2rxEng_upd_rsp.read(txSar);
-				rxEng2timer_clearRetransmitTimer.write(rxRetransmitTimerUpdate(fsm_meta.sessionID, (fsm_meta.meta.ackNumb == txSar.nextByte)));
-				// Check state and if FIN in order, Current out of order FINs are not accepted
-				if ((tcpState == ESTABLISHED || tcpState == FIN_WAIT_1 || tcpState == FIN_WAIT_2) && (rxSar.recvd == fsm_meta.meta.seqNumb))
+				// Old duplicate, dropped and answered with an ACK, RFC 7323 5.3 R1
+				rxEng2eventEng_setEvent.write(event(ACK_NODELAY, fsm_meta.sessionID));
+				if (fsm_meta.meta.length != 0)
 				{
-					rxEng2txSar_upd_req.write((rxTxSarQuery(fsm_meta.sessionID, fsm_meta.meta.ackNumb, fsm_meta.meta.winSize, txSar.cong_window, txSar.count, txSar.fastRetransmitted))); //TODO include count check
+					dropDataFifoOut.write(true);
+				}
+				break;
+			}
+#endif
+			rxEng2timer_clearRetransmitTimer.write(rxRetransmitTimerUpdate(fsm_meta.sessionID, (fsm_meta.meta.ackNumb == txSar.nextByte), rto, pto));
+			// Check state and if FIN in order, Current out of order FINs are not accepted
+			if ((tcpState == ESTABLISHED || tcpState == FIN_WAIT_1 || tcpState == FIN_WAIT_2) && (rxSar.recvd == fsm_meta.meta.seqNumb))
+			{
+				writeBack.txSar = rxTxSarQuery(fsm_meta.sessionID, fsm_meta.meta.ackNumb, recvWindow, txSar.cong_window, txSar.slowstart_threshold, txSar.win_shift, txSar.count, txSar.fastRetransmitted); //TODO include count check
+				fsm_fwdTxSar = rxTxSarReply(fsm_meta.meta.ackNumb, txSar.nextByte, txSar.cong_window, txSar.slowstart_threshold, txSar.win_shift, txSar.count, txSar.fastRetransmitted);
 
-					// +1 for phantom byte, there might be data too
-					rxEng2rxSar_upd_req.write(rxSarRecvd(fsm_meta.sessionID, fsm_meta.meta.seqNumb+fsm_meta.meta.length+1, 1)); //diff to ACK
+				// +1 for phantom byte, there might be data too
+				writeBack.rxSar = rxSarRecvd(fsm_meta.sessionID, fsm_meta.meta.seqNumb+fsm_meta.meta.length+1, 1); //diff to ACK
+				fsm_fwdRxSar.recvd = fsm_meta.meta.seqNumb+fsm_meta.meta.length+1;
+				fsm_fwdRxSar.ooo_valid = false;
 
-					// Clear the probe timer
-					rxEng2timer_clearProbeTimer.write(fsm_meta.sessionID);
+				// Clear the probe timer
+				rxEng2timer_clearProbeTimer.write(fsm_meta.sessionID);
 
-					// Check if there is payload
-					if (fsm_meta.meta.length != 0)
-					{
-						ap_uint<32> pkgAddr;
-						pkgAddr(31, 30) = 0x0;
-						pkgAddr(29, 16) = fsm_meta.sessionID(13, 0);
-						pkgAddr(15, 0) = fsm_meta.meta.seqNumb(15, 0);
+				// Check if there is payload
+				if (fsm_meta.meta.length != 0)
+				{
+					ap_uint<32> pkgAddr;
+					pkgAddr(31, 30) = 0x0;
+					pkgAddr(29, 0) = rxSar.buffer.address(fsm_meta.meta.seqNumb(WINDOW_BITS-1, 0));
 #if !(RX_DDR_BYPASS)
-						rxBufferWriteCmd.write(mmCmd(pkgAddr, fsm_meta.meta.length));
+					rxBufferWriteCmd.write(mmBufferCmd(mmCmd(pkgAddr, fsm_meta.meta.length), rxSar.buffer));
 #endif
-						// Tell Application new data is available and connection got closed
-						rxEng2rxApp_notification.write(appNotification(fsm_meta.sessionID, fsm_meta.meta.length, fsm_meta.srcIpAddress, fsm_meta.dstIpPort, true));
-						dropDataFifoOut.write(false);
-					}
-					else if (tcpState == ESTABLISHED)
-					{
-						// Tell Application connection got closed
-						rxEng2rxApp_notification.write(appNotification(fsm_meta.sessionID, fsm_meta.srcIpAddress, fsm_meta.dstIpPort, true)); //CLOSE
-					}
+					// Tell Application new data is available and connection got closed
+					rxEng2rxApp_notification.write(appNotification(fsm_meta.sessionID, fsm_meta.meta.length, fsm_meta.srcIpAddress, fsm_meta.dstIpPort, true));
+					dropDataFifoOut.write(false);
+				}
+				else if (tcpState == ESTABLISHED)
+				{
+					// Tell Application connection got closed
+					rxEng2rxApp_notification.write(appNotification(fsm_meta.sessionID, fsm_meta.srcIpAddress, fsm_meta.dstIpPort, true)); //CLOSE
+				}
 
-					// Update state
-					if (tcpState == ESTABLISHED)
+				// Update state
+				if (tcpState == ESTABLISHED)
+				{
+					rxEng2eventEng_setEvent.write(event(FIN, fsm_meta.sessionID));
+					nextState = LAST_ACK;
+				}
+				else //FIN_WAIT_1 || FIN_WAIT_2
+				{
+					if (fsm_meta.meta.ackNumb == txSar.nextByte) //check if final FIN is ACK'd -> LAST_ACK
 					{
-						rxEng2eventEng_setEvent.write(event(FIN, fsm_meta.sessionID));
-						rxEng2stateTable_upd_req.write(stateQuery(fsm_meta.sessionID, LAST_ACK, 1));
+						// TIME-WAIT is kept by the close_timer, the session is released right away.
+						// The final ACK is sent without the session, its ID only cancels a delayed ACK
+						nextState = CLOSED;
+						rxEng2timer_setCloseTimer.write(timeWaitEntry(fsm_meta.tuple, txSar.nextByte, fsm_meta.meta.seqNumb+fsm_meta.meta.length+1));
+						rxEng2eventEng_setEvent.write(extendedEvent(timeWaitEvent(fsm_meta.sessionID, fsm_meta.meta.seqNumb+fsm_meta.meta.length+1),
+																	rxReplyTuple(fsm_meta.tuple), txSar.nextByte));
 					}
-					else //FIN_WAIT_1 || FIN_WAIT_2
+					else
 					{
-						if (fsm_meta.meta.ackNumb == txSar.nextByte) //check if final FIN is ACK'd -> LAST_ACK
-						{
-							rxEng2stateTable_upd_req.write(stateQuery(fsm_meta.sessionID, TIME_WAIT, 1));
-							rxEng2timer_setCloseTimer.write(fsm_meta.sessionID);
-						}
-						else
-						{
-							rxEng2stateTable_upd_req.write(stateQuery(fsm_meta.sessionID, CLOSING, 1));
-						}
+						nextState = CLOSING;
 						rxEng2eventEng_setEvent.write(event(ACK, fsm_meta.sessionID));
 					}
 				}
-				else // NOT (ESTABLISHED || FIN_WAIT_1 || FIN_WAIT_2)
+			}
+			else // NOT (ESTABLISHED || FIN_WAIT_1 || FIN_WAIT_2)
+			{
+				rxEng2eventEng_setEvent.write(event(ACK, fsm_meta.sessionID));
+				nextState = tcpState;
+				// If there is payload we need to drop it
+				if (fsm_meta.meta.length != 0)
 				{
-					rxEng2eventEng_setEvent.write(event(ACK, fsm_meta.sessionID));
-					rxEng2stateTable_upd_req.write(stateQuery(fsm_meta.sessionID, tcpState, 1));
-					// If there is payload we need to drop it
-					if (fsm_meta.meta.length != 0)
-					{
-						dropDataFifoOut.write(true);
-					}
+					dropDataFifoOut.write(true);
 				}
 			}
 			break;
@@ -1051,61 +1689,96 @@ void rxTcpFSM(			stream<rxFsmMetaData>&					fsmMetaDataFifo,
 			// stateTable is locked, make sure it is released in at the end
 			// If there is an ACK we read txSar
 			// We always read rxSar
-			if (fsm_state == LOAD)
+			// Handle if RST
+			if (fsm_meta.meta.rst)
 			{
-				stateTable2rxEng_upd_rsp.read(tcpState);
-				rxSar2rxEng_upd_rsp.read(rxSar); //TODO not sure nb works
-				txSar2rxEng_upd_rsp.read_nb(txSar);
-			}
-			if (fsm_state == LOAD)
-			{
-				// Handle if RST
-				if (fsm_meta.meta.rst)
+				if (tcpState == SYN_SENT) //TODO this would be a RST,ACK i think
 				{
-					if (tcpState == SYN_SENT) //TODO this would be a RST,ACK i think
+					if (fsm_meta.meta.ackNumb == txSar.nextByte) // Check if matching SYN
 					{
-						if (fsm_meta.meta.ackNumb == txSar.nextByte) // Check if matching SYN
-						{
-							//tell application, could not open connection
-							openConStatusOut.write(openStatus(fsm_meta.sessionID, false));
-							rxEng2stateTable_upd_req.write(stateQuery(fsm_meta.sessionID, CLOSED, 1));
-							rxEng2timer_clearRetransmitTimer.write(rxRetransmitTimerUpdate(fsm_meta.sessionID, true));
-						}
-						else
-						{
-							// Ignore since not matching
-							rxEng2stateTable_upd_req.write(stateQuery(fsm_meta.sessionID, tcpState, 1));
-						}
+						//tell application, could not open connection
+						openConStatusOut.write(openStatus(fsm_meta.sessionID, false));
+						nextState = CLOSED;
+						rxEng2timer_clearRetransmitTimer.write(rxRetransmitTimerUpdate(fsm_meta.sessionID, true));
 					}
 					else
 					{
-						// Check if in window
-						if (fsm_meta.meta.seqNumb == rxSar.recvd)
-						{
-							//tell application, RST occurred, abort
-							rxEng2rxApp_notification.write(appNotification(fsm_meta.sessionID, fsm_meta.srcIpAddress, fsm_meta.dstIpPort, true)); //RESET
-							rxEng2stateTable_upd_req.write(stateQuery(fsm_meta.sessionID, CLOSED, 1)); //TODO maybe some TIME_WAIT state
-							rxEng2timer_clearRetransmitTimer.write(rxRetransmitTimerUpdate(fsm_meta.sessionID, true));
-						}
-						else
-						{
-							// Ingore since not matching window
-							rxEng2stateTable_upd_req.write(stateQuery(fsm_meta.sessionID, tcpState, 1));
-						}
+						// Ignore since not matching
+						nextState = tcpState;
 					}
 				}
-				else // Handle non RST bogus packages
+				else
 				{
-					//TODO maybe sent RST ourselves, or simply ignore
-					// For now ignore, sent ACK??
-					//eventsOut.write(rstEvent(mh_meta.seqNumb, 0, true));
-					rxEng2stateTable_upd_req.write(stateQuery(fsm_meta.sessionID, tcpState, 1));
-				} // if rst
-			} // if fsm_stat
+					// Check if in window
+					if (fsm_meta.meta.seqNumb == rxSar.recvd)
+					{
+						//tell application, RST occurred, abort
+						rxEng2rxApp_notification.write(appNotification(fsm_meta.sessionID, fsm_meta.srcIpAddress, fsm_meta.dstIpPort, true)); //RESET
+						nextState = CLOSED; //TODO maybe some TIME_WAIT state
+						rxEng2timer_clearRetransmitTimer.write(rxRetransmitTimerUpdate(fsm_meta.sessionID, true));
+					}
+					else
+					{
+						// Ingore since not matching window
+						nextState = tcpState;
+					}
+				}
+			}
+			else // Handle non RST bogus packages
+			{
+				//TODO maybe sent RST ourselves, or simply ignore
+				// For now ignore, sent ACK??
+				//eventsOut.write(rstEvent(mh_meta.seqNumb, 0, true));
+				nextState = tcpState;
+			} // if rst
 			break;
 		} //switch control_bits
-		break;
-	} //switch state
+
+		// The RTT estimate and the congestion control state go along with the txSar update, the sample is lost if the ACK is not accepted
+		if (writeBack.txSar.write)
+		{
+			writeBack.txSar.srtt = srtt;
+			writeBack.txSar.rttvar = rttvar;
+			writeBack.txSar.rto = rto;
+			writeBack.txSar.pto = pto;
+			writeBack.txSar.rtt_sample = rttSampleValid;
+			fsm_fwdTxSar.srtt = srtt;
+			fsm_fwdTxSar.rttvar = rttvar;
+			fsm_fwdTxSar.rto = rto;
+			fsm_fwdTxSar.rtt_seq = txSar.rtt_seq;
+			fsm_fwdRttEnded = (rttSampleValid || writeBack.txSar.fastRetransmitted);
+			writeBack.txSar.cc = txSar.cc;
+			writeBack.txSar.cc_newEpoch = ccNewEpoch;
+			fsm_fwdTxSar.cc = txSar.cc;
+			fsm_fwdNewEpoch = ccNewEpoch;
+			writeBack.txSar.cwr = ecnReduced;
+			writeBack.txSar.recover = txSar.recover;
+			fsm_fwdTxSar.recover = txSar.recover;
+#if TCP_PACING
+			rxEng2pacer_setRate.write(pacerRateUpdate(fsm_meta.sessionID, writeBack.txSar.cong_window, srtt,
+														(writeBack.txSar.cong_window < writeBack.txSar.slowstart_threshold)));
+#endif
+		}
+#if TCP_TIMESTAMPS
+		// Segments without accepted data update TS.Recent too, the receive state is written back unchanged
+		if (!writeBack.rxSar.write && tsRecent != rxSar.ts_recent)
+		{
+			writeBack.rxSar = rxSarRecvd(fsm_meta.sessionID, rxSar.recvd, rxSar.ooo_head, rxSar.ooo_length, rxSar.ooo_valid);
+		}
+#endif
+		if (writeBack.rxSar.write && !writeBack.rxSar.init)
+		{
+			writeBack.rxSar.ce = ceState;
+			fsm_fwdRxSar.ce = ceState;
+			writeBack.rxSar.ts_recent = tsRecent;
+			fsm_fwdRxSar.ts_recent = tsRecent;
+		}
+
+		writeBack.state = stateQuery(fsm_meta.sessionID, nextState, 1);
+		fsmWriteBackFifo.write(writeBack);
+		fsm_fwdState = nextState;
+		fsm_metaValid = false;
+	}
 }
 
 /** @ingroup rx_engine
@@ -1179,6 +1852,8 @@ void rxPackageDropper(stream<axiWord>&		dataIn,
 
 /** @ingroup rx_engine
  *  Delays the notifications to the application until the data is actually is written to memory
+ *  Write status of out-of-order segments (tagged with @ref RX_OOO_WRITE_TAG) have no matching notification,
+ *  they are released together with the in-order segment closing the hole.
  *  @param[in]		rxWriteStatusIn, the status which we get back from the DATA MOVER it indicates if the write was successful
  *  @param[in]		internalNotificationFifoIn, incoming notifications
  *  @param[out]		notificationOut, outgoing notifications
@@ -1193,31 +1868,51 @@ void rxAppNotificationDelayer(	stream<mmStatus>&				rxWriteStatusIn, stream<appN
 	#pragma HLS STREAM variable=rand_notificationBuffer depth=32 //depends on memory delay
 	#pragma HLS DATA_PACK variable=rand_notificationBuffer
 
-	static ap_uint<1>		rxAppNotificationDoubleAccessFlag = false;
+	enum randFsmStateType {STATUS, SECOND_STATUS, NOTIFY};
+	static randFsmStateType rand_state = STATUS;
 	static ap_uint<5>		rand_fifoCount = 0;
 	static mmStatus			rxAppNotificationStatus1, rxAppNotificationStatus2;
-	static appNotification	rxAppNotification;
+	static bool				rand_statusOkay = false;
+	appNotification			rxAppNotification;
 
-	if (rxAppNotificationDoubleAccessFlag == true) {
-		if(!rxWriteStatusIn.empty()) {
-			rxWriteStatusIn.read(rxAppNotificationStatus2);
-			rand_fifoCount--;
-			if (rxAppNotificationStatus1.okay && rxAppNotificationStatus2.okay)
+	switch (rand_state) {
+	case STATUS:
+		if (!rxWriteStatusIn.empty() && !doubleAccess.empty()) {
+			rxWriteStatusIn.read(rxAppNotificationStatus1);
+			rand_statusOkay = rxAppNotificationStatus1.okay;
+			if (doubleAccess.read()) // If the memory access was broken down in two for this segment w8 for the second status
+				rand_state = SECOND_STATUS;
+			else if (rxAppNotificationStatus1.tag != RX_OOO_WRITE_TAG)
+				rand_state = NOTIFY;
+		}
+		else if (!internalNotificationFifoIn.empty() && (rand_fifoCount < 31)) {
+			internalNotificationFifoIn.read(rxAppNotification);
+			if (rxAppNotification.length != 0) {
+				rand_notificationBuffer.write(rxAppNotification);
+				rand_fifoCount++;
+			}
+			else
 				notificationOut.write(rxAppNotification);
-			rxAppNotificationDoubleAccessFlag = false;
 		}
-	}
-	else if (rxAppNotificationDoubleAccessFlag == false) {
-		if(!rxWriteStatusIn.empty() && !rand_notificationBuffer.empty() && !doubleAccess.empty()) {
-			rxWriteStatusIn.read(rxAppNotificationStatus1);
+		break;
+	case SECOND_STATUS:
+		if (!rxWriteStatusIn.empty()) {
+			rxWriteStatusIn.read(rxAppNotificationStatus2);
+			rand_statusOkay = rand_statusOkay && rxAppNotificationStatus2.okay;
+			if (rxAppNotificationStatus1.tag != RX_OOO_WRITE_TAG)
+				rand_state = NOTIFY;
+			else
+				rand_state = STATUS;
+		}
+		break;
+	case NOTIFY:
+		if (!rand_notificationBuffer.empty()) {
 			rand_notificationBuffer.read(rxAppNotification);
-			rxAppNotificationDoubleAccessFlag = doubleAccess.read(); 	// Read the double notification flag. If one then go and w8 for the second status
-			if (rxAppNotificationDoubleAccessFlag == 0) {				// if the memory access was not broken down in two for this segment
-				rand_fifoCount--;
-				if (rxAppNotificationStatus1.okay)
-					notificationOut.write(rxAppNotification);				// Output the notification
-			}
+			rand_fifoCount--;
+			if (rand_statusOkay)
+				notificationOut.write(rxAppNotification);	// Output the notification
 			//TODO else, we are screwed since the ACK is already sent
+			rand_state = STATUS;
 		}
 		else if (!internalNotificationFifoIn.empty() && (rand_fifoCount < 31)) {
 			internalNotificationFifoIn.read(rxAppNotification);
@@ -1228,10 +1923,11 @@ void rxAppNotificationDelayer(	stream<mmStatus>&				rxWriteStatusIn, stream<appN
 			else
 				notificationOut.write(rxAppNotification);
 		}
+		break;
 	}
 }
 
-void rxEventMerger(stream<extendedEvent>& in1, stream<event>& in2, stream<extendedEvent>& out)
+void rxEventMerger(stream<extendedEvent>& in1, stream<extendedEvent>& in2, stream<extendedEvent>& out)
 {
 	#pragma HLS PIPELINE II=1
 	#pragma HLS INLINE
@@ -1246,7 +1942,7 @@ void rxEventMerger(stream<extendedEvent>& in1, stream<event>& in2, stream<extend
 	}
 }
 
-void rxEngMemWrite(	stream<axiWord>& 				rxMemWrDataIn, stream<mmCmd>&				rxMemWrCmdIn,
+void rxEngMemWrite(	stream<axiWord>& 				rxMemWrDataIn, stream<mmBufferCmd>&			rxMemWrCmdIn,
 					stream<mmCmd>&					rxMemWrCmdOut, stream<axiWord>&				rxMemWrDataOut,
 					stream<ap_uint<1> >&			doubleAccess) {
 #pragma HLS pipeline II=1
@@ -1255,6 +1951,7 @@ void rxEngMemWrite(	stream<axiWord>& 				rxMemWrDataIn, stream<mmCmd>&				rxMemW
 	static enum rxmwrState{RXMEMWR_IDLE, RXMEMWR_WRFIRST, RXMEMWR_EVALSECOND, RXMEMWR_WRSECOND, RXMEMWR_WRSECONDSTR, RXMEMWR_ALIGNED, RXMEMWR_RESIDUE} rxMemWrState;
 	static mmCmd rxMemWriterCmd = mmCmd(0, 0);
 	static ap_uint<16> rxEngBreakTemp = 0;
+	static ap_uint<WINDOW_BITS> rxEngBufferOffset = 0;
 	static uint8_t lengthBuffer = 0;
 	static ap_uint<3> rxEngAccessResidue = 0;
 	static bool txAppBreakdown = false;
@@ -1264,12 +1961,15 @@ void rxEngMemWrite(	stream<axiWord>& 				rxMemWrDataIn, stream<mmCmd>&				rxMemW
 	switch (rxMemWrState) {
 	case RXMEMWR_IDLE:
 		if (!rxMemWrCmdIn.empty() && !rxMemWrCmdOut.full() && !doubleAccess.full()) {
-			rxMemWriterCmd = rxMemWrCmdIn.read();
+			mmBufferCmd bufferCmd = rxMemWrCmdIn.read();
+			rxMemWriterCmd = bufferCmd.cmd;
 			mmCmd tempCmd = rxMemWriterCmd;
-			if ((rxMemWriterCmd.saddr.range(15, 0) + rxMemWriterCmd.bbt) > 65536) {
-				rxEngBreakTemp = 65536 - rxMemWriterCmd.saddr;
+			// The session buffer is aligned to its size, the lower bits of the address are the offset into it
+			rxEngBufferOffset = rxMemWriterCmd.saddr.range(WINDOW_BITS-1, 0) & bufferCmd.buffer.mask();
+			if ((rxEngBufferOffset + rxMemWriterCmd.bbt) > bufferCmd.buffer.size()) {
+				rxEngBreakTemp = bufferCmd.buffer.size() - rxEngBufferOffset;
 				rxMemWriterCmd.bbt -= rxEngBreakTemp;
-				tempCmd = mmCmd(rxMemWriterCmd.saddr, rxEngBreakTemp);
+				tempCmd = mmCmd(rxMemWriterCmd.saddr, rxEngBreakTemp, rxMemWriterCmd.tag);
 				txAppBreakdown = true;
 			}
 			else
@@ -1296,7 +1996,7 @@ void rxEngMemWrite(	stream<axiWord>& 				rxMemWrDataIn, stream<mmCmd>&				rxMemW
 			{
 				if (txAppBreakdown == true)
 				{				/// Changes are to go in here
-					if (rxMemWriterCmd.saddr.range(15, 0) % 8 != 0) // If the word is not perfectly aligned then there is some magic to be worked.
+					if (rxMemWriterCmd.saddr.range(WINDOW_BITS-1, 0) % 8 != 0) // If the word is not perfectly aligned then there is some magic to be worked.
 					{
 						outputWord.keep = lenToKeep(rxEngBreakTemp);
 					}
@@ -1317,16 +2017,16 @@ void rxEngMemWrite(	stream<axiWord>& 				rxMemWrDataIn, stream<mmCmd>&				rxMemW
 		break;
 	case RXMEMWR_EVALSECOND:
 		if (!rxMemWrCmdOut.full()) {
-			if (rxMemWriterCmd.saddr.range(15, 0) % 8 == 0)
+			if (rxMemWriterCmd.saddr.range(WINDOW_BITS-1, 0) % 8 == 0)
 				rxMemWrState = RXMEMWR_ALIGNED;
 			//else if (rxMemWriterCmd.bbt + rxEngAccessResidue > 8 || rxEngAccessResidue > 0)
 			else if (rxMemWriterCmd.bbt - rxEngAccessResidue > 0)
 				rxMemWrState = RXMEMWR_WRSECONDSTR;
 			else
 				rxMemWrState = RXMEMWR_RESIDUE;
-			rxMemWriterCmd.saddr.range(15, 0) = 0;
+			rxMemWriterCmd.saddr -= rxEngBufferOffset;
 			rxEngBreakTemp = rxMemWriterCmd.bbt;
-			rxMemWrCmdOut.write(mmCmd(rxMemWriterCmd.saddr, rxEngBreakTemp));
+			rxMemWrCmdOut.write(mmCmd(rxMemWriterCmd.saddr, rxEngBreakTemp, rxMemWriterCmd.tag));
 			//std::cerr <<  "Cmd: " << std::dec << txAppPktCounter << " - " << std::hex << txAppTempCmd.saddr << " - " << txAppTempCmd.bbt << std::endl;
 			txAppBreakdown = false;
 
@@ -1384,18 +2084,21 @@ void rxEngMemWrite(	stream<axiWord>& 				rxMemWrDataIn, stream<mmCmd>&				rxMemW
  *  @param[in]		sLookup2rxEng_rsp
  *  @param[in]		stateTable2rxEng_upd_rsp
  *  @param[in]		portTable2rxEng_rsp
- *  @param[in]		rxSar2rxEng_upd_rsp
- *  @param[in]		txSar2rxEng_upd_rsp
+ *  @param[in]		ctx2rxEng_upd_rsp
+ *  @param[in]		timer2rxEng_timeWaitRsp
+ *  @param[in]		timer2rxEng_synRsp
  *  @param[in]		rxBufferWriteStatus
  *
  *  @param[out]		rxBufferWriteData
  *  @param[out]		rxEng2sLookup_req
  *  @param[out]		rxEng2stateTable_upd_req
  *  @param[out]		rxEng2portTable_req
- *  @param[out]		rxEng2rxSar_upd_req
- *  @param[out]		rxEng2txSar_upd_req
+ *  @param[out]		rxEng2ctx_upd_req
  *  @param[out]		rxEng2timer_clearRetransmitTimer
  *  @param[out]		rxEng2timer_setCloseTimer
+ *  @param[out]		rxEng2timer_timeWaitQuery
+ *  @param[out]		rxEng2timer_synQuery
+ *  @param[out]		rxEng2timer_setKeepAlive
  *  @param[out]		openConStatusOut
  *  @param[out]		rxEng2eventEng_setEvent
  *  @param[out]		rxBufferWriteCmd
@@ -1404,9 +2107,10 @@ void rxEngMemWrite(	stream<axiWord>& 				rxMemWrDataIn, stream<mmCmd>&				rxMemW
 void rx_engine(	stream<axiWord>&					ipRxData,
 				stream<sessionLookupReply>&			sLookup2rxEng_rsp,
 				stream<sessionState>&				stateTable2rxEng_upd_rsp,
-				stream<bool>&						portTable2rxEng_rsp,
-				stream<rxSarEntry>&					rxSar2rxEng_upd_rsp,
-				stream<rxTxSarReply>&				txSar2rxEng_upd_rsp,
+				stream<portCheckReply>&				portTable2rxEng_rsp,
+				stream<rxSessionCtxReply>&			ctx2rxEng_upd_rsp,
+				stream<timeWaitReply>&				timer2rxEng_timeWaitRsp,
+				stream<timeWaitReply>&				timer2rxEng_synRsp,
 #if !(RX_DDR_BYPASS)
 				stream<mmStatus>&					rxBufferWriteStatus,
 #endif
@@ -1414,11 +2118,18 @@ void rx_engine(	stream<axiWord>&					ipRxData,
 				stream<sessionLookupQuery>&			rxEng2sLookup_req,
 				stream<stateQuery>&					rxEng2stateTable_upd_req,
 				stream<ap_uint<16> >&				rxEng2portTable_req,
-				stream<rxSarRecvd>&					rxEng2rxSar_upd_req,
-				stream<rxTxSarQuery>&				rxEng2txSar_upd_req,
+				stream<rxSessionCtxQuery>&			rxEng2ctx_upd_req,
 				stream<rxRetransmitTimerUpdate>&	rxEng2timer_clearRetransmitTimer,
 				stream<ap_uint<16> >&				rxEng2timer_clearProbeTimer,
-				stream<ap_uint<16> >&				rxEng2timer_setCloseTimer,
+				stream<timeWaitEntry>&				rxEng2timer_setCloseTimer,
+				stream<timeWaitQuery>&				rxEng2timer_timeWaitQuery,
+				stream<timeWaitQuery>&				rxEng2timer_synQuery,
+#if (TCP_KEEPALIVE)
+				stream<keepAliveUpdate>&			rxEng2timer_setKeepAlive,
+#endif
+#if (TCP_PACING)
+				stream<pacerRateUpdate>&			rxEng2pacer_setRate,
+#endif
 				stream<openStatus>&					openConStatusOut,
 				stream<extendedEvent>&				rxEng2eventEng_setEvent,
 #if !(RX_DDR_BYPASS)
@@ -1451,18 +2162,29 @@ void rx_engine(	stream<axiWord>&					ipRxData,
 	// Meta Streams/FIFOs
 	static stream<bool>					rxEng_tcpValidFifo("rx_tcpValidFifo");
 	static stream<rxEngineMetaData>		rxEng_metaDataFifo("rx_metaDataFifo");
+	static stream<rxLookupMetaData>		rxEng_lookupMetaFifo("rxEng_lookupMetaFifo");
 	static stream<rxFsmMetaData>		rxEng_fsmMetaDataFifo("rxEng_fsmMetaDataFifo");
+	static stream<rxFsmIssuedMeta>		rxEng_fsmIssuedMetaFifo("rxEng_fsmIssuedMetaFifo");
+	static stream<rxFsmWriteBack>		rxEng_fsmWriteBackFifo("rxEng_fsmWriteBackFifo");
 	static stream<fourTuple>			rxEng_tupleBuffer("rx_tupleBuffer");
 	static stream<ap_uint<16> >			rxEng_tcpLenFifo("rx_tcpLenFifo");
+	static stream<bool>					rxEng_ceFifo("rxEng_ceFifo");
 	#pragma HLS stream variable=rxEng_tcpValidFifo depth=2
 	#pragma HLS stream variable=rxEng_metaDataFifo depth=2
 	#pragma HLS stream variable=rxEng_tupleBuffer depth=2
 	#pragma HLS stream variable=rxEng_tcpLenFifo depth=2
+	#pragma HLS stream variable=rxEng_ceFifo depth=4
+	#pragma HLS stream variable=rxEng_lookupMetaFifo depth=8 // Lookups in flight
+	#pragma HLS stream variable=rxEng_fsmIssuedMetaFifo depth=4
+	#pragma HLS stream variable=rxEng_fsmWriteBackFifo depth=4
 	#pragma HLS DATA_PACK variable=rxEng_metaDataFifo
 	#pragma HLS DATA_PACK variable=rxEng_tupleBuffer
+	#pragma HLS DATA_PACK variable=rxEng_lookupMetaFifo
+	#pragma HLS DATA_PACK variable=rxEng_fsmIssuedMetaFifo
+	#pragma HLS DATA_PACK variable=rxEng_fsmWriteBackFifo
 
 	static stream<extendedEvent>		rxEng_metaHandlerEventFifo("rxEng_metaHandlerEventFifo");
-	static stream<event>				rxEng_fsmEventFifo("rxEng_fsmEventFifo");
+	static stream<extendedEvent>		rxEng_fsmEventFifo("rxEng_fsmEventFifo");
 	#pragma HLS stream variable=rxEng_metaHandlerEventFifo depth=2
 	#pragma HLS stream variable=rxEng_fsmEventFifo depth=2
 	#pragma HLS DATA_PACK variable=rxEng_metaHandlerEventFifo
@@ -1479,7 +2201,7 @@ void rx_engine(	stream<axiWord>&					ipRxData,
 	#pragma HLS stream variable=rx_internalNotificationFifo depth=8 //This depends on the memory delay
 	#pragma HLS DATA_PACK variable=rx_internalNotificationFifo
 
-	static stream<mmCmd> 					rxTcpFsm2wrAccessBreakdown("rxTcpFsm2wrAccessBreakdown");
+	static stream<mmBufferCmd> 			rxTcpFsm2wrAccessBreakdown("rxTcpFsm2wrAccessBreakdown");
 	#pragma HLS stream variable=rxTcpFsm2wrAccessBreakdown depth=8
 	#pragma HLS DATA_PACK variable=rxTcpFsm2wrAccessBreakdown
 
@@ -1489,34 +2211,50 @@ void rx_engine(	stream<axiWord>&					ipRxData,
 
 	static stream<ap_uint<1> >				rxEngDoubleAccess("rxEngDoubleAccess");
 	#pragma HLS stream variable=rxEngDoubleAccess depth=8
-	rxTcpLengthExtract(ipRxData, rxEng_dataBuffer0, rxEng_tcpLenFifo);
+	rxTcpLengthExtract(ipRxData, rxEng_dataBuffer0, rxEng_tcpLenFifo, rxEng_ceFifo);
 
 	rxInsertPseudoHeader(rxEng_dataBuffer0, rxEng_tcpLenFifo, rxEng_dataBuffer1);
 
-	rxCheckTCPchecksum(rxEng_dataBuffer1, rxEng_dataBuffer2, rxEng_tcpValidFifo, rxEng_metaDataFifo,
+	rxCheckTCPchecksum(rxEng_dataBuffer1, rxEng_ceFifo, rxEng_dataBuffer2, rxEng_tcpValidFifo, rxEng_metaDataFifo,
 						rxEng_tupleBuffer, rxEng2portTable_req);
 
 	rxTcpInvalidDropper(rxEng_dataBuffer2, rxEng_tcpValidFifo, rxEng_dataBuffer3);
 
 	rxMetadataHandler(	rxEng_metaDataFifo,
-						sLookup2rxEng_rsp,
 						portTable2rxEng_rsp,
 						rxEng_tupleBuffer,
 						rxEng2sLookup_req,
-						rxEng_metaHandlerEventFifo,
-						rxEng_metaHandlerDropFifo,
-						rxEng_fsmMetaDataFifo);
+						rxEng2timer_synQuery,
+						rxEng_lookupMetaFifo);
+
+	rxLookupReplyHandler(	rxEng_lookupMetaFifo,
+							sLookup2rxEng_rsp,
+							timer2rxEng_timeWaitRsp,
+							timer2rxEng_synRsp,
+							rxEng2timer_timeWaitQuery,
+							rxEng_metaHandlerEventFifo,
+							rxEng_metaHandlerDropFifo,
+							rxEng_fsmMetaDataFifo);
+
+	rxFsmRequestIssuer(	rxEng_fsmMetaDataFifo,
+						rxEng_fsmWriteBackFifo,
+						rxEng2stateTable_upd_req,
+						rxEng2ctx_upd_req,
+#if (TCP_KEEPALIVE)
+						rxEng2timer_setKeepAlive,
+#endif
+						rxEng_fsmIssuedMetaFifo);
 
-	rxTcpFSM(			rxEng_fsmMetaDataFifo,
+	rxTcpFSM(			rxEng_fsmIssuedMetaFifo,
 							stateTable2rxEng_upd_rsp,
-							rxSar2rxEng_upd_rsp,
-							txSar2rxEng_upd_rsp,
-							rxEng2stateTable_upd_req,
-							rxEng2rxSar_upd_req,
-							rxEng2txSar_upd_req,
+							ctx2rxEng_upd_rsp,
+							rxEng_fsmWriteBackFifo,
 							rxEng2timer_clearRetransmitTimer,
 							rxEng2timer_clearProbeTimer,
 							rxEng2timer_setCloseTimer,
+#if (TCP_PACING)
+							rxEng2pacer_setRate,
+#endif
 							openConStatusOut,
 							rxEng_fsmEventFifo,
 							rxEng_fsmDropFifo,
@@ -28,9 +28,23 @@ EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.// Copyright (c) 2015 Xilinx,
 ************************************************/
 
 #include "../toe.hpp"
+#include "../congestion_control/congestion_control.hpp"
+#include "../syn_cookie/syn_cookie.hpp"
 
 using namespace hls;
 
+/** @ingroup rx_engine
+ *  Data mover tag of buffer writes for out-of-order segments, their write status
+ *  is consumed without releasing a notification to the application
+ */
+static const ap_uint<4> RX_OOO_WRITE_TAG = 0x1;
+
+/** @ingroup rx_engine
+ *  TCP option kinds extracted by the option parser in @ref rxCheckTCPchecksum
+ */
+enum tcpOptionKind {OPT_KIND_EOL = 0, OPT_KIND_NOP = 1, OPT_KIND_MSS = 2, OPT_KIND_WS = 3,
+					OPT_KIND_SACK_PERMITTED = 4, OPT_KIND_SACK = 5, OPT_KIND_TIMESTAMP = 8};
+
 /** @ingroup rx_engine
  *  @TODO check if same as in Tx engine
  */
@@ -45,6 +59,22 @@ struct rxEngineMetaData
 	ap_uint<1>	rst;
 	ap_uint<1>	syn;
 	ap_uint<1>	fin;
+	ap_uint<1>	ece;
+	ap_uint<1>	cwr;
+	bool		ce;				// Congestion Experienced in the IP header
+	// TCP options
+	ap_uint<16>	mss;			// DEFAULT_MSS if the option is missing, only valid on SYN
+	ap_uint<4>	winScale;		// Shift of the Window Scale option, only valid on SYN
+	bool		winScaleValid;
+	bool		sackPermitted;	// Only valid on SYN
+	ap_uint<3>	sackCount;		// Number of valid SACK blocks
+	ap_uint<32>	sackLeft[TCP_SACK_BLOCKS];
+	ap_uint<32>	sackRight[TCP_SACK_BLOCKS];
+	ap_uint<32>	tsVal;
+	ap_uint<32>	tsEcr;
+	bool		tsValid;
+	bool		synCookie;		// ACK that returns a valid SYN cookie, set by the rxMetadataHandler
+	ap_uint<2>	bufferClass;	// Buffer class of the listening port, set by the rxMetadataHandler
 	//ap_uint<16> dstPort;
 };
 
@@ -56,10 +86,57 @@ struct rxFsmMetaData
 	ap_uint<16>			sessionID;
 	ap_uint<32>			srcIpAddress;
 	ap_uint<16>			dstIpPort;
+	fourTuple			tuple;	// Kept for the TIME-WAIT record of the session
 	rxEngineMetaData	meta; //check if all needed
+	timeWaitReply		timeWait;	// Hit if a TIME-WAIT record rejects the SYN, RFC 1122 4.2.2.13
 	rxFsmMetaData() {}
-	rxFsmMetaData(ap_uint<16> id, ap_uint<32> ipAddr, ap_uint<16> ipPort, rxEngineMetaData meta)
-				:sessionID(id), srcIpAddress(ipAddr), dstIpPort(ipPort), meta(meta) {}
+	rxFsmMetaData(ap_uint<16> id, ap_uint<32> ipAddr, ap_uint<16> ipPort, fourTuple tuple, rxEngineMetaData meta, timeWaitReply timeWait)
+				:sessionID(id), srcIpAddress(ipAddr), dstIpPort(ipPort), tuple(tuple), meta(meta), timeWait(timeWait) {}
+};
+
+/** @ingroup rx_engine
+ *  Segment waiting in the @ref rxLookupReplyHandler for the reply to its session lookup, no lookup
+ *  is issued for closed ports. A SYN also waits for its TIME-WAIT lookup, which carries the tag.
+ *  The SYN cookie period is the one of the arrival
+ */
+struct rxLookupMetaData
+{
+	rxEngineMetaData					meta;
+	fourTuple							tuple;
+	ap_uint<SYN_COOKIE_PERIOD_BITS>		cookiePeriod;
+	bool								portOpen;
+	bool								timeWaitCheck;
+	ap_uint<3>							tag;
+	rxLookupMetaData() {}
+	rxLookupMetaData(rxEngineMetaData meta, fourTuple tuple, ap_uint<SYN_COOKIE_PERIOD_BITS> period, bool open, bool twCheck, ap_uint<3> tag)
+					:meta(meta), tuple(tuple), cookiePeriod(period), portOpen(open), timeWaitCheck(twCheck), tag(tag) {}
+};
+
+/** @ingroup rx_engine
+ *  Segment handed from the @ref rxFsmRequestIssuer to the @ref rxTcpFSM, indicates if the
+ *  values of the previous segment are forwarded instead of consuming the context reply
+ */
+struct rxFsmIssuedMeta
+{
+	rxFsmMetaData	fsm;
+	bool			forward;
+	rxFsmIssuedMeta() {}
+	rxFsmIssuedMeta(rxFsmMetaData fsm, bool forward)
+					:fsm(fsm), forward(forward) {}
+};
+
+/** @ingroup rx_engine
+ *  All table updates of one segment, passed from the @ref rxTcpFSM back to the @ref rxFsmRequestIssuer.
+ *  The rxSar and txSar parts of the context are only written if their write flag is set
+ */
+struct rxFsmWriteBack
+{
+	stateQuery		state;
+	rxSarRecvd		rxSar;
+	rxTxSarQuery	txSar;
+	rxFsmWriteBack() {}
+	rxFsmWriteBack(ap_uint<16> id)
+					:state(id), rxSar(id), txSar(id) {}
 };
 
 /** @defgroup rx_engine RX Engine
@@ -69,9 +146,10 @@ struct rxFsmMetaData
 void rx_engine(	stream<axiWord>&					ipRxData,
 				stream<sessionLookupReply>&			sLookup2rxEng_rsp,
 				stream<sessionState>&				stateTable2rxEng_upd_rsp,
-				stream<bool>&						portTable2rxEng_rsp,
-				stream<rxSarEntry>&					rxSar2rxEng_upd_rsp,
-				stream<rxTxSarReply>&				txSar2rxEng_upd_rsp,
+				stream<portCheckReply>&				portTable2rxEng_rsp,
+				stream<rxSessionCtxReply>&			ctx2rxEng_upd_rsp,
+				stream<timeWaitReply>&				timer2rxEng_timeWaitRsp,
+				stream<timeWaitReply>&				timer2rxEng_synRsp,
 #if !(RX_DDR_BYPASS)
 				stream<mmStatus>&					rxBufferWriteStatus,
 #endif
@@ -79,11 +157,18 @@ void rx_engine(	stream<axiWord>&					ipRxData,
 				stream<sessionLookupQuery>&			rxEng2sLookup_req,
 				stream<stateQuery>&					rxEng2stateTable_upd_req,
 				stream<ap_uint<16> >&				rxEng2portTable_req,
-				stream<rxSarRecvd>&					rxEng2rxSar_upd_req,
-				stream<rxTxSarQuery>&				rxEng2txSar_upd_req,
+				stream<rxSessionCtxQuery>&			rxEng2ctx_upd_req,
 				stream<rxRetransmitTimerUpdate>&	rxEng2timer_clearRetransmitTimer,
 				stream<ap_uint<16> >&				rxEng2timer_clearProbeTimer,
-				stream<ap_uint<16> >&				rxEng2timer_setCloseTimer,
+				stream<timeWaitEntry>&				rxEng2timer_setCloseTimer,
+				stream<timeWaitQuery>&				rxEng2timer_timeWaitQuery,
+				stream<timeWaitQuery>&				rxEng2timer_synQuery,
+#if (TCP_KEEPALIVE)
+				stream<keepAliveUpdate>&			rxEng2timer_setKeepAlive,
+#endif
+#if (TCP_PACING)
+				stream<pacerRateUpdate>&			rxEng2pacer_setRate,
+#endif
 				stream<openStatus>&					openConStatusOut, //TODO remove
 				stream<extendedEvent>&				rxEng2eventEng_setEvent,
 #if !(RX_DDR_BYPASS)
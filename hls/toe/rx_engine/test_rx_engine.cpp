@@ -41,12 +41,12 @@ void simSlookup(stream<sessionLookupQuery>&	req, stream<sessionLookupReply>& rsp
 	}
 }
 
-void simPortTable(stream<ap_uint<16> >& req, stream<bool>& rsp)
+void simPortTable(stream<ap_uint<16> >& req, stream<portCheckReply>& rsp)
 {
 	if (!req.empty())
 	{
 		req.read();
-		rsp.write(true);
+		rsp.write(portCheckReply(true, TCP_BUFFER_CLASS_ACCEPT));
 	}
 }
 
@@ -79,6 +79,9 @@ void simRxSar(stream<rxSarRecvd>& req, stream<rxSarEntry>& rsp)
 		if (query.write)
 		{
 			currRxEntry.recvd = query.recvd;
+			currRxEntry.ooo_head = query.ooo_head;
+			currRxEntry.ooo_length = query.ooo_length;
+			currRxEntry.ooo_valid = query.ooo_valid;
 		}
 		else
 		{
@@ -114,7 +117,7 @@ int main(int argc, char* argv[])
 	stream<axiWord>						ipRxData;
 	stream<sessionLookupReply>			sLookup2rxEng_rsp;
 	stream<sessionState>				stateTable2rxEng_upd_rsp("stateTable2rxEng_upd_rsp");
-	stream<bool>						portTable2rxEng_rsp("portTable2rxEng_rsp");
+	stream<portCheckReply>				portTable2rxEng_rsp("portTable2rxEng_rsp");
 	stream<rxSarEntry>					rxSar2rxEng_upd_rsp;
 	stream<ap_uint<32> >				txSar2rxEng_upd_rsp;
 	stream<mmStatus>					rxBufferWriteStatus;
@@ -125,7 +128,7 @@ int main(int argc, char* argv[])
 	stream<rxSarRecvd>					rxEng2rxSar_upd_req;
 	stream<rxTxSarQuery>				rxEng2txSar_upd_req;
 	stream<rxRetransmitTimerUpdate>		rxEng2timer_clearRetransmitTimer;
-	stream<ap_uint<16> >				rxEng2timer_setCloseTimer;
+	stream<timeWaitEntry>				rxEng2timer_setCloseTimer;
 	stream<openStatus>					openConStatusOut; //TODO remove
 	stream<extendedEvent>				rxEng2eventEng_setEvent("rxEng2eventEng_setEvent");
 	stream<mmCmd>						rxBufferWriteCmd;
@@ -0,0 +1,487 @@
+/************************************************
+Copyright (c) 2016, Xilinx, Inc.
+All rights reserved.
+
+Redistribution and use in source and binary forms, with or without modification, 
+are permitted provided that the following conditions are met:
+
+1. Redistributions of source code must retain the above copyright notice, 
+this list of conditions and the following disclaimer.
+
+2. Redistributions in binary form must reproduce the above copyright notice, 
+this list of conditions and the following disclaimer in the documentation 
+and/or other materials provided with the distribution.
+
+3. Neither the name of the copyright holder nor the names of its contributors 
+may be used to endorse or promote products derived from this software 
+without specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND 
+ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, 
+THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED. 
+IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, 
+INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, 
+PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) 
+HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, 
+OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, 
+EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.// Copyright (c) 2015 Xilinx, Inc.
+************************************************/
+
+#include "session_context_table.hpp"
+
+using namespace hls;
+
+/** @ingroup session_context_table
+ *  Send window of a session, the smaller of the congestion and the receive window.
+ *  Limited transmit, RFC 3042. The first two duplicate ACKs allow one new segment each
+ */
+ap_uint<WINDOW_BITS> ctxMinWindow(	ap_uint<WINDOW_BITS>	congWindow,
+									ap_uint<WINDOW_BITS>	recvWindow,
+									ap_uint<2>				count,
+									bool					fastRetransmitted)
+{
+#pragma HLS INLINE
+	ap_uint<WINDOW_BITS+1> window = congWindow;
+	if (!fastRetransmitted && count != 3)
+	{
+		window += count * MSS;
+	}
+	if (window < recvWindow)
+	{
+		return window;
+	}
+	return recvWindow;
+}
+
+/** @ingroup session_context_table
+ *  Initializes the TX part of a context, the SYN with sequence number notAckd-1 is not acknowledged yet
+ */
+void ctxInitTx(	sessionContext&	ctx,
+				ap_uint<32>		notAckd,
+				bool			finReady,
+				bool			finSent)
+{
+#pragma HLS INLINE
+	ctx.tx.not_ackd = notAckd;
+	ctx.tx.app = notAckd;
+	ctx.tx.ackd = notAckd-1;
+	ctx.tx.cong_window = 0x3908; // 10 x 1460(MSS)
+	ctx.tx.slowstart_threshold = BUFFER_SIZE-1;
+	ccInit(ctx.tx.cc, notAckd);
+	ctx.tx.cwr_pending = false;
+	ctx.tx.count = 0;
+	ctx.tx.fastRetransmitted = false;
+	ctx.tx.recover = notAckd;
+	ctx.tx.finReady = finReady;
+	ctx.tx.finSent = finSent;
+	ctx.sack.count = 0;
+	ctx.tx.srtt = 0;
+	ctx.tx.rttvar = 0;
+	ctx.tx.rto = TCP_RTO_INIT;
+	ctx.tx.pto = TCP_RTO_INIT;
+	ctx.tx.rtt_active = false;
+	ctx.tx.mempt = notAckd;
+}
+
+/** @ingroup session_context_table
+ *  This data structure stores the RX(receiving) and TX(transmitting) sliding windows of every session
+ *  in one record, which replaces the separate RX and TX SAR tables and the copy of the acknowledged
+ *  pointer kept by the @ref tx_app_if. It handles concurrent access from the @ref rx_engine, @ref tx_engine,
+ *  @ref rx_app_if and @ref tx_app_if, the engines read both parts of a record with a single request.
+ *  Next to the TX part the SACK scoreboard of each session is kept, it is replaced by every ACK
+ *  from the @ref rx_engine and read by the @ref tx_engine.
+ *  One segment per session is timed for the RTT estimation, it is started by a @ref tx_engine write
+ *  that sends new data and discarded on a retransmission (Karn's algorithm). The @ref rx_engine
+ *  receives the elapsed cycles with its read and writes the new estimate back.
+ *  The RX buffer of a session is allocated when the @ref rx_engine initializes the RX part, the TX buffer
+ *  on the init by the @ref tx_engine, or by the @ref rx_engine for a session opened by a SYN cookie. Both are
+ *  returned to their @ref buffer_allocator when the session is released.
+ *  A request is held until its record is in the @ref context_cache, with TCP_DDR_CONTEXT the records live in DDR
+ *  and a miss is fetched first. A session evicted with a write back is only fetched again once its write status returned.
+ *  The context region has to be cleared before the TOE is started, like the on-chip table
+ *  @param[in]		rxEng2ctx_upd_req
+ *  @param[in]		txEng2ctx_upd_req
+ *  @param[in]		rxApp2ctx_upd_req
+ *  @param[in]		txApp2ctx_upd_req
+ *  @param[in]		txApp2ctx_app_push
+ *  @param[in]		stateTable2ctx_releaseSession
+ *  @param[in]		sLookup2ctx_prefetch
+ *  @param[in]		sessionContextReadData
+ *  @param[in]		sessionContextWriteStatus
+ *  @param[out]		sessionContextReadCmd
+ *  @param[out]		sessionContextWriteCmd
+ *  @param[out]		sessionContextWriteData
+ *  @param[out]		ctx2rxEng_upd_rsp
+ *  @param[out]		ctx2txEng_upd_rsp
+ *  @param[out]		ctx2rxApp_upd_rsp
+ *  @param[out]		ctx2txApp_upd_rsp
+ */
+void session_context_table(	stream<rxSessionCtxQuery>&		rxEng2ctx_upd_req,
+							stream<txTxSarQuery>&			txEng2ctx_upd_req,
+							stream<rxSarAppd>&				rxApp2ctx_upd_req,
+							stream<txAppTxSarQuery>&		txApp2ctx_upd_req,
+							stream<txAppTxSarPush>&			txApp2ctx_app_push,
+							stream<ap_uint<16> >&			stateTable2ctx_releaseSession,
+#if (TCP_DDR_CONTEXT)
+							stream<ap_uint<16> >&			sLookup2ctx_prefetch,
+							stream<sessionContext>&			sessionContextReadData,
+							stream<mmStatus>&				sessionContextWriteStatus,
+							stream<mmCmd>&					sessionContextReadCmd,
+							stream<mmCmd>&					sessionContextWriteCmd,
+							stream<sessionContext>&			sessionContextWriteData,
+#endif
+							stream<rxSessionCtxReply>&		ctx2rxEng_upd_rsp,
+							stream<txSessionCtxReply>&		ctx2txEng_upd_rsp,
+							stream<rxSarAppd>&				ctx2rxApp_upd_rsp,
+							stream<txAppTxSarReply>&		ctx2txApp_upd_rsp)
+{
+#pragma HLS PIPELINE II=1
+
+	static sessionContext ctx_table[CTX_TABLE_SIZE];
+	#pragma HLS DEPENDENCE variable=ctx_table inter false
+	SESSION_TABLE_RESOURCE(ctx_table, RAM_T2P_BRAM)
+	#pragma HLS DATA_PACK variable=ctx_table
+	// Free running cycle counter, the table is accessed every cycle
+	static ap_uint<32> sct_clock = 0;
+	// Timestamp clock of the TSval we send and the RTT samples taken from the TSecr we receive, RFC 7323
+	static ap_uint<32> sct_tsClock = 0;
+	// Request that is served once its record is cached
+	static ctxSource			sct_source = CTX_SRC_IDLE;
+	static ap_uint<16>			sct_sessionID;
+	static txTxSarQuery			sct_txEngQuery;
+	static rxSessionCtxQuery	sct_rxEngQuery;
+	static rxSarAppd			sct_rxAppQuery;
+	static txAppTxSarQuery		sct_txAppQuery;
+	static txAppTxSarPush		sct_txAppPush;
+
+	txTxSarRtQuery txEngRtUpdate;
+	bool rxBufferAccess = false;
+	bool txBufferAccess = false;
+	bool bufferRelease = false;
+	ap_uint<2> bufferClass = 0;
+	sessionBuffer rxBuffer;
+	sessionBuffer txBuffer;
+	ap_uint<16> slot;
+	ctxCacheResult ctx;
+
+	sct_clock++;
+	if (sct_clock(TS_CLOCK_SHIFT-1, 0) == 0)
+	{
+		sct_tsClock++;
+	}
+
+	if (sct_source == CTX_SRC_IDLE)
+	{
+		if (!txEng2ctx_upd_req.empty())
+		{
+			txEng2ctx_upd_req.read(sct_txEngQuery);
+			sct_sessionID = sct_txEngQuery.sessionID;
+			sct_source = CTX_SRC_TXENG;
+		}
+		else if (!txApp2ctx_app_push.empty())
+		{
+			txApp2ctx_app_push.read(sct_txAppPush);
+			sct_sessionID = sct_txAppPush.sessionID;
+			sct_source = CTX_SRC_TXAPP_PUSH;
+		}
+		else if (!txApp2ctx_upd_req.empty())
+		{
+			txApp2ctx_upd_req.read(sct_txAppQuery);
+			sct_sessionID = sct_txAppQuery.sessionID;
+			sct_source = CTX_SRC_TXAPP;
+		}
+		else if (!rxApp2ctx_upd_req.empty())
+		{
+			rxApp2ctx_upd_req.read(sct_rxAppQuery);
+			sct_sessionID = sct_rxAppQuery.sessionID;
+			sct_source = CTX_SRC_RXAPP;
+		}
+		else if (!rxEng2ctx_upd_req.empty())
+		{
+			rxEng2ctx_upd_req.read(sct_rxEngQuery);
+			sct_sessionID = sct_rxEngQuery.sessionID;
+			sct_source = CTX_SRC_RXENG;
+		}
+		else if (!stateTable2ctx_releaseSession.empty())
+		{
+			stateTable2ctx_releaseSession.read(sct_sessionID);
+			sct_source = CTX_SRC_RELEASE;
+		}
+	}
+
+#if (TCP_DDR_CONTEXT)
+	// A returned line is installed first, the held request is retried afterwards
+	if (!sessionContextReadData.empty())
+	{
+		ctx = context_cache<0>(CTX_FILL, 0, false);
+		sessionContextReadData.read(ctx_table[ctx.slot]);
+	}
+	else if (!sessionContextWriteStatus.empty())
+	{
+		sessionContextWriteStatus.read();
+		context_cache<0>(CTX_WRITE_DONE, 0, false);
+	}
+	else if (sct_source == CTX_SRC_IDLE && !sLookup2ctx_prefetch.empty())
+	{
+		ap_uint<16> prefetchID = sLookup2ctx_prefetch.read();
+		ctx = context_cache<0>(CTX_PREFETCH, prefetchID, false);
+		if (ctx.evict)
+		{
+			sessionContextWriteData.write(ctx_table[ctx.slot]);
+		}
+		contextCacheMemCmd(ctx, prefetchID, sizeof(sessionContext), sessionContextReadCmd, sessionContextWriteCmd);
+	}
+	else
+#endif
+	if (sct_source != CTX_SRC_IDLE)
+	{
+		ctx = context_cache<0>(CTX_ACCESS, sct_sessionID, sct_source == CTX_SRC_TXAPP_PUSH || sct_source == CTX_SRC_RELEASE ||
+															(sct_source == CTX_SRC_TXENG && sct_txEngQuery.write) ||
+															(sct_source == CTX_SRC_TXAPP && sct_txAppQuery.write) ||
+															(sct_source == CTX_SRC_RXAPP && sct_rxAppQuery.write) ||
+															(sct_source == CTX_SRC_RXENG && sct_rxEngQuery.writeMask != 0));
+#if (TCP_DDR_CONTEXT)
+		if (ctx.evict)
+		{
+			sessionContextWriteData.write(ctx_table[ctx.slot]);
+		}
+		contextCacheMemCmd(ctx, sct_sessionID, sizeof(sessionContext), sessionContextReadCmd, sessionContextWriteCmd);
+#endif
+	}
+
+	slot = ctx.slot;
+	if (ctx.hit)
+	{
+		// TX Engine
+		if (sct_source == CTX_SRC_TXENG)
+		{
+			if (sct_txEngQuery.write)
+			{
+				if (!sct_txEngQuery.isRtQuery)
+				{
+					// Time the segment if no other is measured
+					if (!ctx_table[slot].tx.rtt_active && sct_txEngQuery.not_ackd != ctx_table[slot].tx.not_ackd)
+					{
+						ctx_table[slot].tx.rtt_seq = sct_txEngQuery.not_ackd;
+						ctx_table[slot].tx.rtt_start = sct_clock;
+						ctx_table[slot].tx.rtt_active = true;
+					}
+					ctx_table[slot].tx.not_ackd = sct_txEngQuery.not_ackd;
+					if (sct_txEngQuery.init)
+					{
+						ctxInitTx(ctx_table[slot], sct_txEngQuery.not_ackd, sct_txEngQuery.finReady, sct_txEngQuery.finSent);
+						// A repeated init keeps the buffer
+						txBuffer = ctx_table[slot].tx.buffer;
+						txBufferAccess = !ctx_table[slot].tx.bufferValid;
+						bufferClass = sct_txEngQuery.bufferClass;
+					}
+					if (sct_txEngQuery.finReady)
+					{
+						ctx_table[slot].tx.finReady = sct_txEngQuery.finReady;
+					}
+					if (sct_txEngQuery.finSent)
+					{
+						ctx_table[slot].tx.finSent = sct_txEngQuery.finSent;
+					}
+					if (sct_txEngQuery.cwrSent)
+					{
+						ctx_table[slot].tx.cwr_pending = false;
+					}
+				}
+				else
+				{
+					// Loss response of the retransmit timer
+					txEngRtUpdate = sct_txEngQuery;
+					ccLossDetected(	ctx_table[slot].tx.cong_window,
+									ctx_table[slot].tx.slowstart_threshold,
+									ctx_table[slot].tx.cc,
+									txEngRtUpdate.getFlightSize(), true);
+					ctx_table[slot].tx.cc.epoch = sct_clock;
+					ctx_table[slot].tx.rtt_active = false;
+					// A timeout ends the fast recovery, duplicate ACKs of the data sent so far do not start a new one, RFC 6582 4
+					ctx_table[slot].tx.count = 0;
+					ctx_table[slot].tx.fastRetransmitted = false;
+					ctx_table[slot].tx.recover = ctx_table[slot].tx.not_ackd;
+				}
+			}
+			else // Read
+			{
+				txTxSarReply reply(	ctx_table[slot].tx.ackd,
+									ctx_table[slot].tx.not_ackd,
+									ctxMinWindow(ctx_table[slot].tx.cong_window, ctx_table[slot].tx.recv_window,
+												ctx_table[slot].tx.count, ctx_table[slot].tx.fastRetransmitted),
+									ctx_table[slot].tx.app,
+									ctx_table[slot].tx.finReady,
+									ctx_table[slot].tx.finSent);
+				reply.sackBoard = ctx_table[slot].sack;
+				reply.rto = ctx_table[slot].tx.rto;
+				reply.pto = ctx_table[slot].tx.pto;
+				reply.cwr_pending = ctx_table[slot].tx.cwr_pending;
+				reply.ts_clock = sct_tsClock;
+				reply.buffer = ctx_table[slot].tx.buffer;
+				ctx2txEng_upd_rsp.write(txSessionCtxReply(ctx_table[slot].rx, reply));
+			}
+		}
+		// TX App Stream If, the application pointer is released once the data is written
+		else if (sct_source == CTX_SRC_TXAPP_PUSH)
+		{
+			ctx_table[slot].tx.app = sct_txAppPush.app;
+		}
+		// TX App Stream If, write pointer and free space
+		else if (sct_source == CTX_SRC_TXAPP)
+		{
+			if (sct_txAppQuery.write)
+			{
+				ctx_table[slot].tx.mempt = sct_txAppQuery.mempt;
+			}
+			else
+			{
+#if !(TCP_NODELAY)
+				txAppTxSarReply reply(sct_txAppQuery.sessionID, ctx_table[slot].tx.ackd, ctx_table[slot].tx.mempt);
+#else
+				txAppTxSarReply reply(sct_txAppQuery.sessionID, ctx_table[slot].tx.ackd, ctx_table[slot].tx.mempt,
+										ctxMinWindow(ctx_table[slot].tx.cong_window, ctx_table[slot].tx.recv_window,
+													ctx_table[slot].tx.count, ctx_table[slot].tx.fastRetransmitted));
+#endif
+				reply.buffer = ctx_table[slot].tx.buffer;
+				ctx2txApp_upd_rsp.write(reply);
+			}
+		}
+		// Read or Write access from the Rx App I/F to update the application pointer
+		else if (sct_source == CTX_SRC_RXAPP)
+		{
+			if (sct_rxAppQuery.write)
+			{
+				ctx_table[slot].rx.appd = sct_rxAppQuery.appd;
+			}
+			else
+			{
+				ctx2rxApp_upd_rsp.write(rxSarAppd(sct_rxAppQuery.sessionID, ctx_table[slot].rx.appd, ctx_table[slot].rx.buffer));
+			}
+		}
+		// RX Engine, both parts are read with one request and written back as selected by the mask
+		else if (sct_source == CTX_SRC_RXENG)
+		{
+			if (sct_rxEngQuery.writeMask & CTX_WRITE_RXSAR)
+			{
+				ctx_table[slot].rx.recvd = sct_rxEngQuery.rxSar.recvd;
+				ctx_table[slot].rx.ooo_head = sct_rxEngQuery.rxSar.ooo_head;
+				ctx_table[slot].rx.ooo_length = sct_rxEngQuery.rxSar.ooo_length;
+				ctx_table[slot].rx.ooo_valid = sct_rxEngQuery.rxSar.ooo_valid;
+				ctx_table[slot].rx.ce = sct_rxEngQuery.rxSar.ce;
+				ctx_table[slot].rx.ts_recent = sct_rxEngQuery.rxSar.ts_recent;
+				if (sct_rxEngQuery.rxSar.init)
+				{
+					ctx_table[slot].rx.appd = sct_rxEngQuery.rxSar.recvd;
+					ctx_table[slot].rx.win_shift = sct_rxEngQuery.rxSar.win_shift;
+					ctx_table[slot].rx.sack_ok = sct_rxEngQuery.rxSar.sack_ok;
+					ctx_table[slot].rx.ecn_ok = sct_rxEngQuery.rxSar.ecn_ok;
+					ctx_table[slot].rx.ts_ok = sct_rxEngQuery.rxSar.ts_ok;
+					// A repeated init keeps the buffer
+					rxBufferAccess = !ctx_table[slot].rx.bufferValid;
+					bufferClass = sct_rxEngQuery.rxSar.bufferClass;
+				}
+			}
+#if (TCP_SYN_COOKIES)
+			// The ACK of a SYN cookie opened the session, the TX part was never initialized by a SYN-ACK
+			if ((sct_rxEngQuery.writeMask & CTX_WRITE_TXSAR) && sct_rxEngQuery.txSar.init)
+			{
+				ctxInitTx(ctx_table[slot], sct_rxEngQuery.txSar.ackd, false, false);
+				ctx_table[slot].tx.ackd = sct_rxEngQuery.txSar.ackd;
+				ctx_table[slot].tx.recv_window = sct_rxEngQuery.txSar.recv_window;
+				ctx_table[slot].tx.win_shift = sct_rxEngQuery.txSar.win_shift;
+				txBuffer = ctx_table[slot].tx.buffer;
+				txBufferAccess = !ctx_table[slot].tx.bufferValid;
+				bufferClass = TCP_BUFFER_CLASS_ACCEPT;
+			}
+			else
+#endif
+			if (sct_rxEngQuery.writeMask & CTX_WRITE_TXSAR)
+			{
+				ctx_table[slot].tx.ackd = sct_rxEngQuery.txSar.ackd;
+				ctx_table[slot].tx.recv_window = sct_rxEngQuery.txSar.recv_window;
+				ctx_table[slot].tx.cong_window = sct_rxEngQuery.txSar.cong_window;
+				ctx_table[slot].tx.slowstart_threshold = sct_rxEngQuery.txSar.slowstart_threshold;
+				ctx_table[slot].tx.cc = sct_rxEngQuery.txSar.cc;
+				if (sct_rxEngQuery.txSar.cc_newEpoch)
+				{
+					ctx_table[slot].tx.cc.epoch = sct_clock;
+				}
+				if (sct_rxEngQuery.txSar.cwr)
+				{
+					ctx_table[slot].tx.cwr_pending = true;
+				}
+				ctx_table[slot].tx.win_shift = sct_rxEngQuery.txSar.win_shift;
+				ctx_table[slot].tx.count = sct_rxEngQuery.txSar.count;
+				ctx_table[slot].tx.fastRetransmitted = sct_rxEngQuery.txSar.fastRetransmitted;
+				ctx_table[slot].tx.recover = sct_rxEngQuery.txSar.recover;
+				ctx_table[slot].sack = sct_rxEngQuery.txSar.sackBoard;
+				if (sct_rxEngQuery.txSar.rtt_sample)
+				{
+					ctx_table[slot].tx.srtt = sct_rxEngQuery.txSar.srtt;
+					ctx_table[slot].tx.rttvar = sct_rxEngQuery.txSar.rttvar;
+					ctx_table[slot].tx.rto = sct_rxEngQuery.txSar.rto;
+					ctx_table[slot].tx.pto = sct_rxEngQuery.txSar.pto;
+				}
+				// A fast retransmit makes the timed segment ambiguous
+				if (sct_rxEngQuery.txSar.rtt_sample || sct_rxEngQuery.txSar.fastRetransmitted)
+				{
+					ctx_table[slot].tx.rtt_active = false;
+				}
+			}
+			if (sct_rxEngQuery.writeMask == 0)
+			{
+				rxTxSarReply reply(	ctx_table[slot].tx.ackd,
+									ctx_table[slot].tx.not_ackd,
+									ctx_table[slot].tx.cong_window,
+									ctx_table[slot].tx.slowstart_threshold,
+									ctx_table[slot].tx.win_shift,
+									ctx_table[slot].tx.count,
+									ctx_table[slot].tx.fastRetransmitted);
+				reply.recover = ctx_table[slot].tx.recover;
+				reply.cc = ctx_table[slot].tx.cc;
+				reply.cc_elapsed = sct_clock - ctx_table[slot].tx.cc.epoch;
+				reply.srtt = ctx_table[slot].tx.srtt;
+				reply.rttvar = ctx_table[slot].tx.rttvar;
+				reply.rto = ctx_table[slot].tx.rto;
+				reply.rtt_seq = ctx_table[slot].tx.rtt_seq;
+				reply.rtt_elapsed = sct_clock - ctx_table[slot].tx.rtt_start;
+				reply.rtt_active = ctx_table[slot].tx.rtt_active;
+				reply.ts_clock = sct_tsClock;
+				ctx2rxEng_upd_rsp.write(rxSessionCtxReply(ctx_table[slot].rx, reply));
+			}
+		}
+		// Session was closed
+		else if (sct_source == CTX_SRC_RELEASE)
+		{
+			rxBuffer = ctx_table[slot].rx.buffer;
+			rxBufferAccess = ctx_table[slot].rx.bufferValid;
+			txBuffer = ctx_table[slot].tx.buffer;
+			txBufferAccess = ctx_table[slot].tx.bufferValid;
+			bufferRelease = true;
+			ctx_table[slot].rx.bufferValid = false;
+			ctx_table[slot].tx.bufferValid = false;
+		}
+		sct_source = CTX_SRC_IDLE;
+	}
+
+	// The pools hold more buffers than sessions, an allocation does not fail
+	if (rxBufferAccess)
+	{
+		buffer_allocator<0>(bufferRelease, bufferClass, rxBuffer);
+		if (!bufferRelease)
+		{
+			ctx_table[slot].rx.buffer = rxBuffer;
+			ctx_table[slot].rx.bufferValid = true;
+		}
+	}
+	if (txBufferAccess)
+	{
+		buffer_allocator<1>(bufferRelease, bufferClass, txBuffer);
+		if (!bufferRelease)
+		{
+			ctx_table[slot].tx.buffer = txBuffer;
+			ctx_table[slot].tx.bufferValid = true;
+		}
+	}
+}
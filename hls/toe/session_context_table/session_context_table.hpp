@@ -27,16 +27,36 @@ OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF
 EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.// Copyright (c) 2015 Xilinx, Inc.
 ************************************************/
 #include "../toe.hpp"
+#include "../congestion_control/congestion_control.hpp"
+#include "../buffer_allocator/buffer_allocator.hpp"
+#include "../context_cache/context_cache.hpp"
 
 using namespace hls;
 
-/** @defgroup tx_sar_table TX SAR Table
+/** @ingroup session_context_table
+ *  Origin of the request held by the table
+ */
+enum ctxSource {CTX_SRC_IDLE, CTX_SRC_TXENG, CTX_SRC_TXAPP_PUSH, CTX_SRC_TXAPP, CTX_SRC_RXAPP, CTX_SRC_RXENG, CTX_SRC_RELEASE};
+
+/** @defgroup session_context_table Session Context Table
  *  @ingroup tcp_module
- *  @TODO rename, why SAR
+ *  Holds the RX and TX sliding windows of every session in one record
  */
-void tx_sar_table(	stream<rxTxSarQuery>&			rxEng2txSar_upd_req,
-					stream<txTxSarQuery>&			txEng2txSar_upd_req,
-					stream<txAppTxSarPush>&			txApp2txSar_app_push,
-					stream<rxTxSarReply>&			txSar2rxEng_upd_rsp,
-					stream<txTxSarReply>&			txSar2txEng_upd_rsp,
-					stream<txSarAckPush>&			txSar2txApp_ack_push);
+void session_context_table(	stream<rxSessionCtxQuery>&		rxEng2ctx_upd_req,
+							stream<txTxSarQuery>&			txEng2ctx_upd_req,
+							stream<rxSarAppd>&				rxApp2ctx_upd_req,
+							stream<txAppTxSarQuery>&		txApp2ctx_upd_req,
+							stream<txAppTxSarPush>&			txApp2ctx_app_push,
+							stream<ap_uint<16> >&			stateTable2ctx_releaseSession,
+#if (TCP_DDR_CONTEXT)
+							stream<ap_uint<16> >&			sLookup2ctx_prefetch,
+							stream<sessionContext>&			sessionContextReadData,
+							stream<mmStatus>&				sessionContextWriteStatus,
+							stream<mmCmd>&					sessionContextReadCmd,
+							stream<mmCmd>&					sessionContextWriteCmd,
+							stream<sessionContext>&			sessionContextWriteData,
+#endif
+							stream<rxSessionCtxReply>&		ctx2rxEng_upd_rsp,
+							stream<txSessionCtxReply>&		ctx2txEng_upd_rsp,
+							stream<rxSarAppd>&				ctx2rxApp_upd_rsp,
+							stream<txAppTxSarReply>&		ctx2txApp_upd_rsp);
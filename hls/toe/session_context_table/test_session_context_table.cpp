@@ -0,0 +1,196 @@
+/************************************************
+Copyright (c) 2016, Xilinx, Inc.
+All rights reserved.
+
+Redistribution and use in source and binary forms, with or without modification, 
+are permitted provided that the following conditions are met:
+
+1. Redistributions of source code must retain the above copyright notice, 
+this list of conditions and the following disclaimer.
+
+2. Redistributions in binary form must reproduce the above copyright notice, 
+this list of conditions and the following disclaimer in the documentation 
+and/or other materials provided with the distribution.
+
+3. Neither the name of the copyright holder nor the names of its contributors 
+may be used to endorse or promote products derived from this software 
+without specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND 
+ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, 
+THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED. 
+IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, 
+INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, 
+PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) 
+HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, 
+OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, 
+EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.// Copyright (c) 2015 Xilinx, Inc.
+************************************************/
+#include "session_context_table.hpp"
+#include <iostream>
+
+using namespace hls;
+
+stream<rxSessionCtxQuery>	rxEng2ctx_upd_req;
+stream<txTxSarQuery>		txEng2ctx_upd_req;
+stream<rxSarAppd>			rxApp2ctx_upd_req;
+stream<txAppTxSarQuery>		txApp2ctx_upd_req;
+stream<txAppTxSarPush>		txApp2ctx_app_push;
+stream<ap_uint<16> >		stateTable2ctx_releaseSession;
+stream<rxSessionCtxReply>	ctx2rxEng_upd_rsp;
+stream<txSessionCtxReply>	ctx2txEng_upd_rsp;
+stream<rxSarAppd>			ctx2rxApp_upd_rsp;
+stream<txAppTxSarReply>		ctx2txApp_upd_rsp;
+
+void runTable(int cycles)
+{
+	for (int i = 0; i < cycles; i++)
+	{
+		session_context_table(	rxEng2ctx_upd_req,
+								txEng2ctx_upd_req,
+								rxApp2ctx_upd_req,
+								txApp2ctx_upd_req,
+								txApp2ctx_app_push,
+								stateTable2ctx_releaseSession,
+								ctx2rxEng_upd_rsp,
+								ctx2txEng_upd_rsp,
+								ctx2rxApp_upd_rsp,
+								ctx2txApp_upd_rsp);
+	}
+}
+
+int main()
+{
+	rxSessionCtxReply rxEngReply;
+	txSessionCtxReply txEngReply;
+	txAppTxSarReply txAppReply;
+	rxSarAppd rxAppReply;
+	sessionBuffer releasedBuffer;
+	int errCount = 0;
+
+	/*
+	 * Test1: rxEng init of the RX part; rxEng read returns both parts
+	 */
+	rxEng2ctx_upd_req.write(rxSessionCtxQuery(rxSarRecvd(0x57, 0x25ca, 1, 1), rxTxSarQuery(0x57)));
+	rxEng2ctx_upd_req.write(rxSessionCtxQuery(0x57));
+	runTable(10);
+	if (ctx2rxEng_upd_rsp.empty())
+	{
+		std::cerr << "Test1: no reply to the rxEng read" << std::endl;
+		errCount++;
+	}
+	else
+	{
+		ctx2rxEng_upd_rsp.read(rxEngReply);
+		if (rxEngReply.rxSar.recvd != 0x25ca || rxEngReply.rxSar.appd != 0x25ca || !rxEngReply.rxSar.bufferValid)
+		{
+			std::cerr << "Test1: recvd " << std::hex << rxEngReply.rxSar.recvd << " appd " << rxEngReply.rxSar.appd << std::endl;
+			errCount++;
+		}
+	}
+
+	/*
+	 * Test2: txEng init of the TX part; txApp read sees the acknowledged and the write pointer
+	 */
+	txEng2ctx_upd_req.write(txTxSarQuery(0x57, 0x1000, 1, 1));
+	txApp2ctx_upd_req.write(txAppTxSarQuery(0x57));
+	runTable(10);
+	if (ctx2txApp_upd_rsp.empty())
+	{
+		std::cerr << "Test2: no reply to the txApp read" << std::endl;
+		errCount++;
+	}
+	else
+	{
+		ctx2txApp_upd_rsp.read(txAppReply);
+		if (txAppReply.ackd != (ap_uint<WINDOW_BITS>) 0x0fff || txAppReply.mempt != (ap_uint<WINDOW_BITS>) 0x1000)
+		{
+			std::cerr << "Test2: ackd " << std::hex << txAppReply.ackd << " mempt " << txAppReply.mempt << std::endl;
+			errCount++;
+		}
+	}
+
+	/*
+	 * Test3: the write mask only updates the TX part, a txEng read returns both parts
+	 */
+	rxEng2ctx_upd_req.write(rxSessionCtxQuery(rxSarRecvd(0x57), rxTxSarQuery(0x57, 0x1400, 0x2000, 0x3908, 0xffff, 0, 0, false)));
+	runTable(5);
+	txEng2ctx_upd_req.write(txTxSarQuery(0x57));
+	runTable(10);
+	if (ctx2txEng_upd_rsp.empty())
+	{
+		std::cerr << "Test3: no reply to the txEng read" << std::endl;
+		errCount++;
+	}
+	else
+	{
+		ctx2txEng_upd_rsp.read(txEngReply);
+		if (txEngReply.rxSar.recvd != 0x25ca || txEngReply.txSar.ackd != 0x1400 || txEngReply.txSar.not_ackd != 0x1000)
+		{
+			std::cerr << "Test3: recvd " << std::hex << txEngReply.rxSar.recvd << " ackd " << txEngReply.txSar.ackd;
+			std::cerr << " not_ackd " << txEngReply.txSar.not_ackd << std::endl;
+			errCount++;
+		}
+	}
+
+	/*
+	 * Test4: release returns the RX buffer, the next session reuses it
+	 */
+	releasedBuffer = rxEngReply.rxSar.buffer;
+	stateTable2ctx_releaseSession.write(0x57);
+	runTable(5);
+	rxEng2ctx_upd_req.write(rxSessionCtxQuery(rxSarRecvd(0x58, 0x100, 1, 1), rxTxSarQuery(0x58)));
+	runTable(5);
+	rxApp2ctx_upd_req.write(rxSarAppd(0x58));
+	runTable(10);
+	if (ctx2rxApp_upd_rsp.empty())
+	{
+		std::cerr << "Test4: no reply to the rxApp read" << std::endl;
+		errCount++;
+	}
+	else
+	{
+		ctx2rxApp_upd_rsp.read(rxAppReply);
+		if (rxAppReply.appd != 0x100 || rxAppReply.buffer.sizeClass != releasedBuffer.sizeClass || rxAppReply.buffer.slot != releasedBuffer.slot)
+		{
+			std::cerr << "Test4: appd " << std::hex << rxAppReply.appd << " buffer slot " << rxAppReply.buffer.slot << std::endl;
+			errCount++;
+		}
+	}
+
+#if (TCP_SYN_COOKIES)
+	/*
+	 * Test5: the ACK of a SYN cookie initializes both parts, the SYN-ACK is already acknowledged
+	 */
+	rxTxSarQuery cookieTxSar(0x59, 0x8001, 0x2000, 0, 0, 0, 0, false);
+	cookieTxSar.init = true;
+	rxEng2ctx_upd_req.write(rxSessionCtxQuery(rxSarRecvd(0x59, 0x4000, 1, 1), cookieTxSar));
+	runTable(5);
+	txApp2ctx_upd_req.write(txAppTxSarQuery(0x59));
+	runTable(10);
+	if (ctx2txApp_upd_rsp.empty())
+	{
+		std::cerr << "Test5: no reply to the txApp read" << std::endl;
+		errCount++;
+	}
+	else
+	{
+		ctx2txApp_upd_rsp.read(txAppReply);
+		if (txAppReply.ackd != (ap_uint<WINDOW_BITS>) 0x8001 || txAppReply.mempt != (ap_uint<WINDOW_BITS>) 0x8001
+				|| txAppReply.buffer.sizeClass != TCP_BUFFER_CLASS_ACCEPT)
+		{
+			std::cerr << "Test5: ackd " << std::hex << txAppReply.ackd << " mempt " << txAppReply.mempt << std::endl;
+			errCount++;
+		}
+	}
+#endif
+
+	if (!ctx2rxEng_upd_rsp.empty() || !ctx2txEng_upd_rsp.empty() || !ctx2rxApp_upd_rsp.empty() || !ctx2txApp_upd_rsp.empty())
+	{
+		std::cerr << "Unexpected replies" << std::endl;
+		errCount++;
+	}
+
+	std::cerr << "Errors: " << std::dec << errCount << std::endl;
+	return errCount != 0;
+}
@@ -32,86 +32,402 @@ EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.// Copyright (c) 2015 Xilinx,
 using namespace hls;
 
 /** @ingroup session_lookup_controller
- *  SessionID manager
+ *  SessionID manager, hands out the IDs 0 to MAX_SESSIONS-1 once and then the released ones.
+ *  Released IDs are kept in a ring of MAX_SESSIONS entries, so a release is accepted in every
+ *  cycle and never waits for the @ref lookupReplyHandler to take an ID.
  *  @param[in]		fin_id, IDs that are released and appended to the SessionID free list
  *  @param[out]		new_id, get a new SessionID from the SessionID free list
  */
-void sessionIdManager(	stream<ap_uint<14> >&		new_id,
-						stream<ap_uint<14> >&		fin_id)
+void sessionIdManager(	stream<ap_uint<SESSION_ID_BITS> >&		new_id,
+						stream<ap_uint<SESSION_ID_BITS> >&		fin_id)
 {
 #pragma HLS PIPELINE II=1
 #pragma HLS INLINE off
 
-	static ap_uint<14> counter = 0;
-	#pragma HLS reset variable=counter
-	ap_uint<14> sessionID;
+	static ap_uint<SESSION_ID_BITS> freeIdRing[MAX_SESSIONS];
+	SESSION_TABLE_RESOURCE(freeIdRing, RAM_2P_BRAM)
+	#pragma HLS DEPENDENCE variable=freeIdRing inter false
 
+	static ap_uint<SESSION_ID_BITS> counter = 0;
+	static ap_uint<SESSION_ID_BITS> ringHead = 0;
+	static ap_uint<SESSION_ID_BITS> ringTail = 0;
+	static ap_uint<SESSION_ID_BITS+1> ringCount = 0;
+	#pragma HLS reset variable=counter
+	#pragma HLS reset variable=ringHead
+	#pragma HLS reset variable=ringTail
+	#pragma HLS reset variable=ringCount
+	ap_uint<SESSION_ID_BITS> sessionID;
+	bool released = false;
+	bool taken = false;
+
+	// Each ID exists only once, the ring can not overflow
 	if (!fin_id.empty())
 	{
 		fin_id.read(sessionID);
-		new_id.write(sessionID);
+		freeIdRing[ringTail] = sessionID;
+		ringTail = (ringTail == MAX_SESSIONS-1) ? (ap_uint<SESSION_ID_BITS>) 0 : (ap_uint<SESSION_ID_BITS>) (ringTail+1);
+		released = true;
 	}
-	else if (counter < MAX_SESSIONS)
+
+	if (!new_id.full())
 	{
-		new_id.write(counter);
-		counter++;
+		if (counter < MAX_SESSIONS)
+		{
+			new_id.write(counter);
+			counter++;
+		}
+		else if (ringCount != 0)
+		{
+			new_id.write(freeIdRing[ringHead]);
+			ringHead = (ringHead == MAX_SESSIONS-1) ? (ap_uint<SESSION_ID_BITS>) 0 : (ap_uint<SESSION_ID_BITS>) (ringHead+1);
+			taken = true;
+		}
 	}
 
+	if (released && !taken)
+	{
+		ringCount++;
+	}
+	else if (!released && taken)
+	{
+		ringCount--;
+	}
 }
 
 /** @ingroup session_lookup_controller
- *  Handles the Lookup relies from the RTL Lookup Table, if there was no hit,
- *  it checks if the request is allowed to create a new sessionID and does so.
- *  If it is a hit, the reply is forwarded to the corresponding source.
- *  It also handles the replies of the Session Updates [Inserts/Deletes], in case
- *  of insert the response with the new sessionID is replied to the request source.
- *  @param[in]		txEng2sLookup_rev_req
+ *  Hashes the tuple into an index of the given way of the session hash table, each way
+ *  uses a different seed. The upper bits of the multiplicative hash are used as index.
+ *  @param[in]		key
+ *  @param[in]		way
+ *  @return			index into the way
+ */
+ap_uint<HT_WAY_BITS> sessionHash(fourTupleInternal key, uint8_t way)
+{
+#pragma HLS INLINE
+	ap_uint<32> ports = (key.theirPort, key.myPort);
+	ap_uint<32> hash = HT_HASH_SEED[way];
+
+	hash = (hash ^ key.myIp) * 0x9e3779b1;
+	hash = hash ^ (hash >> 15);
+	hash = (hash ^ key.theirIp) * 0x9e3779b1;
+	hash = hash ^ (hash >> 15);
+	hash = (hash ^ ports) * 0x9e3779b1;
+	hash = hash ^ (hash >> 15);
+	return hash(31, 32-HT_WAY_BITS);
+}
+
+/** @ingroup session_lookup_controller
+ *  Session hash table mapping the tuple to the sessionID, it replaces the external SmartCam.
+ *  The table is split into HT_NUM_WAYS ways which are read in parallel, each indexed by its own hash
+ *  of the tuple and holding buckets of HT_BUCKET_SIZE entries. An insert goes to the least loaded of
+ *  the candidate buckets, the leftmost one on a tie (d-left hashing). A small fully associative stash holds
+ *  the entries for which all candidate buckets are full. Every request reads all ways and the stash,
+ *  a lookup, insert or delete is handled every cycle, updates have priority over lookups.
+ *  If there is no free entry for an insert, its reply is not successful.
+ *  @param[in]		sessionLookup_req
+ *  @param[in]		sessionUpdate_req
+ *  @param[out]		sessionLookup_rsp
+ *  @param[out]		sessionUpdate_rsp
+ */
+void sessionHashTable(	stream<rtlSessionLookupRequest>&	sessionLookup_req,
+						stream<rtlSessionUpdateRequest>&	sessionUpdate_req,
+						stream<rtlSessionLookupReply>&		sessionLookup_rsp,
+						stream<rtlSessionUpdateReply>&		sessionUpdate_rsp)
+{
+#pragma HLS PIPELINE II=1
+#pragma HLS INLINE off
+
+	static htEntry ht_table[HT_NUM_WAYS][HT_BUCKET_SIZE][HT_WAY_SIZE];
+	#pragma HLS ARRAY_PARTITION variable=ht_table complete dim=1
+	#pragma HLS ARRAY_PARTITION variable=ht_table complete dim=2
+	SESSION_TABLE_RESOURCE(ht_table, RAM_2P_BRAM)
+	#pragma HLS DEPENDENCE variable=ht_table inter false
+	#pragma HLS DATA_PACK variable=ht_table
+	static htEntry ht_stash[HT_STASH_SIZE];
+	#pragma HLS ARRAY_PARTITION variable=ht_stash complete
+
+	rtlSessionLookupRequest	lookup;
+	rtlSessionUpdateRequest	update;
+	fourTupleInternal		key;
+	htEntry					entry;
+	ap_uint<HT_WAY_BITS>	index[HT_NUM_WAYS];
+	#pragma HLS ARRAY_PARTITION variable=index complete
+	uint8_t					load;
+	uint8_t					minLoad = HT_BUCKET_SIZE;
+	bool					bucketFree;
+	uint8_t					bucketFreeSlot;
+	bool					request = false;
+	bool					isUpdate = false;
+	bool					hit = false;
+	bool					stashHit = false;
+	bool					freeStash = false;
+	uint8_t					hitWay = 0;
+	uint8_t					hitSlot = 0;
+	uint8_t					freeWay = 0;
+	uint8_t					freeSlot = 0;
+	ap_uint<SESSION_ID_BITS>				value = 0;
+
+	if (!sessionUpdate_req.empty())
+	{
+		sessionUpdate_req.read(update);
+		key = update.key;
+		request = true;
+		isUpdate = true;
+	}
+	else if (!sessionLookup_req.empty())
+	{
+		sessionLookup_req.read(lookup);
+		key = lookup.key;
+		request = true;
+	}
+
+	if (request)
+	{
+		// Search the candidate bucket of each way, the first free entry of the least loaded one is taken,
+		// on a tie the bucket of the lowest way
+		for (uint8_t i = 0; i < HT_NUM_WAYS; i++)
+		{
+		#pragma HLS UNROLL
+			index[i] = sessionHash(key, i);
+			load = 0;
+			bucketFree = false;
+			bucketFreeSlot = 0;
+			for (uint8_t j = 0; j < HT_BUCKET_SIZE; j++)
+			{
+			#pragma HLS UNROLL
+				entry = ht_table[i][j][index[i]];
+				if (entry.valid)
+				{
+					load++;
+					if (entry.key == key)
+					{
+						hit = true;
+						hitWay = i;
+						hitSlot = j;
+						value = entry.value;
+					}
+				}
+				else if (!bucketFree)
+				{
+					bucketFree = true;
+					bucketFreeSlot = j;
+				}
+			}
+			// The load of the bucket is only complete after all its entries were checked
+			if (load < minLoad)
+			{
+				minLoad = load;
+				freeWay = i;
+				freeSlot = bucketFreeSlot;
+			}
+		}
+		// Search the stash, its free entries are only used if all buckets are full
+		for (uint8_t i = 0; i < HT_STASH_SIZE; i++)
+		{
+		#pragma HLS UNROLL
+			if (ht_stash[i].valid && ht_stash[i].key == key)
+			{
+				hit = true;
+				stashHit = true;
+				hitSlot = i;
+				value = ht_stash[i].value;
+			}
+			if (!ht_stash[i].valid && !freeStash && minLoad == HT_BUCKET_SIZE)
+			{
+				freeStash = true;
+				freeSlot = i;
+			}
+		}
+
+		if (!isUpdate)
+		{
+			sessionLookup_rsp.write(rtlSessionLookupReply(hit, value, lookup.source, lookup.tag));
+		}
+		else
+		{
+			// An existing entry is overwritten or deleted, an insert otherwise takes the free entry
+			bool tableWrite = (hit && !stashHit) || (!hit && update.op == INSERT && minLoad < HT_BUCKET_SIZE);
+			bool stashWrite = stashHit || (!hit && update.op == INSERT && freeStash);
+			if (hit)
+			{
+				freeWay = hitWay;
+				freeSlot = hitSlot;
+			}
+			entry = htEntry(key, update.value, (update.op == INSERT));
+			for (uint8_t i = 0; i < HT_NUM_WAYS; i++)
+			{
+			#pragma HLS UNROLL
+				for (uint8_t j = 0; j < HT_BUCKET_SIZE; j++)
+				{
+				#pragma HLS UNROLL
+					if (tableWrite && freeWay == i && freeSlot == j)
+					{
+						ht_table[i][j][index[i]] = entry;
+					}
+				}
+			}
+			for (uint8_t i = 0; i < HT_STASH_SIZE; i++)
+			{
+			#pragma HLS UNROLL
+				if (stashWrite && freeSlot == i)
+				{
+					ht_stash[i] = entry;
+				}
+			}
+			sessionUpdate_rsp.write(rtlSessionUpdateReply(update.value, update.op, update.source, (tableWrite || stashWrite || update.op == DELETE), update.tag));
+		}
+	}
+}
+
+/** @ingroup session_lookup_controller
+ *  Issues the lookups of the RX Engine and TX App back to back, each one gets a slot in a ring of
+ *  SLC_LOOKUP_SLOTS entries and carries the slot as tag through the @ref sessionHashTable.
+ *  If a lookup misses and the request is allowed to create a new sessionID, an insert with the same
+ *  tag is issued while the replies of the following lookups keep being processed. The replies are
+ *  released to their source in issue order, as soon as the slot at the head of the ring is completed.
+ *  A miss on a tuple for which an insert is still outstanding is looked up again, this way a tuple
+ *  is never inserted twice. A completed insert marks the slots in flight with the same tuple, their
+ *  lookups may have passed the table before the insert and are repeated on a miss as well. Insert
+ *  replies are processed before lookup replies, there are at most SLC_LOOKUP_SLOTS of them and
+ *  retried lookups can not hold them back.
+ *  With TCP_DDR_CONTEXT a hit of the RX Engine prefetches the context of the session into the session context table,
+ *  the prefetch is only a hint and dropped if the table is busy.
  *  @param[in]		sessionLookup_rsp
- *  @param[in]		sessionUpdatea_rsp
- *  @param[in]		stateTable2sLookup_releaseSession
- *  @param[in]		lookups
+ *  @param[in]		sessionInsert_rsp
+ *  @param[in]		rxEng2sLookup_req
+ *  @param[in]		txApp2sLookup_req
+ *  @param[in]		sessionIdFreeList
+ *  @param[out]		sessionLookup_req
  *  @param[out]		sLookup2rxEng_rsp
  *  @param[out]		sLookup2txApp_rsp
- *  @param[out]		sLookup2txEng_rev_rsp
- *  @param[out]		sessionLookup_req
- *  @param[out]		sLookup2portTable_releasePort
- *  @TODO document more
+ *  @param[out]		sessionInsert_req
+ *  @param[out]		sLookup2ctx_prefetch
+ *  @param[out]		reverseTableInsertFifo
  */
 void lookupReplyHandler(stream<rtlSessionLookupReply>&			sessionLookup_rsp,
 						stream<rtlSessionUpdateReply>&			sessionInsert_rsp,
 						stream<sessionLookupQuery>&			rxEng2sLooup_req,
 						stream<fourTuple>&					txApp2sLookup_req,
-						stream<ap_uint<14> >&					sessionIdFreeList,
+						stream<ap_uint<SESSION_ID_BITS> >&					sessionIdFreeList,
 						stream<rtlSessionLookupRequest>&		sessionLookup_req,
 						stream<sessionLookupReply>&				sLookup2rxEng_rsp,
 						stream<sessionLookupReply>&				sLookup2txApp_rsp,
 						stream<rtlSessionUpdateRequest>&		sessionInsert_req,
+#if (TCP_DDR_CONTEXT)
+						stream<ap_uint<16> >&					sLookup2ctx_prefetch,
+#endif
 						stream<revLupInsert>&					reverseTableInsertFifo)
 {
 #pragma HLS PIPELINE II=1
 #pragma HLS INLINE off
 
-	static stream<fourTupleInternal>		slc_insertTuples("slc_insertTuples2");
-	#pragma HLS STREAM variable=slc_insertTuples depth=4
-
-	static stream<sessionLookupQueryInternal>		slc_queryCache("slc_queryCache");
-	#pragma HLS STREAM variable=slc_queryCache depth=8
+	static sessionLookupQueryInternal	slc_query[SLC_LOOKUP_SLOTS];
+	static sessionLookupReply			slc_reply[SLC_LOOKUP_SLOTS];
+	static bool							slc_replyValid[SLC_LOOKUP_SLOTS];
+	static bool							slc_insertPending[SLC_LOOKUP_SLOTS];
+	static bool							slc_recheck[SLC_LOOKUP_SLOTS];
+	#pragma HLS ARRAY_PARTITION variable=slc_query complete
+	#pragma HLS ARRAY_PARTITION variable=slc_reply complete
+	#pragma HLS ARRAY_PARTITION variable=slc_replyValid complete
+	#pragma HLS ARRAY_PARTITION variable=slc_insertPending complete
+	#pragma HLS ARRAY_PARTITION variable=slc_recheck complete
+	static ap_uint<3>	slc_head = 0;
+	static ap_uint<3>	slc_tail = 0;
+	static ap_uint<4>	slc_usedSlots = 0;
 
 	fourTuple toeTuple;
-	fourTupleInternal tuple;
 	sessionLookupQuery query;
 	sessionLookupQueryInternal intQuery;
 	rtlSessionLookupReply lupReply;
 	rtlSessionUpdateReply insertReply;
-	ap_uint<16> sessionID;
-	ap_uint<14> freeID = 0;
+	ap_uint<SESSION_ID_BITS> freeID = 0;
+	bool pending = false;
+	bool retry = false;
+	bool issue = false;
 
-	enum slcFsmStateType {LUP_REQ, LUP_RSP, UPD_RSP};
-	static slcFsmStateType slc_fsmState = LUP_REQ;
+	// Release the reply at the head to its source
+	if (slc_replyValid[slc_head])
+	{
+		if (slc_query[slc_head].source == RX)
+		{
+			sLookup2rxEng_rsp.write(slc_reply[slc_head]);
+		}
+		else
+		{
+			sLookup2txApp_rsp.write(slc_reply[slc_head]);
+		}
+		slc_replyValid[slc_head] = false;
+		slc_head++;
+		slc_usedSlots--;
+	}
 
-	switch (slc_fsmState)
+	if (!sessionInsert_rsp.empty())
+	{
+		sessionInsert_rsp.read(insertReply);
+		intQuery = slc_query[insertReply.tag];
+		if (insertReply.success)
+		{
+			reverseTableInsertFifo.write(revLupInsert(insertReply.sessionID, intQuery.tuple));
+			for (uint8_t i = 0; i < SLC_LOOKUP_SLOTS; i++)
+			{
+			#pragma HLS UNROLL
+				if (slc_query[i].allowCreation && slc_query[i].tuple == intQuery.tuple)
+				{
+					slc_recheck[i] = true;
+				}
+			}
+		}
+		else // Hash table is full, the sessionID is released again
+		{
+			sessionInsert_req.write(rtlSessionUpdateRequest(intQuery.tuple, insertReply.sessionID, DELETE, intQuery.source));
+		}
+		slc_reply[insertReply.tag] = sessionLookupReply(insertReply.sessionID, insertReply.success);
+		slc_replyValid[insertReply.tag] = true;
+		slc_insertPending[insertReply.tag] = false;
+	}
+	else if (!sessionLookup_rsp.empty())
+	{
+		sessionLookup_rsp.read(lupReply);
+		intQuery = slc_query[lupReply.tag];
+		for (uint8_t i = 0; i < SLC_LOOKUP_SLOTS; i++)
+		{
+		#pragma HLS UNROLL
+			if (slc_insertPending[i] && slc_query[i].tuple == intQuery.tuple)
+			{
+				pending = true;
+			}
+		}
+		if (slc_recheck[lupReply.tag])
+		{
+			pending = true;
+		}
+		slc_recheck[lupReply.tag] = false;
+		if (!lupReply.hit && intQuery.allowCreation && pending)
+		{
+			sessionLookup_req.write(rtlSessionLookupRequest(intQuery.tuple, intQuery.source, lupReply.tag));
+			retry = true;
+		}
+		else if (!lupReply.hit && intQuery.allowCreation && !sessionIdFreeList.empty())
+		{
+			sessionIdFreeList.read(freeID);
+			sessionInsert_req.write(rtlSessionUpdateRequest(intQuery.tuple, freeID, INSERT, intQuery.source, lupReply.tag));
+			slc_insertPending[lupReply.tag] = true;
+		}
+		else
+		{
+			slc_reply[lupReply.tag] = sessionLookupReply(lupReply.sessionID, lupReply.hit);
+			slc_replyValid[lupReply.tag] = true;
+#if (TCP_DDR_CONTEXT)
+			if (lupReply.hit && intQuery.source == RX && !sLookup2ctx_prefetch.full())
+			{
+				sLookup2ctx_prefetch.write(lupReply.sessionID);
+			}
+#endif
+		}
+	}
+	// Issue a new lookup into the next free slot
+	if (!retry && slc_usedSlots < SLC_LOOKUP_SLOTS)
 	{
-	case LUP_REQ:
 		if (!txApp2sLookup_req.empty())
 		{
 			txApp2sLookup_req.read(toeTuple);
@@ -121,9 +437,7 @@ void lookupReplyHandler(stream<rtlSessionLookupReply>&			sessionLookup_rsp,
 			intQuery.tuple.myPort = toeTuple.srcPort;
 			intQuery.allowCreation = true;
 			intQuery.source = TX_APP;
-			sessionLookup_req.write(rtlSessionLookupRequest(intQuery.tuple, intQuery.source));
-			slc_queryCache.write(intQuery);
-			slc_fsmState = LUP_RSP;
+			issue = true;
 		}
 		else if (!rxEng2sLooup_req.empty())
 		{
@@ -134,64 +448,28 @@ void lookupReplyHandler(stream<rtlSessionLookupReply>&			sessionLookup_rsp,
 			intQuery.tuple.myPort = query.tuple.dstPort;
 			intQuery.allowCreation = query.allowCreation;
 			intQuery.source = RX;
-			sessionLookup_req.write(rtlSessionLookupRequest(intQuery.tuple, intQuery.source));
-			slc_queryCache.write(intQuery);
-			slc_fsmState = LUP_RSP;
-		}
-		break;
-	case LUP_RSP:
-		if(!sessionLookup_rsp.empty() && !slc_queryCache.empty())
-		{
-			sessionLookup_rsp.read(lupReply);
-			slc_queryCache.read(intQuery);
-			if (!lupReply.hit && intQuery.allowCreation && !sessionIdFreeList.empty())
-			{
-				sessionIdFreeList.read(freeID);
-				sessionInsert_req.write(rtlSessionUpdateRequest(intQuery.tuple, freeID, INSERT, lupReply.source));
-				slc_insertTuples.write(intQuery.tuple);
-				slc_fsmState = UPD_RSP;
-			}
-			else
-			{
-				if (lupReply.source == RX)
-				{
-					sLookup2rxEng_rsp.write(sessionLookupReply(lupReply.sessionID, lupReply.hit));
-				}
-				else
-				{
-					sLookup2txApp_rsp.write(sessionLookupReply(lupReply.sessionID, lupReply.hit));
-				}
-				slc_fsmState = LUP_REQ;
-			}
+			issue = true;
 		}
-		break;
-	//case UPD_REQ:
-		//break;
-	case UPD_RSP:
-		if (!sessionInsert_rsp.empty() && !slc_insertTuples.empty())
+		if (issue)
 		{
-			sessionInsert_rsp.read(insertReply);
-			slc_insertTuples.read(tuple);
-			//updateReplies.write(sessionLookupReply(insertReply.sessionID, true));
-			if (insertReply.source == RX)
-			{
-				sLookup2rxEng_rsp.write(sessionLookupReply(insertReply.sessionID, true));
-			}
-			else
-			{
-				sLookup2txApp_rsp.write(sessionLookupReply(insertReply.sessionID, true));
-			}
-			reverseTableInsertFifo.write(revLupInsert(insertReply.sessionID, tuple));
-			slc_fsmState = LUP_REQ;
+			sessionLookup_req.write(rtlSessionLookupRequest(intQuery.tuple, intQuery.source, slc_tail));
+			slc_query[slc_tail] = intQuery;
+			slc_recheck[slc_tail] = false;
+			slc_tail++;
+			slc_usedSlots++;
 		}
-		break;
 	}
 }
 
+/** @ingroup session_lookup_controller
+ *  Merges the inserts and deletes towards the session hash table and keeps track of the
+ *  number of sessions in use. A DELETE on the insert path belongs to a failed insert, it
+ *  is not sent to the table, only its sessionID is released.
+ */
 void updateRequestSender(stream<rtlSessionUpdateRequest>&		sessionInsert_req,
 					stream<rtlSessionUpdateRequest>&		sessionDelete_req,
 					stream<rtlSessionUpdateRequest>&		sessionUpdate_req,
-					stream<ap_uint<14> >&					sessionIdFinFifo,
+					stream<ap_uint<SESSION_ID_BITS> >&					sessionIdFinFifo,
 					ap_uint<16>& regSessionCount)
 {
 #pragma HLS PIPELINE II=1
@@ -202,8 +480,17 @@ void updateRequestSender(stream<rtlSessionUpdateRequest>&		sessionInsert_req,
 
 	if (!sessionInsert_req.empty())
 	{
-		sessionUpdate_req.write(sessionInsert_req.read());
-		usedSessionIDs++;
+		sessionInsert_req.read(request);
+		if (request.op == INSERT)
+		{
+			sessionUpdate_req.write(request);
+			usedSessionIDs++;
+		}
+		else
+		{
+			sessionIdFinFifo.write(request.value);
+			usedSessionIDs--;
+		}
 		regSessionCount = usedSessionIDs;
 	}
 	else if (!sessionDelete_req.empty())
@@ -219,7 +506,7 @@ void updateRequestSender(stream<rtlSessionUpdateRequest>&		sessionInsert_req,
 
 void updateReplyHandler(	stream<rtlSessionUpdateReply>&			sessionUpdate_rsp,
 							stream<rtlSessionUpdateReply>&			sessionInsert_rsp)
-							//stream<ap_uint<14> >&					sessionIdFinFifo)
+							//stream<ap_uint<SESSION_ID_BITS> >&					sessionIdFinFifo)
 {
 #pragma HLS PIPELINE II=1
 #pragma HLS INLINE off
@@ -252,7 +539,7 @@ void reverseLookupTableInterface(	stream<revLupInsert>& revTableInserts,
 #pragma HLS INLINE off
 
 	static fourTupleInternal reverseLookupTable[MAX_SESSIONS];
-	#pragma HLS RESOURCE variable=reverseLookupTable core=RAM_T2P_BRAM
+	SESSION_TABLE_RESOURCE(reverseLookupTable, RAM_T2P_BRAM)
 	#pragma HLS DEPENDENCE variable=reverseLookupTable inter false
 	static bool tupleValid[MAX_SESSIONS];
 	#pragma HLS DEPENDENCE variable=tupleValid inter false
@@ -293,20 +580,16 @@ void reverseLookupTableInterface(	stream<revLupInsert>& revTableInserts,
 }
 
 /** @ingroup session_lookup_controller
- *  This module acts as a wrapper for the RTL implementation of the SessionID Table.
+ *  This module contains the SessionID Table, implemented as hash table in @ref sessionHashTable.
  *  It also includes the wrapper for the sessionID free list which keeps track of the free SessionIDs
  *  @param[in]		rxLookupIn
  *  @param[in]		stateTable2sLookup_releaseSession
  *  @param[in]		txAppLookupIn
  *  @param[in]		txLookup
- *  @param[in]		lookupIn
- *  @param[in]		updateIn
  *  @param[out]		rxLookupOut
  *  @param[out]		portReleaseOut
  *  @param[out]		txAppLookupOut
  *  @param[out]		txResponse
- *  @param[out]		lookupOut
- *  @param[out]		updateOut
  *  @TODO rename
  */
 void session_lookup_controller(	stream<sessionLookupQuery>&			rxEng2sLookup_req,
@@ -317,12 +600,9 @@ void session_lookup_controller(	stream<sessionLookupQuery>&			rxEng2sLookup_req,
 								stream<sessionLookupReply>&			sLookup2txApp_rsp,
 								stream<ap_uint<16> >&				txEng2sLookup_rev_req,
 								stream<fourTuple>&					sLookup2txEng_rev_rsp,
-								stream<rtlSessionLookupRequest>&	sessionLookup_req,
-								stream<rtlSessionLookupReply>&		sessionLookup_rsp,
-								stream<rtlSessionUpdateRequest>&	sessionUpdate_req,
-								//stream<rtlSessionUpdateRequest>&	sessionInsert_req,
-								//stream<rtlSessionUpdateRequest>&	sessionDelete_req,
-								stream<rtlSessionUpdateReply>&		sessionUpdate_rsp,
+#if (TCP_DDR_CONTEXT)
+								stream<ap_uint<16> >&				sLookup2ctx_prefetch,
+#endif
 								ap_uint<16>& regSessionCount)
 {
 //#pragma HLS DATAFLOW
@@ -333,9 +613,9 @@ void session_lookup_controller(	stream<sessionLookupQuery>&			rxEng2sLookup_req,
 	#pragma HLS stream variable=slc_lookups depth=4
 	#pragma HLS DATA_PACK variable=slc_lookups
 
-	static stream<ap_uint<14> > slc_sessionIdFreeList("slc_sessionIdFreeList");
-	static stream<ap_uint<14> > slc_sessionIdFinFifo("slc_sessionIdFinFifo");
-	#pragma HLS stream variable=slc_sessionIdFreeList depth=16384
+	static stream<ap_uint<SESSION_ID_BITS> > slc_sessionIdFreeList("slc_sessionIdFreeList");
+	static stream<ap_uint<SESSION_ID_BITS> > slc_sessionIdFinFifo("slc_sessionIdFinFifo");
+	#pragma HLS stream variable=slc_sessionIdFreeList depth=16
 	#pragma HLS stream variable=slc_sessionIdFinFifo depth=2
 
 	static stream<rtlSessionUpdateReply>	slc_sessionInsert_rsp("slc_sessionInsert_rsp");
@@ -350,6 +630,20 @@ void session_lookup_controller(	stream<sessionLookupQuery>&			rxEng2sLookup_req,
 	static stream<revLupInsert>				reverseLupInsertFifo("reverseLupInsertFifo");
 	#pragma HLS STREAM variable=reverseLupInsertFifo depth=4
 
+	// Session hash table interface
+	static stream<rtlSessionLookupRequest>	sessionLookup_req("sessionLookup_req");
+	static stream<rtlSessionLookupReply>	sessionLookup_rsp("sessionLookup_rsp");
+	static stream<rtlSessionUpdateRequest>	sessionUpdate_req("sessionUpdate_req");
+	static stream<rtlSessionUpdateReply>	sessionUpdate_rsp("sessionUpdate_rsp");
+	#pragma HLS STREAM variable=sessionLookup_req depth=4
+	#pragma HLS STREAM variable=sessionLookup_rsp depth=4
+	#pragma HLS STREAM variable=sessionUpdate_req depth=4
+	#pragma HLS STREAM variable=sessionUpdate_rsp depth=4
+	#pragma HLS DATA_PACK variable=sessionLookup_req
+	#pragma HLS DATA_PACK variable=sessionLookup_rsp
+	#pragma HLS DATA_PACK variable=sessionUpdate_req
+	#pragma HLS DATA_PACK variable=sessionUpdate_rsp
+
 
 	sessionIdManager(slc_sessionIdFreeList, slc_sessionIdFinFifo);
 
@@ -362,6 +656,9 @@ void session_lookup_controller(	stream<sessionLookupQuery>&			rxEng2sLookup_req,
 						sLookup2rxEng_rsp,
 						sLookup2txApp_rsp,
 						sessionInsert_req,
+#if (TCP_DDR_CONTEXT)
+						sLookup2ctx_prefetch,
+#endif
 						reverseLupInsertFifo
 						);//regSessionCount);
 
@@ -371,6 +668,11 @@ void session_lookup_controller(	stream<sessionLookupQuery>&			rxEng2sLookup_req,
 						slc_sessionIdFinFifo,
 						regSessionCount);
 
+	sessionHashTable(	sessionLookup_req,
+						sessionUpdate_req,
+						sessionLookup_rsp,
+						sessionUpdate_rsp);
+
 	updateReplyHandler(	sessionUpdate_rsp,
 						slc_sessionInsert_rsp);
 
@@ -41,6 +41,12 @@ enum lookupSource {RX, TX_APP};
  */
 enum lookupOp {INSERT, DELETE};
 
+/** @ingroup session_lookup_controller
+ *  Number of lookups in flight between the @ref lookupReplyHandler and the @ref sessionHashTable,
+ *  the requests are tagged with their slot, must match the 3-bit tags
+ */
+static const uint8_t SLC_LOOKUP_SLOTS = 8;
+
 struct slupRouting
 {
 	bool			isUpdate;
@@ -94,6 +100,11 @@ struct fourTupleInternal
 		}
 		return false;
 	}
+
+	bool operator==(const fourTupleInternal& other) const
+	{
+		return ((myIp == other.myIp) && (theirIp == other.theirIp) && (myPort == other.myPort) && (theirPort == other.theirPort));
+	}
 };
 
 /** @ingroup session_lookup_controller
@@ -116,9 +127,12 @@ struct rtlSessionLookupRequest
 {
 	lookupSource		source;
 	fourTupleInternal	key;
+	ap_uint<3>			tag;
 	rtlSessionLookupRequest() {}
 	rtlSessionLookupRequest(fourTupleInternal tuple, lookupSource src)
-				:key(tuple), source(src) {}
+				:key(tuple), source(src), tag(0) {}
+	rtlSessionLookupRequest(fourTupleInternal tuple, lookupSource src, ap_uint<3> tag)
+				:key(tuple), source(src), tag(tag) {}
 };
 
 /** @ingroup session_lookup_controller
@@ -128,16 +142,19 @@ struct rtlSessionUpdateRequest
 {
 	lookupSource		source;
 	lookupOp			op;
-	ap_uint<14>			value;
+	ap_uint<SESSION_ID_BITS>			value;
 	fourTupleInternal	key;
-	/*ap_uint<14>			value;
+	ap_uint<3>			tag;
+	/*ap_uint<SESSION_ID_BITS>			value;
 	lookupOp			op;
 	lookupSource		source;*/
 	rtlSessionUpdateRequest() {}
 	/*rtlSessionUpdateRequest(fourTupleInternal key, lookupSource src)
 				:key(key), value(0), op(INSERT), source(src) {}*/
-	rtlSessionUpdateRequest(fourTupleInternal key, ap_uint<14> value, lookupOp op, lookupSource src)
-			:key(key), value(value), op(op), source(src) {}
+	rtlSessionUpdateRequest(fourTupleInternal key, ap_uint<SESSION_ID_BITS> value, lookupOp op, lookupSource src)
+			:key(key), value(value), op(op), source(src), tag(0) {}
+	rtlSessionUpdateRequest(fourTupleInternal key, ap_uint<SESSION_ID_BITS> value, lookupOp op, lookupSource src, ap_uint<3> tag)
+			:key(key), value(value), op(op), source(src), tag(tag) {}
 };
 
 /** @ingroup session_lookup_controller
@@ -146,15 +163,18 @@ struct rtlSessionUpdateRequest
 struct rtlSessionLookupReply
 {
 	//bool				hit;
-	//ap_uint<14>			sessionID;
+	//ap_uint<SESSION_ID_BITS>			sessionID;
 	lookupSource		source;
-	ap_uint<14>			sessionID;
+	ap_uint<SESSION_ID_BITS>			sessionID;
 	bool				hit;
+	ap_uint<3>			tag;
 	rtlSessionLookupReply() {}
 	rtlSessionLookupReply(bool hit, lookupSource src)
-			:hit(hit), sessionID(0), source(src) {}
-	rtlSessionLookupReply(bool hit, ap_uint<14> id, lookupSource src)
-			:hit(hit), sessionID(id), source(src) {}
+			:hit(hit), sessionID(0), source(src), tag(0) {}
+	rtlSessionLookupReply(bool hit, ap_uint<SESSION_ID_BITS> id, lookupSource src)
+			:hit(hit), sessionID(id), source(src), tag(0) {}
+	rtlSessionLookupReply(bool hit, ap_uint<SESSION_ID_BITS> id, lookupSource src, ap_uint<3> tag)
+			:hit(hit), sessionID(id), source(src), tag(tag) {}
 };
 
 /** @ingroup session_lookup_controller
@@ -164,14 +184,47 @@ struct rtlSessionUpdateReply
 {
 	lookupSource		source;
 	lookupOp			op;
-	ap_uint<14>			sessionID;
+	ap_uint<SESSION_ID_BITS>			sessionID;
+	bool				success;
+	ap_uint<3>			tag;
 	//lookupOp			op;
 	//lookupSource		source;
 	rtlSessionUpdateReply() {}
 	rtlSessionUpdateReply(lookupOp op, lookupSource src)
-			:op(op), source(src) {}
-	rtlSessionUpdateReply(ap_uint<14> id, lookupOp op, lookupSource src)
-			:sessionID(id), op(op), source(src) {}
+			:op(op), source(src), success(true), tag(0) {}
+	rtlSessionUpdateReply(ap_uint<SESSION_ID_BITS> id, lookupOp op, lookupSource src)
+			:sessionID(id), op(op), source(src), success(true), tag(0) {}
+	rtlSessionUpdateReply(ap_uint<SESSION_ID_BITS> id, lookupOp op, lookupSource src, bool success, ap_uint<3> tag)
+			:sessionID(id), op(op), source(src), success(success), tag(tag) {}
+};
+
+/** @ingroup session_lookup_controller
+ *  Geometry of the session hash table, HT_NUM_WAYS ways of HT_WAY_SIZE buckets with HT_BUCKET_SIZE
+ *  entries each. Every way is indexed by its own hash of the tuple. The total number of entries should
+ *  be at least 1.5 times MAX_SESSIONS, the stash catches the few inserts for which all buckets are full.
+ */
+static const uint8_t	HT_NUM_WAYS = 4;
+static const uint8_t	HT_BUCKET_SIZE = 2;
+#if (TCP_64K_SESSIONS)
+static const uint8_t	HT_WAY_BITS = 14;
+#else
+static const uint8_t	HT_WAY_BITS = 11;
+#endif
+static const uint32_t	HT_WAY_SIZE = (1 << HT_WAY_BITS);
+static const uint8_t	HT_STASH_SIZE = 8;
+static const uint32_t	HT_HASH_SEED[HT_NUM_WAYS] = {0x6a09e667, 0xbb67ae85, 0x3c6ef372, 0xa54ff53a};
+
+/** @ingroup session_lookup_controller
+ *  Entry of the session hash table
+ */
+struct htEntry
+{
+	fourTupleInternal	key;
+	ap_uint<SESSION_ID_BITS>			value;
+	bool				valid;
+	htEntry() {}
+	htEntry(fourTupleInternal key, ap_uint<SESSION_ID_BITS> value, bool valid)
+			:key(key), value(value), valid(valid) {}
 };
 
 struct revLupInsert
@@ -194,11 +247,8 @@ void session_lookup_controller(	stream<sessionLookupQuery>&			rxEng2sLookup_req,
 								stream<sessionLookupReply>&			sLookup2txApp_rsp,
 								stream<ap_uint<16> >&				txEng2sLookup_rev_req,
 								stream<fourTuple>&					sLookup2txEng_rev_rsp,
-								stream<rtlSessionLookupRequest>&	sessionLookup_req,
-								stream<rtlSessionLookupReply>&		sessionLookup_rsp,
-								stream<rtlSessionUpdateRequest>&	sessionUpdate_req,
-								//stream<rtlSessionUpdateRequest>&	sessionInsert_req,
-								//stream<rtlSessionUpdateRequest>&	sessionDelete_req,
-								stream<rtlSessionUpdateReply>&		sessionUpdate_rsp,
+#if (TCP_DDR_CONTEXT)
+								stream<ap_uint<16> >&				sLookup2ctx_prefetch,
+#endif
 								//ap_uint<16>&						relSessionCount,
 								ap_uint<16>&						regSessionCount);
@@ -0,0 +1,218 @@
+/************************************************
+Copyright (c) 2016, Xilinx, Inc.
+All rights reserved.
+
+Redistribution and use in source and binary forms, with or without modification, 
+are permitted provided that the following conditions are met:
+
+1. Redistributions of source code must retain the above copyright notice, 
+this list of conditions and the following disclaimer.
+
+2. Redistributions in binary form must reproduce the above copyright notice, 
+this list of conditions and the following disclaimer in the documentation 
+and/or other materials provided with the distribution.
+
+3. Neither the name of the copyright holder nor the names of its contributors 
+may be used to endorse or promote products derived from this software 
+without specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND 
+ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, 
+THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED. 
+IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, 
+INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, 
+PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) 
+HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, 
+OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, 
+EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.// Copyright (c) 2015 Xilinx, Inc.
+************************************************/
+#include "session_lookup_controller.hpp"
+#include "../state_table/state_table.hpp"
+#include "../retransmit_timer/retransmit_timer.hpp"
+#include <deque>
+
+using namespace hls;
+
+/*
+ * Opens every session the TOE can hold and lets all of them time out. The lookup controller, the state table
+ * and the retransmit timer are connected as in the TOE: the RX engine side reads and writes the state of each
+ * new session and the TX engine side arms its retransmit timer. Each timer expires TCP_MAX_RETRANSMISSIONS times
+ * and is re-armed, the last time-out releases the session through the state table. A second round reopens all
+ * sessions on the released IDs.
+ */
+
+static const int TCP_MAX_RETRANSMISSIONS = 4;
+
+int main()
+{
+	stream<sessionLookupQuery>			rxEng2sLookup_req;
+	stream<sessionLookupReply>			sLookup2rxEng_rsp("sLookup2rxEng_rsp");
+	stream<ap_uint<16> >				stateTable2sLookup_releaseSession;
+	stream<ap_uint<16> >				sLookup2portTable_releasePort;
+	stream<fourTuple>					txApp2sLookup_req;
+	stream<sessionLookupReply>			sLookup2txApp_rsp;
+	stream<ap_uint<16> >				txEng2sLookup_rev_req;
+	stream<fourTuple>					sLookup2txEng_rev_rsp;
+
+	stream<stateQuery>					rxEng2stateTable_upd_req;
+	stream<stateQuery>					txApp2stateTable_upd_req;
+	stream<ap_uint<16> >				txApp2stateTable_req;
+	stream<sessionState>				stateTable2rxEng_upd_rsp;
+	stream<sessionState>				stateTable2TxApp_upd_rsp;
+	stream<sessionState>				stateTable2txApp_rsp;
+	stream<ap_uint<16> >				stateTable2ctx_releaseSession;
+
+	stream<rxRetransmitTimerUpdate>		rxEng2timer_clearRetransmitTimer;
+	stream<txRetransmitTimerSet>		txEng2timer_setRetransmitTimer;
+	stream<event>						rtTimer2eventEng_setEvent;
+	stream<ap_uint<16> >				rtTimer2stateTable_releaseState;
+	stream<appNotification>				rtTimer2rxApp_notification;
+	stream<openStatus>					rtTimer2txApp_notification;
+
+	ap_uint<16> regSessionCount = 0;
+	int errorCount = 0;
+
+	fourTuple tuple;
+	tuple.dstIp = 0x01010101;
+	tuple.dstPort = 7;
+
+	sessionLookupReply reply;
+	sessionState state;
+	event ev;
+	appNotification notification;
+	ap_uint<16> sessionID;
+
+	for (int round = 0; round < 2; round++)
+	{
+		std::vector<int> retransmits(MAX_SESSIONS, 0);
+		std::vector<int> timeOuts(MAX_SESSIONS, 0);
+		std::vector<int> ctxReleases(MAX_SESSIONS, 0);
+		std::vector<bool> idUsed(MAX_SESSIONS, false);
+		std::deque<ap_uint<16> > stateReads;
+		int sent = 0;
+		int opened = 0;
+		int closed = 0;
+		int released = 0;
+		int portReleases = 0;
+		int count;
+
+		for (count = 0; (opened < MAX_SESSIONS || closed < MAX_SESSIONS || released < MAX_SESSIONS || regSessionCount != 0) && count < 100*MAX_SESSIONS; count++)
+		{
+			if (sent < MAX_SESSIONS && rxEng2sLookup_req.empty())
+			{
+				tuple.srcIp = 0x0a000000 + sent;
+				tuple.srcPort = 0x8000 + (sent & 0xff);
+				rxEng2sLookup_req.write(sessionLookupQuery(tuple, true));
+				sent++;
+			}
+			session_lookup_controller(	rxEng2sLookup_req,
+										sLookup2rxEng_rsp,
+										stateTable2sLookup_releaseSession,
+										sLookup2portTable_releasePort,
+										txApp2sLookup_req,
+										sLookup2txApp_rsp,
+										txEng2sLookup_rev_req,
+										sLookup2txEng_rev_rsp,
+										regSessionCount);
+			state_table(	rxEng2stateTable_upd_req,
+							txApp2stateTable_upd_req,
+							txApp2stateTable_req,
+							rtTimer2stateTable_releaseState,
+							stateTable2rxEng_upd_rsp,
+							stateTable2TxApp_upd_rsp,
+							stateTable2txApp_rsp,
+							stateTable2sLookup_releaseSession,
+							stateTable2ctx_releaseSession);
+			retransmit_timer(	rxEng2timer_clearRetransmitTimer,
+								txEng2timer_setRetransmitTimer,
+								rtTimer2eventEng_setEvent,
+								rtTimer2stateTable_releaseState,
+								rtTimer2rxApp_notification,
+								rtTimer2txApp_notification);
+
+			// RX engine, a new session is read from the state table and set to ESTABLISHED
+			if (!sLookup2rxEng_rsp.empty())
+			{
+				sLookup2rxEng_rsp.read(reply);
+				if (!reply.hit || reply.sessionID >= MAX_SESSIONS || idUsed[reply.sessionID])
+				{
+					std::cout << "ERROR: session " << opened << " got " << reply.sessionID << "\t" << reply.hit << " in round " << round << std::endl;
+					errorCount++;
+				}
+				else
+				{
+					idUsed[reply.sessionID] = true;
+					rxEng2stateTable_upd_req.write(stateQuery(reply.sessionID));
+					stateReads.push_back(reply.sessionID);
+				}
+				opened++;
+			}
+			if (!stateTable2rxEng_upd_rsp.empty())
+			{
+				stateTable2rxEng_upd_rsp.read(state);
+				sessionID = stateReads.front();
+				stateReads.pop_front();
+				if (state != CLOSED)
+				{
+					std::cout << "ERROR: new session " << sessionID << " is in state " << state << std::endl;
+					errorCount++;
+				}
+				rxEng2stateTable_upd_req.write(stateQuery(sessionID, ESTABLISHED, 1));
+				txEng2timer_setRetransmitTimer.write(txRetransmitTimerSet(sessionID, RT, TCP_RTO_MIN));
+			}
+			// TX engine, every retransmission re-arms the timer
+			if (!rtTimer2eventEng_setEvent.empty())
+			{
+				rtTimer2eventEng_setEvent.read(ev);
+				retransmits[ev.sessionID]++;
+				if (ev.type != RT || (int) ev.rt_count != retransmits[ev.sessionID] || timeOuts[ev.sessionID] != 0)
+				{
+					std::cout << "ERROR: unexpected event " << ev.type << " of session " << ev.sessionID << std::endl;
+					errorCount++;
+				}
+				txEng2timer_setRetransmitTimer.write(txRetransmitTimerSet(ev.sessionID, RT, TCP_RTO_MIN));
+			}
+			if (!rtTimer2rxApp_notification.empty())
+			{
+				rtTimer2rxApp_notification.read(notification);
+				timeOuts[notification.sessionID]++;
+				if (!notification.closed || retransmits[notification.sessionID] != TCP_MAX_RETRANSMISSIONS)
+				{
+					std::cout << "ERROR: session " << notification.sessionID << " timed out after " << retransmits[notification.sessionID] << " retransmissions" << std::endl;
+					errorCount++;
+				}
+				closed++;
+			}
+			if (!stateTable2ctx_releaseSession.empty())
+			{
+				stateTable2ctx_releaseSession.read(sessionID);
+				ctxReleases[sessionID]++;
+				released++;
+			}
+			if (!sLookup2portTable_releasePort.empty())
+			{
+				sLookup2portTable_releasePort.read();
+				portReleases++;
+			}
+		}
+
+		for (int i = 0; i < MAX_SESSIONS; i++)
+		{
+			if (timeOuts[i] != 1 || ctxReleases[i] != 1)
+			{
+				std::cout << "ERROR: session " << i << " timed out " << timeOuts[i] << " times and was released " << ctxReleases[i] << " times" << std::endl;
+				errorCount++;
+				break;
+			}
+		}
+		if (opened != MAX_SESSIONS || portReleases != MAX_SESSIONS || regSessionCount != 0 || !rtTimer2txApp_notification.empty())
+		{
+			std::cout << "ERROR: " << opened << " sessions opened, " << portReleases << " ports released, " << regSessionCount << " sessions left in round " << round << std::endl;
+			errorCount++;
+		}
+		std::cout << "Round " << round << ": " << opened << " sessions in " << count << " cycles" << std::endl;
+	}
+	std::cout << "Errors: " << errorCount << std::endl;
+
+	return (errorCount != 0);
+}
@@ -31,51 +31,6 @@ EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.// Copyright (c) 2015 Xilinx,
 
 using namespace hls;
 
-void sessionLookupStub(stream<rtlSessionLookupRequest>& lup_req, stream<rtlSessionLookupReply>& lup_rsp,
-						stream<rtlSessionUpdateRequest>& upd_req, stream<rtlSessionUpdateReply>& upd_rsp)
-						//stream<ap_uint<14> >& new_id, stream<ap_uint<14> >& fin_id)
-{
-	static std::map<fourTupleInternal, ap_uint<14> > lookupTable;
-
-	rtlSessionLookupRequest request;
-	rtlSessionUpdateRequest update;
-
-	std::map<fourTupleInternal, ap_uint<14> >::const_iterator findPos;
-
-	if (!lup_req.empty())
-	{
-		lup_req.read(request);
-		findPos = lookupTable.find(request.key);
-		if (findPos != lookupTable.end()) //hit
-		{
-			lup_rsp.write(rtlSessionLookupReply(true, findPos->second, request.source));
-		}
-		else
-		{
-			lup_rsp.write(rtlSessionLookupReply(false, request.source));
-		}
-	}
-
-	if (!upd_req.empty()) //TODO what if element does not exist
-	{
-		upd_req.read(update);
-		if (update.op == INSERT) //Is there a check if it already exists?
-		{
-			// Read free id
-			//new_id.read(update.value);
-			lookupTable[update.key] = update.value;
-			upd_rsp.write(rtlSessionUpdateReply(update.value, INSERT, update.source));
-
-		}
-		else // DELETE
-		{
-			//fin_id.write(update.value);
-			lookupTable.erase(update.key);
-			upd_rsp.write(rtlSessionUpdateReply(update.value, DELETE, update.source));
-		}
-	}
-}
-
 /*void lookupRequestMerger(	stream<sessionLookupQuery>&				rxLookupIn,
 					stream<fourTuple>&						txAppLookupIn,
 					stream<rtlSessionLookupRequest>&		rtlLookupIn,
@@ -129,10 +84,6 @@ int main()
 	stream<sessionLookupReply>			sLookup2txApp_rsp;
 	stream<ap_uint<16> >				txEng2sLookup_rev_req;
 	stream<fourTuple>					sLookup2txEng_rev_rsp;
-	stream<rtlSessionLookupRequest>		sessionLookup_req;
-	stream<rtlSessionLookupReply>		sessionLookup_rsp("test_sessionLookup_rsp");
-	stream<rtlSessionUpdateRequest>		sessionUpdate_req;
-	stream<rtlSessionUpdateReply>		sessionUpdate_rsp("test_sessionUpdate_rsp");
 
 	stream<rtlSessionUpdateRequest>		sessionInsert_req;
 	stream<rtlSessionUpdateRequest>		sessionDelete_req;
@@ -181,12 +132,6 @@ int main()
 									sLookup2txApp_rsp,
 									txEng2sLookup_rev_req,
 									sLookup2txEng_rev_rsp,
-									sessionLookup_req,
-									sessionLookup_rsp,
-									sessionUpdate_req,
-									//sessionInsert_req,
-									//sessionDelete_req,
-									sessionUpdate_rsp,
 									regSessionCount);
 		//lookupRequestMerger(rxEng2sLookup_req, txApp2sLookup_req, sessionLookup_req, lookups);
 		//updateRequestMerger(sessionInsert_req, sessionDelete_req, sessionUpdate_req);
@@ -195,7 +140,6 @@ int main()
 			std::cout << "SessionCount\t" << regSessionCount << std::endl;
 			lastSessionCount = regSessionCount;
 		}
-		sessionLookupStub(sessionLookup_req, sessionLookup_rsp,	sessionUpdate_req, sessionUpdate_rsp);
 		count++;
 	}
 
@@ -216,5 +160,252 @@ int main()
 		std::cout << "txEng " << tuple.dstIp << ":" << tuple.dstPort << "\t " << tuple.srcIp << ":" << tuple.srcPort << std::endl;
 	}
 
-	return 0;
+	// Fill the hash table with the remaining sessions, then look all of them up again
+	const int fillCount = MAX_SESSIONS-2; // Two sessions are already open
+	std::vector<ap_uint<16> > sessionIDs(MAX_SESSIONS);
+	int errorCount = 0;
+	for (int phase = 0; phase < 2; phase++)
+	{
+		int sent = 0;
+		int received = 0;
+		count = 0;
+		while (received < fillCount && count < 10*MAX_SESSIONS)
+		{
+			if (sent < fillCount && rxEng2sLookup_req.empty())
+			{
+				tuple.srcIp = 0x0a000000 + sent;
+				tuple.srcPort = 0x8000 + (sent & 0xff);
+				rxEng2sLookup_req.write(sessionLookupQuery(tuple, (phase == 0)));
+				sent++;
+			}
+			session_lookup_controller(	rxEng2sLookup_req,
+										sLookup2rxEng_rsp,
+										stateTable2sLookup_releaseSession,
+										sLookup2portTable_releasePort,
+										txApp2sLookup_req,
+										sLookup2txApp_rsp,
+										txEng2sLookup_rev_req,
+										sLookup2txEng_rev_rsp,
+										regSessionCount);
+			if (!sLookup2rxEng_rsp.empty())
+			{
+				sLookup2rxEng_rsp.read(reply);
+				tuple.srcIp = 0x0a000000 + received;
+				tuple.srcPort = 0x8000 + (received & 0xff);
+				if (!reply.hit)
+				{
+					std::cout << "ERROR: no session for " << std::hex << tuple.srcIp << std::dec << " in phase " << phase << std::endl;
+					errorCount++;
+				}
+				else if (phase == 0)
+				{
+					sessionIDs[received] = reply.sessionID;
+				}
+				else if (sessionIDs[received] != reply.sessionID)
+				{
+					std::cout << "ERROR: sessionID mismatch for " << std::hex << tuple.srcIp << std::dec << std::endl;
+					errorCount++;
+				}
+				received++;
+			}
+			count++;
+		}
+		if (received != fillCount)
+		{
+			std::cout << "ERROR: only " << received << " replies in phase " << phase << std::endl;
+			errorCount++;
+		}
+	}
+
+	// Every session gets its own ID, with TCP_64K_SESSIONS they use the full 16 bits
+	std::vector<bool> idUsed(MAX_SESSIONS, false);
+	ap_uint<16> maxID = 0;
+	for (int i = 0; i < fillCount; i++)
+	{
+		if (sessionIDs[i] >= MAX_SESSIONS || idUsed[sessionIDs[i]])
+		{
+			std::cout << "ERROR: sessionID " << sessionIDs[i] << " handed out twice or out of range" << std::endl;
+			errorCount++;
+			break;
+		}
+		idUsed[sessionIDs[i]] = true;
+		if (sessionIDs[i] > maxID)
+		{
+			maxID = sessionIDs[i];
+		}
+	}
+	if (maxID != MAX_SESSIONS-1)
+	{
+		std::cout << "ERROR: highest sessionID is " << maxID << std::endl;
+		errorCount++;
+	}
+
+	// Drive all sessions through the reverse lookup of the TX engine
+	int sent = 0;
+	int received = 0;
+	for (count = 0; received < fillCount && count < 10*MAX_SESSIONS; count++)
+	{
+		if (sent < fillCount && txEng2sLookup_rev_req.empty())
+		{
+			txEng2sLookup_rev_req.write(sessionIDs[sent]);
+			sent++;
+		}
+		session_lookup_controller(	rxEng2sLookup_req,
+									sLookup2rxEng_rsp,
+									stateTable2sLookup_releaseSession,
+									sLookup2portTable_releasePort,
+									txApp2sLookup_req,
+									sLookup2txApp_rsp,
+									txEng2sLookup_rev_req,
+									sLookup2txEng_rev_rsp,
+									regSessionCount);
+		if (!sLookup2txEng_rev_rsp.empty())
+		{
+			sLookup2txEng_rev_rsp.read(tuple);
+			// The reverse table returns the tuple from our point of view
+			if (tuple.dstIp != (0x0a000000 + received) || tuple.dstPort != (0x8000 + (received & 0xff)))
+			{
+				std::cout << "ERROR: reverse lookup of session " << sessionIDs[received] << " returned " << std::hex << tuple.dstIp << std::dec << std::endl;
+				errorCount++;
+			}
+			received++;
+		}
+	}
+	if (received != fillCount)
+	{
+		std::cout << "ERROR: only " << received << " reverse lookups answered" << std::endl;
+		errorCount++;
+	}
+
+	// Release the first of them, its tuple must not be found anymore
+	stateTable2sLookup_releaseSession.write(sessionIDs[0]);
+	tuple.srcIp = 0x0a000000;
+	tuple.srcPort = 0x8000;
+	for (count = 0; count < 100; count++)
+	{
+		if (count == 10)
+		{
+			rxEng2sLookup_req.write(sessionLookupQuery(tuple, false));
+		}
+		session_lookup_controller(	rxEng2sLookup_req,
+									sLookup2rxEng_rsp,
+									stateTable2sLookup_releaseSession,
+									sLookup2portTable_releasePort,
+									txApp2sLookup_req,
+									sLookup2txApp_rsp,
+									txEng2sLookup_rev_req,
+									sLookup2txEng_rev_rsp,
+									regSessionCount);
+	}
+	if (sLookup2rxEng_rsp.empty() || sLookup2rxEng_rsp.read().hit)
+	{
+		std::cout << "ERROR: released session is still found" << std::endl;
+		errorCount++;
+	}
+
+	// Back to back lookups of a new tuple, e.g. retransmitted SYNs, must create only one session
+	tuple.srcIp = 0x0b000000;
+	for (count = 0; count < 100; count++)
+	{
+		if (count < 4)
+		{
+			rxEng2sLookup_req.write(sessionLookupQuery(tuple, true));
+		}
+		session_lookup_controller(	rxEng2sLookup_req,
+									sLookup2rxEng_rsp,
+									stateTable2sLookup_releaseSession,
+									sLookup2portTable_releasePort,
+									txApp2sLookup_req,
+									sLookup2txApp_rsp,
+									txEng2sLookup_rev_req,
+									sLookup2txEng_rev_rsp,
+									regSessionCount);
+	}
+	for (int i = 0; i < 4; i++)
+	{
+		if (sLookup2rxEng_rsp.empty())
+		{
+			std::cout << "ERROR: missing reply for duplicate lookup " << i << std::endl;
+			errorCount++;
+			break;
+		}
+		sLookup2rxEng_rsp.read(reply);
+		if (i == 0)
+		{
+			sessionIDs[0] = reply.sessionID;
+		}
+		if (!reply.hit || reply.sessionID != sessionIDs[0])
+		{
+			std::cout << "ERROR: duplicate lookup " << i << " returned " << reply.sessionID << "\t" << reply.hit << std::endl;
+			errorCount++;
+		}
+	}
+	if (regSessionCount != MAX_SESSIONS)
+	{
+		std::cout << "ERROR: duplicate lookups created more than one session" << std::endl;
+		errorCount++;
+	}
+
+	// Release half of the sessions and open new ones, they have to reuse exactly the released IDs
+	const int reuseCount = fillCount/2;
+	std::vector<bool> idReleased(MAX_SESSIONS, false);
+	for (int i = 1; i <= reuseCount; i++)
+	{
+		idReleased[sessionIDs[i]] = true;
+	}
+	sent = 0;
+	received = 0;
+	int released = 1;
+	for (count = 0; received < reuseCount && count < 10*MAX_SESSIONS; count++)
+	{
+		if (released <= reuseCount)
+		{
+			stateTable2sLookup_releaseSession.write(sessionIDs[released]);
+			released++;
+		}
+		else if (sent < reuseCount && rxEng2sLookup_req.empty())
+		{
+			tuple.srcIp = 0x0c000000 + sent;
+			tuple.srcPort = 0x8000 + (sent & 0xff);
+			rxEng2sLookup_req.write(sessionLookupQuery(tuple, true));
+			sent++;
+		}
+		session_lookup_controller(	rxEng2sLookup_req,
+									sLookup2rxEng_rsp,
+									stateTable2sLookup_releaseSession,
+									sLookup2portTable_releasePort,
+									txApp2sLookup_req,
+									sLookup2txApp_rsp,
+									txEng2sLookup_rev_req,
+									sLookup2txEng_rev_rsp,
+									regSessionCount);
+		if (!sLookup2rxEng_rsp.empty())
+		{
+			sLookup2rxEng_rsp.read(reply);
+			if (!reply.hit || reply.sessionID >= MAX_SESSIONS || !idReleased[reply.sessionID])
+			{
+				std::cout << "ERROR: reopened session got " << reply.sessionID << "\t" << reply.hit << std::endl;
+				errorCount++;
+			}
+			else
+			{
+				idReleased[reply.sessionID] = false;
+			}
+			received++;
+		}
+	}
+	if (received != reuseCount)
+	{
+		std::cout << "ERROR: only " << received << " sessions reopened" << std::endl;
+		errorCount++;
+	}
+	if (regSessionCount != MAX_SESSIONS)
+	{
+		std::cout << "ERROR: session count " << regSessionCount << " after reopening" << std::endl;
+		errorCount++;
+	}
+	std::cout << "SessionCount\t" << regSessionCount << std::endl;
+	std::cout << "Errors: " << errorCount << std::endl;
+
+	return (errorCount != 0);
 }
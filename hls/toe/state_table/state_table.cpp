@@ -31,12 +31,37 @@ EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.// Copyright (c) 2015 Xilinx,
 
 using namespace hls;
 
+/** @ingroup state_table
+ *  Checks if @param sessionID is locked by one of the RX engine segments in flight,
+ *  the locks are kept in a ring with the oldest one at @param head - @param count
+ */
+bool rxSessionLocked(ap_uint<16> sessionID, ap_uint<16> lockedID[RX_FSM_INFLIGHT], ap_uint<2> head, ap_uint<3> count)
+{
+#pragma HLS INLINE
+	bool locked = false;
+	for (ap_uint<3> i = 0; i < RX_FSM_INFLIGHT; i++)
+	{
+	#pragma HLS UNROLL
+		ap_uint<2> slot = head - 1 - i;
+		if (i < count && lockedID[slot] == sessionID)
+		{
+			locked = true;
+		}
+	}
+	return locked;
+}
+
 /** @ingroup state_table
  *  Stores the TCP connection state of each session. It is accessed
  *  from the @ref rx_engine, @ref tx_app_if and from @ref tx_engine.
  *  It also receives Session-IDs from the @ref close_timer, those sessions
  *  are closed and the IDs forwarded to the @ref session_lookup_controller which
- *  releases this ID.
+ *  releases this ID, and to the @ref session_context_table which
+ *  return the session buffers.
+ *  The @ref rx_engine can have up to RX_FSM_INFLIGHT segments in flight, each read
+ *  of it locks the session until the corresponding write back. A read of a session
+ *  which is already locked by the RX engine is served right away, the write backs
+ *  arrive in the same order as the reads.
  *  @param[in]		rxEng2stateTable_upd_req
  *  @param[in]		txApp2stateTable_upd_req
  *  @param[in]		txApp2stateTable_req
@@ -45,6 +70,7 @@ using namespace hls;
  *  @param[out]		stateTable2TxApp_upd_rsp
  *  @param[out]		stateTable2txApp_rsp
  *  @param[out]		stateTable2sLookup_releaseSession
+ *  @param[out]		stateTable2ctx_releaseSession
  */
 void state_table(	stream<stateQuery>&			rxEng2stateTable_upd_req,
 					stream<stateQuery>&			txApp2stateTable_upd_req,
@@ -53,18 +79,21 @@ void state_table(	stream<stateQuery>&			rxEng2stateTable_upd_req,
 					stream<sessionState>&		stateTable2rxEng_upd_rsp,
 					stream<sessionState>&		stateTable2TxApp_upd_rsp,
 					stream<sessionState>&		stateTable2txApp_rsp,
-					stream<ap_uint<16> >&		stateTable2sLookup_releaseSession)
+					stream<ap_uint<16> >&		stateTable2sLookup_releaseSession,
+					stream<ap_uint<16> >&		stateTable2ctx_releaseSession)
 {
 #pragma HLS PIPELINE II=1
 
 	static sessionState state_table[MAX_SESSIONS];
-	#pragma HLS RESOURCE variable=state_table core=RAM_2P_BRAM
+	SESSION_TABLE_RESOURCE(state_table, RAM_2P_BRAM)
 	#pragma HLS DEPENDENCE variable=state_table inter false
 
 	static ap_uint<16> stt_txSessionID;
-	static ap_uint<16> stt_rxSessionID;
-	static bool stt_rxSessionLocked = false;
 	static bool stt_txSessionLocked = false;
+	static ap_uint<16> stt_rxLockedID[RX_FSM_INFLIGHT];
+	#pragma HLS ARRAY_PARTITION variable=stt_rxLockedID complete
+	static ap_uint<2> stt_rxLockHead = 0;
+	static ap_uint<3> stt_rxLockCount = 0;
 
 	static stateQuery stt_txAccess;
 	static stateQuery stt_rxAccess;
@@ -81,7 +110,7 @@ void state_table(	stream<stateQuery>&			rxEng2stateTable_upd_req,
 	if(!txApp2stateTable_upd_req.empty() && !stt_txWait)
 	{
 		txApp2stateTable_upd_req.read(stt_txAccess);
-		if ((stt_txAccess.sessionID == stt_rxSessionID) && stt_rxSessionLocked) //delay
+		if (rxSessionLocked(stt_txAccess.sessionID, stt_rxLockedID, stt_rxLockHead, stt_rxLockCount)) //delay
 		{
 			stt_txWait = true;
 		}
@@ -122,15 +151,18 @@ void state_table(	stream<stateQuery>&			rxEng2stateTable_upd_req,
 				if (stt_rxAccess.state == CLOSED)// && state_table[stt_rxAccess.sessionID] != CLOSED) // We check if it was not closed before, not sure if necessary
 				{
 					stateTable2sLookup_releaseSession.write(stt_rxAccess.sessionID);
+					stateTable2ctx_releaseSession.write(stt_rxAccess.sessionID);
 				}
 				state_table[stt_rxAccess.sessionID] = stt_rxAccess.state;
-				stt_rxSessionLocked = false;
+				// Releases the oldest lock
+				stt_rxLockCount--;
 			}
 			else
 			{
 				stateTable2rxEng_upd_rsp.write(state_table[stt_rxAccess.sessionID]);
-				stt_rxSessionID = stt_rxAccess.sessionID;
-				stt_rxSessionLocked = true;
+				stt_rxLockedID[stt_rxLockHead] = stt_rxAccess.sessionID;
+				stt_rxLockHead++;
+				stt_rxLockCount++;
 			}
 		}
 	}
@@ -139,19 +171,21 @@ void state_table(	stream<stateQuery>&			rxEng2stateTable_upd_req,
 	{
 		timer2stateTable_releaseState.read(stt_closeSessionID);
 		// Check if locked
-		if (((stt_closeSessionID == stt_rxSessionID) && stt_rxSessionLocked) ||  ((stt_closeSessionID == stt_txSessionID) && stt_txSessionLocked))
+		if (rxSessionLocked(stt_closeSessionID, stt_rxLockedID, stt_rxLockHead, stt_rxLockCount) ||  ((stt_closeSessionID == stt_txSessionID) && stt_txSessionLocked))
 		{
 			stt_closeWait = true;
 		}
-		else
+		// A session the RX engine closed in the meantime was already released
+		else if (state_table[stt_closeSessionID] != CLOSED)
 		{
 			state_table[stt_closeSessionID] = CLOSED;
 			stateTable2sLookup_releaseSession.write(stt_closeSessionID);
+			stateTable2ctx_releaseSession.write(stt_closeSessionID);
 		}
 	}
 	else if (stt_txWait)
 	{
-		if ((stt_txAccess.sessionID != stt_rxSessionID) || !stt_rxSessionLocked)
+		if (!rxSessionLocked(stt_txAccess.sessionID, stt_rxLockedID, stt_rxLockHead, stt_rxLockCount))
 		{
 			if (stt_txAccess.write)
 			{
@@ -176,25 +210,32 @@ void state_table(	stream<stateQuery>&			rxEng2stateTable_upd_req,
 				if (stt_rxAccess.state == CLOSED)
 				{
 					stateTable2sLookup_releaseSession.write(stt_rxAccess.sessionID);
+					stateTable2ctx_releaseSession.write(stt_rxAccess.sessionID);
 				}
 				state_table[stt_rxAccess.sessionID] = stt_rxAccess.state;
-				stt_rxSessionLocked = false;
+				// Releases the oldest lock
+				stt_rxLockCount--;
 			}
 			else
 			{
 				stateTable2rxEng_upd_rsp.write(state_table[stt_rxAccess.sessionID]);
-				stt_rxSessionID = stt_rxAccess.sessionID;
-				stt_rxSessionLocked = true;
+				stt_rxLockedID[stt_rxLockHead] = stt_rxAccess.sessionID;
+				stt_rxLockHead++;
+				stt_rxLockCount++;
 			}
 			stt_rxWait = false;
 		}
 	}
 	else if (stt_closeWait)
 	{
-		if (((stt_closeSessionID != stt_rxSessionID) || !stt_rxSessionLocked) && ((stt_closeSessionID != stt_txSessionID) || !stt_txSessionLocked))
+		if (!rxSessionLocked(stt_closeSessionID, stt_rxLockedID, stt_rxLockHead, stt_rxLockCount) && ((stt_closeSessionID != stt_txSessionID) || !stt_txSessionLocked))
 		{
-			state_table[stt_closeSessionID] = CLOSED;
-			stateTable2sLookup_releaseSession.write(stt_closeSessionID);
+			if (state_table[stt_closeSessionID] != CLOSED)
+			{
+				state_table[stt_closeSessionID] = CLOSED;
+				stateTable2sLookup_releaseSession.write(stt_closeSessionID);
+				stateTable2ctx_releaseSession.write(stt_closeSessionID);
+			}
 			stt_closeWait = false;
 		}
 	}
@@ -0,0 +1,133 @@
+/************************************************
+Copyright (c) 2016, Xilinx, Inc.
+All rights reserved.
+
+Redistribution and use in source and binary forms, with or without modification, 
+are permitted provided that the following conditions are met:
+
+1. Redistributions of source code must retain the above copyright notice, 
+this list of conditions and the following disclaimer.
+
+2. Redistributions in binary form must reproduce the above copyright notice, 
+this list of conditions and the following disclaimer in the documentation 
+and/or other materials provided with the distribution.
+
+3. Neither the name of the copyright holder nor the names of its contributors 
+may be used to endorse or promote products derived from this software 
+without specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND 
+ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, 
+THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED. 
+IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, 
+INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, 
+PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) 
+HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, 
+OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, 
+EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.// Copyright (c) 2015 Xilinx, Inc.
+************************************************/
+#ifndef SYN_COOKIE_HPP_INCLUDED
+#define SYN_COOKIE_HPP_INCLUDED
+
+#include "../toe.hpp"
+
+using namespace hls;
+
+// Hash bits of a cookie, the period of the secret is kept in the top SYN_COOKIE_PERIOD_BITS
+static const uint8_t SYN_COOKIE_HASH_BITS = 32 - SYN_COOKIE_PERIOD_BITS;
+
+/** @ingroup syn_cookie
+ *  One SipRound on 32-bit words, as in HalfSipHash
+ */
+static inline void synCookieRound(ap_uint<32>& v0, ap_uint<32>& v1, ap_uint<32>& v2, ap_uint<32>& v3)
+{
+#pragma HLS INLINE
+
+	v0 += v1; v1 = (v1 << 5) | (v1 >> 27); v1 ^= v0; v0 = (v0 << 16) | (v0 >> 16);
+	v2 += v3; v3 = (v3 << 8) | (v3 >> 24); v3 ^= v2;
+	v0 += v3; v3 = (v3 << 7) | (v3 >> 25); v3 ^= v0;
+	v2 += v1; v1 = (v1 << 13) | (v1 >> 19); v1 ^= v2; v2 = (v2 << 16) | (v2 >> 16);
+}
+
+/** @defgroup syn_cookie SYN Cookie
+ *  @ingroup tcp_module
+ *  Keyed hash of the SYN cookies, HalfSipHash-1-2 over the four-tuple, the ISN of the peer and the period
+ *  of the secret. All five words are absorbed in one cycle, the function is inlined into its callers.
+ *  @param[in]		remoteIp
+ *  @param[in]		remotePort
+ *  @param[in]		localIp
+ *  @param[in]		localPort
+ *  @param[in]		isn, sequence number of the SYN
+ *  @param[in]		period, of the secret
+ *  @return			cookie, used as the ISN of the SYN-ACK
+ */
+static inline ap_uint<32> synCookieGenerate(ap_uint<32>						remoteIp,
+											ap_uint<16>						remotePort,
+											ap_uint<32>						localIp,
+											ap_uint<16>						localPort,
+											ap_uint<32>						isn,
+											ap_uint<SYN_COOKIE_PERIOD_BITS>	period)
+{
+#pragma HLS INLINE
+
+	const ap_uint<64> key = TCP_SYN_COOKIE_KEY;
+	ap_uint<32> msg[5];
+#pragma HLS ARRAY_PARTITION variable=msg complete
+	msg[0] = remoteIp;
+	msg[1] = localIp;
+	msg[2] = (remotePort, localPort);
+	msg[3] = isn;
+	msg[4] = period;
+
+	ap_uint<32> v0 = key(31, 0);
+	ap_uint<32> v1 = key(63, 32);
+	ap_uint<32> v2 = key(31, 0) ^ 0x6c796765;
+	ap_uint<32> v3 = key(63, 32) ^ 0x74656462;
+	for (int i = 0; i < 5; i++)
+	{
+#pragma HLS UNROLL
+		v3 ^= msg[i];
+		synCookieRound(v0, v1, v2, v3);
+		v0 ^= msg[i];
+	}
+	v2 ^= 0xff;
+	synCookieRound(v0, v1, v2, v3);
+	synCookieRound(v0, v1, v2, v3);
+	ap_uint<32> hash = v1 ^ v3;
+
+	ap_uint<32> cookie;
+	cookie(31, SYN_COOKIE_HASH_BITS) = period;
+	cookie(SYN_COOKIE_HASH_BITS-1, 0) = hash(SYN_COOKIE_HASH_BITS-1, 0);
+	return cookie;
+}
+
+/** @ingroup syn_cookie
+ *  Checks the cookie returned by the ACK of a handshake, it has to be from the current or the previous period
+ *  @param[in]		remoteIp
+ *  @param[in]		remotePort
+ *  @param[in]		localIp
+ *  @param[in]		localPort
+ *  @param[in]		isn, sequence number of the SYN, SEQ-1 of the ACK
+ *  @param[in]		cookie, ACK-1 of the ACK
+ *  @param[in]		currentPeriod
+ *  @return			true if the cookie is valid
+ */
+static inline bool synCookieCheck(	ap_uint<32>						remoteIp,
+									ap_uint<16>						remotePort,
+									ap_uint<32>						localIp,
+									ap_uint<16>						localPort,
+									ap_uint<32>						isn,
+									ap_uint<32>						cookie,
+									ap_uint<SYN_COOKIE_PERIOD_BITS>	currentPeriod)
+{
+#pragma HLS INLINE
+
+	ap_uint<SYN_COOKIE_PERIOD_BITS> period = cookie(31, SYN_COOKIE_HASH_BITS);
+	if (period != currentPeriod && period != (ap_uint<SYN_COOKIE_PERIOD_BITS>) (currentPeriod-1))
+	{
+		return false;
+	}
+	return (synCookieGenerate(remoteIp, remotePort, localIp, localPort, isn, period) == cookie);
+}
+
+#endif
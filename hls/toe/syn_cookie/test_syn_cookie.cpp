@@ -0,0 +1,86 @@
+/************************************************
+Copyright (c) 2016, Xilinx, Inc.
+All rights reserved.
+
+Redistribution and use in source and binary forms, with or without modification, 
+are permitted provided that the following conditions are met:
+
+1. Redistributions of source code must retain the above copyright notice, 
+this list of conditions and the following disclaimer.
+
+2. Redistributions in binary form must reproduce the above copyright notice, 
+this list of conditions and the following disclaimer in the documentation 
+and/or other materials provided with the distribution.
+
+3. Neither the name of the copyright holder nor the names of its contributors 
+may be used to endorse or promote products derived from this software 
+without specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND 
+ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, 
+THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED. 
+IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, 
+INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, 
+PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) 
+HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, 
+OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, 
+EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.// Copyright (c) 2015 Xilinx, Inc.
+************************************************/
+#include "syn_cookie.hpp"
+#include <iostream>
+
+using namespace hls;
+
+int main()
+{
+	ap_uint<32> remoteIp = 0x0a010101;
+	ap_uint<32> localIp = 0x0a010102;
+	ap_uint<16> remotePort = 0xc350;
+	ap_uint<16> localPort = 80;
+	ap_uint<32> isn = 0x12345678;
+	int errCount = 0;
+
+	ap_uint<32> cookie = synCookieGenerate(remoteIp, remotePort, localIp, localPort, isn, 5);
+	if (cookie(31, SYN_COOKIE_HASH_BITS) != 5)
+	{
+		std::cout << "Period not encoded: " << std::hex << cookie << std::endl;
+		errCount++;
+	}
+	// Valid in the period it was sent and the one after
+	if (!synCookieCheck(remoteIp, remotePort, localIp, localPort, isn, cookie, 5))
+	{
+		std::cout << "Cookie rejected in its period" << std::endl;
+		errCount++;
+	}
+	if (!synCookieCheck(remoteIp, remotePort, localIp, localPort, isn, cookie, 6))
+	{
+		std::cout << "Cookie rejected in the next period" << std::endl;
+		errCount++;
+	}
+	if (synCookieCheck(remoteIp, remotePort, localIp, localPort, isn, cookie, 7))
+	{
+		std::cout << "Expired cookie accepted" << std::endl;
+		errCount++;
+	}
+	// Wraps around the period counter
+	cookie = synCookieGenerate(remoteIp, remotePort, localIp, localPort, isn, 7);
+	if (!synCookieCheck(remoteIp, remotePort, localIp, localPort, isn, cookie, 0))
+	{
+		std::cout << "Cookie rejected after the period wrapped" << std::endl;
+		errCount++;
+	}
+	// Any change of the tuple or the ISN invalidates the cookie
+	cookie = synCookieGenerate(remoteIp, remotePort, localIp, localPort, isn, 2);
+	if (synCookieCheck(remoteIp+1, remotePort, localIp, localPort, isn, cookie, 2) ||
+		synCookieCheck(remoteIp, remotePort+1, localIp, localPort, isn, cookie, 2) ||
+		synCookieCheck(remoteIp, remotePort, localIp, localPort+1, isn, cookie, 2) ||
+		synCookieCheck(remoteIp, remotePort, localIp, localPort, isn+1, cookie, 2) ||
+		synCookieCheck(remoteIp, remotePort, localIp, localPort, isn, cookie+1, 2))
+	{
+		std::cout << "Forged cookie accepted" << std::endl;
+		errCount++;
+	}
+
+	std::cout << "Errors: " << errCount << std::endl;
+	return errCount;
+}
@@ -0,0 +1,147 @@
+/************************************************
+Copyright (c) 2016, Xilinx, Inc.
+All rights reserved.
+
+Redistribution and use in source and binary forms, with or without modification, 
+are permitted provided that the following conditions are met:
+
+1. Redistributions of source code must retain the above copyright notice, 
+this list of conditions and the following disclaimer.
+
+2. Redistributions in binary form must reproduce the above copyright notice, 
+this list of conditions and the following disclaimer in the documentation 
+and/or other materials provided with the distribution.
+
+3. Neither the name of the copyright holder nor the names of its contributors 
+may be used to endorse or promote products derived from this software 
+without specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND 
+ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, 
+THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED. 
+IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, 
+INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, 
+PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) 
+HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, 
+OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, 
+EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.// Copyright (c) 2015 Xilinx, Inc.
+************************************************/
+#include "timing_wheel.hpp"
+#include <iostream>
+
+using namespace hls;
+
+static const uint32_t RUN_TICKS = 140000;
+static const uint32_t NEVER = 0xFFFFFFFF;
+
+stream<timerWheelOp>		opFifo;
+stream<timerWheelExpiry>	expiredFifo;
+
+// Reference model of the armed timers, the expected expiry tick and tag of each ID
+bool		armed[MAX_SESSIONS];
+uint32_t	deadline[MAX_SESSIONS];
+ap_uint<8>	armedTag[MAX_SESSIONS];
+
+uint32_t count = 0;
+int errCount = 0;
+
+// The wheel advances one tick every TIMER_TICK_CYCLES calls, the ops are written in the middle of a tick
+uint32_t currentTick()
+{
+	return count / TIMER_TICK_CYCLES;
+}
+
+void setTimer(ap_uint<16> id, uint32_t delay, ap_uint<8> tag)
+{
+	opFifo.write(timerWheelOp(id, delay, tag));
+	armed[id] = true;
+	armedTag[id] = tag;
+	if (delay == 0) // already due, fires with the next tick
+	{
+		deadline[id] = currentTick() + 1;
+	}
+	else if (delay > TIMER_WHEEL_MAX_DELAY)
+	{
+		deadline[id] = NEVER;
+	}
+	else
+	{
+		deadline[id] = currentTick() + delay;
+	}
+}
+
+void cancelTimer(ap_uint<16> id)
+{
+	opFifo.write(timerWheelOp(id));
+	armed[id] = false;
+}
+
+void runUntilTick(uint32_t tick)
+{
+	timerWheelExpiry expired;
+	for (; count < tick*TIMER_TICK_CYCLES + TIMER_TICK_CYCLES/2; count++)
+	{
+		timing_wheel<0>(opFifo, expiredFifo);
+		if (!expiredFifo.empty())
+		{
+			expiredFifo.read(expired);
+			if (!armed[expired.sessionID] || expired.tag != armedTag[expired.sessionID]
+					|| currentTick() != deadline[expired.sessionID])
+			{
+				std::cout << "ERROR: ID " << expired.sessionID << " tag " << expired.tag << " expired at tick " << currentTick();
+				std::cout << ", expected " << (armed[expired.sessionID] ? (int) deadline[expired.sessionID] : -1) << std::endl;
+				errCount++;
+			}
+			armed[expired.sessionID] = false;
+		}
+	}
+}
+
+int main()
+{
+	for (int i = 0; i < MAX_SESSIONS; i++)
+	{
+		armed[i] = false;
+	}
+
+	runUntilTick(1);
+	setTimer(0, 10, 0);			// level 0
+	setTimer(1, 300, 0);		// cascades from level 1
+	setTimer(2, 70000, 0);		// cascades from level 2 across a level 2 wrap
+	setTimer(3, 100, 0);		// cancelled below
+	setTimer(4, 0, 0);			// due right away
+	setTimer(5, 131075, 0);		// two level 2 slots ahead
+	setTimer(6, 0xFFFFFFFF, 0);	// clamped, would be due right away otherwise
+	setTimer(7, (1 << 24) + 5, 0);	// clamped, beyond the range of the wheel
+	setTimer(8, 20, 3);
+	setTimer(9, 255, 0);		// last slot of level 0
+	setTimer(10, 256, 0);		// first slot of level 1
+	for (int i = 100; i < 200; i++)
+	{
+		setTimer(i, 500, i);	// all in one slot
+	}
+
+	runUntilTick(5);
+	setTimer(8, 40, 4);			// re-armed before it expired, only the new tag fires
+
+	runUntilTick(50);
+	cancelTimer(3);				// must not fire
+	setTimer(0, 50, 1);			// re-armed after it expired
+
+	runUntilTick(400);
+	setTimer(1, 600, 1);		// re-armed after a cascade, while the others of its slot are due
+	setTimer(3, 65536, 2);		// cancelled timer armed again
+
+	runUntilTick(RUN_TICKS);
+	for (int i = 0; i < MAX_SESSIONS; i++)
+	{
+		if (armed[i] && deadline[i] != NEVER)
+		{
+			std::cout << "ERROR: ID " << i << " did not expire at tick " << deadline[i] << std::endl;
+			errCount++;
+		}
+	}
+
+	std::cout << "Errors: " << errCount << std::endl;
+	return errCount;
+}
@@ -0,0 +1,287 @@
+/************************************************
+Copyright (c) 2016, Xilinx, Inc.
+All rights reserved.
+
+Redistribution and use in source and binary forms, with or without modification, 
+are permitted provided that the following conditions are met:
+
+1. Redistributions of source code must retain the above copyright notice, 
+this list of conditions and the following disclaimer.
+
+2. Redistributions in binary form must reproduce the above copyright notice, 
+this list of conditions and the following disclaimer in the documentation 
+and/or other materials provided with the distribution.
+
+3. Neither the name of the copyright holder nor the names of its contributors 
+may be used to endorse or promote products derived from this software 
+without specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND 
+ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, 
+THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED. 
+IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, 
+INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, 
+PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) 
+HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, 
+OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, 
+EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.// Copyright (c) 2015 Xilinx, Inc.
+************************************************/
+#ifndef TIMING_WHEEL_HPP_INCLUDED
+#define TIMING_WHEEL_HPP_INCLUDED
+
+#include "../toe.hpp"
+
+using namespace hls;
+
+// Three levels of 256 slots, a slot of level n spans 256^n ticks. Together they cover 2^24 ticks
+static const uint8_t TIMER_WHEEL_LEVELS = 3;
+static const uint16_t TIMER_WHEEL_SLOTS = 256;
+static const ap_uint<16> TIMER_WHEEL_NONE = 0xFFFF;
+// Longer delays are clamped, they could otherwise land in the level 2 slot that is currently walked
+static const ap_uint<32> TIMER_WHEEL_MAX_DELAY = (1 << 24) - (1 << 16);
+
+enum timerWheelWalk {TW_IDLE, TW_WALK_L0, TW_WALK_L1, TW_WALK_L2};
+
+/** @ingroup timing_wheel
+ *  Arms (set) or cancels a timer, a set on an armed timer restarts it. The tag is returned
+ *  on expiration, the owner uses it to discard expirations of timers it already re-armed
+ */
+struct timerWheelOp
+{
+	ap_uint<16>	sessionID;
+	ap_uint<32>	delay;
+	ap_uint<8>	tag;
+	bool		set;
+	timerWheelOp() {}
+	timerWheelOp(ap_uint<16> id)
+				:sessionID(id), delay(0), tag(0), set(false) {}
+	timerWheelOp(ap_uint<16> id, ap_uint<32> delay, ap_uint<8> tag)
+				:sessionID(id), delay(delay), tag(tag), set(true) {}
+};
+
+/** @ingroup timing_wheel
+ *
+ */
+struct timerWheelExpiry
+{
+	ap_uint<16>	sessionID;
+	ap_uint<8>	tag;
+	timerWheelExpiry() {}
+	timerWheelExpiry(ap_uint<16> id, ap_uint<8> tag)
+				:sessionID(id), tag(tag) {}
+};
+
+/** @ingroup timing_wheel
+ *
+ */
+struct timerWheelEntry
+{
+	ap_uint<32>	deadline;
+	ap_uint<10>	slot;
+	ap_uint<8>	tag;
+	bool		linked;
+};
+
+/** @defgroup timing_wheel Timing Wheel
+ *  @ingroup tcp_module
+ *  Hierarchical timing wheel shared by the timers. Every armed timer is linked into the slot of its
+ *  deadline, a slot holds a doubly linked list of Session-IDs, so arming and canceling take constant time.
+ *  Every TIMER_TICK_CYCLES cycles the wheel advances by one tick and only walks the lists that are due:
+ *  the level 0 slot of the tick, and on a level wrap the level 1 (and level 2) slot, whose entries are
+ *  cascaded down. The timer resolution does not depend on MAX_SESSIONS anymore.
+ *  Each instance has its own state, TIMER_ID only has to be unique per instance.
+ *  @param[in]		timerOpIn
+ *  @param[out]		timerExpiredOut
+ */
+template <int TIMER_ID>
+void timing_wheel(	stream<timerWheelOp>&		timerOpIn,
+					stream<timerWheelExpiry>&	timerExpiredOut)
+{
+#pragma HLS INLINE off
+#pragma HLS PIPELINE II=1
+
+	static timerWheelEntry tw_entries[MAX_SESSIONS];
+	SESSION_TABLE_RESOURCE(tw_entries, RAM_T2P_BRAM)
+	#pragma HLS DATA_PACK variable=tw_entries
+	#pragma HLS DEPENDENCE variable=tw_entries inter false
+	static ap_uint<16> tw_next[MAX_SESSIONS];
+	SESSION_TABLE_RESOURCE(tw_next, RAM_T2P_BRAM)
+	#pragma HLS DEPENDENCE variable=tw_next inter false
+	static ap_uint<16> tw_prev[MAX_SESSIONS];
+	SESSION_TABLE_RESOURCE(tw_prev, RAM_T2P_BRAM)
+	#pragma HLS DEPENDENCE variable=tw_prev inter false
+	static ap_uint<16> tw_head[TIMER_WHEEL_LEVELS*TIMER_WHEEL_SLOTS];
+	#pragma HLS RESOURCE variable=tw_head core=RAM_T2P_BRAM
+	#pragma HLS DEPENDENCE variable=tw_head inter false
+
+	static bool			tw_initDone = false;
+	static ap_uint<10>	tw_initSlot = 0;
+	static ap_uint<32>	tw_now = 0;
+	static ap_uint<32>	tw_cycles = 0;
+	static timerWheelWalk tw_walk = TW_IDLE;
+	static bool			tw_insertValid = false;
+	static ap_uint<16>	tw_insertID;
+
+	timerWheelOp op;
+	timerWheelEntry entry;
+	ap_uint<16> currID;
+	ap_uint<16> prevID;
+	ap_uint<16> nextID;
+	ap_uint<32> delta;
+	ap_uint<32> nextTick;
+	ap_uint<10> slot;
+
+	tw_cycles++;
+
+	// Empty all slots after reset
+	if (!tw_initDone)
+	{
+		tw_head[tw_initSlot] = TIMER_WHEEL_NONE;
+		tw_initSlot++;
+		if (tw_initSlot == TIMER_WHEEL_LEVELS*TIMER_WHEEL_SLOTS)
+		{
+			tw_initDone = true;
+		}
+	}
+	// Link the entry into the slot of its deadline, set and cascade unlink it the cycle before
+	else if (tw_insertValid)
+	{
+		entry = tw_entries[tw_insertID];
+		delta = entry.deadline - tw_now;
+		if (delta == 0 || delta[31] == 1) // already due, fires with the next tick
+		{
+			nextTick = tw_now + 1;
+			slot = nextTick(7, 0);
+		}
+		else if (delta < TIMER_WHEEL_SLOTS)
+		{
+			slot = entry.deadline(7, 0);
+		}
+		else if (delta < (TIMER_WHEEL_SLOTS*TIMER_WHEEL_SLOTS))
+		{
+			slot = TIMER_WHEEL_SLOTS + entry.deadline(15, 8);
+		}
+		else
+		{
+			slot = 2*TIMER_WHEEL_SLOTS + entry.deadline(23, 16);
+		}
+		nextID = tw_head[slot];
+		tw_next[tw_insertID] = nextID;
+		tw_prev[tw_insertID] = TIMER_WHEEL_NONE;
+		if (nextID != TIMER_WHEEL_NONE)
+		{
+			tw_prev[nextID] = tw_insertID;
+		}
+		tw_head[slot] = tw_insertID;
+		entry.slot = slot;
+		entry.linked = true;
+		tw_entries[tw_insertID] = entry;
+		tw_insertValid = false;
+	}
+	else if (!timerOpIn.empty())
+	{
+		timerOpIn.read(op);
+		entry = tw_entries[op.sessionID];
+		// Unlink, also on a set which moves the entry to another slot
+		if (entry.linked)
+		{
+			prevID = tw_prev[op.sessionID];
+			nextID = tw_next[op.sessionID];
+			if (prevID == TIMER_WHEEL_NONE)
+			{
+				tw_head[entry.slot] = nextID;
+			}
+			else
+			{
+				tw_next[prevID] = nextID;
+			}
+			if (nextID != TIMER_WHEEL_NONE)
+			{
+				tw_prev[nextID] = prevID;
+			}
+			entry.linked = false;
+		}
+		if (op.set)
+		{
+			entry.deadline = tw_now + ((op.delay < TIMER_WHEEL_MAX_DELAY) ? op.delay : TIMER_WHEEL_MAX_DELAY);
+			entry.tag = op.tag;
+			tw_insertID = op.sessionID;
+			tw_insertValid = true;
+		}
+		tw_entries[op.sessionID] = entry;
+	}
+	// Walk the due slots, the head of the slot is removed until the list is empty
+	else if (tw_walk != TW_IDLE && !timerExpiredOut.full())
+	{
+		switch (tw_walk)
+		{
+		case TW_WALK_L2:
+			slot = 2*TIMER_WHEEL_SLOTS + tw_now(23, 16);
+			break;
+		case TW_WALK_L1:
+			slot = TIMER_WHEEL_SLOTS + tw_now(15, 8);
+			break;
+		default:
+			slot = tw_now(7, 0);
+			break;
+		}
+		currID = tw_head[slot];
+		if (currID == TIMER_WHEEL_NONE)
+		{
+			switch (tw_walk)
+			{
+			case TW_WALK_L2:
+				tw_walk = TW_WALK_L1;
+				break;
+			case TW_WALK_L1:
+				tw_walk = TW_WALK_L0;
+				break;
+			default:
+				tw_walk = TW_IDLE;
+				break;
+			}
+		}
+		else
+		{
+			nextID = tw_next[currID];
+			tw_head[slot] = nextID;
+			if (nextID != TIMER_WHEEL_NONE)
+			{
+				tw_prev[nextID] = TIMER_WHEEL_NONE;
+			}
+			entry = tw_entries[currID];
+			entry.linked = false;
+			tw_entries[currID] = entry;
+			delta = entry.deadline - tw_now;
+			if (delta == 0 || delta[31] == 1)
+			{
+				timerExpiredOut.write(timerWheelExpiry(currID, entry.tag));
+			}
+			else // Cascade to a lower level
+			{
+				tw_insertID = currID;
+				tw_insertValid = true;
+			}
+		}
+	}
+	// Advance by one tick, ticks missed during a long walk are caught up
+	else if (tw_walk == TW_IDLE && tw_cycles >= TIMER_TICK_CYCLES)
+	{
+		tw_cycles -= TIMER_TICK_CYCLES;
+		tw_now++;
+		if (tw_now(15, 0) == 0)
+		{
+			tw_walk = TW_WALK_L2;
+		}
+		else if (tw_now(7, 0) == 0)
+		{
+			tw_walk = TW_WALK_L1;
+		}
+		else
+		{
+			tw_walk = TW_WALK_L0;
+		}
+	}
+}
+
+#endif
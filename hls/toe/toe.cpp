@@ -31,13 +31,14 @@ EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.// Copyright (c) 2015 Xilinx,
 
 #include "session_lookup_controller/session_lookup_controller.hpp"
 #include "state_table/state_table.hpp"
-#include "rx_sar_table/rx_sar_table.hpp"
-#include "tx_sar_table/tx_sar_table.hpp"
+#include "session_context_table/session_context_table.hpp"
 #include "retransmit_timer/retransmit_timer.hpp"
 #include "probe_timer/probe_timer.hpp"
 #include "close_timer/close_timer.hpp"
+#include "keepalive_timer/keepalive_timer.hpp"
 #include "event_engine/event_engine.hpp"
 #include "ack_delay/ack_delay.hpp"
+#include "tx_pacer/tx_pacer.hpp"
 #include "port_table/port_table.hpp"
 
 
@@ -165,6 +166,11 @@ void stream_merger(stream<T>& in1, stream<T>& in2, stream<T>& out)
  *  @param[in]		txEng2timer_setRetransmitTimer
  *  @param[in]		txEng2timer_setProbeTimer
  *  @param[in]		rxEng2timer_setCloseTimer
+ *  @param[in]		rxEng2timer_timeWaitQuery
+ *  @param[in]		rxEng2timer_synQuery
+ *  @param[in]		rxEng2timer_setKeepAlive
+ *  @param[out]		timer2rxEng_timeWaitRsp
+ *  @param[out]		timer2rxEng_synRsp
  *  @param[out]		timer2stateTable_releaseState
  *  @param[out]		timer2eventEng_setEvent
  *  @param[out]		rtTimer2rxApp_notification
@@ -173,7 +179,14 @@ void timerWrapper(	stream<rxRetransmitTimerUpdate>&	rxEng2timer_clearRetransmitT
 					stream<txRetransmitTimerSet>&		txEng2timer_setRetransmitTimer,
 					stream<ap_uint<16> >&				rxEng2timer_clearProbeTimer,
 					stream<ap_uint<16> >&				txEng2timer_setProbeTimer,
-					stream<ap_uint<16> >&				rxEng2timer_setCloseTimer,
+					stream<timeWaitEntry>&				rxEng2timer_setCloseTimer,
+					stream<timeWaitQuery>&				rxEng2timer_timeWaitQuery,
+					stream<timeWaitQuery>&				rxEng2timer_synQuery,
+#if (TCP_KEEPALIVE)
+					stream<keepAliveUpdate>&			rxEng2timer_setKeepAlive,
+#endif
+					stream<timeWaitReply>&				timer2rxEng_timeWaitRsp,
+					stream<timeWaitReply>&				timer2rxEng_synRsp,
 					stream<ap_uint<16> >&				timer2stateTable_releaseState,
 					stream<event>&						timer2eventEng_setEvent,
 					stream<appNotification>&			rtTimer2rxApp_notification,
@@ -182,47 +195,81 @@ void timerWrapper(	stream<rxRetransmitTimerUpdate>&	rxEng2timer_clearRetransmitT
 	#pragma HLS INLINE
 	#pragma HLS PIPELINE II=1
 	
-	static stream<ap_uint<16> > closeTimer2stateTable_releaseState("closeTimer2stateTable_releaseState");
-	static stream<ap_uint<16> > rtTimer2stateTable_releaseState("rtTimer2stateTable_releaseState");
-	#pragma HLS stream variable=closeTimer2stateTable_releaseState		depth=2
-	#pragma HLS stream variable=rtTimer2stateTable_releaseState			depth=2
-
 	static stream<event> rtTimer2eventEng_setEvent("rtTimer2eventEng_setEvent");
 	static stream<event> probeTimer2eventEng_setEvent("probeTimer2eventEng_setEvent");
 	#pragma HLS stream variable=rtTimer2eventEng_setEvent		depth=2
 	#pragma HLS stream variable=probeTimer2eventEng_setEvent	depth=2
 
+#if (TCP_KEEPALIVE)
+	static stream<event> keepAlive2eventEng_setEvent("keepAlive2eventEng_setEvent");
+	static stream<event> probeKeepAlive2eventEng_setEvent("probeKeepAlive2eventEng_setEvent");
+	static stream<ap_uint<16> > rtTimer2stateTable_releaseState("rtTimer2stateTable_releaseState");
+	static stream<appNotification> retransmit2rxApp_notification("retransmit2rxApp_notification");
+	static stream<appNotification> keepAlive2rxApp_notification("keepAlive2rxApp_notification");
+	#pragma HLS stream variable=keepAlive2eventEng_setEvent			depth=2
+	#pragma HLS stream variable=probeKeepAlive2eventEng_setEvent	depth=2
+	#pragma HLS stream variable=rtTimer2stateTable_releaseState		depth=2
+	#pragma HLS stream variable=retransmit2rxApp_notification		depth=2
+	#pragma HLS stream variable=keepAlive2rxApp_notification		depth=2
+	#pragma HLS DATA_PACK variable=retransmit2rxApp_notification
+	#pragma HLS DATA_PACK variable=keepAlive2rxApp_notification
+
+	// Merge Events, Order: rtTimer has to be before probeTimer, keep-alive probes come last
+	stream_merger(probeTimer2eventEng_setEvent, keepAlive2eventEng_setEvent, probeKeepAlive2eventEng_setEvent);
+	stream_merger(rtTimer2eventEng_setEvent, probeKeepAlive2eventEng_setEvent, timer2eventEng_setEvent);
+	// Both timers notify the application of the sessions they release
+	stream_merger(retransmit2rxApp_notification, keepAlive2rxApp_notification, rtTimer2rxApp_notification);
+
+	retransmit_timer(	rxEng2timer_clearRetransmitTimer,
+						txEng2timer_setRetransmitTimer,
+						rtTimer2eventEng_setEvent,
+						rtTimer2stateTable_releaseState,
+						retransmit2rxApp_notification,
+						rtTimer2txApp_notification);
+	// Releases of the retransmit timer pass through the keep-alive timer, which adds its own
+	keepalive_timer(rxEng2timer_setKeepAlive,
+					rtTimer2stateTable_releaseState,
+					keepAlive2eventEng_setEvent,
+					keepAlive2rxApp_notification,
+					timer2stateTable_releaseState);
+#else
 	// Merge Events, Order: rtTimer has to be before probeTimer
 	stream_merger(rtTimer2eventEng_setEvent, probeTimer2eventEng_setEvent, timer2eventEng_setEvent);
 
 	retransmit_timer(	rxEng2timer_clearRetransmitTimer,
 						txEng2timer_setRetransmitTimer,
 						rtTimer2eventEng_setEvent,
-						rtTimer2stateTable_releaseState,
+						timer2stateTable_releaseState,
 						rtTimer2rxApp_notification,
 						rtTimer2txApp_notification);
+#endif
 	probe_timer(rxEng2timer_clearProbeTimer,
 				txEng2timer_setProbeTimer,
 				probeTimer2eventEng_setEvent);
+	// Sessions are released on entering TIME-WAIT, the close_timer only keeps their records
 	close_timer(rxEng2timer_setCloseTimer,
-				closeTimer2stateTable_releaseState);
-	stream_merger(		closeTimer2stateTable_releaseState,
-						rtTimer2stateTable_releaseState,
-						timer2stateTable_releaseState);
+				rxEng2timer_timeWaitQuery,
+				rxEng2timer_synQuery,
+				timer2rxEng_timeWaitRsp,
+				timer2rxEng_synRsp);
 }
-void rxAppMemAccessBreakdown(stream<mmCmd> &inputMemAccess, stream<mmCmd> &outputMemAccess, stream<ap_uint<1> > &rxAppDoubleAccess) {
+void rxAppMemAccessBreakdown(stream<mmBufferCmd> &inputMemAccess, stream<mmCmd> &outputMemAccess, stream<ap_uint<1> > &rxAppDoubleAccess) {
 #pragma HLS PIPELINE II=1
 #pragma HLS INLINE off
 
 	static bool rxAppBreakdown = false;
 	static mmCmd rxAppTempCmd;
 	static ap_uint<16> rxAppAccLength = 0;
+	static ap_uint<WINDOW_BITS> rxAppBufferOffset = 0;
 
 	if (rxAppBreakdown == false) {
 		if (!inputMemAccess.empty() && !outputMemAccess.full()) {
-			rxAppTempCmd = inputMemAccess.read();
-			if ((rxAppTempCmd.saddr.range(15, 0) + rxAppTempCmd.bbt) > 65536) {
-				rxAppAccLength = 65536 - rxAppTempCmd.saddr;
+			mmBufferCmd bufferCmd = inputMemAccess.read();
+			rxAppTempCmd = bufferCmd.cmd;
+			// The session buffer is aligned to its size, the lower bits of the address are the offset into it
+			rxAppBufferOffset = rxAppTempCmd.saddr.range(WINDOW_BITS-1, 0) & bufferCmd.buffer.mask();
+			if ((rxAppBufferOffset + rxAppTempCmd.bbt) > bufferCmd.buffer.size()) {
+				rxAppAccLength = bufferCmd.buffer.size() - rxAppBufferOffset;
 				outputMemAccess.write(mmCmd(rxAppTempCmd.saddr, rxAppAccLength));
 				rxAppBreakdown = true;
 			}
@@ -234,7 +281,7 @@ void rxAppMemAccessBreakdown(stream<mmCmd> &inputMemAccess, stream<mmCmd> &outpu
 	}
 	else if (rxAppBreakdown == true) {
 		if (!outputMemAccess.full()) {
-			rxAppTempCmd.saddr.range(15, 0) = 0;
+			rxAppTempCmd.saddr -= rxAppBufferOffset;
 			rxAppAccLength = rxAppTempCmd.bbt - rxAppAccLength;
 			outputMemAccess.write(mmCmd(rxAppTempCmd.saddr, rxAppAccLength));
 			//std::cerr << "Mem.Cmd: " << std::hex << rxAppTempCmd.saddr << " - " << rxAppTempCmd.bbt - (65536 - rxAppTempCmd.saddr) << std::endl;
@@ -413,13 +460,13 @@ void rxAppMemDataRead(	stream<ap_uint<1> >&	rxBufferReadCmd,
 
 
 void rxAppWrapper(	stream<appReadRequest>&			appRxDataReq,
-					stream<rxSarAppd>&				rxSar2rxApp_upd_rsp,
+					stream<rxSarAppd>&				ctx2rxApp_upd_rsp,
 					stream<ap_uint<16> >&			appListenPortReq,
 					stream<bool>&					portTable2rxApp_listen_rsp,
 					stream<appNotification>&		rxEng2rxApp_notification,
 					stream<appNotification>&		timer2rxApp_notification,
 					stream<ap_uint<16> >&			appRxDataRspMetadata,
-					stream<rxSarAppd>&				rxApp2rxSar_upd_req,
+					stream<rxSarAppd>&				rxApp2ctx_upd_req,
 #if !(RX_DDR_BYPASS)
 					stream<mmCmd>&					rxBufferReadCmd,
 #endif
@@ -432,7 +479,7 @@ void rxAppWrapper(	stream<appReadRequest>&			appRxDataReq,
 	#pragma HLS INLINE
 	#pragma HLS PIPELINE II=1
 
-	static stream<mmCmd>			rxAppStreamIf2memAccessBreakdown("rxAppStreamIf2memAccessBreakdown");
+	static stream<mmBufferCmd>		rxAppStreamIf2memAccessBreakdown("rxAppStreamIf2memAccessBreakdown");
 	static stream<ap_uint<1> >		rxAppDoubleAccess("rxAppDoubleAccess");
 	#pragma HLS stream variable=rxAppStreamIf2memAccessBreakdown	depth=16
 	#pragma HLS stream variable=rxAppDoubleAccess					depth=16
@@ -444,13 +491,13 @@ void rxAppWrapper(	stream<appReadRequest>&			appRxDataReq,
 
 	 // RX Application Stream Interface
 #if !(RX_DDR_BYPASS)
-	rx_app_stream_if(appRxDataReq, rxSar2rxApp_upd_rsp, appRxDataRspMetadata,
-						rxApp2rxSar_upd_req, rxAppStreamIf2memAccessBreakdown);
+	rx_app_stream_if(appRxDataReq, ctx2rxApp_upd_rsp, appRxDataRspMetadata,
+						rxApp2ctx_upd_req, rxAppStreamIf2memAccessBreakdown);
 	rxAppMemAccessBreakdown(rxAppStreamIf2memAccessBreakdown, rxBufferReadCmd, rxAppDoubleAccess);
 	rxAppMemDataRead(rxBufferReadData, rxDataRsp, rxAppDoubleAccess);
 #else
-	rx_app_stream_if(appRxDataReq, rxSar2rxApp_upd_rsp, appRxDataRspMetadata,
-						rxApp2rxSar_upd_req, rxBufferReadCmd);
+	rx_app_stream_if(appRxDataReq, ctx2rxApp_upd_rsp, appRxDataRspMetadata,
+						rxApp2ctx_upd_req, rxBufferReadCmd);
 	rxAppMemDataRead(rxBufferReadCmd, rxBufferReadData, rxDataRsp);
 #endif
 
@@ -479,13 +526,12 @@ void rxAppWrapper(	stream<appReadRequest>&			appRxDataReq,
  *  @param[out]		txBufferReadCmd
  *  @param[out]		rxBufferWriteData
  *  @param[out]		txBufferWriteData
- *  @param[in]		sessionLookup_rsp
- *  @param[in]		sessionUpdate_rsp
- *  @param[in]		finSessionIdIn
- *  @param[out]		sessionLookup_req
- *  @param[out]		sessionUpdate_req
- *  @param[out]		writeNewSessionId
- *  @param[in]		listenPortReq
+ *  @param[in]		sessionContextReadData
+ *  @param[in]		sessionContextWriteStatus
+ *  @param[out]		sessionContextReadCmd
+ *  @param[out]		sessionContextWriteCmd
+ *  @param[out]		sessionContextWriteData
+ *  @param[in]		listenPortReq, bit 15 requests TCP_BUFFER_CLASS_SMALL buffers for the sessions of the port
  *  @param[in]		rxDataReq
  *  @param[in]		openConnReq
  *  @param[in]		closeConnReq
@@ -515,15 +561,14 @@ void toe(	// Data & Memory Interface
 			stream<mmCmd>&							txBufferReadCmd,
 			stream<axiWord>&						rxBufferWriteData,
 			stream<axiWord>&						txBufferWriteData,
-			// SmartCam Interface
-			stream<rtlSessionLookupReply>&			sessionLookup_rsp,
-			stream<rtlSessionUpdateReply>&			sessionUpdate_rsp,
-			//stream<ap_uint<14> >&					readFinSessionId,
-			stream<rtlSessionLookupRequest>&		sessionLookup_req,
-			stream<rtlSessionUpdateRequest>&		sessionUpdate_req,
-			//stream<rtlSessionUpdateRequest>&		sessionInsert_req,
-			//stream<rtlSessionUpdateRequest>&		sessionDelete_req,
-			//stream<ap_uint<14> >&					writeNewSessionId,
+#if (TCP_DDR_CONTEXT)
+			// Session Context Memory Interface
+			stream<sessionContext>&					sessionContextReadData,
+			stream<mmStatus>&						sessionContextWriteStatus,
+			stream<mmCmd>&							sessionContextReadCmd,
+			stream<mmCmd>&							sessionContextWriteCmd,
+			stream<sessionContext>&					sessionContextWriteData,
+#endif
 			// Application Interface
 			stream<ap_uint<16> >&					listenPortReq,
 			// This is disabled for the time being, due to complexity concerns
@@ -588,19 +633,19 @@ void toe(	// Data & Memory Interface
 	#pragma HLS resource core=AXI4Stream variable=txBufferWriteStatus metadata="-bus_bundle s_axis_txwrite_sts"
 	#pragma HLS DATA_PACK variable=txBufferWriteStatus
 
-	// SmartCam Interface
-	#pragma HLS resource core=AXI4Stream variable=sessionLookup_req metadata="-bus_bundle m_axis_session_lup_req"
-	#pragma HLS resource core=AXI4Stream variable=sessionLookup_rsp metadata="-bus_bundle s_axis_session_lup_rsp"
-	#pragma HLS resource core=AXI4Stream variable=sessionUpdate_req metadata="-bus_bundle m_axis_session_upd_req"
-	//#pragma HLS resource core=AXI4Stream variable=sessionInsert_req metadata="-bus_bundle m_axis_session_ins_req"
-	//#pragma HLS resource core=AXI4Stream variable=sessionDelete_req metadata="-bus_bundle m_axis_session_del_req"
-	#pragma HLS resource core=AXI4Stream variable=sessionUpdate_rsp metadata="-bus_bundle s_axis_session_upd_rsp"
-	#pragma HLS DATA_PACK variable=sessionLookup_req
-	#pragma HLS DATA_PACK variable=sessionLookup_rsp
-	#pragma HLS DATA_PACK variable=sessionUpdate_req
-	//#pragma HLS DATA_PACK variable=sessionInsert_req
-	//#pragma HLS DATA_PACK variable=sessionDelete_req
-	#pragma HLS DATA_PACK variable=sessionUpdate_rsp
+#if (TCP_DDR_CONTEXT)
+	// Session Context Memory Interface
+	#pragma HLS resource core=AXI4Stream variable=sessionContextReadCmd metadata="-bus_bundle m_axis_ctx_read_cmd"
+	#pragma HLS resource core=AXI4Stream variable=sessionContextReadData metadata="-bus_bundle s_axis_ctx_read_data"
+	#pragma HLS resource core=AXI4Stream variable=sessionContextWriteCmd metadata="-bus_bundle m_axis_ctx_write_cmd"
+	#pragma HLS resource core=AXI4Stream variable=sessionContextWriteData metadata="-bus_bundle m_axis_ctx_write_data"
+	#pragma HLS resource core=AXI4Stream variable=sessionContextWriteStatus metadata="-bus_bundle s_axis_ctx_write_sts"
+	#pragma HLS DATA_PACK variable=sessionContextReadCmd
+	#pragma HLS DATA_PACK variable=sessionContextReadData
+	#pragma HLS DATA_PACK variable=sessionContextWriteCmd
+	#pragma HLS DATA_PACK variable=sessionContextWriteData
+	#pragma HLS DATA_PACK variable=sessionContextWriteStatus
+#endif
 
 	// Application Interface
 	#pragma HLS resource core=AXI4Stream variable=listenPortRsp metadata="-bus_bundle m_axis_listen_port_rsp"
@@ -665,6 +710,7 @@ void toe(	// Data & Memory Interface
 	static stream<ap_uint<16> >			txApp2stateTable_req("txApp2stateTable_req");
 	static stream<sessionState>			stateTable2txApp_rsp("stateTable2txApp_rsp");
 	static stream<ap_uint<16> >			stateTable2sLookup_releaseSession("stateTable2sLookup_releaseSession");
+	static stream<ap_uint<16> >			stateTable2ctx_releaseSession("stateTable2ctx_releaseSession");
 	#pragma HLS stream variable=rxEng2stateTable_upd_req			depth=2
 	#pragma HLS stream variable=stateTable2rxEng_upd_rsp			depth=2
 	#pragma HLS stream variable=txApp2stateTable_upd_req			depth=2
@@ -672,54 +718,43 @@ void toe(	// Data & Memory Interface
 	#pragma HLS stream variable=txApp2stateTable_req				depth=2
 	#pragma HLS stream variable=stateTable2txApp_rsp				depth=2
 	#pragma HLS stream variable=stateTable2sLookup_releaseSession	depth=2
+	#pragma HLS stream variable=stateTable2ctx_releaseSession		depth=2
+#if (TCP_DDR_CONTEXT)
+	static stream<ap_uint<16> >			sLookup2ctx_prefetch("sLookup2ctx_prefetch");
+	#pragma HLS stream variable=sLookup2ctx_prefetch				depth=4
+#endif
 	#pragma HLS DATA_PACK variable=rxEng2stateTable_upd_req
 	#pragma HLS DATA_PACK variable=txApp2stateTable_upd_req
 	//#pragma HLS DATA_PACK variable=txApp2stateTable_req
 
-	// RX Sar Table
-	static stream<rxSarRecvd>			rxEng2rxSar_upd_req("rxEng2rxSar_upd_req");
-	static stream<rxSarEntry>			rxSar2rxEng_upd_rsp("rxSar2rxEng_upd_rsp");
-	static stream<rxSarAppd>			rxApp2rxSar_upd_req("rxApp2rxSar_upd_req");
-	static stream<rxSarAppd>			rxSar2rxApp_upd_rsp("rxSar2rxApp_upd_rsp");
-	static stream<ap_uint<16> >			txEng2rxSar_req("txEng2rxSar_req");
-	static stream<rxSarEntry>			rxSar2txEng_rsp("rxSar2txEng_rsp");
-	#pragma HLS stream variable=rxEng2rxSar_upd_req		depth=2
-	#pragma HLS stream variable=rxSar2rxEng_upd_rsp		depth=2
-	#pragma HLS stream variable=rxApp2rxSar_upd_req		depth=2
-	#pragma HLS stream variable=rxSar2rxApp_upd_rsp		depth=2
-	#pragma HLS stream variable=txEng2rxSar_req			depth=2
-	#pragma HLS stream variable=rxSar2txEng_rsp			depth=2
-	#pragma HLS DATA_PACK variable=rxEng2rxSar_upd_req
-	#pragma HLS DATA_PACK variable=rxSar2rxEng_upd_rsp
-	#pragma HLS DATA_PACK variable=rxApp2rxSar_upd_req
-	#pragma HLS DATA_PACK variable=rxSar2rxApp_upd_rsp
-	#pragma HLS DATA_PACK variable=rxSar2txEng_rsp
-
-	// TX Sar Table
-	static stream<txTxSarQuery>			txEng2txSar_upd_req("txEng2txSar_upd_req");
-	static stream<txTxSarReply>			txSar2txEng_upd_rsp("txSar2txEng_upd_rsp");
-	//static stream<txAppTxSarQuery>		txApp2txSar_upd_req("txApp2txSar_upd_req");
-	//static stream<txAppTxSarReply>		txSar2txApp_upd_rsp("txSar2txApp_upd_rsp");
-	static stream<rxTxSarQuery>			rxEng2txSar_upd_req("rxEng2txSar_upd_req");
-	static stream<rxTxSarReply>			txSar2rxEng_upd_rsp("txSar2rxEng_upd_rsp");
-	static stream<txSarAckPush>			txSar2txApp_ack_push("txSar2txApp_ack_push");
-	static stream<txAppTxSarPush>		txApp2txSar_push("txApp2txSar_push");
-	#pragma HLS stream variable=txEng2txSar_upd_req		depth=2
-	#pragma HLS stream variable=txSar2txEng_upd_rsp		depth=2
-	//#pragma HLS stream variable=txApp2txSar_upd_req		depth=2
-	//#pragma HLS stream variable=txSar2txApp_upd_rsp		depth=2
-	#pragma HLS stream variable=rxEng2txSar_upd_req		depth=2
-	#pragma HLS stream variable=txSar2rxEng_upd_rsp		depth=2
-	#pragma HLS stream variable=txSar2txApp_ack_push	depth=2
-	#pragma HLS stream variable=txApp2txSar_push		depth=2
-	#pragma HLS DATA_PACK variable=txEng2txSar_upd_req
-	#pragma HLS DATA_PACK variable=txSar2txEng_upd_rsp
-	//#pragma HLS DATA_PACK variable=txApp2txSar_upd_req
-	//#pragma HLS DATA_PACK variable=txSar2txApp_upd_rsp
-	#pragma HLS DATA_PACK variable=rxEng2txSar_upd_req
-	#pragma HLS DATA_PACK variable=txSar2rxEng_upd_rsp
-	#pragma HLS DATA_PACK variable=txSar2txApp_ack_push
-	#pragma HLS DATA_PACK variable=txApp2txSar_push
+	// Session Context Table
+	static stream<rxSessionCtxQuery>	rxEng2ctx_upd_req("rxEng2ctx_upd_req");
+	static stream<rxSessionCtxReply>	ctx2rxEng_upd_rsp("ctx2rxEng_upd_rsp");
+	static stream<txTxSarQuery>			txEng2ctx_upd_req("txEng2ctx_upd_req");
+	static stream<txSessionCtxReply>	ctx2txEng_upd_rsp("ctx2txEng_upd_rsp");
+	static stream<rxSarAppd>			rxApp2ctx_upd_req("rxApp2ctx_upd_req");
+	static stream<rxSarAppd>			ctx2rxApp_upd_rsp("ctx2rxApp_upd_rsp");
+	static stream<txAppTxSarQuery>		txApp2ctx_upd_req("txApp2ctx_upd_req");
+	static stream<txAppTxSarReply>		ctx2txApp_upd_rsp("ctx2txApp_upd_rsp");
+	static stream<txAppTxSarPush>		txApp2ctx_app_push("txApp2ctx_app_push");
+	#pragma HLS stream variable=rxEng2ctx_upd_req		depth=2
+	#pragma HLS stream variable=ctx2rxEng_upd_rsp		depth=2
+	#pragma HLS stream variable=txEng2ctx_upd_req		depth=2
+	#pragma HLS stream variable=ctx2txEng_upd_rsp		depth=2
+	#pragma HLS stream variable=rxApp2ctx_upd_req		depth=2
+	#pragma HLS stream variable=ctx2rxApp_upd_rsp		depth=2
+	#pragma HLS stream variable=txApp2ctx_upd_req		depth=2
+	#pragma HLS stream variable=ctx2txApp_upd_rsp		depth=2
+	#pragma HLS stream variable=txApp2ctx_app_push		depth=2
+	#pragma HLS DATA_PACK variable=rxEng2ctx_upd_req
+	#pragma HLS DATA_PACK variable=ctx2rxEng_upd_rsp
+	#pragma HLS DATA_PACK variable=txEng2ctx_upd_req
+	#pragma HLS DATA_PACK variable=ctx2txEng_upd_rsp
+	#pragma HLS DATA_PACK variable=rxApp2ctx_upd_req
+	#pragma HLS DATA_PACK variable=ctx2rxApp_upd_rsp
+	#pragma HLS DATA_PACK variable=txApp2ctx_upd_req
+	#pragma HLS DATA_PACK variable=ctx2txApp_upd_rsp
+	#pragma HLS DATA_PACK variable=txApp2ctx_app_push
 
 	// Retransmit Timer
 	static stream<rxRetransmitTimerUpdate>		rxEng2timer_clearRetransmitTimer("rxEng2timer_clearRetransmitTimer");
@@ -733,8 +768,33 @@ void toe(	// Data & Memory Interface
 	static stream<ap_uint<16> >					txEng2timer_setProbeTimer("txEng2timer_setProbeTimer");
 	#pragma HLS stream variable=txEng2timer_setProbeTimer depth=2
 	// Close Timer
-	static stream<ap_uint<16> >					rxEng2timer_setCloseTimer("rxEng2timer_setCloseTimer");
+	static stream<timeWaitEntry>				rxEng2timer_setCloseTimer("rxEng2timer_setCloseTimer");
+	static stream<timeWaitQuery>				rxEng2timer_timeWaitQuery("rxEng2timer_timeWaitQuery");
+	static stream<timeWaitReply>				timer2rxEng_timeWaitRsp("timer2rxEng_timeWaitRsp");
+	static stream<timeWaitQuery>				rxEng2timer_synQuery("rxEng2timer_synQuery");
+	static stream<timeWaitReply>				timer2rxEng_synRsp("timer2rxEng_synRsp");
 	#pragma HLS stream variable=rxEng2timer_setCloseTimer depth=2
+	#pragma HLS stream variable=rxEng2timer_timeWaitQuery depth=2
+	#pragma HLS stream variable=timer2rxEng_timeWaitRsp depth=2
+	#pragma HLS stream variable=rxEng2timer_synQuery depth=2
+	#pragma HLS stream variable=timer2rxEng_synRsp depth=8 // One per lookup in flight
+	#pragma HLS DATA_PACK variable=rxEng2timer_setCloseTimer
+	#pragma HLS DATA_PACK variable=rxEng2timer_timeWaitQuery
+	#pragma HLS DATA_PACK variable=timer2rxEng_timeWaitRsp
+	#pragma HLS DATA_PACK variable=rxEng2timer_synQuery
+	#pragma HLS DATA_PACK variable=timer2rxEng_synRsp
+#if (TCP_KEEPALIVE)
+	// Keep-Alive Timer
+	static stream<keepAliveUpdate>				rxEng2timer_setKeepAlive("rxEng2timer_setKeepAlive");
+	#pragma HLS stream variable=rxEng2timer_setKeepAlive depth=4
+	#pragma HLS DATA_PACK variable=rxEng2timer_setKeepAlive
+#endif
+#if (TCP_PACING)
+	// TX Pacer
+	static stream<pacerRateUpdate>				rxEng2pacer_setRate("rxEng2pacer_setRate");
+	#pragma HLS stream variable=rxEng2pacer_setRate depth=4
+	#pragma HLS DATA_PACK variable=rxEng2pacer_setRate
+#endif
 	// Timer Session release Fifos
 	static stream<ap_uint<16> >					timer2stateTable_releaseState("timer2stateTable_releaseState");
 	#pragma HLS stream variable=timer2stateTable_releaseState			depth=2
@@ -742,6 +802,7 @@ void toe(	// Data & Memory Interface
 	// Event Engine
 	static stream<extendedEvent>			rxEng2eventEng_setEvent("rxEng2eventEng_setEvent");
 	static stream<event>					txApp2eventEng_setEvent("txApp2eventEng_setEvent");
+	static stream<event>					txApp2pacer_event("txApp2pacer_event");
 	//static stream<event>					appStreamEventFifo("appStreamEventFifo");
 	//static stream<event>					retransmitEventFifo("retransmitEventFifo");
 	static stream<event>					timer2eventEng_setEvent("timer2eventEng_setEvent");
@@ -749,11 +810,13 @@ void toe(	// Data & Memory Interface
 	static stream<extendedEvent>			eventEng2txEng_event("eventEng2txEng_event");
 	#pragma HLS stream variable=rxEng2eventEng_setEvent				depth=512
 	#pragma HLS stream variable=txApp2eventEng_setEvent			depth=4
+	#pragma HLS stream variable=txApp2pacer_event				depth=4
 	#pragma HLS stream variable=timer2eventEng_setEvent			depth=4 //TODO maybe reduce to 2, there should be no evil cycle
 	#pragma HLS stream variable=eventEng2ackDelay_event				depth=4
 	#pragma HLS stream variable=eventEng2txEng_event				depth=16
 	#pragma HLS DATA_PACK variable=rxEng2eventEng_setEvent
 	#pragma HLS DATA_PACK variable=txApp2eventEng_setEvent
+	#pragma HLS DATA_PACK variable=txApp2pacer_event
 	#pragma HLS DATA_PACK variable=timer2eventEng_setEvent
 	#pragma HLS DATA_PACK variable=eventEng2ackDelay_event
 	#pragma HLS DATA_PACK variable=eventEng2txEng_event
@@ -775,7 +838,7 @@ void toe(	// Data & Memory Interface
 
 	// Port Table
 	static stream<ap_uint<16> >				rxEng2portTable_check_req("rxEng2portTable_check_req");
-	static stream<bool>						portTable2rxEng_check_rsp("portTable2rxEng_check_rsp");
+	static stream<portCheckReply>			portTable2rxEng_check_rsp("portTable2rxEng_check_rsp");
 	static stream<ap_uint<16> >				rxApp2portTable_listen_req("rxApp2portTable_listen_req");
 	static stream<bool>						portTable2rxApp_listen_rsp("portTable2rxApp_listen_rsp");
 	//static stream<ap_uint<1> >				txApp2portTable_port_req("txApp2portTable_port_req");
@@ -803,12 +866,9 @@ void toe(	// Data & Memory Interface
 								sLookup2txApp_rsp,
 								txEng2sLookup_rev_req,
 								sLookup2txEng_rev_rsp,
-								sessionLookup_req,
-								sessionLookup_rsp,
-								sessionUpdate_req,
-								//sessionInsert_req,
-								//sessionDelete_req,
-								sessionUpdate_rsp,
+#if (TCP_DDR_CONTEXT)
+								sLookup2ctx_prefetch,
+#endif
 								regSessionCount);
 	// State Table
 	state_table(	rxEng2stateTable_upd_req,
@@ -818,23 +878,27 @@ void toe(	// Data & Memory Interface
 					stateTable2rxEng_upd_rsp,
 					stateTable2txApp_upd_rsp,
 					stateTable2txApp_rsp,
-					stateTable2sLookup_releaseSession);
-	// RX Sar Table
-	rx_sar_table(	rxEng2rxSar_upd_req,
-					rxApp2rxSar_upd_req,
-					txEng2rxSar_req,
-					rxSar2rxEng_upd_rsp,
-					rxSar2rxApp_upd_rsp,
-					rxSar2txEng_rsp);
-	// TX Sar Table
-	tx_sar_table(	rxEng2txSar_upd_req,
-					//txApp2txSar_upd_req,
-					txEng2txSar_upd_req,
-					txApp2txSar_push,
-					txSar2rxEng_upd_rsp,
-					//txSar2txApp_upd_rsp,
-					txSar2txEng_upd_rsp,
-					txSar2txApp_ack_push);
+					stateTable2sLookup_releaseSession,
+					stateTable2ctx_releaseSession);
+	// Session Context Table
+	session_context_table(	rxEng2ctx_upd_req,
+							txEng2ctx_upd_req,
+							rxApp2ctx_upd_req,
+							txApp2ctx_upd_req,
+							txApp2ctx_app_push,
+							stateTable2ctx_releaseSession,
+#if (TCP_DDR_CONTEXT)
+							sLookup2ctx_prefetch,
+							sessionContextReadData,
+							sessionContextWriteStatus,
+							sessionContextReadCmd,
+							sessionContextWriteCmd,
+							sessionContextWriteData,
+#endif
+							ctx2rxEng_upd_rsp,
+							ctx2txEng_upd_rsp,
+							ctx2rxApp_upd_rsp,
+							ctx2txApp_upd_rsp);
 	// Port Table
 	port_table(		rxEng2portTable_check_req,
 					rxApp2portTable_listen_req,
@@ -849,6 +913,13 @@ void toe(	// Data & Memory Interface
 					rxEng2timer_clearProbeTimer,
 					txEng2timer_setProbeTimer,
 					rxEng2timer_setCloseTimer,
+					rxEng2timer_timeWaitQuery,
+					rxEng2timer_synQuery,
+#if (TCP_KEEPALIVE)
+					rxEng2timer_setKeepAlive,
+#endif
+					timer2rxEng_timeWaitRsp,
+					timer2rxEng_synRsp,
 					timer2stateTable_releaseState,
 					timer2eventEng_setEvent,
 					timer2rxApp_notification,
@@ -860,8 +931,14 @@ void toe(	// Data & Memory Interface
 	#pragma HLS stream variable=ackDelayFifoWriteCount		depth=2
 	static stream<ap_uint<1> > txEngFifoReadCount("txEngFifoReadCount");
 	#pragma HLS stream variable=txEngFifoReadCount		depth=2
+#if (TCP_PACING)
+	tx_pacer(txApp2pacer_event, rxEng2pacer_setRate, txApp2eventEng_setEvent);
 	event_engine(txApp2eventEng_setEvent, rxEng2eventEng_setEvent, timer2eventEng_setEvent, eventEng2ackDelay_event,
 					ackDelayFifoReadCount, ackDelayFifoWriteCount, txEngFifoReadCount);
+#else
+	event_engine(txApp2pacer_event, rxEng2eventEng_setEvent, timer2eventEng_setEvent, eventEng2ackDelay_event,
+					ackDelayFifoReadCount, ackDelayFifoWriteCount, txEngFifoReadCount);
+#endif
 	ack_delay(eventEng2ackDelay_event, eventEng2txEng_event, ackDelayFifoReadCount, ackDelayFifoWriteCount);
 
 	/*
@@ -872,8 +949,9 @@ void toe(	// Data & Memory Interface
 				sLookup2rxEng_rsp,
 				stateTable2rxEng_upd_rsp,
 				portTable2rxEng_check_rsp,
-				rxSar2rxEng_upd_rsp,
-				txSar2rxEng_upd_rsp,
+				ctx2rxEng_upd_rsp,
+				timer2rxEng_timeWaitRsp,
+				timer2rxEng_synRsp,
 #if !(RX_DDR_BYPASS)
 				rxBufferWriteStatus,
 #endif
@@ -881,11 +959,18 @@ void toe(	// Data & Memory Interface
 				rxEng2sLookup_req,
 				rxEng2stateTable_upd_req,
 				rxEng2portTable_check_req,
-				rxEng2rxSar_upd_req,
-				rxEng2txSar_upd_req,
+				rxEng2ctx_upd_req,
 				rxEng2timer_clearRetransmitTimer,
 				rxEng2timer_clearProbeTimer,
 				rxEng2timer_setCloseTimer,
+				rxEng2timer_timeWaitQuery,
+				rxEng2timer_synQuery,
+#if (TCP_KEEPALIVE)
+				rxEng2timer_setKeepAlive,
+#endif
+#if (TCP_PACING)
+				rxEng2pacer_setRate,
+#endif
 				conEstablishedFifo, //remove this
 				rxEng2eventEng_setEvent,
 #if !(RX_DDR_BYPASS)
@@ -899,15 +984,13 @@ void toe(	// Data & Memory Interface
 				);
 	// TX Engine
 	tx_engine(	eventEng2txEng_event,
-				rxSar2txEng_rsp,
-				txSar2txEng_upd_rsp,
+				ctx2txEng_upd_rsp,
 				txBufferReadData,
 #if (TCP_NODELAY)
             txApp2txEng_data_stream,
 #endif
 				sLookup2txEng_rev_rsp,
-				txEng2rxSar_req,
-				txEng2txSar_upd_req,
+				txEng2ctx_upd_req,
 				txEng2timer_setRetransmitTimer,
 				txEng2timer_setProbeTimer,
 				txBufferReadCmd,
@@ -919,13 +1002,13 @@ void toe(	// Data & Memory Interface
 	 * Application Interfaces
 	 */
 	 rxAppWrapper(	rxDataReq,
-			 	 	rxSar2rxApp_upd_rsp,
+			 	 	ctx2rxApp_upd_rsp,
 			 	 	listenPortReq,
 			 	 	portTable2rxApp_listen_rsp,
 			 	 	rxEng2rxApp_notification,
 			 	 	timer2rxApp_notification,
 			 	 	rxDataRspMeta,
-			 	 	rxApp2rxSar_upd_req,
+			 	 	rxApp2ctx_upd_req,
 #if !(RX_DDR_BYPASS)
 			 	 	rxBufferReadCmd,
 #endif
@@ -938,8 +1021,7 @@ void toe(	// Data & Memory Interface
 	tx_app_interface(	txDataReqMeta,
 						txDataReq,
 						stateTable2txApp_rsp,
-						//txSar2txApp_upd_rsp,
-						txSar2txApp_ack_push,
+						ctx2txApp_upd_rsp,
 						txBufferWriteStatus,
 						openConnReq,
 						closeConnReq,
@@ -949,18 +1031,18 @@ void toe(	// Data & Memory Interface
 						conEstablishedFifo,
 						txDataRsp,
 						txApp2stateTable_req,
-						//txApp2txSar_upd_req,
 						txBufferWriteCmd,
 						txBufferWriteData,
 #if (TCP_NODELAY)
                   txApp2txEng_data_stream,
 #endif
-						txApp2txSar_push,
+						txApp2ctx_upd_req,
+						txApp2ctx_app_push,
 						openConnRsp,
 						txApp2sLookup_req,
 						//txApp2portTable_port_req,
 						txApp2stateTable_upd_req,
-						txApp2eventEng_setEvent,
+						txApp2pacer_event,
 						timer2txApp_notification,
 						myIpAddress);
 
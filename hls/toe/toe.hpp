@@ -42,7 +42,47 @@ EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.// Copyright (c) 2015 Xilinx,
 
 static const ap_uint<16> MSS=1460; //536
 
+// TCP_64K_SESSIONS flag, 64K-session build for UltraScale+. Session IDs are 16 bits wide end to end and the
+// per-session tables are placed in UltraRAM, 0xFFFF is not handed out as it marks an empty timer list
+#ifndef TCP_64K_SESSIONS
+#define TCP_64K_SESSIONS 0
+#endif
+
+#if (TCP_64K_SESSIONS)
+static const uint16_t MAX_SESSIONS = 65535;
+static const uint8_t SESSION_ID_BITS = 16;
+#else
 static const uint16_t MAX_SESSIONS = 10000;
+static const uint8_t SESSION_ID_BITS = 14;
+#endif
+
+// Places a table that grows with MAX_SESSIONS, in UltraRAM for the 64K-session build and in the given BRAM core otherwise
+#define DO_PRAGMA(x) _Pragma(#x)
+#if (TCP_64K_SESSIONS)
+#define SESSION_TABLE_RESOURCE(table, bramCore) DO_PRAGMA(HLS RESOURCE variable=table core=XPM_MEMORY uram)
+#else
+#define SESSION_TABLE_RESOURCE(table, bramCore) DO_PRAGMA(HLS RESOURCE variable=table core=bramCore)
+#endif
+
+// TCP_DDR_CONTEXT flag, the records of the session context table are kept in DDR, one line per session,
+// and only the working set is held on-chip in a set-associative write-back cache, see @ref context_cache
+#ifndef TCP_DDR_CONTEXT
+#define TCP_DDR_CONTEXT 0
+#endif
+
+static const uint8_t CTX_CACHE_WAYS = 4;
+static const uint8_t CTX_CACHE_SET_BITS = 10;
+static const uint16_t CTX_CACHE_SETS = 1 << CTX_CACHE_SET_BITS;
+static const uint32_t CTX_CACHE_LINES = CTX_CACHE_WAYS * CTX_CACHE_SETS;
+// Dirty evictions whose write status has not returned yet, a further one waits
+static const uint8_t CTX_WRITEBACK_SLOTS = 4;
+// Each context occupies a 256B line, the line of a session starts at sessionID << CTX_LINE_BITS
+static const uint8_t CTX_LINE_BITS = 8;
+#if (TCP_DDR_CONTEXT)
+static const uint32_t CTX_TABLE_SIZE = CTX_CACHE_LINES;
+#else
+static const uint32_t CTX_TABLE_SIZE = MAX_SESSIONS;
+#endif
 
 // TCP_NODELAY flag, to disable Nagle's Algorithm
 #define TCP_NODELAY 1
@@ -52,6 +92,146 @@ static const uint16_t MAX_SESSIONS = 10000;
 
 #define FAST_RETRANSMIT 1
 
+// TCP_SACK flag, offers SACK-permitted in SYN and SYN-ACK, RFC 2018
+#define TCP_SACK 1
+
+// TCP_ECN flag, requests ECN in SYN and SYN-ACK, RFC 3168. CE marks are echoed per segment and the sender reacts like DCTCP, RFC 8257
+#define TCP_ECN 1
+
+// TCP_TIMESTAMPS flag, offers the Timestamps option in SYN and SYN-ACK, RFC 7323. Every ACK gives an RTT sample and
+// old duplicates are rejected by PAWS
+#define TCP_TIMESTAMPS 1
+
+// TCP_PACING flag, spreads the segments of a session over its RTT, the rate follows cwnd/SRTT, see tx_pacer.
+// The events of the application wait in per-session queues
+#ifndef TCP_PACING
+#define TCP_PACING 0
+#endif
+
+// TCP_TX_SCHEDULER flag, the events of the application are scheduled per session by deficit round robin, see event_engine
+#ifndef TCP_TX_SCHEDULER
+#define TCP_TX_SCHEDULER 0
+#endif
+
+// The tx_pacer and the TX scheduler release the segments of different sessions out of order. With either of them the
+// DDR bypass of TCP_NODELAY is turned off and the segments are read back from the session buffers
+#define TCP_TX_REORDER ((TCP_PACING) || (TCP_TX_SCHEDULER))
+
+// TCP_SYN_COOKIES flag, passive opens are answered statelessly, RFC 4987 3.6. The ISN of the SYN-ACK is a keyed hash
+// of the four-tuple and the ISN of the peer, the session is only created by the ACK that returns it, see syn_cookie.
+// The options of the SYN are not kept, cookie sessions run without Window Scale, SACK, Timestamps and ECN
+#ifndef TCP_SYN_COOKIES
+#define TCP_SYN_COOKIES 0
+#endif
+
+// Secret of the SYN cookie hash, to be set per device
+#ifndef TCP_SYN_COOKIE_KEY
+#define TCP_SYN_COOKIE_KEY 0x5a3c96e1f0872d4bULL
+#endif
+
+// TCP_KEEPALIVE flag, probes sessions on which nothing was received for TCP_KEEPALIVE_IDLE, RFC 1122 4.2.3.6.
+// A session that did not answer TCP_KEEPALIVE_PROBES probes is released, see keepalive_timer
+#ifndef TCP_KEEPALIVE
+#define TCP_KEEPALIVE 0
+#endif
+
+// Number of unanswered keep-alive probes after which the session is released
+#ifndef TCP_KEEPALIVE_PROBES
+#define TCP_KEEPALIVE_PROBES 5
+#endif
+
+// Delayed ACKs, RFC 1122 4.2.3.2 and RFC 5681 4.2. Received data is ACKed once TCP_ACK_SEGMENTS segments or TCP_ACK_BYTES
+// bytes are unacknowledged, otherwise when the delay runs out, see ack_delay. The first TCP_QUICKACK_SEGMENTS data
+// segments of a session are ACKed right away so the slow start of the peer is not slowed down
+#ifndef TCP_ACK_SEGMENTS
+#define TCP_ACK_SEGMENTS 2
+#endif
+#ifndef TCP_ACK_BYTES
+#define TCP_ACK_BYTES (2*MSS)
+#endif
+#ifndef TCP_QUICKACK_SEGMENTS
+#define TCP_QUICKACK_SEGMENTS 16
+#endif
+
+// Congestion control algorithms, see congestion_control. TCP_CC_DEFAULT is assigned to every new session
+enum ccAlgorithm {CC_RENO, CC_CUBIC};
+static const ap_uint<2> TCP_CC_DEFAULT = CC_CUBIC;
+
+// Number of segments the RX engine has in flight between issuing the table reads and the TCP state machine,
+// the state table keeps a lock for each of them. Must match the 2-bit ring index in rxFsmRequestIssuer
+static const uint8_t RX_FSM_INFLIGHT = 4;
+
+// TCP_WINDOW_SCALE_BITS, window scale shift we advertise in SYN and SYN-ACK, RFC 7323. The buffers of class 0 hold
+// 64KB << TCP_WINDOW_SCALE_BITS, classes 1 and 2 keep their 16KB and 4KB. Shifts 0 and 1 fit the default pools into
+// the 1GB regions, larger ones need fewer TCP_BUFFER_CLASS_SLOTS_0. 0 turns window scaling off
+#ifndef TCP_WINDOW_SCALE_BITS
+#define TCP_WINDOW_SCALE_BITS 1
+#endif
+static const uint8_t WINDOW_SCALE_BITS = TCP_WINDOW_SCALE_BITS;
+static const uint8_t WINDOW_BITS = 16 + WINDOW_SCALE_BITS;
+static const uint32_t BUFFER_SIZE = (1 << WINDOW_BITS);
+// Session buffers are assigned by the buffer_allocators of the session_context_table. The 1GB RX and TX
+// regions are split into BUFFER_CLASSES pools, class k holds BUFFER_CLASS_SLOTS[k] buffers of 2^BUFFER_CLASS_BITS[k]
+// bytes starting at BUFFER_CLASS_BASE[k]. Class 0 holds the largest buffers, classes 1 and 2 are smaller by
+// TCP_BUFFER_CLASS_SHIFT_1 and TCP_BUFFER_CLASS_SHIFT_2 bits. The pools have to fit into 1GB, hold at least
+// MAX_SESSIONS buffers and each of them at most 2^BUFFER_SLOT_BITS
+#ifndef TCP_BUFFER_CLASS_SHIFT_1
+#define TCP_BUFFER_CLASS_SHIFT_1 (2 + TCP_WINDOW_SCALE_BITS)
+#endif
+#ifndef TCP_BUFFER_CLASS_SHIFT_2
+#define TCP_BUFFER_CLASS_SHIFT_2 (4 + TCP_WINDOW_SCALE_BITS)
+#endif
+#ifndef TCP_BUFFER_CLASS_SLOTS_0
+#define TCP_BUFFER_CLASS_SLOTS_0 4096
+#endif
+#ifndef TCP_BUFFER_CLASS_SLOTS_1
+#define TCP_BUFFER_CLASS_SLOTS_1 8192
+#endif
+#if (TCP_64K_SESSIONS)
+#ifndef TCP_BUFFER_CLASS_SLOTS_2
+#define TCP_BUFFER_CLASS_SLOTS_2 65536
+#endif
+#ifndef TCP_BUFFER_SLOT_BITS
+#define TCP_BUFFER_SLOT_BITS 16
+#endif
+#else
+#ifndef TCP_BUFFER_CLASS_SLOTS_2
+#define TCP_BUFFER_CLASS_SLOTS_2 16384
+#endif
+#ifndef TCP_BUFFER_SLOT_BITS
+#define TCP_BUFFER_SLOT_BITS 14
+#endif
+#endif
+static const uint8_t BUFFER_CLASSES = 3;
+static const uint8_t BUFFER_SLOT_BITS = TCP_BUFFER_SLOT_BITS;
+static const uint8_t BUFFER_CLASS_BITS[BUFFER_CLASSES]		= {WINDOW_BITS,
+																WINDOW_BITS-TCP_BUFFER_CLASS_SHIFT_1,
+																WINDOW_BITS-TCP_BUFFER_CLASS_SHIFT_2};
+static const uint32_t BUFFER_CLASS_SLOTS[BUFFER_CLASSES]	= {TCP_BUFFER_CLASS_SLOTS_0, TCP_BUFFER_CLASS_SLOTS_1, TCP_BUFFER_CLASS_SLOTS_2};
+static const uint32_t BUFFER_CLASS_BASE[BUFFER_CLASSES]		= {0,
+																((uint32_t) TCP_BUFFER_CLASS_SLOTS_0 << BUFFER_CLASS_BITS[0]),
+																((uint32_t) TCP_BUFFER_CLASS_SLOTS_0 << BUFFER_CLASS_BITS[0])
+																	+ ((uint32_t) TCP_BUFFER_CLASS_SLOTS_1 << BUFFER_CLASS_BITS[1])};
+// Class of the buffers of sessions we open and of the sessions we accept. The application picks
+// TCP_BUFFER_CLASS_SMALL for the sessions of a listening port by setting bit 15 of the listen request, the
+// listening ports are below 32768. Sessions of SYN cookies always get TCP_BUFFER_CLASS_ACCEPT. The allocator
+// falls back to smaller and then to larger buffers if the class is exhausted
+#ifndef TCP_BUFFER_CLASS_OPEN
+#define TCP_BUFFER_CLASS_OPEN 0
+#endif
+#ifndef TCP_BUFFER_CLASS_ACCEPT
+#define TCP_BUFFER_CLASS_ACCEPT 0
+#endif
+#ifndef TCP_BUFFER_CLASS_SMALL
+#define TCP_BUFFER_CLASS_SMALL 2
+#endif
+// Largest shift a peer may announce, RFC 7323 2.3
+static const uint8_t WINDOW_SCALE_MAX = 14;
+// MSS assumed if the peer does not send the MSS option, RFC 1122 4.2.2.6
+static const ap_uint<16> DEFAULT_MSS = 536;
+// SACK blocks fitting into the 40 option bytes of a TCP header, RFC 2018
+static const uint8_t TCP_SACK_BLOCKS = 4;
+
 #define noOfTxSessions 1 // Number of Tx Sessions to open for testing
 extern uint32_t packetCounter;
 extern uint32_t cycleCounter;
@@ -64,9 +244,13 @@ struct rtlSessionLookupRequest;
 
 using namespace hls;
 
+// The timing wheels advance by one tick every TIMER_TICK_CYCLES clock cycles (6.4ns), 8us per tick
+static const uint32_t TIMER_TICK_CYCLES = 1250;
+
 #ifndef __SYNTHESIS__
 static const ap_uint<32> TIME_64us		= 1;
 static const ap_uint<32> TIME_128us		= 1;
+static const ap_uint<32> TIME_200us		= 1;
 static const ap_uint<32> TIME_1ms		= 1;
 static const ap_uint<32> TIME_5ms		= 1;
 static const ap_uint<32> TIME_25ms		= 1;
@@ -84,28 +268,64 @@ static const ap_uint<32> TIME_30s		= 6;
 static const ap_uint<32> TIME_60s		= 60;
 static const ap_uint<32> TIME_120s		= 120;
 #else
-static const ap_uint<32> TIME_64us		= (       64.0/0.0064/MAX_SESSIONS) + 1;
-static const ap_uint<32> TIME_128us		= (      128.0/0.0064/MAX_SESSIONS) + 1;
-static const ap_uint<32> TIME_1ms		= (     1000.0/0.0064/MAX_SESSIONS) + 1;
-static const ap_uint<32> TIME_5ms		= (     5000.0/0.0064/MAX_SESSIONS) + 1;
-static const ap_uint<32> TIME_25ms		= (    25000.0/0.0064/MAX_SESSIONS) + 1;
-static const ap_uint<32> TIME_50ms		= (    50000.0/0.0064/MAX_SESSIONS) + 1;
-static const ap_uint<32> TIME_100ms		= (   100000.0/0.0064/MAX_SESSIONS) + 1;
-static const ap_uint<32> TIME_250ms		= (   250000.0/0.0064/MAX_SESSIONS) + 1;
-static const ap_uint<32> TIME_500ms		= (   500000.0/0.0064/MAX_SESSIONS) + 1;
-static const ap_uint<32> TIME_1s		= (  1000000.0/0.0064/MAX_SESSIONS) + 1;
-static const ap_uint<32> TIME_5s		= (  5000000.0/0.0064/MAX_SESSIONS) + 1;
-static const ap_uint<32> TIME_7s		= (  7000000.0/0.0064/MAX_SESSIONS) + 1;
-static const ap_uint<32> TIME_10s		= ( 10000000.0/0.0064/MAX_SESSIONS) + 1;
-static const ap_uint<32> TIME_15s		= ( 15000000.0/0.0064/MAX_SESSIONS) + 1;
-static const ap_uint<32> TIME_20s		= ( 20000000.0/0.0064/MAX_SESSIONS) + 1;
-static const ap_uint<32> TIME_30s		= ( 30000000.0/0.0064/MAX_SESSIONS) + 1;
-static const ap_uint<32> TIME_60s		= ( 60000000.0/0.0064/MAX_SESSIONS) + 1;
-static const ap_uint<32> TIME_120s		= (120000000.0/0.0064/MAX_SESSIONS) + 1;
-#endif
-
-
-enum eventType {TX, RT, ACK, SYN, SYN_ACK, FIN, RST, ACK_NODELAY};
+static const ap_uint<32> TIME_64us		= (       64.0/0.0064/TIMER_TICK_CYCLES) + 1;
+static const ap_uint<32> TIME_128us		= (      128.0/0.0064/TIMER_TICK_CYCLES) + 1;
+static const ap_uint<32> TIME_200us		= (      200.0/0.0064/TIMER_TICK_CYCLES) + 1;
+static const ap_uint<32> TIME_1ms		= (     1000.0/0.0064/TIMER_TICK_CYCLES) + 1;
+static const ap_uint<32> TIME_5ms		= (     5000.0/0.0064/TIMER_TICK_CYCLES) + 1;
+static const ap_uint<32> TIME_25ms		= (    25000.0/0.0064/TIMER_TICK_CYCLES) + 1;
+static const ap_uint<32> TIME_50ms		= (    50000.0/0.0064/TIMER_TICK_CYCLES) + 1;
+static const ap_uint<32> TIME_100ms		= (   100000.0/0.0064/TIMER_TICK_CYCLES) + 1;
+static const ap_uint<32> TIME_250ms		= (   250000.0/0.0064/TIMER_TICK_CYCLES) + 1;
+static const ap_uint<32> TIME_500ms		= (   500000.0/0.0064/TIMER_TICK_CYCLES) + 1;
+static const ap_uint<32> TIME_1s		= (  1000000.0/0.0064/TIMER_TICK_CYCLES) + 1;
+static const ap_uint<32> TIME_5s		= (  5000000.0/0.0064/TIMER_TICK_CYCLES) + 1;
+static const ap_uint<32> TIME_7s		= (  7000000.0/0.0064/TIMER_TICK_CYCLES) + 1;
+static const ap_uint<32> TIME_10s		= ( 10000000.0/0.0064/TIMER_TICK_CYCLES) + 1;
+static const ap_uint<32> TIME_15s		= ( 15000000.0/0.0064/TIMER_TICK_CYCLES) + 1;
+static const ap_uint<32> TIME_20s		= ( 20000000.0/0.0064/TIMER_TICK_CYCLES) + 1;
+static const ap_uint<32> TIME_30s		= ( 30000000.0/0.0064/TIMER_TICK_CYCLES) + 1;
+static const ap_uint<32> TIME_60s		= ( 60000000.0/0.0064/TIMER_TICK_CYCLES) + 1;
+static const ap_uint<32> TIME_120s		= (120000000.0/0.0064/TIMER_TICK_CYCLES) + 1;
+#endif
+
+// Retransmission timeout in timer ticks, RFC 6298. The floor is far below the 1s of RFC 6298 2.4 so a tail drop
+// does not stall a datacenter flow, TCP_RTO_INIT is used until the first RTT sample was taken. The floor can be raised
+// for paths with a longer RTT, e.g. -DTCP_RTO_MIN=TIME_5ms
+#ifndef TCP_RTO_MIN
+#define TCP_RTO_MIN TIME_200us
+#endif
+static const ap_uint<32> TCP_RTO_INIT		= TIME_1s;
+static const ap_uint<32> TCP_RTO_MAX		= TIME_60s;
+// Probe timeout of the tail loss probe, RFC 8985 7.2. PTO = 2 * SRTT plus an allowance for the delayed ACK of the peer,
+// the probe is skipped if the PTO is not shorter than the RTO
+static const ap_uint<32> TCP_TLP_ACK_DELAY	= TIME_64us;
+// Bounds of the delayed ACK in timer ticks. Every held segment restarts the delay with TCP_ACK_DELAY_MIN, but the ACK
+// is never held longer than TCP_ACK_DELAY_MAX after the first unacknowledged segment
+static const ap_uint<32> TCP_ACK_DELAY_MIN	= TIME_64us;
+static const ap_uint<32> TCP_ACK_DELAY_MAX	= TIME_200us;
+// Keep-alive idle time and probe interval in timer ticks. The idle time is far below the 2 hours of RFC 1122, it is
+// bounded by the range of the timing wheel
+static const ap_uint<32> TCP_KEEPALIVE_IDLE		= TIME_120s;
+static const ap_uint<32> TCP_KEEPALIVE_INTERVAL	= TIME_10s;
+// RTT samples are measured in clock cycles
+static const ap_uint<32> RTT_CYCLES_PER_TICK	= TIMER_TICK_CYCLES;
+// The timestamp clock ticks every 2^TS_CLOCK_SHIFT clock cycles, 0.82us at 156.25MHz. The 2^31 ticks after which
+// PAWS wraps are still 29 minutes, far above the MSL
+static const uint8_t TS_CLOCK_SHIFT = 7;
+// Pacing interval in clock cycles per byte with PACING_FRAC_BITS fractional bits
+static const uint8_t PACING_FRAC_BITS = 8;
+// The SYN cookie secret changes every 2^SYN_COOKIE_PERIOD_SHIFT clock cycles, 55s at 156.25MHz. A cookie is accepted
+// in the period it was sent and the one after
+#ifndef __SYNTHESIS__
+static const uint8_t SYN_COOKIE_PERIOD_SHIFT = 16;
+#else
+static const uint8_t SYN_COOKIE_PERIOD_SHIFT = 33;
+#endif
+static const uint8_t SYN_COOKIE_PERIOD_BITS = 3;
+
+
+enum eventType {TX, RT, ACK, SYN, SYN_ACK, FIN, RST, ACK_NODELAY, TLP, SYN_COOKIE, TIME_WAIT_ACK, KEEP_ALIVE};
 /*
  * There is no explicit LISTEN state
  * CLOSE-WAIT state is not used, since the FIN is sent out immediately after we receive a FIN, the application is simply notified
@@ -115,7 +335,7 @@ enum eventType {TX, RT, ACK, SYN, SYN_ACK, FIN, RST, ACK_NODELAY};
 enum sessionState {CLOSED, SYN_SENT, SYN_RECEIVED, ESTABLISHED, FIN_WAIT_1, FIN_WAIT_2, CLOSING, TIME_WAIT, LAST_ACK};
 
 
-enum { WORD_0, WORD_1, WORD_2, WORD_3, WORD_4 };
+enum { WORD_0, WORD_1, WORD_2, WORD_3, WORD_4, WORD_5, WORD_6, WORD_7 };
 
 struct axiWord
 {
@@ -166,6 +386,16 @@ struct sessionLookupReply
 			:sessionID(id), hit(hit) {}
 };
 
+// Reply of the port_table to the rx_engine, a listening port carries the buffer class of its sessions
+struct portCheckReply
+{
+	bool		open;
+	ap_uint<2>	bufferClass;
+	portCheckReply() {}
+	portCheckReply(bool open, ap_uint<2> bufferClass)
+			:open(open), bufferClass(bufferClass) {}
+};
+
 
 struct stateQuery
 {
@@ -179,72 +409,195 @@ struct stateQuery
 				:sessionID(id), state(state), write(write) {}
 };
 
-/** @ingroup rx_sar_table
+/** @ingroup buffer_allocator
+ *  RX or TX buffer of a session, the lower bits of the sequence numbers are the offset into the buffer.
+ *  The buffer is aligned to its size, an access wrapping around its end is split in two
+ */
+struct sessionBuffer
+{
+	ap_uint<2>					sizeClass;
+	ap_uint<BUFFER_SLOT_BITS>	slot;
+	sessionBuffer() {}
+	sessionBuffer(ap_uint<2> sizeClass, ap_uint<BUFFER_SLOT_BITS> slot)
+				:sizeClass(sizeClass), slot(slot) {}
+	ap_uint<WINDOW_BITS+1> size()
+	{
+		return ((ap_uint<WINDOW_BITS+1>) 1) << BUFFER_CLASS_BITS[sizeClass];
+	}
+	ap_uint<WINDOW_BITS> mask()
+	{
+		return size() - 1;
+	}
+	// Address within the 1GB RX or TX region
+	ap_uint<30> address(ap_uint<WINDOW_BITS> offset)
+	{
+		return BUFFER_CLASS_BASE[sizeClass] + (((ap_uint<30>) slot) << BUFFER_CLASS_BITS[sizeClass]) + (offset & mask());
+	}
+};
+
+/** @ingroup session_context_table
  *  @ingroup rx_engine
  *  @ingroup tx_engine
- *  This struct defines an entry of the @ref rx_sar_table
+ *  This struct defines the RX part of a record of the @ref session_context_table
  */
 struct rxSarEntry
 {
 	ap_uint<32> recvd;
-	ap_uint<16> appd;
+	ap_uint<WINDOW_BITS> appd;
+	ap_uint<32> ooo_head;	// First byte of the out-of-order interval already stored in the buffer
+	ap_uint<16> ooo_length;
+	bool		ooo_valid;
+	ap_uint<4>	win_shift;	// Shift applied to the window we advertise, 0 if window scaling was not negotiated
+	bool		sack_ok;	// SACK-permitted was exchanged in the handshake
+	bool		ecn_ok;		// ECN was negotiated in the handshake
+	bool		ce;			// The last data segment was CE marked, echoed with ECE
+	bool		ts_ok;		// Timestamps were exchanged in the handshake
+	ap_uint<32>	ts_recent;	// TSval echoed in TSecr, RFC 7323 4.3
+	sessionBuffer buffer;	// Assigned on init, returned when the session is released
+	bool		bufferValid;
 };
 
 struct rxSarRecvd
 {
 	ap_uint<16> sessionID;
 	ap_uint<32> recvd;
+	ap_uint<32> ooo_head;
+	ap_uint<16> ooo_length;
+	bool		ooo_valid;
+	ap_uint<4>	win_shift;
+	bool		sack_ok;
+	bool		ecn_ok;
+	bool		ce;
+	bool		ts_ok;
+	ap_uint<32>	ts_recent;
+	ap_uint<2>	bufferClass;	// Size class of the buffer allocated on init
 	ap_uint<1> write;
 	ap_uint<1> init;
 	rxSarRecvd() {}
 	rxSarRecvd(ap_uint<16> id)
-				:sessionID(id), recvd(0), write(0), init(0) {}
+				:sessionID(id), recvd(0), ooo_head(0), ooo_length(0), ooo_valid(false), win_shift(0), sack_ok(false), ecn_ok(false), ce(false), ts_ok(false), ts_recent(0), bufferClass(TCP_BUFFER_CLASS_ACCEPT), write(0), init(0) {}
 	rxSarRecvd(ap_uint<16> id, ap_uint<32> recvd, ap_uint<1> write)
-				:sessionID(id), recvd(recvd), write(write), init(0) {}
+				:sessionID(id), recvd(recvd), ooo_head(0), ooo_length(0), ooo_valid(false), win_shift(0), sack_ok(false), ecn_ok(false), ce(false), ts_ok(false), ts_recent(0), bufferClass(TCP_BUFFER_CLASS_ACCEPT), write(write), init(0) {}
 	rxSarRecvd(ap_uint<16> id, ap_uint<32> recvd, ap_uint<1> write, ap_uint<1> init)
-					:sessionID(id), recvd(recvd), write(write), init(init) {}
+				:sessionID(id), recvd(recvd), ooo_head(0), ooo_length(0), ooo_valid(false), win_shift(0), sack_ok(false), ecn_ok(false), ce(false), ts_ok(false), ts_recent(0), bufferClass(TCP_BUFFER_CLASS_ACCEPT), write(write), init(init) {}
+	rxSarRecvd(ap_uint<16> id, ap_uint<32> recvd, ap_uint<1> write, ap_uint<1> init, ap_uint<4> winShift, bool sackOk, bool ecnOk)
+				:sessionID(id), recvd(recvd), ooo_head(0), ooo_length(0), ooo_valid(false), win_shift(winShift), sack_ok(sackOk), ecn_ok(ecnOk), ce(false), ts_ok(false), ts_recent(0), bufferClass(TCP_BUFFER_CLASS_ACCEPT), write(write), init(init) {}
+	rxSarRecvd(ap_uint<16> id, ap_uint<32> recvd, ap_uint<32> oooHead, ap_uint<16> oooLength, bool oooValid)
+				:sessionID(id), recvd(recvd), ooo_head(oooHead), ooo_length(oooLength), ooo_valid(oooValid), win_shift(0), sack_ok(false), ecn_ok(false), ce(false), ts_ok(false), ts_recent(0), bufferClass(TCP_BUFFER_CLASS_ACCEPT), write(1), init(0) {}
 };
 
 struct rxSarAppd
 {
 	ap_uint<16> sessionID;
-	ap_uint<16> appd;
+	ap_uint<WINDOW_BITS> appd;
+	sessionBuffer buffer;	// Only valid in the reply
 	ap_uint<1>	write;
 	rxSarAppd() {}
 	rxSarAppd(ap_uint<16> id)
 				:sessionID(id), appd(0), write(0) {}
-	rxSarAppd(ap_uint<16> id, ap_uint<16> appd)
+	rxSarAppd(ap_uint<16> id, ap_uint<WINDOW_BITS> appd)
 				:sessionID(id), appd(appd), write(1) {}
+	rxSarAppd(ap_uint<16> id, ap_uint<WINDOW_BITS> appd, sessionBuffer buffer)
+				:sessionID(id), appd(appd), buffer(buffer), write(0) {}
+};
+
+/** @ingroup session_context_table
+ *  SACK blocks last reported by the peer, only the lower WINDOW_BITS of the sequence numbers
+ *  are stored since all blocks lie within the send window
+ */
+struct txSackScoreboard
+{
+	ap_uint<WINDOW_BITS>	left[TCP_SACK_BLOCKS];
+	ap_uint<WINDOW_BITS>	right[TCP_SACK_BLOCKS];
+	ap_uint<3>				count;
+	txSackScoreboard()
+		:count(0) {}
+};
+
+/** @ingroup congestion_control
+ *  Per session state of the congestion control besides the congestion window and the slow start threshold
+ */
+struct congestionState
+{
+	ap_uint<WINDOW_BITS>	bytes_acked;	// Acknowledged bytes in congestion avoidance, the window grows once a full window was acknowledged
+	ap_uint<WINDOW_BITS>	w_max;			// CUBIC: window before the last reduction
+	ap_uint<WINDOW_BITS>	w_est;			// CUBIC: window of Reno, used in the TCP-friendly region
+	ap_uint<20>				k;				// CUBIC: time until w_max is reached again, in CUBIC time units
+	ap_uint<32>				epoch;			// CUBIC: clock cycle of the last reduction
+	ap_uint<2>				algorithm;
+	// DCTCP, RFC 8257. Fraction of ECE marked bytes per window of data, alpha is scaled by 2^10
+	ap_uint<WINDOW_BITS+1>	ecn_acked;
+	ap_uint<WINDOW_BITS+1>	ecn_marked;
+	ap_uint<11>				ecn_alpha;
+	ap_uint<32>				ecn_windowEnd;		// alpha is updated once this sequence number is acknowledged
+	ap_uint<32>				ecn_recoveryEnd;	// Only one reduction until this sequence number is acknowledged
 };
 
 struct txSarEntry
 {
 	ap_uint<32> ackd;
 	ap_uint<32> not_ackd;
-	ap_uint<16> recv_window;
-	ap_uint<16> cong_window;
-	ap_uint<16> slowstart_threshold;
-	ap_uint<16> app;
+	ap_uint<WINDOW_BITS> recv_window;
+	ap_uint<WINDOW_BITS> cong_window;
+	ap_uint<WINDOW_BITS> slowstart_threshold;
+	ap_uint<WINDOW_BITS> app;
+	ap_uint<4>	win_shift;	// Shift announced by the peer, applied to every window it advertises
 	ap_uint<2>	count;
-	bool		fastRetransmitted;
+	bool		fastRetransmitted;	// In fast recovery until recover is acknowledged
+	ap_uint<32>	recover;			// NewReno, first sequence number behind the data sent when the loss was detected
 	bool		finReady;
 	bool		finSent;
+	congestionState cc;
+	ap_uint<32>	srtt;		// Smoothed RTT in clock cycles, 0 until the first sample
+	ap_uint<32>	rttvar;
+	ap_uint<32>	rto;		// Retransmission timeout in timer ticks
+	ap_uint<32>	pto;		// Probe timeout of the tail loss probe in timer ticks
+	ap_uint<32>	rtt_seq;	// The RTT sample is taken when this sequence number is acknowledged
+	ap_uint<32>	rtt_start;
+	bool		rtt_active;
+	bool		cwr_pending;	// Window was reduced on ECE, the next new segment carries CWR
+	ap_uint<WINDOW_BITS> mempt;	// Write pointer of the tx_app_stream_if, ahead of app until the data is written
+	sessionBuffer buffer;		// Assigned on init, returned when the session is released
+	bool		bufferValid;
+};
+
+/** @ingroup session_context_table
+ *  Record of a session, the context of the RX and TX direction is read and written in one access
+ */
+struct sessionContext
+{
+	rxSarEntry			rx;
+	txSarEntry			tx;
+	txSackScoreboard	sack;
 };
 
 struct rxTxSarQuery
 {
 	ap_uint<16> sessionID;
 	ap_uint<32> ackd;
-	ap_uint<16> recv_window;
-	ap_uint<16>	cong_window;
+	ap_uint<WINDOW_BITS> recv_window;
+	ap_uint<WINDOW_BITS> cong_window;
+	ap_uint<WINDOW_BITS> slowstart_threshold;
+	ap_uint<4>	win_shift;
 	ap_uint<2>  count;
 	bool		fastRetransmitted;
+	ap_uint<32>	recover;
+	txSackScoreboard sackBoard;
+	congestionState cc;
+	bool		cc_newEpoch;	// The window was reduced, the CUBIC epoch restarts
+	bool		cwr;			// The window was reduced on ECE, CWR has to be sent
+	ap_uint<32>	srtt;
+	ap_uint<32>	rttvar;
+	ap_uint<32>	rto;
+	ap_uint<32>	pto;
+	bool		rtt_sample;	// RTT estimate is only written if a sample was taken
+	bool		init;		// The session was opened by a SYN cookie, the TX side is initialized from ackd
 	ap_uint<1> write;
 	rxTxSarQuery () {}
 	rxTxSarQuery(ap_uint<16> id)
-				:sessionID(id), ackd(0), recv_window(0), count(0), fastRetransmitted(false), write(0) {}
-	rxTxSarQuery(ap_uint<16> id, ap_uint<32> ackd, ap_uint<16> recv_win, ap_uint<16> cong_win, ap_uint<2> count, bool fastRetransmitted)
-				:sessionID(id), ackd(ackd), recv_window(recv_win), cong_window(cong_win), count(count), fastRetransmitted(fastRetransmitted), write(1) {}
+				:sessionID(id), ackd(0), recv_window(0), win_shift(0), count(0), fastRetransmitted(false), cc_newEpoch(false), cwr(false), rtt_sample(false), init(false), write(0) {}
+	rxTxSarQuery(ap_uint<16> id, ap_uint<32> ackd, ap_uint<WINDOW_BITS> recv_win, ap_uint<WINDOW_BITS> cong_win, ap_uint<WINDOW_BITS> sstresh, ap_uint<4> winShift, ap_uint<2> count, bool fastRetransmitted)
+				:sessionID(id), ackd(ackd), recv_window(recv_win), cong_window(cong_win), slowstart_threshold(sstresh), win_shift(winShift), count(count), fastRetransmitted(fastRetransmitted), cc_newEpoch(false), cwr(false), rtt_sample(false), init(false), write(1) {}
 };
 
 struct txTxSarQuery
@@ -256,17 +609,21 @@ struct txTxSarQuery
 	bool		finReady;
 	bool		finSent;
 	bool		isRtQuery;
+	bool		cwrSent;	// A segment carried CWR, clears cwr_pending
+	ap_uint<2>	bufferClass;	// Size class of the buffer allocated on init
 	txTxSarQuery() {}
 	txTxSarQuery(ap_uint<16> id)
-				:sessionID(id), not_ackd(0), write(0), init(0), finReady(false), finSent(false), isRtQuery(false) {}
+				:sessionID(id), not_ackd(0), write(0), init(0), finReady(false), finSent(false), isRtQuery(false), cwrSent(false), bufferClass(TCP_BUFFER_CLASS_OPEN) {}
 	txTxSarQuery(ap_uint<16> id, ap_uint<32> not_ackd, ap_uint<1> write)
-				:sessionID(id), not_ackd(not_ackd), write(write), init(0), finReady(false), finSent(false), isRtQuery(false) {}
+				:sessionID(id), not_ackd(not_ackd), write(write), init(0), finReady(false), finSent(false), isRtQuery(false), cwrSent(false), bufferClass(TCP_BUFFER_CLASS_OPEN) {}
 	txTxSarQuery(ap_uint<16> id, ap_uint<32> not_ackd, ap_uint<1> write, ap_uint<1> init)
-				:sessionID(id), not_ackd(not_ackd), write(write), init(init), finReady(false), finSent(false), isRtQuery(false) {}
+				:sessionID(id), not_ackd(not_ackd), write(write), init(init), finReady(false), finSent(false), isRtQuery(false), cwrSent(false), bufferClass(TCP_BUFFER_CLASS_OPEN) {}
 	txTxSarQuery(ap_uint<16> id, ap_uint<32> not_ackd, ap_uint<1> write, ap_uint<1> init, bool finReady, bool finSent)
-				:sessionID(id), not_ackd(not_ackd), write(write), init(init), finReady(finReady), finSent(finSent), isRtQuery(false) {}
+				:sessionID(id), not_ackd(not_ackd), write(write), init(init), finReady(finReady), finSent(finSent), isRtQuery(false), cwrSent(false), bufferClass(TCP_BUFFER_CLASS_OPEN) {}
 	txTxSarQuery(ap_uint<16> id, ap_uint<32> not_ackd, ap_uint<1> write, ap_uint<1> init, bool finReady, bool finSent, bool isRt)
-				:sessionID(id), not_ackd(not_ackd), write(write), init(init), finReady(finReady), finSent(finSent), isRtQuery(isRt) {}
+				:sessionID(id), not_ackd(not_ackd), write(write), init(init), finReady(finReady), finSent(finSent), isRtQuery(isRt), cwrSent(false), bufferClass(TCP_BUFFER_CLASS_OPEN) {}
+	txTxSarQuery(ap_uint<16> id, ap_uint<32> not_ackd, ap_uint<1> write, ap_uint<1> init, bool finReady, bool finSent, bool isRt, bool cwrSent)
+				:sessionID(id), not_ackd(not_ackd), write(write), init(init), finReady(finReady), finSent(finSent), isRtQuery(isRt), cwrSent(cwrSent), bufferClass(TCP_BUFFER_CLASS_OPEN) {}
 };
 
 struct txTxSarRtQuery : public txTxSarQuery
@@ -274,11 +631,11 @@ struct txTxSarRtQuery : public txTxSarQuery
 	txTxSarRtQuery() {}
 	txTxSarRtQuery(const txTxSarQuery& q)
 			:txTxSarQuery(q.sessionID, q.not_ackd, q.write, q.init, q.finReady, q.finSent, q.isRtQuery) {}
-	txTxSarRtQuery(ap_uint<16> id, ap_uint<16> ssthresh)
-			:txTxSarQuery(id, ssthresh, 1, 0, false, false, true) {}
-	ap_uint<16> getThreshold()
+	txTxSarRtQuery(ap_uint<16> id, ap_uint<WINDOW_BITS> flightSize)
+			:txTxSarQuery(id, flightSize, 1, 0, false, false, true) {}
+	ap_uint<WINDOW_BITS> getFlightSize()
 	{
-	return not_ackd(15, 0);
+	return not_ackd(WINDOW_BITS-1, 0);
 	}
 };
 
@@ -286,12 +643,12 @@ struct txAppTxSarQuery
 {
 	ap_uint<16> sessionID;
 	//ap_uint<16> ackd;
-	ap_uint<16> mempt;
+	ap_uint<WINDOW_BITS> mempt;
 	bool		write;
 	txAppTxSarQuery() {}
 	txAppTxSarQuery(ap_uint<16> id)
 				:sessionID(id), mempt(0), write(false) {}
-	txAppTxSarQuery(ap_uint<16> id, ap_uint<16> pt)
+	txAppTxSarQuery(ap_uint<16> id, ap_uint<WINDOW_BITS> pt)
 			:sessionID(id), mempt(pt), write(true) {}
 };
 
@@ -299,29 +656,41 @@ struct rxTxSarReply
 {
 	ap_uint<32>	prevAck;
 	ap_uint<32> nextByte;
-	ap_uint<16>	cong_window;
-	ap_uint<16> slowstart_threshold;
+	ap_uint<WINDOW_BITS> cong_window;
+	ap_uint<WINDOW_BITS> slowstart_threshold;
+	ap_uint<4>	win_shift;
 	ap_uint<2>	count;
 	bool		fastRetransmitted;
+	ap_uint<32>	recover;
+	congestionState cc;
+	ap_uint<32>	cc_elapsed;		// Clock cycles since the CUBIC epoch started
+	ap_uint<32>	srtt;
+	ap_uint<32>	rttvar;
+	ap_uint<32>	rto;
+	ap_uint<32>	rtt_seq;
+	ap_uint<32>	rtt_elapsed;	// Clock cycles since the timed segment was sent
+	bool		rtt_active;
+	ap_uint<32>	ts_clock;		// Current value of the timestamp clock
 	rxTxSarReply() {}
-	rxTxSarReply(ap_uint<32> ack, ap_uint<32> next, ap_uint<16> cong_win, ap_uint<16> sstresh, ap_uint<2> count, bool fastRetransmitted)
-			:prevAck(ack), nextByte(next), cong_window(cong_win), slowstart_threshold(sstresh), count(count), fastRetransmitted(fastRetransmitted) {}
+	rxTxSarReply(ap_uint<32> ack, ap_uint<32> next, ap_uint<WINDOW_BITS> cong_win, ap_uint<WINDOW_BITS> sstresh, ap_uint<4> winShift, ap_uint<2> count, bool fastRetransmitted)
+			:prevAck(ack), nextByte(next), cong_window(cong_win), slowstart_threshold(sstresh), win_shift(winShift), count(count), fastRetransmitted(fastRetransmitted) {}
 };
 
 struct txAppTxSarReply
 {
 	ap_uint<16> sessionID;
-	ap_uint<16> ackd;
-	ap_uint<16> mempt;
+	ap_uint<WINDOW_BITS> ackd;
+	ap_uint<WINDOW_BITS> mempt;
 #if (TCP_NODELAY)
-	ap_uint<16> min_window;
+	ap_uint<WINDOW_BITS> min_window;
 #endif
+	sessionBuffer buffer;
 	txAppTxSarReply() {}
 #if !(TCP_NODELAY)
-	txAppTxSarReply(ap_uint<16> id, ap_uint<16> ackd, ap_uint<16> pt)
+	txAppTxSarReply(ap_uint<16> id, ap_uint<WINDOW_BITS> ackd, ap_uint<WINDOW_BITS> pt)
 		:sessionID(id), ackd(ackd), mempt(pt) {}
 #else
-	txAppTxSarReply(ap_uint<16> id, ap_uint<16> ackd, ap_uint<16> pt, ap_uint<16> min_window)
+	txAppTxSarReply(ap_uint<16> id, ap_uint<WINDOW_BITS> ackd, ap_uint<WINDOW_BITS> pt, ap_uint<WINDOW_BITS> min_window)
 		:sessionID(id), ackd(ackd), mempt(pt), min_window(min_window) {}
 #endif
 };
@@ -329,72 +698,167 @@ struct txAppTxSarReply
 struct txAppTxSarPush
 {
 	ap_uint<16> sessionID;
-	ap_uint<16> app;
+	ap_uint<WINDOW_BITS> app;
 	txAppTxSarPush() {}
-	txAppTxSarPush(ap_uint<16> id, ap_uint<16> app)
+	txAppTxSarPush(ap_uint<16> id, ap_uint<WINDOW_BITS> app)
 			:sessionID(id), app(app) {}
 };
 
-struct txSarAckPush
-{
-	ap_uint<16> sessionID;
-	ap_uint<16> ackd;
-#if (TCP_NODELAY)
-	ap_uint<16> min_window;
-#endif
-	ap_uint<1>	init;
-	txSarAckPush() {}
-#if !(TCP_NODELAY)
-	txSarAckPush(ap_uint<16> id, ap_uint<16> ackd)
-		:sessionID(id), ackd(ackd), init(0) {}
-	txSarAckPush(ap_uint<16> id, ap_uint<16> ackd, ap_uint<1> init)
-		:sessionID(id), ackd(ackd), init(init) {}
-#else
-	txSarAckPush(ap_uint<16> id, ap_uint<16> ackd, ap_uint<16> min_window)
-		:sessionID(id), ackd(ackd), min_window(min_window), init(0) {}
-	txSarAckPush(ap_uint<16> id, ap_uint<16> ackd, ap_uint<16> min_window, ap_uint<1> init)
-		:sessionID(id), ackd(ackd), min_window(min_window), init(init) {}
-#endif
-};
-
 struct txTxSarReply
 {
 	ap_uint<32> ackd;
 	ap_uint<32> not_ackd;
-	ap_uint<16> min_window;
-	ap_uint<16> app;
+	ap_uint<WINDOW_BITS> min_window;
+	ap_uint<WINDOW_BITS> app;
 	bool		finReady;
 	bool		finSent;
+	txSackScoreboard sackBoard;
+	ap_uint<32>	rto;
+	ap_uint<32>	pto;
+	bool		cwr_pending;
+	ap_uint<32>	ts_clock;
+	sessionBuffer buffer;
 	txTxSarReply() {}
-	txTxSarReply(ap_uint<32> ack, ap_uint<32> nack, ap_uint<16> min_window, ap_uint<16> app, bool finReady, bool finSent)
-		:ackd(ack), not_ackd(nack), min_window(min_window), app(app), finReady(finReady), finSent(finSent) {}
+	txTxSarReply(ap_uint<32> ack, ap_uint<32> nack, ap_uint<WINDOW_BITS> min_window, ap_uint<WINDOW_BITS> app, bool finReady, bool finSent)
+		:ackd(ack), not_ackd(nack), min_window(min_window), app(app), finReady(finReady), finSent(finSent), cwr_pending(false) {}
+};
+
+// Parts of the session context written by a request of the rx_engine
+static const ap_uint<2> CTX_WRITE_RXSAR = 0x1;
+static const ap_uint<2> CTX_WRITE_TXSAR = 0x2;
+
+/** @ingroup session_context_table
+ *  Access of the @ref rx_engine, the write mask selects the parts of the record that are updated.
+ *  Within a part the init and rtt_sample flags select the fields, without any part set both are read
+ */
+struct rxSessionCtxQuery
+{
+	ap_uint<16>		sessionID;
+	ap_uint<2>		writeMask;
+	rxSarRecvd		rxSar;
+	rxTxSarQuery	txSar;
+	rxSessionCtxQuery() {}
+	rxSessionCtxQuery(ap_uint<16> id)
+				:sessionID(id), writeMask(0), rxSar(id), txSar(id) {}
+	rxSessionCtxQuery(rxSarRecvd rxSar, rxTxSarQuery txSar)
+				:sessionID(rxSar.sessionID), writeMask((txSar.write, rxSar.write)), rxSar(rxSar), txSar(txSar) {}
+};
+
+struct rxSessionCtxReply
+{
+	rxSarEntry		rxSar;
+	rxTxSarReply	txSar;
+	rxSessionCtxReply() {}
+	rxSessionCtxReply(rxSarEntry rxSar, rxTxSarReply txSar)
+				:rxSar(rxSar), txSar(txSar) {}
+};
+
+/** @ingroup session_context_table
+ *  Reply to a read of the @ref tx_engine, carries both parts of the record
+ */
+struct txSessionCtxReply
+{
+	rxSarEntry		rxSar;
+	txTxSarReply	txSar;
+	txSessionCtxReply() {}
+	txSessionCtxReply(rxSarEntry rxSar, txTxSarReply txSar)
+				:rxSar(rxSar), txSar(txSar) {}
 };
 
 struct rxRetransmitTimerUpdate {
 	ap_uint<16> sessionID;
 	bool		stop;
+	ap_uint<32>	rto;
+	ap_uint<32>	pto;
 	rxRetransmitTimerUpdate() {}
 	rxRetransmitTimerUpdate(ap_uint<16> id)
-				:sessionID(id), stop(0) {}
+				:sessionID(id), stop(0), rto(TCP_RTO_INIT), pto(TCP_RTO_INIT) {}
 	rxRetransmitTimerUpdate(ap_uint<16> id, bool stop)
+				:sessionID(id), stop(stop), rto(TCP_RTO_INIT), pto(TCP_RTO_INIT) {}
+	rxRetransmitTimerUpdate(ap_uint<16> id, bool stop, ap_uint<32> rto)
+				:sessionID(id), stop(stop), rto(rto), pto(rto) {}
+	rxRetransmitTimerUpdate(ap_uint<16> id, bool stop, ap_uint<32> rto, ap_uint<32> pto)
+				:sessionID(id), stop(stop), rto(rto), pto(pto) {}
+};
+
+// Activity of a session seen by the RX engine, restarts its keep-alive timer. Stop when the session is closed
+struct keepAliveUpdate {
+	ap_uint<16> sessionID;
+	bool		stop;
+	keepAliveUpdate() {}
+	keepAliveUpdate(ap_uint<16> id)
+				:sessionID(id), stop(false) {}
+	keepAliveUpdate(ap_uint<16> id, bool stop)
 				:sessionID(id), stop(stop) {}
 };
 
 struct txRetransmitTimerSet {
 	ap_uint<16> sessionID;
 	eventType	type;
+	ap_uint<32>	rto;
+	ap_uint<32>	pto;
 	txRetransmitTimerSet() {}
 	txRetransmitTimerSet(ap_uint<16> id)
-				:sessionID(id), type(RT) {} //FIXME??
+				:sessionID(id), type(RT), rto(TCP_RTO_INIT), pto(TCP_RTO_INIT) {} //FIXME??
 	txRetransmitTimerSet(ap_uint<16> id, eventType type)
-				:sessionID(id), type(type) {}
+				:sessionID(id), type(type), rto(TCP_RTO_INIT), pto(TCP_RTO_INIT) {}
+	txRetransmitTimerSet(ap_uint<16> id, eventType type, ap_uint<32> rto)
+				:sessionID(id), type(type), rto(rto), pto(rto) {}
+	txRetransmitTimerSet(ap_uint<16> id, eventType type, ap_uint<32> rto, ap_uint<32> pto)
+				:sessionID(id), type(type), rto(rto), pto(pto) {}
+};
+
+// Record of a session entering TIME-WAIT, the tuple is in the orientation of received segments.
+// seqNumb and ackNumb are the numbers of the ACKs we send in TIME-WAIT
+struct timeWaitEntry {
+	fourTuple				tuple;
+	ap_uint<32>				seqNumb;
+	ap_uint<32>				ackNumb;
+	timeWaitEntry() {}
+	timeWaitEntry(fourTuple tuple, ap_uint<32> seq, ap_uint<32> ack)
+				:tuple(tuple), seqNumb(seq), ackNumb(ack) {}
+};
+
+// Lookup of a segment without a session, a FIN restarts the TIME-WAIT of its record, RFC 793.
+// SYNs are looked up on their own port alongside their session lookup, the tag is returned in the reply
+struct timeWaitQuery {
+	fourTuple				tuple;
+	bool					fin;
+	ap_uint<3>				tag;
+	timeWaitQuery() {}
+	timeWaitQuery(fourTuple tuple, bool fin)
+				:tuple(tuple), fin(fin), tag(0) {}
+	timeWaitQuery(fourTuple tuple, bool fin, ap_uint<3> tag)
+				:tuple(tuple), fin(fin), tag(tag) {}
+};
+
+struct timeWaitReply {
+	bool					hit;
+	ap_uint<32>				seqNumb;
+	ap_uint<32>				ackNumb;
+	ap_uint<3>				tag;
+	timeWaitReply() {}
+	timeWaitReply(bool hit, ap_uint<32> seq, ap_uint<32> ack)
+				:hit(hit), seqNumb(seq), ackNumb(ack), tag(0) {}
+	timeWaitReply(bool hit, ap_uint<32> seq, ap_uint<32> ack, ap_uint<3> tag)
+				:hit(hit), seqNumb(seq), ackNumb(ack), tag(tag) {}
+};
+
+struct pacerRateUpdate {
+	ap_uint<16>				sessionID;
+	ap_uint<WINDOW_BITS>	cong_window;
+	ap_uint<32>				srtt;
+	bool					slowStart;
+	pacerRateUpdate() {}
+	pacerRateUpdate(ap_uint<16> id, ap_uint<WINDOW_BITS> cwnd, ap_uint<32> srtt, bool slowStart)
+				:sessionID(id), cong_window(cwnd), srtt(srtt), slowStart(slowStart) {}
 };
 
 struct event
 {
 	eventType	type;
 	ap_uint<16>	sessionID;
-	ap_uint<16> address;
+	ap_uint<WINDOW_BITS> address;
 	ap_uint<16> length;
 	ap_uint<3>	rt_count;
 	event() {}
@@ -403,20 +867,23 @@ struct event
 			:type(type), sessionID(id), address(0), length(0), rt_count(0) {}
 	event(eventType type, ap_uint<16> id, ap_uint<3> rt_count)
 			:type(type), sessionID(id), address(0), length(0), rt_count(rt_count) {}
-	event(eventType type, ap_uint<16> id, ap_uint<16> addr, ap_uint<16> len)
+	event(eventType type, ap_uint<16> id, ap_uint<WINDOW_BITS> addr, ap_uint<16> len)
 			:type(type), sessionID(id), address(addr), length(len), rt_count(0) {}
-	event(eventType type, ap_uint<16> id, ap_uint<16> addr, ap_uint<16> len, ap_uint<3> rt_count)
+	event(eventType type, ap_uint<16> id, ap_uint<WINDOW_BITS> addr, ap_uint<16> len, ap_uint<3> rt_count)
 			:type(type), sessionID(id), address(addr), length(len), rt_count(rt_count) {}
 };
 
 struct extendedEvent : public event
 {
 	fourTuple	tuple;
+	ap_uint<32>	seqNumb;	// Sequence number of a TIME_WAIT_ACK, it is sent without a session
 	extendedEvent() {}
 	extendedEvent(const event& ev)
-			:event(ev.type, ev.sessionID, ev.address, ev.length, ev.rt_count) {}
+			:event(ev.type, ev.sessionID, ev.address, ev.length, ev.rt_count), seqNumb(0) {}
 	extendedEvent(const event& ev, fourTuple tuple)
-			:event(ev.type, ev.sessionID, ev.address, ev.length, ev.rt_count), tuple(tuple) {}
+			:event(ev.type, ev.sessionID, ev.address, ev.length, ev.rt_count), tuple(tuple), seqNumb(0) {}
+	extendedEvent(const event& ev, fourTuple tuple, ap_uint<32> seqNumb)
+			:event(ev.type, ev.sessionID, ev.address, ev.length, ev.rt_count), tuple(tuple), seqNumb(seqNumb) {}
 };
 
 struct rstEvent : public event
@@ -436,7 +903,7 @@ struct rstEvent : public event
 	ap_uint<32> getAckNumb()
 	{
 		ap_uint<32> seq;
-		seq(31, 16) = address;
+		seq(31, 16) = address(15, 0);
 		seq(15, 0) = length;
 		return seq;
 	}
@@ -446,6 +913,51 @@ struct rstEvent : public event
 	}
 };
 
+// ACK of a session in TIME-WAIT, the session slot is already released. With a session ID it is the
+// final ACK of the close, otherwise the answer to a stray segment found in the close_timer
+struct timeWaitEvent : public event
+{
+	timeWaitEvent() {}
+	timeWaitEvent(const event& ev)
+		:event(ev.type, ev.sessionID, ev.address, ev.length, ev.rt_count) {}
+	timeWaitEvent(ap_uint<32> ack)
+			:event(TIME_WAIT_ACK, 0, ack(31, 16), ack(15, 0), 0) {}
+	timeWaitEvent(ap_uint<16> id, ap_uint<32> ack)
+			:event(TIME_WAIT_ACK, id, ack(31, 16), ack(15, 0), 1) {}
+	ap_uint<32> getAckNumb()
+	{
+		ap_uint<32> ack;
+		ack(31, 16) = address(15, 0);
+		ack(15, 0) = length;
+		return ack;
+	}
+	bool hasSessionID()
+	{
+		return (rt_count != 0);
+	}
+};
+
+// SYN-ACK of a passive open that is answered without a session, carries the ACK number and the cookie period
+struct synCookieEvent : public event
+{
+	synCookieEvent() {}
+	synCookieEvent(const event& ev)
+		:event(ev.type, ev.sessionID, ev.address, ev.length, ev.rt_count) {}
+	synCookieEvent(ap_uint<32> ack, ap_uint<SYN_COOKIE_PERIOD_BITS> period)
+			:event(SYN_COOKIE, 0, ack(31, 16), ack(15, 0), period) {}
+	ap_uint<32> getAckNumb()
+	{
+		ap_uint<32> ack;
+		ack(31, 16) = address(15, 0);
+		ack(15, 0) = length;
+		return ack;
+	}
+	ap_uint<SYN_COOKIE_PERIOD_BITS> getPeriod()
+	{
+		return rt_count;
+	}
+};
+
 struct mmCmd
 {
 	ap_uint<23>	bbt;
@@ -459,12 +971,27 @@ struct mmCmd
 	mmCmd() {}
 	mmCmd(ap_uint<32> addr, ap_uint<16> len)
 		:bbt(len), type(1), dsa(0), eof(1), drr(1), saddr(addr), tag(0), rsvd(0) {}
+	mmCmd(ap_uint<32> addr, ap_uint<16> len, ap_uint<4> tag)
+		:bbt(len), type(1), dsa(0), eof(1), drr(1), saddr(addr), tag(tag), rsvd(0) {}
 	/*mm_cmd(ap_uint<32> addr, ap_uint<16> len, ap_uint<1> last)
 		:bbt(len), type(1), dsa(0), eof(last), drr(1), saddr(addr), tag(0), rsvd(0) {}*/
 	/*mm_cmd(ap_uint<32> addr, ap_uint<16> len, ap_uint<4> dsa)
 			:bbt(len), type(1), dsa(dsa), eof(1), drr(1), saddr(addr), tag(0), rsvd(0) {}*/
 };
 
+/** @ingroup buffer_allocator
+ *  Access to a session buffer, the access breakdown splits it into two data mover commands
+ *  if it wraps around the end of the buffer
+ */
+struct mmBufferCmd
+{
+	mmCmd			cmd;
+	sessionBuffer	buffer;
+	mmBufferCmd() {}
+	mmBufferCmd(mmCmd cmd, sessionBuffer buffer)
+				:cmd(cmd), buffer(buffer) {}
+};
+
 struct mmStatus
 {
 	ap_uint<4>	tag;
@@ -561,15 +1088,14 @@ void toe(	// Data & Memory Interface
 			stream<mmCmd>&							txBufferReadCmd,
 			stream<axiWord>&						rxBufferWriteData,
 			stream<axiWord>&						txBufferWriteData,
-			// SmartCam Interface
-			stream<rtlSessionLookupReply>&			sessionLookup_rsp,
-			stream<rtlSessionUpdateReply>&			sessionUpdate_rsp,
-			//stream<ap_uint<14> >&					readFinSessionId,
-			stream<rtlSessionLookupRequest>&		sessionLookup_req,
-			stream<rtlSessionUpdateRequest>&		sessionUpdate_req,
-			//stream<rtlSessionUpdateRequest>&		sessionInsert_req,
-			//stream<rtlSessionUpdateRequest>&		sessionDelete_req,
-			//stream<ap_uint<14> >&					writeNewSessionId,
+#if (TCP_DDR_CONTEXT)
+			// Session Context Memory Interface
+			stream<sessionContext>&					sessionContextReadData,
+			stream<mmStatus>&						sessionContextWriteStatus,
+			stream<mmCmd>&							sessionContextReadCmd,
+			stream<mmCmd>&							sessionContextWriteCmd,
+			stream<sessionContext>&					sessionContextWriteData,
+#endif
 			// Application Interface
 			stream<ap_uint<16> >&					listenPortReq,
 			// This is disabled for the time being, due to complexity concerns
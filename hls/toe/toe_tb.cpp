@@ -39,42 +39,6 @@ using namespace std;
 uint32_t cycleCounter;
 unsigned int	simCycleCounter		= 0;
 
-void sessionLookupStub(stream<rtlSessionLookupRequest>& lup_req, stream<rtlSessionLookupReply>& lup_rsp,
-						stream<rtlSessionUpdateRequest>& upd_req, stream<rtlSessionUpdateReply>& upd_rsp) {
-						//stream<ap_uint<14> >& new_id, stream<ap_uint<14> >& fin_id)
-	static map<fourTupleInternal, ap_uint<14> > lookupTable;
-
-	rtlSessionLookupRequest request;
-	rtlSessionUpdateRequest update;
-
-	map<fourTupleInternal, ap_uint<14> >::const_iterator findPos;
-
-	if (!lup_req.empty()) {
-		lup_req.read(request);
-		findPos = lookupTable.find(request.key);
-		if (findPos != lookupTable.end()) //hit
-			lup_rsp.write(rtlSessionLookupReply(true, findPos->second, request.source));
-		else
-			lup_rsp.write(rtlSessionLookupReply(false, request.source));
-	}
-
-	if (!upd_req.empty()) {	//TODO what if element does not exist
-		upd_req.read(update);
-		if (update.op == INSERT) {	//Is there a check if it already exists?
-			// Read free id
-			//new_id.read(update.value);
-			lookupTable[update.key] = update.value;
-			upd_rsp.write(rtlSessionUpdateReply(update.value, INSERT, update.source));
-
-		}
-		else {	// DELETE
-			//fin_id.write(update.value);
-			lookupTable.erase(update.key);
-			upd_rsp.write(rtlSessionUpdateReply(update.value, DELETE, update.source));
-		}
-	}
-}
-
 // Use Dummy Memory
 void simulateRx(dummyMemory* memory, stream<mmCmd>& WriteCmdFifo,  stream<mmStatus>& WriteStatusFifo, stream<mmCmd>& ReadCmdFifo,
 					stream<axiWord>& BufferIn, stream<axiWord>& BufferOut) {
@@ -91,11 +55,13 @@ void simulateRx(dummyMemory* memory, stream<mmCmd>& WriteCmdFifo,  stream<mmStat
 	static bool stx_readCmd = false;
 	static ap_uint<16> wrBufferWriteCounter = 0;
 	static ap_uint<16> wrBufferReadCounter = 0;
+	static ap_uint<4> wrBufferTag = 0;
 
 	if (!WriteCmdFifo.empty() && !stx_write) {
 		WriteCmdFifo.read(cmd);
 		memory->setWriteCmd(cmd);
 		wrBufferWriteCounter = cmd.bbt;
+		wrBufferTag = cmd.tag;
 		stx_write = true;
 	}
 	else if (!BufferIn.empty() && stx_write) {
@@ -106,6 +72,7 @@ void simulateRx(dummyMemory* memory, stream<mmCmd>& WriteCmdFifo,  stream<mmStat
 		if (wrBufferWriteCounter < 9) {
 			//fake_txBuffer.write(inWord); // RT hack
 			stx_write = false;
+			status.tag = wrBufferTag;
 			status.okay = 1;
 			WriteStatusFifo.write(status);
 		}
@@ -579,11 +546,6 @@ int main(int argc, char *argv[]) {
 	stream<mmCmd>						txBufferReadCmd("txBufferReadCmd");
 	stream<axiWord>						rxBufferWriteData("rxBufferWriteData");
 	stream<axiWord>						txBufferWriteData("txBufferWriteData");
-	stream<rtlSessionLookupReply>		sessionLookup_rsp("sessionLookup_rsp");
-	stream<rtlSessionUpdateReply>		sessionUpdate_rsp("sessionUpdate_rsp");
-	stream<rtlSessionLookupRequest>		sessionLookup_req("sessionLookup_req");
-	stream<rtlSessionUpdateRequest>		sessionUpdate_req("sessionUpdate_req");
-//	stream<rtlSessionUpdateRequest>		sessionUpdate_req;
 	stream<ap_uint<16> >				listenPortReq("listenPortReq");
 	stream<appReadRequest>				rxDataReq("rxDataReq");
 	stream<ipTuple>						openConnReq("openConnReq");
@@ -806,8 +768,8 @@ int main(int argc, char *argv[]) {
 //			}
 		}
 		toe(ipRxData, rxBufferWriteStatus, txBufferWriteStatus, rxBufferReadData, txBufferReadData, ipTxData, rxBufferWriteCmd,
-			rxBufferReadCmd, txBufferWriteCmd, txBufferReadCmd, rxBufferWriteData, txBufferWriteData, sessionLookup_rsp, sessionUpdate_rsp,
-			sessionLookup_req, sessionUpdate_req, listenPortReq, rxDataReq, openConnReq, closeConnReq, txDataReqMeta, txDataReq,
+			rxBufferReadCmd, txBufferWriteCmd, txBufferReadCmd, rxBufferWriteData, txBufferWriteData,
+			listenPortReq, rxDataReq, openConnReq, closeConnReq, txDataReqMeta, txDataReq,
 			//listenPortRsp, notification, rxDataRspMeta, rxDataRsp, openConnRsp, txDataRsp);
 			//relSessionCount, regSessionCount);
 			listenPortRsp, notification, rxDataRspMeta, rxDataRsp, openConnRsp, txDataRsp, 0x01010101, relSessionCount, regSessionCount);
@@ -818,7 +780,6 @@ int main(int argc, char *argv[]) {
 
 		simulateRx(&rxMemory, rxBufferWriteCmd, rxBufferWriteStatus, rxBufferReadCmd, rxBufferWriteData, rxBufferReadData);
 		simulateTx(&txMemory, txBufferWriteCmd, txBufferWriteStatus, txBufferReadCmd, txBufferWriteData, txBufferReadData);
-		  		   sessionLookupStub(sessionLookup_req, sessionLookup_rsp,	sessionUpdate_req, sessionUpdate_rsp);
 
 		if (!ipTxData.empty()) {
 			ipTxData.read(ipTxDataOut_Data);
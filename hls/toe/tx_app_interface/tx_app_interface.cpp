@@ -61,6 +61,7 @@ void txEventMerger(	stream<event>&	txApp2eventEng_mergeEvent,
 
 void txAppStatusHandler(stream<mmStatus>&				txBufferWriteStatus,
 						stream<event>&					tasi_eventCacheFifo,
+						stream<ap_uint<1> >&			txAppDoubleAccess,
 #if !(TCP_NODELAY)
 						stream<event>&					txAppStream2eventEng_setEvent,
 #endif
@@ -76,10 +77,12 @@ void txAppStatusHandler(stream<mmStatus>&				txBufferWriteStatus,
 
 	switch (tash_state) {
 	case 0:
-		if (!txBufferWriteStatus.empty() && !tasi_eventCacheFifo.empty()) {
+		if (!txBufferWriteStatus.empty() && !tasi_eventCacheFifo.empty() && !txAppDoubleAccess.empty()) {
 			//wrStatusCounter = 0;
 			txBufferWriteStatus.read(status);
 			tasi_eventCacheFifo.read(ev);
+			// The write was split if it wrapped around the end of the session buffer
+			ap_uint<1> doubleAccess = txAppDoubleAccess.read();
 #if !(TCP_NODELAY)
 			if (ev.type != TX)
 			{
@@ -89,9 +92,8 @@ void txAppStatusHandler(stream<mmStatus>&				txBufferWriteStatus,
 #endif
 			if (status.okay)
 			{
-				ap_uint<17> tempLength = ev.address + ev.length;
 				//if (tempLength >= 0x0FFFF && wrStatusCounter == 0)
-				if (tempLength > 65536)// && wrStatusCounter == 0)
+				if (doubleAccess)// && wrStatusCounter == 0)
 				{
 					tash_state = 1;
 				}
@@ -141,62 +143,10 @@ void txAppStatusHandler(stream<mmStatus>&				txBufferWriteStatus,
 }
 
 
-void tx_app_table(	stream<txSarAckPush>&		txSar2txApp_ack_push,
-					stream<txAppTxSarQuery>&	txApp_upd_req,
-					stream<txAppTxSarReply>&	txApp_upd_rsp)
-{
-#pragma HLS PIPELINE II=1
-
-	static txAppTableEntry app_table[MAX_SESSIONS];
-
-
-	txSarAckPush	ackPush;
-	txAppTxSarQuery txAppUpdate;
-
-	if (!txSar2txApp_ack_push.empty())
-	{
-		txSar2txApp_ack_push.read(ackPush);
-		if (ackPush.init)
-		{
-			// At init this is actually not_ackd
-			app_table[ackPush.sessionID].ackd = ackPush.ackd-1;
-			app_table[ackPush.sessionID].mempt = ackPush.ackd;
-#if (TCP_NODELAY)
-			app_table[ackPush.sessionID].min_window = ackPush.min_window;
-#endif
-		}
-		else
-		{
-			app_table[ackPush.sessionID].ackd = ackPush.ackd;
-#if (TCP_NODELAY)
-			app_table[ackPush.sessionID].min_window = ackPush.min_window;
-#endif
-		}
-	}
-	else if (!txApp_upd_req.empty())
-	{
-		txApp_upd_req.read(txAppUpdate);
-		// Write
-		if(txAppUpdate.write)
-		{
-			app_table[txAppUpdate.sessionID].mempt = txAppUpdate.mempt;
-		}
-		else // Read
-		{
-#if !(TCP_NODELAY)
-			txApp_upd_rsp.write(txAppTxSarReply(txAppUpdate.sessionID, app_table[txAppUpdate.sessionID].ackd, app_table[txAppUpdate.sessionID].mempt));
-#else
-			txApp_upd_rsp.write(txAppTxSarReply(txAppUpdate.sessionID, app_table[txAppUpdate.sessionID].ackd, app_table[txAppUpdate.sessionID].mempt, app_table[txAppUpdate.sessionID].min_window));
-#endif
-		}
-	}
-
-}
-
 void tx_app_interface(	stream<appTxMeta>&			appTxDataReqMetadata,
 					stream<axiWord>&				appTxDataReq,
 					stream<sessionState>&			stateTable2txApp_rsp,
-					stream<txSarAckPush>&			txSar2txApp_ack_push,
+					stream<txAppTxSarReply>&		ctx2txApp_upd_rsp,
 					stream<mmStatus>&				txBufferWriteStatus,
 
 					stream<ipTuple>&				appOpenConnReq,
@@ -213,7 +163,8 @@ void tx_app_interface(	stream<appTxMeta>&			appTxDataReqMetadata,
 #if (TCP_NODELAY)
 					stream<axiWord>&				txApp2txEng_data_stream,
 #endif
-					stream<txAppTxSarPush>&			txApp2txSar_push,
+					stream<txAppTxSarQuery>&		txApp2ctx_upd_req,
+					stream<txAppTxSarPush>&			txApp2ctx_app_push,
 
 					stream<openStatus>&				appOpenConnRsp,
 					stream<fourTuple>&				txApp2sLookup_req,
@@ -241,16 +192,12 @@ void tx_app_interface(	stream<appTxMeta>&			appTxDataReqMetadata,
 	#pragma HLS stream variable=txApp_txEventCache	depth=64
 	#pragma HLS DATA_PACK variable=txApp_txEventCache
 
-	static stream<txAppTxSarQuery>		txApp2txSar_upd_req("txApp2txSar_upd_req");
-	static stream<txAppTxSarReply>		txSar2txApp_upd_rsp("txSar2txApp_upd_rsp");
-	#pragma HLS stream variable=txApp2txSar_upd_req		depth=2
-	#pragma HLS stream variable=txSar2txApp_upd_rsp		depth=2
-	#pragma HLS DATA_PACK variable=txApp2txSar_upd_req
-	#pragma HLS DATA_PACK variable=txSar2txApp_upd_rsp
+	static stream<ap_uint<1> > txAppDoubleAccess("txAppDoubleAccess");
+	#pragma HLS stream variable=txAppDoubleAccess	depth=64
 
 	// Before merging, check status for TX
 	//txAppEvSplitter(txAppStream2event_mergeEvent, tasi_txSplit2mergeFifo, txApp_txEventCache);
-	//txAppStatusHandler(txBufferWriteStatus, txApp_txEventCache, txApp2txSar_push);
+	//txAppStatusHandler(txBufferWriteStatus, txApp_txEventCache, txApp2ctx_app_push);
 	// Merge Events
 	txEventMerger(	txApp2eventEng_mergeEvent,
 					txAppStream2event_mergeEvent,
@@ -264,25 +211,28 @@ void tx_app_interface(	stream<appTxMeta>&			appTxDataReqMetadata,
 	txAppStatusHandler(	txBufferWriteStatus,
 #if (TCP_NODELAY)
 						txApp_txEventCache,
+						txAppDoubleAccess,
 #else
 						txApp_eventCacheFifo,
+						txAppDoubleAccess,
 						txApp2eventEng_setEvent,
 #endif
-						txApp2txSar_push);
+						txApp2ctx_app_push);
 
 	// TX application Stream Interface
 	tx_app_stream_if(	appTxDataReqMetadata,
 						appTxDataReq,
 						stateTable2txApp_rsp,
-						txSar2txApp_upd_rsp,
+						ctx2txApp_upd_rsp,
 						appTxDataRsp,
 						txApp2stateTable_req,
-						txApp2txSar_upd_req,
+						txApp2ctx_upd_req,
 						txBufferWriteCmd,
 						txBufferWriteData,
 #if (TCP_NODELAY)
 						txApp2txEng_data_stream,
 #endif
+						txAppDoubleAccess,
 						txAppStream2event_mergeEvent);
 
 	// TX Application Interface
@@ -299,9 +249,4 @@ void tx_app_interface(	stream<appTxMeta>&			appTxDataReqMetadata,
 				txApp2eventEng_mergeEvent,
 				rtTimer2txApp_notification,
 				myIpAddress);
-
-	// TX App Meta Table
-	tx_app_table(	txSar2txApp_ack_push,
-					txApp2txSar_upd_req,
-					txSar2txApp_upd_rsp);
 }
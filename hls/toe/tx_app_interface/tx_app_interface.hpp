@@ -33,20 +33,10 @@ EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.// Copyright (c) 2015 Xilinx,
 
 using namespace hls;
 
-struct txAppTableEntry
-{
-	ap_uint<16>		ackd;
-	ap_uint<16>		mempt;
-#if (TCP_NODELAY)
-	ap_uint<16> 	min_window;
-#endif
-	txAppTableEntry() {}
-};
-
 void tx_app_interface(	stream<appTxMeta>&			appTxDataReqMetadata,
 					stream<axiWord>&				appTxDataReq,
 					stream<sessionState>&			stateTable2txApp_rsp,
-					stream<txSarAckPush>&			txSar2txApp_ack_push,
+					stream<txAppTxSarReply>&		ctx2txApp_upd_rsp,
 					stream<mmStatus>&				txBufferWriteStatus,
 
 					stream<ipTuple>&				appOpenConnReq,
@@ -63,7 +53,8 @@ void tx_app_interface(	stream<appTxMeta>&			appTxDataReqMetadata,
 #if (TCP_NODELAY)
 					stream<axiWord>&				txApp2txEng_data_stream,
 #endif
-					stream<txAppTxSarPush>&			txApp2txSar_push,
+					stream<txAppTxSarQuery>&		txApp2ctx_upd_req,
+					stream<txAppTxSarPush>&			txApp2ctx_app_push,
 
 					stream<openStatus>&				appOpenConnRsp,
 					stream<fourTuple>&				txApp2sLookup_req,
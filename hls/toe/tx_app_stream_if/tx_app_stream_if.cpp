@@ -74,11 +74,11 @@ void tasi_metaLoader(	stream<appTxMeta>&			appTxDataReqMetaData,
 		{
 			stateTable2txApp_rsp.read(state);
 			txSar2txApp_upd_rsp.read(writeSar);
-			ap_uint<16> maxWriteLength = (writeSar.ackd - writeSar.mempt) - 1;
+			ap_uint<WINDOW_BITS> maxWriteLength = ((writeSar.ackd - writeSar.mempt) - 1) & writeSar.buffer.mask();
 #if (TCP_NODELAY)
 			//tasi_writeSar.mempt and txSar.not_ackd are supposed to be equal (with a few cycles delay)
-			ap_uint<16> usedLength = ((ap_uint<16>) writeSar.mempt - writeSar.ackd);
-			ap_uint<16> usableWindow = 0;
+			ap_uint<WINDOW_BITS> usedLength = ((ap_uint<WINDOW_BITS>) writeSar.mempt - writeSar.ackd);
+			ap_uint<WINDOW_BITS> usableWindow = 0;
 			if (writeSar.min_window > usedLength)
 			{
 				usableWindow = writeSar.min_window - usedLength;
@@ -106,7 +106,7 @@ void tasi_metaLoader(	stream<appTxMeta>&			appTxDataReqMetaData,
 			else //if (state == ESTABLISHED && pkgLen <= tasi_maxWriteLength)
 			{
 				// TODO there seems some redundancy
-				tasi_writeToBufFifo.write(pkgPushMeta(tasi_writeMeta.sessionID, writeSar.mempt, tasi_writeMeta.length));
+				tasi_writeToBufFifo.write(pkgPushMeta(tasi_writeMeta.sessionID, writeSar.mempt, tasi_writeMeta.length, writeSar.buffer));
 				appTxDataRsp.write(appTxRsp(tasi_writeMeta.length, maxWriteLength, NO_ERROR));
 				//tasi_eventCacheFifo.write(eventMeta(tasi_writeSessionID, tasi_writeSar.mempt, pkgLen));
 				txAppStream2eventEng_setEvent.write(event(TX, tasi_writeMeta.sessionID, writeSar.mempt, tasi_writeMeta.length));
@@ -137,13 +137,11 @@ void tasi_metaLoader(	stream<appTxMeta>&			appTxDataReqMetaData,
 void tasi_pkg_pusher(	stream<axiWord>& 				tasi_pkgBuffer,
 						stream<pkgPushMeta>&			tasi_writeToBufFifo,
 						stream<mmCmd>&					txBufferWriteCmd,
-#if !(TCP_NODELAY)
-						stream<axiWord>&				txBufferWriteData)
-
-#else
 						stream<axiWord>&				txBufferWriteData,
-						stream<axiWord>&				txApp2txEng_data_stream)
+#if (TCP_NODELAY)
+						stream<axiWord>&				txApp2txEng_data_stream,
 #endif
+						stream<ap_uint<1> >&			txAppDoubleAccess)
 {
 #pragma HLS pipeline II=1 enable_flush
 #pragma HLS INLINE off
@@ -152,6 +150,7 @@ void tasi_pkg_pusher(	stream<axiWord>& 				tasi_pkgBuffer,
 	static pkgPushMeta tasi_pushMeta;
 	static mmCmd txAppTempCmd = mmCmd(0, 0);
 	static ap_uint<16> txAppBreakTemp = 0;
+	static ap_uint<WINDOW_BITS> txAppBufferOffset = 0;
 	static uint8_t lengthBuffer = 0;
 	static ap_uint<3> accessResidue = 0;
 	static bool txAppBreakdown = false;
@@ -163,17 +162,17 @@ void tasi_pkg_pusher(	stream<axiWord>& 				tasi_pkgBuffer,
 
 	switch (tasiPkgPushState) {
 	case 0:
-		if (!tasi_writeToBufFifo.empty() && !txBufferWriteCmd.full()) {
+		if (!tasi_writeToBufFifo.empty() && !txBufferWriteCmd.full() && !txAppDoubleAccess.full()) {
 			tasi_writeToBufFifo.read(tasi_pushMeta);
 			if (!tasi_pushMeta.drop) {
 				ap_uint<32> pkgAddr;
 				pkgAddr(31, 30) = 0x01;
-				pkgAddr(29, 16) = tasi_pushMeta.sessionID(13, 0);
-				pkgAddr(15, 0) = tasi_pushMeta.address;
+				pkgAddr(29, 0) = tasi_pushMeta.buffer.address(tasi_pushMeta.address);
 				txAppTempCmd = mmCmd(pkgAddr, tasi_pushMeta.length);
 				mmCmd tempCmd = txAppTempCmd;
-				if ((txAppTempCmd.saddr.range(15, 0) + txAppTempCmd.bbt) > 65536) {
-					txAppBreakTemp = 65536 - txAppTempCmd.saddr;
+				txAppBufferOffset = tasi_pushMeta.address & tasi_pushMeta.buffer.mask();
+				if ((txAppBufferOffset + txAppTempCmd.bbt) > tasi_pushMeta.buffer.size()) {
+					txAppBreakTemp = tasi_pushMeta.buffer.size() - txAppBufferOffset;
 					txAppTempCmd.bbt -= txAppBreakTemp;
 					tempCmd = mmCmd(txAppTempCmd.saddr, txAppBreakTemp);
 					txAppBreakdown = true;
@@ -183,6 +182,8 @@ void tasi_pkg_pusher(	stream<axiWord>& 				tasi_pkgBuffer,
 					txAppBreakTemp = txAppTempCmd.bbt;
 				}
 				txBufferWriteCmd.write(tempCmd);
+				// Tells the status handler to wait for the status of both writes
+				txAppDoubleAccess.write(txAppBreakdown);
 			}
 			tasiPkgPushState = 1;
 		}
@@ -190,7 +191,7 @@ void tasi_pkg_pusher(	stream<axiWord>& 				tasi_pkgBuffer,
 	case 1:
 		if (!tasi_pkgBuffer.empty()) {
 			tasi_pkgBuffer.read(pushWord);
-#if (TCP_NODELAY)
+#if (TCP_NODELAY) && !(TCP_TX_REORDER)
 			txApp2txEng_data_stream.write(pushWord);
 #endif
 			axiWord outputWord = pushWord;
@@ -204,7 +205,7 @@ void tasi_pkg_pusher(	stream<axiWord>& 				tasi_pkgBuffer,
 				else
 				{
 					if (txAppBreakdown == true) {				/// Changes are to go in here
-						if (txAppTempCmd.saddr.range(15, 0) % 8 != 0) // If the word is not perfectly aligned then there is some magic to be worked.
+						if (txAppTempCmd.saddr.range(WINDOW_BITS-1, 0) % 8 != 0) // If the word is not perfectly aligned then there is some magic to be worked.
 						{
 							outputWord.keep = lenToKeep(txAppBreakTemp);
 						}
@@ -229,14 +230,14 @@ void tasi_pkg_pusher(	stream<axiWord>& 				tasi_pkgBuffer,
 		break;
 	case 2:
 		if (!txBufferWriteCmd.full()) {
-			if (txAppTempCmd.saddr.range(15, 0) % 8 == 0)
+			if (txAppTempCmd.saddr.range(WINDOW_BITS-1, 0) % 8 == 0)
 				tasiPkgPushState = 3;
 			//else if (txAppTempCmd.bbt +  accessResidue > 8 || accessResidue > 0)
 			else if (txAppTempCmd.bbt - accessResidue > 0)
 				tasiPkgPushState = 4;
 			else
 				tasiPkgPushState = 5;
-			txAppTempCmd.saddr.range(15, 0) = 0;
+			txAppTempCmd.saddr -= txAppBufferOffset;
 			txAppBreakTemp = txAppTempCmd.bbt;
 			txBufferWriteCmd.write(mmCmd(txAppTempCmd.saddr, txAppBreakTemp));
 			txAppBreakdown = false;
@@ -246,7 +247,7 @@ void tasi_pkg_pusher(	stream<axiWord>& 				tasi_pkgBuffer,
 	case 3:	// This is the non-realignment state
 		if (!tasi_pkgBuffer.empty() & !txBufferWriteData.full()) {
 			tasi_pkgBuffer.read(pushWord);
-#if (TCP_NODELAY)
+#if (TCP_NODELAY) && !(TCP_TX_REORDER)
 			txApp2txEng_data_stream.write(pushWord);
 #endif
 			if (!tasi_pushMeta.drop) {
@@ -262,7 +263,7 @@ void tasi_pkg_pusher(	stream<axiWord>& 				tasi_pkgBuffer,
 			axiWord outputWord = axiWord(0, 0xFF, 0);
 			outputWord.data.range(((8-lengthBuffer)*8) - 1, 0) = pushWord.data.range(63, lengthBuffer*8);
 			pushWord = tasi_pkgBuffer.read();
-#if (TCP_NODELAY)
+#if (TCP_NODELAY) && !(TCP_TX_REORDER)
 			txApp2txEng_data_stream.write(pushWord);
 #endif
 			outputWord.data.range(63, (8-lengthBuffer)*8) = pushWord.data.range((lengthBuffer * 8), 0 );
@@ -317,6 +318,7 @@ void tasi_pkg_pusher(	stream<axiWord>& 				tasi_pkgBuffer,
  *  @param[out]		txApp2txSar_upd_req
  *  @param[out]		txBufferWriteCmd
  *  @param[out]		txBufferWriteData
+ *  @param[out]		txAppDoubleAccess
  *  @param[out]		txAppStream2eventEng_setEvent
  */
 void tx_app_stream_if(	stream<appTxMeta>&				appTxDataReqMetaData,
@@ -331,6 +333,7 @@ void tx_app_stream_if(	stream<appTxMeta>&				appTxDataReqMetaData,
 #if (TCP_NODELAY)
 						stream<axiWord>&				txApp2txEng_data_stream,
 #endif
+						stream<ap_uint<1> >&			txAppDoubleAccess,
 						stream<event>&					txAppStream2eventEng_setEvent)
 {
 #pragma HLS INLINE
@@ -351,11 +354,10 @@ void tx_app_stream_if(	stream<appTxMeta>&				appTxDataReqMetaData,
 	tasi_pkg_pusher(	appTxDataReq,
 						tasi_writeToBufFifo,
 						txBufferWriteCmd,
-#if !(TCP_NODELAY)
-						txBufferWriteData);
-#else
 						txBufferWriteData,
-						txApp2txEng_data_stream);
+#if (TCP_NODELAY)
+						txApp2txEng_data_stream,
 #endif
+						txAppDoubleAccess);
 
 }
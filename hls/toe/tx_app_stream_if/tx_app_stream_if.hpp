@@ -41,24 +41,25 @@ static const ap_uint<4> ERROR_NOSPACE			= 2;
 struct eventMeta
 {
 	ap_uint<16> sessionID;
-	ap_uint<16> address;
+	ap_uint<WINDOW_BITS> address;
 	ap_uint<16> length;
 	eventMeta() {}
-	eventMeta(ap_uint<16> id, ap_uint<16> addr, ap_uint<16> len)
+	eventMeta(ap_uint<16> id, ap_uint<WINDOW_BITS> addr, ap_uint<16> len)
 				:sessionID(id), address(addr), length(len) {}
 };
 
 struct pkgPushMeta
 {
 	ap_uint<16> sessionID;
-	ap_uint<16> address;
+	ap_uint<WINDOW_BITS> address;
 	ap_uint<16> length;
+	sessionBuffer buffer;
 	bool		drop;
 	pkgPushMeta() {}
 	pkgPushMeta(bool drop)
 						:sessionID(0), address(0), length(0), drop(drop) {}
-	pkgPushMeta(ap_uint<16> id, ap_uint<16> addr, ap_uint<16> len)
-					:sessionID(id), address(addr), length(len), drop(false) {}
+	pkgPushMeta(ap_uint<16> id, ap_uint<WINDOW_BITS> addr, ap_uint<16> len, sessionBuffer buffer)
+					:sessionID(id), address(addr), length(len), buffer(buffer), drop(false) {}
 };
 
 
@@ -77,4 +78,5 @@ void tx_app_stream_if(	stream<appTxMeta>&				appTxDataReqMetaData,
 #if (TCP_NODELAY)
 						stream<axiWord>&				txApp2txEng_data_stream,
 #endif
+						stream<ap_uint<1> >&			txAppDoubleAccess,
 						stream<event>&					txAppStream2eventEng_setEvent);
@@ -34,17 +34,15 @@ using namespace hls;
 /** @ingroup tx_engine
  *  @name metaLoader
  *  The metaLoader reads the Events from the EventEngine then it loads all the necessary MetaData from the data
- *  structures (RX & TX Sar Table). Depending on the Event type it generates the necessary MetaData for the
+ *  structure (Session Context Table). Depending on the Event type it generates the necessary MetaData for the
  *  ipHeaderConstruction and the pseudoHeaderConstruction.
  *  Additionally it requests the IP Tuples from the Session. In some special cases the IP Tuple is delivered directly
  *  from @ref rx_engine and does not have to be loaded from the Session Table. The isLookUpFifo indicates this special cases.
  *  Lookup Table for the current session.
  *  Depending on the Event Type the retransmit or/and probe Timer is set.
  *  @param[in]		eventEng2txEng_event
- *  @param[in]		rxSar2txEng_upd_rsp
- *  @param[in]		txSar2txEng_upd_rsp
- *  @param[out]		txEng2rxSar_upd_req
- *  @param[out]		txEng2txSar_upd_req
+ *  @param[in]		ctx2txEng_upd_rsp
+ *  @param[out]		txEng2ctx_upd_req
  *  @param[out]		txEng2timer_setRetransmitTimer
  *  @param[out]		txEng2timer_setProbeTimer
  *  @param[out]		txEng_ipMetaFifoOut
@@ -55,15 +53,13 @@ using namespace hls;
  *  @param[out]		txEng_tupleShortCutFifoOut
  */
 void metaLoader(stream<extendedEvent>&				eventEng2txEng_event,
-				stream<rxSarEntry>&					rxSar2txEng_rsp,
-				stream<txTxSarReply>&				txSar2txEng_upd_rsp,
-				stream<ap_uint<16> >&				txEng2rxSar_req,
-				stream<txTxSarQuery>&				txEng2txSar_upd_req,
+				stream<txSessionCtxReply>&			ctx2txEng_upd_rsp,
+				stream<txTxSarQuery>&				txEng2ctx_upd_req,
 				stream<txRetransmitTimerSet>&		txEng2timer_setRetransmitTimer,
 				stream<ap_uint<16> >&				txEng2timer_setProbeTimer,
-				stream<ap_uint<16> >&				txEng_ipMetaFifoOut,
+				stream<ipHeaderMeta>&				txEng_ipMetaFifoOut,
 				stream<tx_engine_meta>&				txEng_tcpMetaFifoOut,
-				stream<mmCmd>&						txBufferReadCmd,
+				stream<mmBufferCmd>&				txBufferReadCmd,
 				stream<ap_uint<16> >&				txEng2sLookup_rev_req,
 				stream<bool>&						txEng_isLookUpFifoOut,
 #if (TCP_NODELAY)
@@ -77,18 +73,27 @@ void metaLoader(stream<extendedEvent>&				eventEng2txEng_event,
 
 	static ap_uint<1> ml_FsmState = 0;
 	static bool ml_sarLoaded = false;
+#if !(TCP_NODELAY)
+	static bool ml_cwrSent = false; // A segment of the current TX event carried CWR
+#endif
 	static extendedEvent ml_curEvent;
 	static ap_uint<32> ml_randomValue= 0x562301af; //Random seed initialization
 
 	static ap_uint<2> ml_segmentCount = 0;
 	static rxSarEntry	rxSar;
 	static txTxSarReply	txSar;
-	ap_uint<16> windowSize;
-	ap_uint<16> currLength;
-	ap_uint<16> usableWindow;
-	ap_uint<16> slowstart_threshold;
+	txSessionCtxReply ctxReply;
+	ap_uint<WINDOW_BITS> windowSize;
+	ap_uint<WINDOW_BITS> currLength;
+	ap_uint<WINDOW_BITS> usableWindow;
+	ap_uint<WINDOW_BITS> sackSkip;
+	ap_uint<WINDOW_BITS> sackLimit;
+	ap_uint<WINDOW_BITS> tailLength;
+	ap_uint<16> segmentSize;
 	static tx_engine_meta meta;
 	rstEvent resetEvent;
+	synCookieEvent cookieEvent;
+	timeWaitEvent waitEvent;
 
 	switch (ml_FsmState)
 	{
@@ -98,43 +103,43 @@ void metaLoader(stream<extendedEvent>&				eventEng2txEng_event,
 			eventEng2txEng_event.read(ml_curEvent);
 			readCountFifo.write(1);
 			ml_sarLoaded = false;
+#if !(TCP_NODELAY)
+			ml_cwrSent = false;
+#endif
+			meta.sack_valid = false; // Only pure ACKs carry a SACK block
+			meta.ts_valid = false;
 			//NOT necessary for SYN/SYN_ACK only needs one
 			switch (ml_curEvent.type)
 			{
+			case TLP:
 			case RT:
-				txEng2rxSar_req.write(ml_curEvent.sessionID);
-				txEng2txSar_upd_req.write(txTxSarQuery(ml_curEvent.sessionID));
+				txEng2ctx_upd_req.write(txTxSarQuery(ml_curEvent.sessionID));
 				break;
 			case TX:
-				txEng2rxSar_req.write(ml_curEvent.sessionID);
-				txEng2txSar_upd_req.write(txTxSarQuery(ml_curEvent.sessionID));
+				txEng2ctx_upd_req.write(txTxSarQuery(ml_curEvent.sessionID));
 				break;
 			case SYN_ACK:
-				txEng2rxSar_req.write(ml_curEvent.sessionID);
-				txEng2txSar_upd_req.write(txTxSarQuery(ml_curEvent.sessionID));
+				txEng2ctx_upd_req.write(txTxSarQuery(ml_curEvent.sessionID));
 				break;
 			case FIN:
-				txEng2rxSar_req.write(ml_curEvent.sessionID);
-				txEng2txSar_upd_req.write(txTxSarQuery(ml_curEvent.sessionID));
+				txEng2ctx_upd_req.write(txTxSarQuery(ml_curEvent.sessionID));
 				break;
 			case RST:
 				// Get txSar for SEQ numb
 				resetEvent = ml_curEvent;
 				if (resetEvent.hasSessionID())
 				{
-					txEng2txSar_upd_req.write(txTxSarQuery(ml_curEvent.sessionID));
+					txEng2ctx_upd_req.write(txTxSarQuery(ml_curEvent.sessionID));
 				}
 				break;
 			case ACK_NODELAY:
 			case ACK:
-				txEng2rxSar_req.write(ml_curEvent.sessionID);
-				txEng2txSar_upd_req.write(txTxSarQuery(ml_curEvent.sessionID));
+			case KEEP_ALIVE:
+				txEng2ctx_upd_req.write(txTxSarQuery(ml_curEvent.sessionID));
 				break;
 			case SYN:
-				if (ml_curEvent.rt_count != 0)
-				{
-					txEng2txSar_upd_req.write(txTxSarQuery(ml_curEvent.sessionID));
-				}
+				// Read even if the SYN initializes the txSar, the reply carries the timestamp clock
+				txEng2ctx_upd_req.write(txTxSarQuery(ml_curEvent.sessionID));
 				break;
 			default:
 				break;
@@ -151,28 +156,36 @@ void metaLoader(stream<extendedEvent>&				eventEng2txEng_event,
 		// Can bypass DDR
 #if (TCP_NODELAY)
 		case TX:
-			if ((!rxSar2txEng_rsp.empty() && !txSar2txEng_upd_rsp.empty()) || ml_sarLoaded)
+			if (!ctx2txEng_upd_rsp.empty() || ml_sarLoaded)
 			{
 				if (!ml_sarLoaded)
 				{
-					rxSar2txEng_rsp.read(rxSar);
-					txSar2txEng_upd_rsp.read(txSar);
+					ctx2txEng_upd_rsp.read(ctxReply);
+					rxSar = ctxReply.rxSar;
+					txSar = ctxReply.txSar;
 				}
 
 				//Compute our space, Advertise at least a quarter/half, otherwise 0
 
-				windowSize = (rxSar.appd - ((ap_uint<16>)rxSar.recvd)) - 1; // This works even for wrap around
+				windowSize = ((rxSar.appd - ((ap_uint<WINDOW_BITS>)rxSar.recvd)) - 1) & rxSar.buffer.mask(); // This works even for wrap around
 				meta.ackNumb = rxSar.recvd;
 				meta.seqNumb = txSar.not_ackd;
 				meta.window_size = windowSize;
+				meta.win_shift = rxSar.win_shift;
 				meta.ack = 1; // ACK is always set when established
 				meta.rst = 0;
 				meta.syn = 0;
 				meta.fin = 0;
+				// ECE echoes the CE state, CWR follows a window reduction on ECE, RFC 3168 6.1
+				meta.ece = (rxSar.ecn_ok && rxSar.ce);
+				meta.cwr = (txSar.cwr_pending && ml_curEvent.length != 0);
+				meta.ts_valid = rxSar.ts_ok;
+				meta.ts_val = txSar.ts_clock;
+				meta.ts_ecr = rxSar.ts_recent;
 				//meta.length = 0;
 
 				/*currLength = ml_curEvent.length;
-				ap_uint<16> usedLength = ((ap_uint<16>) txSar.not_ackd - txSar.ackd);
+				ap_uint<WINDOW_BITS> usedLength = ((ap_uint<WINDOW_BITS>) txSar.not_ackd - txSar.ackd);
 				// min_window, is the min(txSar.recv_window, txSar.cong_window)
 				if (txSar.min_window > usedLength)
 				{
@@ -189,25 +202,37 @@ void metaLoader(stream<extendedEvent>&				eventEng2txEng_event,
 				}
 
 				meta.length = ml_curEvent.length;
+#if (TCP_TX_REORDER)
+				// The tx_pacer and the event_engine reorder the segments of the sessions, they are read back from the session buffer
+				ap_uint<32> pkgAddr;
+				pkgAddr(31, 30) = 0x01;
+				pkgAddr(29, 0) = txSar.buffer.address(txSar.not_ackd(WINDOW_BITS-1, 0));
+#endif
 
 				//TODO some checking
 				txSar.not_ackd += ml_curEvent.length;
 
-				txEng2txSar_upd_req.write(txTxSarQuery(ml_curEvent.sessionID, txSar.not_ackd, 1));
+				txEng2ctx_upd_req.write(txTxSarQuery(ml_curEvent.sessionID, txSar.not_ackd, 1, 0, false, false, false, meta.cwr));
 				ml_FsmState = 0;
 
 
 				// Send a packet only if there is data or we want to send an empty probing message
 				if (meta.length != 0)// || ml_curEvent.retransmit) //TODO retransmit boolean currently not set, should be removed
 				{
-					txEng_ipMetaFifoOut.write(meta.length);
+					// New data is ECN-capable
+					txEng_ipMetaFifoOut.write(ipHeaderMeta(meta.length + meta.tsOptionLength(), rxSar.ecn_ok ? ECN_ECT0 : ECN_NOT_ECT));
 					txEng_tcpMetaFifoOut.write(meta);
 					txEng_isLookUpFifoOut.write(true);
+#if !(TCP_TX_REORDER)
 					txEng_isDDRbypass.write(true);
+#else
+					txBufferReadCmd.write(mmBufferCmd(mmCmd(pkgAddr, meta.length), txSar.buffer));
+					txEng_isDDRbypass.write(false);
+#endif
 					txEng2sLookup_rev_req.write(ml_curEvent.sessionID);
 
 					// Only set RT timer if we actually send sth, TODO only set if we change state and sent sth
-					txEng2timer_setRetransmitTimer.write(txRetransmitTimerSet(ml_curEvent.sessionID));
+					txEng2timer_setRetransmitTimer.write(txRetransmitTimerSet(ml_curEvent.sessionID, RT, txSar.rto, txSar.pto));
 				}//TODO if probe send msg length 1
 				ml_sarLoaded = true;
 			}
@@ -216,27 +241,37 @@ void metaLoader(stream<extendedEvent>&				eventEng2txEng_event,
 #else
 		case TX:
 			// Sends everyting between txSar.not_ackd and txSar.app
-			if ((!rxSar2txEng_rsp.empty() && !txSar2txEng_upd_rsp.empty()) || ml_sarLoaded)
+			if (!ctx2txEng_upd_rsp.empty() || ml_sarLoaded)
 			{
 				if (!ml_sarLoaded)
 				{
-					rxSar2txEng_rsp.read(rxSar);
-					txSar2txEng_upd_rsp.read(txSar);
+					ctx2txEng_upd_rsp.read(ctxReply);
+					rxSar = ctxReply.rxSar;
+					txSar = ctxReply.txSar;
 				}
 
 				//Compute our space, Advertise at least a quarter/half, otherwise 0
-				windowSize = (rxSar.appd - ((ap_uint<16>)rxSar.recvd)) - 1; // This works even for wrap around
+				windowSize = ((rxSar.appd - ((ap_uint<WINDOW_BITS>)rxSar.recvd)) - 1) & rxSar.buffer.mask(); // This works even for wrap around
 				meta.ackNumb = rxSar.recvd;
 				meta.seqNumb = txSar.not_ackd;
 				meta.window_size = windowSize;
+				meta.win_shift = rxSar.win_shift;
 				meta.ack = 1; // ACK is always set when established
 				meta.rst = 0;
 				meta.syn = 0;
 				meta.fin = 0;
+				// ECE echoes the CE state, CWR follows a window reduction on ECE, RFC 3168 6.1
+				meta.ece = (rxSar.ecn_ok && rxSar.ce);
+				meta.cwr = txSar.cwr_pending;
+				meta.ts_valid = rxSar.ts_ok;
+				meta.ts_val = txSar.ts_clock;
+				meta.ts_ecr = rxSar.ts_recent;
 				meta.length = 0;
+				// Options are not part of the MSS, RFC 6691
+				segmentSize = rxSar.ts_ok ? (ap_uint<16>) (MSS - TS_OPTION_LENGTH) : MSS;
 
-				currLength = (txSar.app - ((ap_uint<16>)txSar.not_ackd));
-				ap_uint<16> usedLength = ((ap_uint<16>) txSar.not_ackd - txSar.ackd);
+				currLength = (txSar.app - ((ap_uint<WINDOW_BITS>)txSar.not_ackd));
+				ap_uint<WINDOW_BITS> usedLength = ((ap_uint<WINDOW_BITS>) txSar.not_ackd - txSar.ackd);
 				// min_window, is the min(txSar.recv_window, txSar.cong_window)
 				if (txSar.min_window > usedLength)
 				{
@@ -249,18 +284,17 @@ void metaLoader(stream<extendedEvent>&				eventEng2txEng_event,
 				// Construct address before modifying txSar.not_ackd
 				ap_uint<32> pkgAddr;
 				pkgAddr(31, 30) = 0x01;
-				pkgAddr(29, 16) = ml_curEvent.sessionID(13, 0);
-				pkgAddr(15, 0) = txSar.not_ackd(15, 0); //ml_curEvent.address;
+				pkgAddr(29, 0) = txSar.buffer.address(txSar.not_ackd(WINDOW_BITS-1, 0));
 
 
 				// Check length, if bigger than Usable Window or MMS
 				if (currLength <= usableWindow)
 				{
-					if (currLength >= MSS) //TODO change to >= MSS, use maxSegmentCount
+					if (currLength >= segmentSize) //TODO change to >= MSS, use maxSegmentCount
 					{
 						// We stay in this state and sent immediately another packet
-						txSar.not_ackd += MSS;
-						meta.length = MSS;
+						txSar.not_ackd += segmentSize;
+						meta.length = segmentSize;
 					}
 					else
 					{
@@ -288,17 +322,18 @@ void metaLoader(stream<extendedEvent>&				eventEng2txEng_event,
 						}
 //#endif
 						// Write back txSar not_ackd pointer
-						txEng2txSar_upd_req.write(txTxSarQuery(ml_curEvent.sessionID, txSar.not_ackd, 1));
+						txEng2ctx_upd_req.write(txTxSarQuery(ml_curEvent.sessionID, txSar.not_ackd, 1, 0, false, false, false,
+																(ml_cwrSent || (meta.cwr && meta.length != 0))));
 					}
 				}
 				else
 				{
 					// code duplication, but better timing..
-					if (usableWindow >= MSS)
+					if (usableWindow >= segmentSize)
 					{
 						// We stay in this state and sent immediately another packet
-						txSar.not_ackd += MSS;
-						meta.length = MSS;
+						txSar.not_ackd += segmentSize;
+						meta.length = segmentSize;
 					}
 					else
 					{
@@ -312,92 +347,161 @@ void metaLoader(stream<extendedEvent>&				eventEng2txEng_event,
 						}
 						// Set probe Timer to try again later
 						txEng2timer_setProbeTimer.write(ml_curEvent.sessionID);
-						txEng2txSar_upd_req.write(txTxSarQuery(ml_curEvent.sessionID, txSar.not_ackd, 1));
+						txEng2ctx_upd_req.write(txTxSarQuery(ml_curEvent.sessionID, txSar.not_ackd, 1, 0, false, false, false,
+																(ml_cwrSent || (meta.cwr && meta.length != 0))));
 						ml_FsmState = 0;
 					}
 				}
 
 				if (meta.length != 0)
 				{
-					txBufferReadCmd.write(mmCmd(pkgAddr, meta.length));
+					txBufferReadCmd.write(mmBufferCmd(mmCmd(pkgAddr, meta.length), txSar.buffer));
 				}
 				// Send a packet only if there is data or we want to send an empty probing message
 				if (meta.length != 0)// || ml_curEvent.retransmit) //TODO retransmit boolean currently not set, should be removed
 				{
-					txEng_ipMetaFifoOut.write(meta.length);
+					// New data is ECN-capable
+					txEng_ipMetaFifoOut.write(ipHeaderMeta(meta.length + meta.tsOptionLength(), rxSar.ecn_ok ? ECN_ECT0 : ECN_NOT_ECT));
 					txEng_tcpMetaFifoOut.write(meta);
 					txEng_isLookUpFifoOut.write(true);
 					txEng2sLookup_rev_req.write(ml_curEvent.sessionID);
+					// Only the first segment after the reduction carries CWR
+					if (meta.cwr)
+					{
+						txSar.cwr_pending = false;
+						ml_cwrSent = true;
+					}
 
 					// Only set RT timer if we actually send sth, TODO only set if we change state and sent sth
-					txEng2timer_setRetransmitTimer.write(txRetransmitTimerSet(ml_curEvent.sessionID));
+					txEng2timer_setRetransmitTimer.write(txRetransmitTimerSet(ml_curEvent.sessionID, RT, txSar.rto, txSar.pto));
 				}//TODO if probe send msg length 1
 				ml_sarLoaded = true;
 			}
 			break;
 #endif
+		case TLP:
 		case RT:
-			if ((!rxSar2txEng_rsp.empty() && !txSar2txEng_upd_rsp.empty()) || ml_sarLoaded)
+			if (!ctx2txEng_upd_rsp.empty() || ml_sarLoaded)
 			{
 				if (!ml_sarLoaded)
 				{
-					rxSar2txEng_rsp.read(rxSar);
-					txSar2txEng_upd_rsp.read(txSar);
+					ctx2txEng_upd_rsp.read(ctxReply);
+					rxSar = ctxReply.rxSar;
+					txSar = ctxReply.txSar;
+				}
+				segmentSize = rxSar.ts_ok ? (ap_uint<16>) (MSS - TS_OPTION_LENGTH) : MSS;
+				// The tail loss probe resends only the last segment, RFC 8985 7.3
+				if (!ml_sarLoaded && ml_curEvent.type == TLP)
+				{
+					tailLength = ((ap_uint<WINDOW_BITS>) txSar.not_ackd - txSar.ackd);
+					if (txSar.finSent)
+					{
+						tailLength--;
+					}
+					if (tailLength > segmentSize)
+					{
+						txSar.ackd += (tailLength - segmentSize);
+					}
 				}
 
 				// Compute our window size
-				windowSize = (rxSar.appd - ((ap_uint<16>)rxSar.recvd)) - 1; // This works even for wrap around
+				windowSize = ((rxSar.appd - ((ap_uint<WINDOW_BITS>)rxSar.recvd)) - 1) & rxSar.buffer.mask(); // This works even for wrap around
 				if (!txSar.finSent) //no FIN sent
 				{
-					currLength = ((ap_uint<16>) txSar.not_ackd - txSar.ackd);
+					currLength = ((ap_uint<WINDOW_BITS>) txSar.not_ackd - txSar.ackd);
 				}
 				else //FIN already sent
 				{
-					currLength = ((ap_uint<16>) txSar.not_ackd - txSar.ackd)-1;
+					currLength = ((ap_uint<WINDOW_BITS>) txSar.not_ackd - txSar.ackd)-1;
 				}
 
 				meta.ackNumb = rxSar.recvd;
 				meta.seqNumb = txSar.ackd;
 				meta.window_size = windowSize;
+				meta.win_shift = rxSar.win_shift;
 				meta.ack = 1; // ACK is always set when session is established
 				meta.rst = 0;
 				meta.syn = 0;
 				meta.fin = 0;
+				meta.ece = (rxSar.ecn_ok && rxSar.ce);
+				meta.cwr = 0;
+				meta.ts_valid = rxSar.ts_ok;
+				meta.ts_val = txSar.ts_clock;
+				meta.ts_ecr = rxSar.ts_recent;
 
 				// Construct address before modifying txSar.ackd
 				ap_uint<32> pkgAddr;
 				pkgAddr(31, 30) = 0x01;
-				pkgAddr(29, 16) = ml_curEvent.sessionID(13, 0);
-				pkgAddr(15, 0) = txSar.ackd(15, 0); //ml_curEvent.address;
+				pkgAddr(29, 0) = txSar.buffer.address(txSar.ackd(WINDOW_BITS-1, 0));
 
-				// Decrease Slow Start Threshold, only on first RT from retransmitTimer
+				// Report the loss with the FlightSize, only on first RT from retransmitTimer.
+				// The congestion control of the session_context_table computes the new window
 				if (!ml_sarLoaded && (ml_curEvent.rt_count == 1))
 				{
-					if (currLength > (4*MSS)) // max( FlightSize/2, 2*MSS) RFC:5681
-					{
-						slowstart_threshold = currLength/2;
-					}
-					else
+					txEng2ctx_upd_req.write(txTxSarRtQuery(ml_curEvent.sessionID, currLength));
+				}
+
+
+				// Check the SACK scoreboard, data the receiver already holds is skipped and a hole
+				// is only resent up to the next SACK block. Blocks behind txSar.ackd never match
+				sackSkip = 0;
+				sackLimit = currLength;
+				for (uint8_t i = 0; i < TCP_SACK_BLOCKS; i++)
+				{
+				#pragma HLS UNROLL
+					ap_uint<WINDOW_BITS> blockLength = txSar.sackBoard.right[i] - txSar.sackBoard.left[i];
+					ap_uint<WINDOW_BITS> blockStart = txSar.sackBoard.left[i] - txSar.ackd(WINDOW_BITS-1, 0);
+					ap_uint<WINDOW_BITS> blockOffset = txSar.ackd(WINDOW_BITS-1, 0) - txSar.sackBoard.left[i];
+					if (i < txSar.sackBoard.count && blockLength != 0)
 					{
-						slowstart_threshold = (2 * MSS);
+						if (blockOffset < blockLength) // txSar.ackd lies inside the block
+						{
+							if ((blockLength - blockOffset) > sackSkip)
+							{
+								sackSkip = blockLength - blockOffset;
+							}
+						}
+						else if (blockStart < sackLimit)
+						{
+							sackLimit = blockStart;
+						}
 					}
-					txEng2txSar_upd_req.write(txTxSarRtQuery(ml_curEvent.sessionID, slowstart_threshold));
 				}
-
+				if (sackSkip > currLength)
+				{
+					sackSkip = currLength;
+				}
 
 				// Since we are retransmitting from txSar.ackd to txSar.not_ackd, this data is already inside the usableWindow
 				// => no check is required
 				// Only check if length is bigger than MMS
-				if (currLength > MSS)
+				if (sackSkip != 0)
+				{
+					// Nothing is sent in this cycle, continue behind the SACK block
+					meta.length = 0;
+					txSar.ackd += sackSkip;
+				}
+				else if (currLength > segmentSize && sackLimit > segmentSize)
 				{
 					// We stay in this state and sent immediately another packet
-					meta.length = MSS;
-					txSar.ackd += MSS;
+					meta.length = segmentSize;
+					txSar.ackd += segmentSize;
 					// TODO replace with dynamic count, remove this
 					if (ml_segmentCount == 3)
 					{
 						// Should set a probe or sth??
-						//txEng2txSar_upd_req.write(txTxSarQuery(ml_curEvent.sessionID, txSar.not_ackd, 1));
+						//txEng2ctx_upd_req.write(txTxSarQuery(ml_curEvent.sessionID, txSar.not_ackd, 1));
+						ml_FsmState = 0;
+					}
+					ml_segmentCount++;
+				}
+				else if (sackLimit < currLength)
+				{
+					// Resend the hole in front of the next SACK block
+					meta.length = sackLimit;
+					txSar.ackd += sackLimit;
+					if (ml_segmentCount == 3)
+					{
 						ml_FsmState = 0;
 					}
 					ml_segmentCount++;
@@ -419,8 +523,9 @@ void metaLoader(stream<extendedEvent>&				eventEng2txEng_event,
 				// Only send a packet if there is data
 				if (meta.length != 0)
 				{
-					txBufferReadCmd.write(mmCmd(pkgAddr, meta.length));
-					txEng_ipMetaFifoOut.write(meta.length);
+					txBufferReadCmd.write(mmBufferCmd(mmCmd(pkgAddr, meta.length), txSar.buffer));
+					// Retransmissions are never ECN-capable, RFC 3168 6.1.5
+					txEng_ipMetaFifoOut.write(ipHeaderMeta(meta.length + meta.tsOptionLength()));
 					txEng_tcpMetaFifoOut.write(meta);
 					txEng_isLookUpFifoOut.write(true);
 #if (TCP_NODELAY)
@@ -429,27 +534,76 @@ void metaLoader(stream<extendedEvent>&				eventEng2txEng_event,
 					txEng2sLookup_rev_req.write(ml_curEvent.sessionID);
 
 					// Only set RT timer if we actually send sth
-					txEng2timer_setRetransmitTimer.write(txRetransmitTimerSet(ml_curEvent.sessionID));
+					txEng2timer_setRetransmitTimer.write(txRetransmitTimerSet(ml_curEvent.sessionID, RT, txSar.rto, txSar.pto));
+					// Fast retransmits of the rx_engine carry a length, only the first unacknowledged segment is resent
+					if (ml_curEvent.length != 0)
+					{
+						ml_FsmState = 0;
+					}
 				}
 				ml_sarLoaded = true;
 			}
 			break;
 		case ACK:
 		case ACK_NODELAY:
-			if (!rxSar2txEng_rsp.empty() && !txSar2txEng_upd_rsp.empty())
+			if (!ctx2txEng_upd_rsp.empty())
 			{
-				rxSar2txEng_rsp.read(rxSar);
-				txSar2txEng_upd_rsp.read(txSar);
-				windowSize = (rxSar.appd - ((ap_uint<16>)rxSar.recvd)) - 1;
+				ctx2txEng_upd_rsp.read(ctxReply);
+				rxSar = ctxReply.rxSar;
+				txSar = ctxReply.txSar;
+				windowSize = ((rxSar.appd - ((ap_uint<WINDOW_BITS>)rxSar.recvd)) - 1) & rxSar.buffer.mask();
 				meta.ackNumb = rxSar.recvd;
 				meta.seqNumb = txSar.not_ackd; //Always send SEQ
 				meta.window_size = windowSize;
+				meta.win_shift = rxSar.win_shift;
+				// Report the out-of-order interval held in the buffer as SACK block, RFC 2018
+				meta.sack_valid = (rxSar.sack_ok && rxSar.ooo_valid);
+				meta.sack_left = rxSar.ooo_head;
+				meta.sack_right = rxSar.ooo_head + rxSar.ooo_length;
+				meta.length = 0;
+				if (meta.sack_valid)
+				{
+					meta.length = 12; // NOP, NOP, Kind, Length, Left Edge, Right Edge
+				}
+				meta.ack = 1;
+				meta.rst = 0;
+				meta.syn = 0;
+				meta.fin = 0;
+				meta.ece = (rxSar.ecn_ok && rxSar.ce);
+				meta.cwr = 0;
+				meta.ts_valid = rxSar.ts_ok;
+				meta.ts_val = txSar.ts_clock;
+				meta.ts_ecr = rxSar.ts_recent;
+				txEng_ipMetaFifoOut.write(ipHeaderMeta(meta.length + meta.tsOptionLength()));
+				txEng_tcpMetaFifoOut.write(meta);
+				txEng_isLookUpFifoOut.write(true);
+				txEng2sLookup_rev_req.write(ml_curEvent.sessionID);
+				ml_FsmState = 0;
+			}
+			break;
+		case KEEP_ALIVE:
+			if (!ctx2txEng_upd_rsp.empty())
+			{
+				ctx2txEng_upd_rsp.read(ctxReply);
+				rxSar = ctxReply.rxSar;
+				txSar = ctxReply.txSar;
+				// Zero-length probe one below the next sequence number, the peer has to answer it with an ACK, RFC 1122 4.2.3.6
+				windowSize = ((rxSar.appd - ((ap_uint<WINDOW_BITS>)rxSar.recvd)) - 1) & rxSar.buffer.mask();
+				meta.ackNumb = rxSar.recvd;
+				meta.seqNumb = txSar.not_ackd - 1;
+				meta.window_size = windowSize;
+				meta.win_shift = rxSar.win_shift;
 				meta.length = 0;
 				meta.ack = 1;
 				meta.rst = 0;
 				meta.syn = 0;
 				meta.fin = 0;
-				txEng_ipMetaFifoOut.write(meta.length);
+				meta.ece = 0;
+				meta.cwr = 0;
+				meta.ts_valid = rxSar.ts_ok;
+				meta.ts_val = txSar.ts_clock;
+				meta.ts_ecr = rxSar.ts_recent;
+				txEng_ipMetaFifoOut.write(ipHeaderMeta(meta.tsOptionLength()));
 				txEng_tcpMetaFifoOut.write(meta);
 				txEng_isLookUpFifoOut.write(true);
 				txEng2sLookup_rev_req.write(ml_curEvent.sessionID);
@@ -457,11 +611,11 @@ void metaLoader(stream<extendedEvent>&				eventEng2txEng_event,
 			}
 			break;
 		case SYN:
-			if (((ml_curEvent.rt_count != 0) && !txSar2txEng_upd_rsp.empty()) || (ml_curEvent.rt_count == 0))
+			if (!ctx2txEng_upd_rsp.empty())
 			{
+				txSar = ctx2txEng_upd_rsp.read().txSar;
 				if (ml_curEvent.rt_count != 0)
 				{
-					txSar2txEng_upd_rsp.read(txSar);
 					meta.seqNumb = txSar.ackd;
 				}
 				else
@@ -469,18 +623,35 @@ void metaLoader(stream<extendedEvent>&				eventEng2txEng_event,
 					txSar.not_ackd = ml_randomValue; // FIXME better rand()
 					ml_randomValue = (ml_randomValue* 8) xor ml_randomValue;
 					meta.seqNumb = txSar.not_ackd;
-					txEng2txSar_upd_req.write(txTxSarQuery(ml_curEvent.sessionID, txSar.not_ackd+1, 1, 1));
+					txEng2ctx_upd_req.write(txTxSarQuery(ml_curEvent.sessionID, txSar.not_ackd+1, 1, 1));
 				}
 				meta.ackNumb = 0;
 				//meta.seqNumb = txSar.not_ackd;
 				meta.window_size = 0xFFFF;
-				meta.length = 4; // For MSS Option, 4 bytes
+				// Window scaling is offered whenever we scale our own window
+				meta.win_shift = WINDOW_SCALE_BITS;
+				meta.sack_ok = TCP_SACK;
+				meta.length = 4; // For MSS Option 4 bytes
+				if (WINDOW_SCALE_BITS != 0)
+				{
+					meta.length += 4; // NOP and Window Scale Option
+				}
+				if (TCP_SACK)
+				{
+					meta.length += 4; // 2 NOPs and SACK-permitted Option
+				}
 				meta.ack = 0;
 				meta.rst = 0;
 				meta.syn = 1;
 				meta.fin = 0;
-
-				txEng_ipMetaFifoOut.write(4); //length
+				// ECN-setup SYN, RFC 3168 6.1.1
+				meta.ece = TCP_ECN;
+				meta.cwr = TCP_ECN;
+				meta.ts_valid = TCP_TIMESTAMPS;
+				meta.ts_val = txSar.ts_clock;
+				meta.ts_ecr = 0;
+
+				txEng_ipMetaFifoOut.write(ipHeaderMeta(meta.length + meta.tsOptionLength())); //length
 				txEng_tcpMetaFifoOut.write(meta);
 				txEng_isLookUpFifoOut.write(true);
 				txEng2sLookup_rev_req.write(ml_curEvent.sessionID);
@@ -490,19 +661,38 @@ void metaLoader(stream<extendedEvent>&				eventEng2txEng_event,
 			}
 			break;
 		case SYN_ACK:
-			if (!rxSar2txEng_rsp.empty() && !txSar2txEng_upd_rsp.empty())
+			if (!ctx2txEng_upd_rsp.empty())
 			{
-				rxSar2txEng_rsp.read(rxSar);
-				txSar2txEng_upd_rsp.read(txSar);
+				ctx2txEng_upd_rsp.read(ctxReply);
+				rxSar = ctxReply.rxSar;
+				txSar = ctxReply.txSar;
 
 				// construct SYN_ACK message
 				meta.ackNumb = rxSar.recvd;
-				meta.window_size = 0xFFFF;
-				meta.length = 4; // For MSS Option, 4 bytes
+				// The RX buffer was assigned when the SYN was received
+				meta.window_size = rxSar.buffer.mask();
+				// Window scaling and SACK are only answered if the SYN offered them, RFC 7323 1.3
+				meta.win_shift = rxSar.win_shift;
+				meta.sack_ok = rxSar.sack_ok;
+				meta.length = 4; // For MSS Option 4 bytes
+				if (rxSar.win_shift != 0)
+				{
+					meta.length += 4; // NOP and Window Scale Option
+				}
+				if (rxSar.sack_ok)
+				{
+					meta.length += 4; // 2 NOPs and SACK-permitted Option
+				}
 				meta.ack = 1;
 				meta.rst = 0;
 				meta.syn = 1;
 				meta.fin = 0;
+				meta.ece = rxSar.ecn_ok; // ECN-setup SYN-ACK
+				meta.cwr = 0;
+				// Timestamps are only answered if the SYN offered them
+				meta.ts_valid = rxSar.ts_ok;
+				meta.ts_val = txSar.ts_clock;
+				meta.ts_ecr = rxSar.ts_recent;
 				if (ml_curEvent.rt_count != 0)
 				{
 					meta.seqNumb = txSar.ackd;
@@ -512,10 +702,13 @@ void metaLoader(stream<extendedEvent>&				eventEng2txEng_event,
 					txSar.not_ackd = ml_randomValue; // FIXME better rand();
 					ml_randomValue = (ml_randomValue* 8) xor ml_randomValue;
 					meta.seqNumb = txSar.not_ackd;
-					txEng2txSar_upd_req.write(txTxSarQuery(ml_curEvent.sessionID, txSar.not_ackd+1, 1, 1));
+					txTxSarQuery initQuery(ml_curEvent.sessionID, txSar.not_ackd+1, 1, 1);
+					// The TX buffer takes the class of the RX buffer, which the listening port chose
+					initQuery.bufferClass = rxSar.buffer.sizeClass;
+					txEng2ctx_upd_req.write(initQuery);
 				}
 
-				txEng_ipMetaFifoOut.write(4); // length
+				txEng_ipMetaFifoOut.write(ipHeaderMeta(meta.length + meta.tsOptionLength())); // length
 				txEng_tcpMetaFifoOut.write(meta);
 				txEng_isLookUpFifoOut.write(true);
 				txEng2sLookup_rev_req.write(ml_curEvent.sessionID);
@@ -526,24 +719,31 @@ void metaLoader(stream<extendedEvent>&				eventEng2txEng_event,
 			}
 			break;
 		case FIN:
-			if ((!rxSar2txEng_rsp.empty() && !txSar2txEng_upd_rsp.empty()) || ml_sarLoaded)
+			if (!ctx2txEng_upd_rsp.empty() || ml_sarLoaded)
 			{
 				if (!ml_sarLoaded)
 				{
-					rxSar2txEng_rsp.read(rxSar);
-					txSar2txEng_upd_rsp.read(txSar);
+					ctx2txEng_upd_rsp.read(ctxReply);
+					rxSar = ctxReply.rxSar;
+					txSar = ctxReply.txSar;
 				}
 
 				//construct FIN message
-				windowSize = (rxSar.appd - ((ap_uint<16>)rxSar.recvd)) - 1;
+				windowSize = ((rxSar.appd - ((ap_uint<WINDOW_BITS>)rxSar.recvd)) - 1) & rxSar.buffer.mask();
 				meta.ackNumb = rxSar.recvd;
 				//meta.seqNumb = txSar.not_ackd;
 				meta.window_size = windowSize;
+				meta.win_shift = rxSar.win_shift;
 				meta.length = 0;
 				meta.ack = 1; // has to be set for FIN message as well
 				meta.rst = 0;
 				meta.syn = 0;
 				meta.fin = 1;
+				meta.ece = (rxSar.ecn_ok && rxSar.ce);
+				meta.cwr = 0;
+				meta.ts_valid = rxSar.ts_ok;
+				meta.ts_val = txSar.ts_clock;
+				meta.ts_ecr = rxSar.ts_recent;
 
 				// Check if retransmission, in case of RT, we have to reuse not_ackd number
 				if (ml_curEvent.rt_count != 0)
@@ -555,46 +755,80 @@ void metaLoader(stream<extendedEvent>&				eventEng2txEng_event,
 					meta.seqNumb = txSar.not_ackd;
 					// Check if all data is sent, otherwise we have to delay FIN message
 					// Set fin flag, such that probeTimer is informed
-					if (txSar.app == txSar.not_ackd(15, 0))
+					if (txSar.app == txSar.not_ackd(WINDOW_BITS-1, 0))
 					{
-						txEng2txSar_upd_req.write(txTxSarQuery(ml_curEvent.sessionID, txSar.not_ackd+1, 1, 0, true, true));
+						txEng2ctx_upd_req.write(txTxSarQuery(ml_curEvent.sessionID, txSar.not_ackd+1, 1, 0, true, true));
 					}
 					else
 					{
-						txEng2txSar_upd_req.write(txTxSarQuery(ml_curEvent.sessionID, txSar.not_ackd, 1, 0, true, false));
+						txEng2ctx_upd_req.write(txTxSarQuery(ml_curEvent.sessionID, txSar.not_ackd, 1, 0, true, false));
 					}
 				}
 
 				// Check if there is a FIN to be sent //TODO maybe restruce this
-				if (meta.seqNumb(15, 0) == txSar.app)
+				if (meta.seqNumb(WINDOW_BITS-1, 0) == txSar.app)
 				{
-					txEng_ipMetaFifoOut.write(meta.length);
+					txEng_ipMetaFifoOut.write(ipHeaderMeta(meta.length + meta.tsOptionLength()));
 					txEng_tcpMetaFifoOut.write(meta);
 					txEng_isLookUpFifoOut.write(true);
 					txEng2sLookup_rev_req.write(ml_curEvent.sessionID);
 					// set retransmit timer
 					//txEng2timer_setRetransmitTimer.write(txRetransmitTimerSet(ml_curEvent.sessionID, FIN));
-					txEng2timer_setRetransmitTimer.write(txRetransmitTimerSet(ml_curEvent.sessionID));
+					txEng2timer_setRetransmitTimer.write(txRetransmitTimerSet(ml_curEvent.sessionID, RT, txSar.rto, txSar.pto));
 				}
 
 				ml_FsmState = 0;
 			}
 			break;
+		case TIME_WAIT_ACK:
+			// The session is already released, the numbers come from the TIME-WAIT record
+			waitEvent = ml_curEvent;
+			txEng_ipMetaFifoOut.write(ipHeaderMeta(0));
+			txEng_tcpMetaFifoOut.write(tx_engine_meta(ml_curEvent.seqNumb, waitEvent.getAckNumb(), 1, 0, 0, 0));
+			txEng_isLookUpFifoOut.write(false);
+			txEng_tupleShortCutFifoOut.write(ml_curEvent.tuple);
+			ml_FsmState = 0;
+			break;
+#if (TCP_SYN_COOKIES)
+		case SYN_COOKIE:
+			// The ISN is the cookie, only the MSS option is sent since the session does not keep the options of the SYN
+			cookieEvent = ml_curEvent;
+			meta.seqNumb = synCookieGenerate(ml_curEvent.tuple.dstIp, ml_curEvent.tuple.dstPort, ml_curEvent.tuple.srcIp, ml_curEvent.tuple.srcPort,
+												cookieEvent.getAckNumb()-1, cookieEvent.getPeriod());
+			meta.ackNumb = cookieEvent.getAckNumb();
+			// The session gets a buffer of the accept class once the cookie returns
+			meta.window_size = (((ap_uint<WINDOW_BITS+1>) 1) << BUFFER_CLASS_BITS[TCP_BUFFER_CLASS_ACCEPT]) - 1;
+			meta.win_shift = 0;
+			meta.sack_ok = false;
+			meta.length = 4; // For MSS Option 4 bytes
+			meta.ack = 1;
+			meta.rst = 0;
+			meta.syn = 1;
+			meta.fin = 0;
+			meta.ece = 0;
+			meta.cwr = 0;
+			txEng_ipMetaFifoOut.write(ipHeaderMeta(meta.length));
+			txEng_tcpMetaFifoOut.write(meta);
+			txEng_isLookUpFifoOut.write(false);
+			txEng_tupleShortCutFifoOut.write(ml_curEvent.tuple);
+			ml_FsmState = 0;
+			break;
+#endif
 		case RST:
 			// Assumption RST length == 0
 			resetEvent = ml_curEvent;
 			if (!resetEvent.hasSessionID())
 			{
-				txEng_ipMetaFifoOut.write(0);
+				txEng_ipMetaFifoOut.write(ipHeaderMeta(0));
 				txEng_tcpMetaFifoOut.write(tx_engine_meta(0, resetEvent.getAckNumb(), 1, 1, 0, 0));
 				txEng_isLookUpFifoOut.write(false);
 				txEng_tupleShortCutFifoOut.write(ml_curEvent.tuple);
 				ml_FsmState = 0;
 			}
-			else if (!txSar2txEng_upd_rsp.empty())
+			else if (!ctx2txEng_upd_rsp.empty())
 			{
-				txSar2txEng_upd_rsp.read(txSar);
-				txEng_ipMetaFifoOut.write(0);
+				txSar = ctx2txEng_upd_rsp.read().txSar;
+				txEng_ipMetaFifoOut.write(ipHeaderMeta(0));
 				txEng_isLookUpFifoOut.write(true);
 				txEng2sLookup_rev_req.write(resetEvent.sessionID); //there is no sessionID??
 				//if (resetEvent.getAckNumb() != 0)
@@ -608,13 +842,17 @@ void metaLoader(stream<extendedEvent>&				eventEng2txEng_event,
 					ml_FsmState = 0;
 			}
 			break;
+		default:
+			// Without TCP_SYN_COOKIES no SYN_COOKIE events are generated, nothing else ends up here
+			ml_FsmState = 0;
+			break;
 		} //switch
 		break;
 	} //switch
 }
 
 /** @ingroup tx_engine
- *  Forwards the incoming tuple from the SmartCam or RX Engine to the 2 header construction modules
+ *  Forwards the incoming tuple from the Session Lookup Controller or RX Engine to the 2 header construction modules
  *  @param[in]	sLookup2txEng_rev_rsp
  *  @param[in]	txEng_tupleShortCutFifoIn
  *  @param[in]	txEng_isLookUpFifoIn
@@ -667,7 +905,7 @@ void tupleSplitter(	stream<fourTuple>&		sLookup2txEng_rev_rsp,
  *  @param[in]		txEng_ipTupleFifoIn
  *  @param[out]		txEng_ipHeaderBufferOut
  */
-void ipHeaderConstruction(stream<ap_uint<16> >&				txEng_ipMetaDataFifoIn,
+void ipHeaderConstruction(stream<ipHeaderMeta>&				txEng_ipMetaDataFifoIn,
 							stream<twoTuple>&				txEng_ipTupleFifoIn,
 							stream<axiWord>&				txEng_ipHeaderBufferOut)
 {
@@ -678,6 +916,7 @@ void ipHeaderConstruction(stream<ap_uint<16> >&				txEng_ipMetaDataFifoIn,
 	static twoTuple ihc_tuple;
 
 	axiWord sendWord;
+	ipHeaderMeta meta;
 	ap_uint<16> length = 0;
 
 	switch(ihc_currWord)
@@ -685,10 +924,11 @@ void ipHeaderConstruction(stream<ap_uint<16> >&				txEng_ipMetaDataFifoIn,
 	case WORD_0:
 		if (!txEng_ipMetaDataFifoIn.empty())
 		{
-			txEng_ipMetaDataFifoIn.read(length);
+			txEng_ipMetaDataFifoIn.read(meta);
 			sendWord.data.range(7, 0) = 0x45;
-			sendWord.data.range(15, 8) = 0;
-			length = length + 40;
+			sendWord.data.range(9, 8) = meta.ecn; // ECN field of the TOS byte
+			sendWord.data.range(15, 10) = 0;
+			length = meta.length + 40;
 			sendWord.data.range(23, 16) = length(15, 8); //length
 			sendWord.data.range(31, 24) = length(7, 0);
 			sendWord.data.range(47, 32) = 0;
@@ -745,6 +985,8 @@ void pseudoHeaderConstruction(stream<tx_engine_meta>&		tcpMetaDataFifoIn,
 	static fourTuple phc_tuple;
 	//static bool phc_done = true;
 	ap_uint<16> length = 0;
+	ap_uint<4> dataOffset;
+	ap_uint<WINDOW_BITS> windowSize;
 
 	/*if (phc_done && !tcpMetaDataFifoIn.empty())
 	{
@@ -776,7 +1018,7 @@ void pseudoHeaderConstruction(stream<tx_engine_meta>&		tcpMetaDataFifoIn,
 		case WORD_1:
 			sendWord.data.range(7, 0) = 0x00;
 			sendWord.data.range(15, 8) = 0x06; // TCP
-			length = phc_meta.length + 0x14;  // 20 bytes for the header
+			length = phc_meta.length + 0x14 + phc_meta.tsOptionLength();  // 20 bytes for the header
 			sendWord.data.range(23, 16) = length(15, 8);
 			sendWord.data.range(31, 24) = length(7, 0);
 			sendWord.data.range(47, 32) = phc_tuple.srcPort; // srcPort
@@ -804,7 +1046,16 @@ void pseudoHeaderConstruction(stream<tx_engine_meta>&		tcpMetaDataFifoIn,
 			break;
 		case WORD_3:
 			sendWord.data(3,1) = 0; // reserved
-			sendWord.data(7, 4) = (0x5 + phc_meta.syn); //data offset
+			dataOffset = 0x5;
+			if (phc_meta.syn || phc_meta.sack_valid)
+			{
+				dataOffset += phc_meta.length(5, 2); // options are the only payload of a SYN or SACK
+			}
+			if (phc_meta.ts_valid)
+			{
+				dataOffset += TS_OPTION_LENGTH(5, 2);
+			}
+			sendWord.data(7, 4) = dataOffset;
 			/* Control bits:
 			 * [8] == FIN
 			 * [9] == SYN
@@ -812,6 +1063,8 @@ void pseudoHeaderConstruction(stream<tx_engine_meta>&		tcpMetaDataFifoIn,
 			 * [11] == PSH
 			 * [12] == ACK
 			 * [13] == URG
+			 * [14] == ECE
+			 * [15] == CWR
 			 */
 			sendWord.data[0] = 0; //NS bit
 			sendWord.data[8] = phc_meta.fin; //control bits
@@ -819,15 +1072,31 @@ void pseudoHeaderConstruction(stream<tx_engine_meta>&		tcpMetaDataFifoIn,
 			sendWord.data[10] = phc_meta.rst;
 			sendWord.data[11] = 0;
 			sendWord.data[12] = phc_meta.ack;
-			sendWord.data(15, 13) = 0; //some other bits
+			sendWord.data[13] = 0; //URG
+			sendWord.data[14] = phc_meta.ece;
+			sendWord.data[15] = phc_meta.cwr;
+			// The window of a SYN is never scaled, RFC 7323 2.2
+			windowSize = phc_meta.window_size;
+			if (!phc_meta.syn)
+			{
+				windowSize = phc_meta.window_size >> phc_meta.win_shift;
+			}
+			if (windowSize > 0xFFFF)
+			{
+				windowSize = 0xFFFF;
+			}
 			//sendWord.data.range(31, 16) = phc_meta.window_size; //check if at least half the size FIXME
-			sendWord.data.range(23, 16) = phc_meta.window_size(15, 8);
-			sendWord.data.range(31, 24) = phc_meta.window_size(7, 0);
+			sendWord.data.range(23, 16) = windowSize(15, 8);
+			sendWord.data.range(31, 24) = windowSize(7, 0);
 			sendWord.data.range(63, 32) = 0; //urgPointer & checksum
 			sendWord.keep = 0xFF;
-			sendWord.last = (phc_meta.length == 0);
+			sendWord.last = (phc_meta.length == 0 && !phc_meta.ts_valid);
 			dataOut.write(sendWord);
-			if (!phc_meta.syn)
+			if (phc_meta.ts_valid)
+			{
+				phc_currWord = WORD_6;
+			}
+			else if (!phc_meta.syn && !phc_meta.sack_valid)
 			{
 				phc_currWord = 0;
 			}
@@ -837,16 +1106,101 @@ void pseudoHeaderConstruction(stream<tx_engine_meta>&		tcpMetaDataFifoIn,
 			}
 			//phc_done = true;
 			break;
-		case WORD_4: // Only used for SYN and MSS negotiation
+		case WORD_4: // SYN: MSS, Window Scale and SACK-permitted negotiation, ACK: SACK block
+			if (!phc_meta.syn)
+			{
+				sendWord.data(15, 0) = 0x0101; // NOP, NOP
+				sendWord.data(23, 16) = 0x05; // Option Kind
+				sendWord.data(31, 24) = 0x0A; // Option length, one block
+				sendWord.data(39, 32) = phc_meta.sack_left(31, 24);
+				sendWord.data(47, 40) = phc_meta.sack_left(23, 16);
+				sendWord.data(55, 48) = phc_meta.sack_left(15, 8);
+				sendWord.data(63, 56) = phc_meta.sack_left(7, 0);
+				sendWord.keep = 0xFF;
+				sendWord.last = 0;
+				dataOut.write(sendWord);
+				phc_currWord++;
+				break;
+			}
 			sendWord.data(7, 0) = 0x02; // Option Kind
 			sendWord.data(15, 8) = 0x04; // Option length
 			sendWord.data(31, 16) = 0xB405; // 0x05B4 = 1460
 			sendWord.data(63, 32) = 0;
 			sendWord.keep = 0x0F;
-			sendWord.last = 1;//(phc_meta.length == 0x04); //OR JUST SET TO 1
+			if (phc_meta.win_shift != 0)
+			{
+				sendWord.data(39, 32) = 0x01; // NOP
+				sendWord.data(47, 40) = 0x03; // Option Kind
+				sendWord.data(55, 48) = 0x03; // Option length
+				sendWord.data(63, 56) = phc_meta.win_shift;
+				sendWord.keep = 0xFF;
+			}
+			else if (phc_meta.sack_ok)
+			{
+				sendWord.data(47, 32) = 0x0101; // NOP, NOP
+				sendWord.data(55, 48) = 0x04; // Option Kind
+				sendWord.data(63, 56) = 0x02; // Option length
+				sendWord.keep = 0xFF;
+			}
+			sendWord.last = (phc_meta.length <= 8);
+			dataOut.write(sendWord);
+			if (sendWord.last)
+			{
+				phc_currWord = 0;
+			}
+			else
+			{
+				phc_currWord++;
+			}
+			break;
+		case WORD_5: // SACK-permitted if Window Scale is present too, right edge of the SACK block
+			sendWord.data(15, 0) = 0x0101; // NOP, NOP
+			sendWord.data(23, 16) = 0x04; // Option Kind
+			sendWord.data(31, 24) = 0x02; // Option length
+			if (!phc_meta.syn)
+			{
+				sendWord.data(7, 0) = phc_meta.sack_right(31, 24);
+				sendWord.data(15, 8) = phc_meta.sack_right(23, 16);
+				sendWord.data(23, 16) = phc_meta.sack_right(15, 8);
+				sendWord.data(31, 24) = phc_meta.sack_right(7, 0);
+			}
+			sendWord.data(63, 32) = 0;
+			sendWord.keep = 0x0F;
+			sendWord.last = 1;
 			dataOut.write(sendWord);
 			phc_currWord = 0;
 			break;
+		case WORD_6: // Timestamps option, RFC 7323 3, in front of the SYN and SACK options
+			sendWord.data(15, 0) = 0x0101; // NOP, NOP
+			sendWord.data(23, 16) = 0x08; // Option Kind
+			sendWord.data(31, 24) = 0x0A; // Option length
+			sendWord.data(39, 32) = phc_meta.ts_val(31, 24);
+			sendWord.data(47, 40) = phc_meta.ts_val(23, 16);
+			sendWord.data(55, 48) = phc_meta.ts_val(15, 8);
+			sendWord.data(63, 56) = phc_meta.ts_val(7, 0);
+			sendWord.keep = 0xFF;
+			sendWord.last = 0;
+			dataOut.write(sendWord);
+			phc_currWord++;
+			break;
+		case WORD_7:
+			sendWord.data(7, 0) = phc_meta.ts_ecr(31, 24);
+			sendWord.data(15, 8) = phc_meta.ts_ecr(23, 16);
+			sendWord.data(23, 16) = phc_meta.ts_ecr(15, 8);
+			sendWord.data(31, 24) = phc_meta.ts_ecr(7, 0);
+			sendWord.data(63, 32) = 0x01010101; // NOP padding
+			sendWord.keep = 0xFF;
+			sendWord.last = (phc_meta.length == 0);
+			dataOut.write(sendWord);
+			if (phc_meta.syn || phc_meta.sack_valid)
+			{
+				phc_currWord = WORD_4;
+			}
+			else
+			{
+				phc_currWord = 0;
+			}
+			break;
 		} //switch
 	//} //else
 }
@@ -875,6 +1229,7 @@ void tcpPkgStitcher(stream<axiWord>&		txEng_tcpHeaderBufferIn,
 	static ap_uint<1> 	txPkgStitcherAccBreakDown = 0;
 	static ap_uint<4> 	shiftBuffer = 0;
 	static bool 		txEngBrkDownReadIn = false;
+	static ap_uint<3>	tps_optionWords = 0;
 
 	bool isShortCutData = false;
 
@@ -887,8 +1242,10 @@ void tcpPkgStitcher(stream<axiWord>&		txEng_tcpHeaderBufferIn,
 			txEng_tcpSegOut.write(currWord);
 			txEngBrkDownReadIn = false;
 			if (ps_wordCount == 3) {
-				if (currWord.data[9] == 1) // is a SYN packet
+				if (currWord.data[9] == 1 || currWord.data(7, 4) > 5) // is a SYN packet or carries options
 				{
+					// Option bytes rounded up to full words
+					tps_optionWords = (currWord.data(7, 4) - 4) >> 1;
 					tps_state = 1;
 				}
 				else
@@ -911,16 +1268,24 @@ void tcpPkgStitcher(stream<axiWord>&		txEng_tcpHeaderBufferIn,
 			}
 		}
 		break;
-	case 1: // Read one more word for MSS Option
+	case 1: // Read the options, MSS, Window Scale and SACK-permitted of a SYN, the SACK block of an ACK or the Timestamps
 		if (!txEng_tcpHeaderBufferIn.empty())
 		{
 			txEng_tcpHeaderBufferIn.read(currWord);
 			txEng_tcpSegOut.write(currWord);
-			tps_state = 7;
+			tps_optionWords--;
 			if (currWord.last)
 			{
 				tps_state = 0;
 			}
+			else if (tps_optionWords == 0) // Only the Timestamps precede payload
+			{
+#if (TCP_NODELAY)
+				tps_state = 7;
+#else
+				tps_state = 2;
+#endif
+			}
 			ps_wordCount = 0;
 		}
 		break;
@@ -1238,7 +1603,7 @@ void pkgStitcher(	stream<axiWord>& 		txEng_ipHeaderBufferIn,
 
 }
 
-void txEngMemAccessBreakdown(stream<mmCmd> &inputMemAccess, stream<mmCmd> &outputMemAccess, stream<ap_uint<1> > &memAccessBreakdown2txPkgStitcher) {
+void txEngMemAccessBreakdown(stream<mmBufferCmd> &inputMemAccess, stream<mmCmd> &outputMemAccess, stream<ap_uint<1> > &memAccessBreakdown2txPkgStitcher) {
 #pragma HLS pipeline II=1
 #pragma HLS INLINE off
 	static bool txEngBreakdown = false;
@@ -1248,11 +1613,15 @@ void txEngMemAccessBreakdown(stream<mmCmd> &inputMemAccess, stream<mmCmd> &outpu
 
 	if (txEngBreakdown == false) {
 		if (!inputMemAccess.empty() && !outputMemAccess.full()) {
-			txEngTempCmd = inputMemAccess.read();
+			mmBufferCmd bufferCmd = inputMemAccess.read();
+			txEngTempCmd = bufferCmd.cmd;
 			mmCmd tempCmd = txEngTempCmd;
-			if ((txEngTempCmd.saddr.range(15, 0) + txEngTempCmd.bbt) > 65536) {
-				txEngBreakTemp = 65536 - txEngTempCmd.saddr;
+			// The session buffer is aligned to its size, the lower bits of the address are the offset into it
+			ap_uint<WINDOW_BITS> offset = txEngTempCmd.saddr.range(WINDOW_BITS-1, 0) & bufferCmd.buffer.mask();
+			if ((offset + txEngTempCmd.bbt) > bufferCmd.buffer.size()) {
+				txEngBreakTemp = bufferCmd.buffer.size() - offset;
 				tempCmd = mmCmd(txEngTempCmd.saddr, txEngBreakTemp);
+				txEngTempCmd.saddr -= offset;
 				txEngBreakdown = true;
 			}
 			outputMemAccess.write(tempCmd);
@@ -1263,7 +1632,6 @@ void txEngMemAccessBreakdown(stream<mmCmd> &inputMemAccess, stream<mmCmd> &outpu
 	}
 	else if (txEngBreakdown == true) {
 		if (!outputMemAccess.full()) {
-			txEngTempCmd.saddr.range(15, 0) = 0;
 			//std::cerr << std::dec << "MemCmd: " << cycleCounter << " - " << std::hex << " - " << txEngTempCmd.saddr << " - " << txEngTempCmd.bbt - txEngBreakTemp << std::endl;
 			outputMemAccess.write(mmCmd(txEngTempCmd.saddr, txEngTempCmd.bbt - txEngBreakTemp));
 			txEngBreakdown = false;
@@ -1273,12 +1641,10 @@ void txEngMemAccessBreakdown(stream<mmCmd> &inputMemAccess, stream<mmCmd> &outpu
 
 /** @ingroup tx_engine
  *  @param[in]		eventEng2txEng_event
- *  @param[in]		rxSar2txEng_upd_rsp
- *  @param[in]		txSar2txEng_upd_rsp
+ *  @param[in]		ctx2txEng_upd_rsp
  *  @param[in]		txBufferReadData
  *  @param[in]		sLookup2txEng_rev_rsp
- *  @param[out]		txEng2rxSar_upd_req
- *  @param[out]		txEng2txSar_upd_req
+ *  @param[out]		txEng2ctx_upd_req
  *  @param[out]		txEng2timer_setRetransmitTimer
  *  @param[out]		txEng2timer_setProbeTimer
  *  @param[out]		txBufferReadCmd
@@ -1286,15 +1652,13 @@ void txEngMemAccessBreakdown(stream<mmCmd> &inputMemAccess, stream<mmCmd> &outpu
  *  @param[out]		ipTxData
  */
 void tx_engine(	stream<extendedEvent>&			eventEng2txEng_event,
-				stream<rxSarEntry>&				rxSar2txEng_rsp,
-				stream<txTxSarReply>&			txSar2txEng_upd_rsp,
+				stream<txSessionCtxReply>&		ctx2txEng_upd_rsp,
 				stream<axiWord>&				txBufferReadData,
 #if (TCP_NODELAY)
 				stream<axiWord>&				txApp2txEng_data_stream,
 #endif
 				stream<fourTuple>&				sLookup2txEng_rev_rsp,
-				stream<ap_uint<16> >&			txEng2rxSar_req,
-				stream<txTxSarQuery>&			txEng2txSar_upd_req,
+				stream<txTxSarQuery>&			txEng2ctx_upd_req,
 				stream<txRetransmitTimerSet>&	txEng2timer_setRetransmitTimer,
 				stream<ap_uint<16> >&			txEng2timer_setProbeTimer,
 				stream<mmCmd>&					txBufferReadCmd,
@@ -1309,13 +1673,13 @@ void tx_engine(	stream<extendedEvent>&			eventEng2txEng_event,
 
 	// Memory Read delay around 76 cycles, 10 cycles/packet, so keep meta of at least 8 packets
 	static stream<tx_engine_meta>		txEng_metaDataFifo("txEng_metaDataFifo");
-	static stream<ap_uint<16> >			txEng_ipMetaFifo("txEng_ipMetaFifo");
+	static stream<ipHeaderMeta>			txEng_ipMetaFifo("txEng_ipMetaFifo");
 	static stream<tx_engine_meta>		txEng_tcpMetaFifo("txEng_tcpMetaFifo");
 	#pragma HLS stream variable=txEng_metaDataFifo depth=16
 	#pragma HLS stream variable=txEng_ipMetaFifo depth=16
 	#pragma HLS stream variable=txEng_tcpMetaFifo depth=16
 	#pragma HLS DATA_PACK variable=txEng_metaDataFifo
-	//#pragma HLS DATA_PACK variable=txEng_ipMetaFifo
+	#pragma HLS DATA_PACK variable=txEng_ipMetaFifo
 	#pragma HLS DATA_PACK variable=txEng_tcpMetaFifo
 
 	static stream<axiWord>		txEng_ipHeaderBuffer("txEng_ipHeaderBuffer");
@@ -1349,7 +1713,7 @@ void tx_engine(	stream<extendedEvent>&			eventEng2txEng_event,
 	#pragma HLS DATA_PACK variable=txEng_ipTupleFifo
 	#pragma HLS DATA_PACK variable=txEng_tcpTupleFifo
 
-	static stream<mmCmd> txMetaloader2memAccessBreakdown("txMetaloader2memAccessBreakdown");
+	static stream<mmBufferCmd> txMetaloader2memAccessBreakdown("txMetaloader2memAccessBreakdown");
 	#pragma HLS stream variable=txMetaloader2memAccessBreakdown depth=32
 	#pragma HLS DATA_PACK variable=txMetaloader2memAccessBreakdown
 	static stream<ap_uint<1> > memAccessBreakdown2txPkgStitcher("memAccessBreakdown2txPkgStitcher");
@@ -1360,10 +1724,8 @@ void tx_engine(	stream<extendedEvent>&			eventEng2txEng_event,
 
 
 	metaLoader(	eventEng2txEng_event,
-				rxSar2txEng_rsp,
-				txSar2txEng_upd_rsp,
-				txEng2rxSar_req,
-				txEng2txSar_upd_req,
+				ctx2txEng_upd_rsp,
+				txEng2ctx_upd_req,
 				txEng2timer_setRetransmitTimer,
 				txEng2timer_setProbeTimer,
 				txEng_ipMetaFifo,
@@ -28,9 +28,16 @@ EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.// Copyright (c) 2015 Xilinx,
 ************************************************/
 
 #include "../toe.hpp"
+#include "../syn_cookie/syn_cookie.hpp"
 
 using namespace hls;
 
+/** @ingroup tx_engine
+ *  Length of the Timestamps option, RFC 7323 3. NOP, NOP, Kind, Length, TSval and TSecr are padded
+ *  with four NOPs, this way the payload behind the header stays 8 byte aligned
+ */
+static const ap_uint<16> TS_OPTION_LENGTH = 16;
+
 /** @ingroup tx_engine
  *
  */
@@ -38,17 +45,52 @@ struct tx_engine_meta //same as rxEngine
 {
 	ap_uint<32> seqNumb;
 	ap_uint<32> ackNumb;
-	ap_uint<16> window_size;
+	ap_uint<WINDOW_BITS> window_size;
+	ap_uint<4>	win_shift;	// Applied to window_size, on a SYN it is announced in the window scale option
+	bool		sack_ok;	// On a SYN SACK-permitted is announced
+	bool		sack_valid;	// On an ACK a SACK block for [sack_left, sack_right) is appended
+	ap_uint<32>	sack_left;
+	ap_uint<32>	sack_right;
+	bool		ts_valid;	// The Timestamps option is inserted in front of all other options
+	ap_uint<32>	ts_val;
+	ap_uint<32>	ts_ecr;
 	ap_uint<16> length;
 	ap_uint<1>	ack;
 	ap_uint<1>	rst;
 	ap_uint<1>	syn;
 	ap_uint<1>	fin;
+	ap_uint<1>	ece;
+	ap_uint<1>	cwr;
 	tx_engine_meta() {}
 	tx_engine_meta(ap_uint<1> ack, ap_uint<1> rst, ap_uint<1> syn, ap_uint<1> fin)
-			:seqNumb(0), ackNumb(0), window_size(0), length(0), ack(ack), rst(rst), syn(syn), fin(fin) {}
+			:seqNumb(0), ackNumb(0), window_size(0), win_shift(0), sack_ok(false), sack_valid(false), sack_left(0), sack_right(0), ts_valid(false), ts_val(0), ts_ecr(0), length(0), ack(ack), rst(rst), syn(syn), fin(fin), ece(0), cwr(0) {}
 	tx_engine_meta(ap_uint<32> seqNumb, ap_uint<32> ackNumb, ap_uint<1> ack, ap_uint<1> rst, ap_uint<1> syn, ap_uint<1> fin)
-			:seqNumb(seqNumb), ackNumb(ackNumb), window_size(0), length(0), ack(ack), rst(rst), syn(syn), fin(fin) {}
+			:seqNumb(seqNumb), ackNumb(ackNumb), window_size(0), win_shift(0), sack_ok(false), sack_valid(false), sack_left(0), sack_right(0), ts_valid(false), ts_val(0), ts_ecr(0), length(0), ack(ack), rst(rst), syn(syn), fin(fin), ece(0), cwr(0) {}
+	// Option bytes of the segment not counted in length, only SYN and SACK options are part of it
+	ap_uint<16> tsOptionLength()
+	{
+		return ts_valid ? TS_OPTION_LENGTH : (ap_uint<16>) 0;
+	}
+};
+
+/** @ingroup tx_engine
+ *  ECN field of the IP header, RFC 3168 5
+ */
+static const ap_uint<2> ECN_NOT_ECT = 0x0;
+static const ap_uint<2> ECN_ECT0 = 0x2;
+
+/** @ingroup tx_engine
+ *  Payload length and ECN field of the IP header
+ */
+struct ipHeaderMeta
+{
+	ap_uint<16>	length;
+	ap_uint<2>	ecn;
+	ipHeaderMeta() {}
+	ipHeaderMeta(ap_uint<16> length)
+			:length(length), ecn(ECN_NOT_ECT) {}
+	ipHeaderMeta(ap_uint<16> length, ap_uint<2> ecn)
+			:length(length), ecn(ecn) {}
 };
 
 /** @ingroup tx_engine
@@ -89,15 +131,13 @@ struct twoTuple
  *  complete packet is then streamed out of the @ref tx_engine.
  */
 void tx_engine(	stream<extendedEvent>&			eventEng2txEng_event,
-				stream<rxSarEntry>&				rxSar2txEng_upd_rsp,
-				stream<txTxSarReply>&			txSar2txEng_upd_rsp,
+				stream<txSessionCtxReply>&		ctx2txEng_upd_rsp,
 				stream<axiWord>&				txBufferReadData,
 #if (TCP_NODELAY)
 				stream<axiWord>&				txApp2txEng_data_stream,
 #endif
 				stream<fourTuple>&				sLookup2txEng_rev_rsp,
-				stream<ap_uint<16> >&			txEng2rxSar_upd_req,
-				stream<txTxSarQuery>&			txEng2txSar_upd_req,
+				stream<txTxSarQuery>&			txEng2ctx_upd_req,
 				stream<txRetransmitTimerSet>&	txEng2timer_setRetransmitTimer,
 				stream<ap_uint<16> >&			txEng2timer_setProbeTimer,
 				stream<mmCmd>&					txBufferReadCmd,
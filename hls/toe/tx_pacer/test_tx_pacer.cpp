@@ -0,0 +1,188 @@
+/************************************************
+Copyright (c) 2016, Xilinx, Inc.
+All rights reserved.
+
+Redistribution and use in source and binary forms, with or without modification, 
+are permitted provided that the following conditions are met:
+
+1. Redistributions of source code must retain the above copyright notice, 
+this list of conditions and the following disclaimer.
+
+2. Redistributions in binary form must reproduce the above copyright notice, 
+this list of conditions and the following disclaimer in the documentation 
+and/or other materials provided with the distribution.
+
+3. Neither the name of the copyright holder nor the names of its contributors 
+may be used to endorse or promote products derived from this software 
+without specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND 
+ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, 
+THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED. 
+IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, 
+INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, 
+PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) 
+HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, 
+OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, 
+EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.// Copyright (c) 2015 Xilinx, Inc.
+************************************************/
+#include "tx_pacer.hpp"
+#include <iostream>
+
+using namespace hls;
+
+int main()
+{
+	stream<event> input;
+	stream<pacerRateUpdate> rateUpdate;
+	stream<event> output;
+	event ev;
+	int errCount = 0;
+	int outCount = 0;
+	int outBytes = 0;
+	int lastCycle = 0;
+
+	// SRTT of 10000 cycles and a window of 10 segments, congestion avoidance
+	rateUpdate.write(pacerRateUpdate(1, 10*MSS, 10000, false));
+	tx_pacer(input, rateUpdate, output);
+	for (int i = 0; i < 10; i++)
+	{
+		input.write(event(TX, 1, 0, MSS));
+	}
+	for (int cycle = 0; cycle < 20000; cycle++)
+	{
+		tx_pacer(input, rateUpdate, output);
+		if (!output.empty())
+		{
+			output.read(ev);
+			// The burst credit covers the first three segments
+			if (outCount > 3 && (cycle - lastCycle < 780 || cycle - lastCycle > 820))
+			{
+				std::cerr << "Segment " << std::dec << outCount << " released after " << cycle - lastCycle << " cycles" << std::endl;
+				errCount++;
+			}
+			if (ev.length > PACER_SEGMENT)
+			{
+				std::cerr << "Segment of " << std::dec << ev.length << " bytes" << std::endl;
+				errCount++;
+			}
+			lastCycle = cycle;
+			outCount++;
+			outBytes += ev.length;
+		}
+	}
+	if (outBytes != 10*MSS)
+	{
+		std::cerr << "Released " << std::dec << outBytes << " of " << 10*MSS << " bytes" << std::endl;
+		errCount++;
+	}
+
+	// Session without an RTT estimate is not paced
+	for (int i = 0; i < 4; i++)
+	{
+		input.write(event(TX, 2, 0, MSS));
+	}
+	outBytes = 0;
+	for (int cycle = 0; cycle < 16; cycle++)
+	{
+		tx_pacer(input, rateUpdate, output);
+		if (!output.empty())
+		{
+			output.read(ev);
+			outBytes += ev.length;
+		}
+	}
+	if (outBytes != 4*MSS)
+	{
+		std::cerr << "Unpaced session released " << std::dec << outBytes << " of " << 4*MSS << " bytes" << std::endl;
+		errCount++;
+	}
+
+	// A paced session that waits does not hold back other sessions, its FIN stays behind its segments
+	rateUpdate.write(pacerRateUpdate(3, 2*MSS, 100000, false));
+	for (int i = 0; i < 6; i++)
+	{
+		input.write(event(TX, 3, 0, MSS));
+	}
+	input.write(event(FIN, 3));
+	input.write(event(SYN, 4));
+	input.write(event(TX, 2, 0, MSS));
+	int syn4Cycle = -1;
+	int tx2Cycle = -1;
+	int tx3Bytes = 0;
+	outCount = 0;
+	for (int cycle = 0; cycle < 400000; cycle++)
+	{
+		tx_pacer(input, rateUpdate, output);
+		if (!output.empty())
+		{
+			output.read(ev);
+			if (ev.sessionID == 4 && ev.type == SYN)
+			{
+				syn4Cycle = cycle;
+			}
+			else if (ev.sessionID == 2 && ev.type == TX)
+			{
+				tx2Cycle = cycle;
+			}
+			else if (ev.sessionID == 3 && ev.type == TX)
+			{
+				tx3Bytes += ev.length;
+			}
+			else if (ev.sessionID == 3 && ev.type == FIN)
+			{
+				if (tx3Bytes != 6*MSS)
+				{
+					std::cerr << "FIN released after " << std::dec << tx3Bytes << " of " << 6*MSS << " bytes" << std::endl;
+					errCount++;
+				}
+				outCount++;
+			}
+		}
+	}
+	if (syn4Cycle < 0 || syn4Cycle > 32 || tx2Cycle < 0 || tx2Cycle > 32)
+	{
+		std::cerr << "Events behind a paced session released at " << std::dec << syn4Cycle << " and " << tx2Cycle << std::endl;
+		errCount++;
+	}
+	if (outCount != 1)
+	{
+		std::cerr << "FIN of the paced session not released" << std::endl;
+		errCount++;
+	}
+
+	// A paced session flooding the pacer with more small writes than it has slots does not block the SYN behind them
+	rateUpdate.write(pacerRateUpdate(5, 2*MSS, 1000000, false));
+	for (int i = 0; i < 4*PACER_SLOTS; i++)
+	{
+		input.write(event(TX, 5, 0, 64));
+	}
+	input.write(event(SYN, 6));
+	int syn6Cycle = -1;
+	int tx5Bytes = 0;
+	for (int cycle = 0; cycle < 8*PACER_SLOTS; cycle++)
+	{
+		tx_pacer(input, rateUpdate, output);
+		if (!output.empty())
+		{
+			output.read(ev);
+			if (ev.sessionID == 6 && ev.type == SYN)
+			{
+				syn6Cycle = cycle;
+			}
+			else if (ev.sessionID == 5)
+			{
+				tx5Bytes += ev.length;
+			}
+		}
+	}
+	if (syn6Cycle < 0 || tx5Bytes >= 4*PACER_SLOTS*64)
+	{
+		std::cerr << "SYN behind a flooding session released at " << std::dec << syn6Cycle << ", "
+					<< tx5Bytes << " bytes of the flood were released" << std::endl;
+		errCount++;
+	}
+
+	std::cout << "Errors: " << std::dec << errCount << std::endl;
+	return errCount;
+}
@@ -0,0 +1,244 @@
+/************************************************
+Copyright (c) 2016, Xilinx, Inc.
+All rights reserved.
+
+Redistribution and use in source and binary forms, with or without modification, 
+are permitted provided that the following conditions are met:
+
+1. Redistributions of source code must retain the above copyright notice, 
+this list of conditions and the following disclaimer.
+
+2. Redistributions in binary form must reproduce the above copyright notice, 
+this list of conditions and the following disclaimer in the documentation 
+and/or other materials provided with the distribution.
+
+3. Neither the name of the copyright holder nor the names of its contributors 
+may be used to endorse or promote products derived from this software 
+without specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND 
+ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, 
+THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED. 
+IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, 
+INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, 
+PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) 
+HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, 
+OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, 
+EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.// Copyright (c) 2015 Xilinx, Inc.
+************************************************/
+
+#include "tx_pacer.hpp"
+
+using namespace hls;
+
+/** @ingroup tx_pacer
+ *  The TX events of the application are merged into a byte count per session, the @ref tx_engine reads the
+ *  data of a reordered TX event from the session buffer at not_ackd. The other events wait in per-session
+ *  queues, linked through a shared pool of PACER_SLOTS slots, so a session can not fill the pool with its
+ *  writes. The sessions with waiting events are visited in round robin, one per call. The visited session
+ *  releases a TX event of at most PACER_SEGMENT bytes once its release time is reached, otherwise it goes to
+ *  the back of the ring. Its other events follow once no bytes are left, the application only sends a SYN
+ *  before and a FIN after its data. The segments of different sessions leave out of order, see TCP_TX_REORDER.
+ *  Each released segment moves the release time of the session by length * interval, the interval in cycles
+ *  per byte is computed from the rate updates of the @ref rx_engine. Sessions without an RTT estimate are not paced.
+ *  Each call either enqueues an event or visits one session.
+ *  @param[in]		input
+ *  @param[in]		rxEng2pacer_setRate
+ *  @param[out]		output
+ */
+void tx_pacer(	stream<event>&				input,
+				stream<pacerRateUpdate>&	rxEng2pacer_setRate,
+				stream<event>&				output)
+{
+#pragma HLS INLINE off
+#pragma HLS PIPELINE II=1
+
+	static ap_uint<32> pacer_intervalTable[MAX_SESSIONS];
+	SESSION_TABLE_RESOURCE(pacer_intervalTable, RAM_2P_BRAM)
+	#pragma HLS DEPENDENCE variable=pacer_intervalTable inter false
+	static ap_uint<48> pacer_timeTable[MAX_SESSIONS];
+	SESSION_TABLE_RESOURCE(pacer_timeTable, RAM_2P_BRAM)
+	#pragma HLS DEPENDENCE variable=pacer_timeTable inter false
+	static pacerSession pacer_sessionTable[MAX_SESSIONS];
+	SESSION_TABLE_RESOURCE(pacer_sessionTable, RAM_2P_BRAM)
+	#pragma HLS DATA_PACK variable=pacer_sessionTable
+	#pragma HLS DEPENDENCE variable=pacer_sessionTable inter false
+	static event pacer_slots[PACER_SLOTS];
+	#pragma HLS RESOURCE variable=pacer_slots core=RAM_2P_BRAM
+	#pragma HLS DATA_PACK variable=pacer_slots
+	#pragma HLS DEPENDENCE variable=pacer_slots inter false
+	static ap_uint<8> pacer_next[PACER_SLOTS];
+	#pragma HLS RESOURCE variable=pacer_next core=RAM_T2P_BRAM
+	#pragma HLS DEPENDENCE variable=pacer_next inter false
+	// Ring of the free slots and ring of the sessions with waiting events, the latter wraps with its index
+	static ap_uint<8> pacer_freeRing[PACER_SLOTS];
+	#pragma HLS RESOURCE variable=pacer_freeRing core=RAM_2P_BRAM
+	#pragma HLS DEPENDENCE variable=pacer_freeRing inter false
+	static ap_uint<16> pacer_activeRing[1 << SESSION_ID_BITS];
+	SESSION_TABLE_RESOURCE(pacer_activeRing, RAM_2P_BRAM)
+	#pragma HLS DEPENDENCE variable=pacer_activeRing inter false
+
+	static ap_uint<48>	tp_clock = 0;
+	static ap_uint<8>	tp_freeHead = 0;
+	static ap_uint<8>	tp_freeTail = 0;
+	static ap_uint<9>	tp_freeCount = 0;
+	// Slots that were never used, they are handed out before the free ring
+	static ap_uint<9>	tp_freshSlots = 0;
+	static ap_uint<SESSION_ID_BITS>		tp_activeHead = 0;
+	static ap_uint<SESSION_ID_BITS>		tp_activeTail = 0;
+	static ap_uint<SESSION_ID_BITS+1>	tp_activeCount = 0;
+	// Release time written by the last event, the table read of the next one can be outdated
+	static ap_uint<16>	tp_lastID;
+	static ap_uint<48>	tp_lastTime;
+	static bool			tp_lastValid = false;
+
+	pacerRateUpdate update;
+	event ev;
+	pacerSession session;
+	ap_uint<16> sessionID;
+	ap_uint<8> slot;
+	ap_uint<42> numerator;
+	ap_uint<WINDOW_BITS+3> denominator;
+	ap_uint<32> interval;
+	ap_uint<48> nextTime;
+	ap_uint<48> earliest;
+	ap_uint<48> timeDelta;
+	ap_uint<16> length;
+	bool active;
+	bool release;
+
+	if (!rxEng2pacer_setRate.empty())
+	{
+		rxEng2pacer_setRate.read(update);
+		if (update.slowStart)
+		{
+			numerator = ((ap_uint<42>) update.srtt) << (PACING_FRAC_BITS - PACING_SLOW_START_SHIFT);
+			denominator = update.cong_window;
+		}
+		else
+		{
+			numerator = ((ap_uint<42>) update.srtt) << (PACING_FRAC_BITS + PACING_CA_SHIFT);
+			denominator = update.cong_window * PACING_CA_DIVISOR;
+		}
+		interval = 0;
+		if (update.srtt != 0 && update.cong_window != 0)
+		{
+			interval = numerator / denominator;
+		}
+		pacer_intervalTable[update.sessionID] = interval;
+	}
+
+	if (!input.empty() && (tp_freeCount != 0 || tp_freshSlots != PACER_SLOTS))
+	{
+		input.read(ev);
+		session = pacer_sessionTable[ev.sessionID];
+		active = (session.queued || session.bytes != 0);
+		if (ev.type == TX)
+		{
+			session.bytes += ev.length;
+		}
+		else
+		{
+			if (tp_freeCount != 0)
+			{
+				slot = pacer_freeRing[tp_freeHead];
+				tp_freeHead++;
+				tp_freeCount--;
+			}
+			else
+			{
+				slot = tp_freshSlots;
+				tp_freshSlots++;
+			}
+			pacer_slots[slot] = ev;
+			if (session.queued)
+			{
+				pacer_next[session.tail] = slot;
+				session.tail = slot;
+			}
+			else
+			{
+				session.head = slot;
+				session.tail = slot;
+				session.queued = true;
+			}
+		}
+		if (!active)
+		{
+			pacer_activeRing[tp_activeTail] = ev.sessionID;
+			tp_activeTail++;
+			tp_activeCount++;
+		}
+		pacer_sessionTable[ev.sessionID] = session;
+	}
+	else if (tp_activeCount != 0 && !output.full())
+	{
+		sessionID = pacer_activeRing[tp_activeHead];
+		session = pacer_sessionTable[sessionID];
+		slot = session.head;
+		release = true;
+		if (session.bytes != 0)
+		{
+			length = (session.bytes < PACER_SEGMENT) ? (ap_uint<16>) session.bytes : PACER_SEGMENT;
+			ev = event(TX, sessionID, 0, length);
+			interval = pacer_intervalTable[sessionID];
+			nextTime = pacer_timeTable[sessionID];
+			if (tp_lastValid && tp_lastID == sessionID)
+			{
+				nextTime = tp_lastTime;
+			}
+			// An idle session may send PACING_BURST bytes right away
+			earliest = tp_clock - ((interval * PACING_BURST) >> PACING_FRAC_BITS);
+			timeDelta = nextTime - earliest;
+			if (interval == 0 || timeDelta.bit(47))
+			{
+				nextTime = earliest;
+			}
+			timeDelta = tp_clock - nextTime;
+			release = !timeDelta.bit(47);
+			if (release)
+			{
+				nextTime += (length * interval) >> PACING_FRAC_BITS;
+				pacer_timeTable[sessionID] = nextTime;
+				tp_lastID = sessionID;
+				tp_lastTime = nextTime;
+				tp_lastValid = true;
+				session.bytes -= length;
+			}
+		}
+		else
+		{
+			ev = pacer_slots[slot];
+			pacer_freeRing[tp_freeTail] = slot;
+			tp_freeTail++;
+			tp_freeCount++;
+			if (slot == session.tail)
+			{
+				session.queued = false;
+			}
+			else
+			{
+				session.head = pacer_next[slot];
+			}
+		}
+
+		tp_activeHead++;
+		if (release)
+		{
+			output.write(ev);
+			pacer_sessionTable[sessionID] = session;
+		}
+		if (session.queued || session.bytes != 0)
+		{
+			// The session waits for its next turn
+			pacer_activeRing[tp_activeTail] = sessionID;
+			tp_activeTail++;
+		}
+		else
+		{
+			// Nothing left, the session leaves the ring
+			tp_activeCount--;
+		}
+	}
+	tp_clock++;
+}
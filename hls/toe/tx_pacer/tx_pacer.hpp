@@ -0,0 +1,74 @@
+/************************************************
+Copyright (c) 2016, Xilinx, Inc.
+All rights reserved.
+
+Redistribution and use in source and binary forms, with or without modification, 
+are permitted provided that the following conditions are met:
+
+1. Redistributions of source code must retain the above copyright notice, 
+this list of conditions and the following disclaimer.
+
+2. Redistributions in binary form must reproduce the above copyright notice, 
+this list of conditions and the following disclaimer in the documentation 
+and/or other materials provided with the distribution.
+
+3. Neither the name of the copyright holder nor the names of its contributors 
+may be used to endorse or promote products derived from this software 
+without specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND 
+ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, 
+THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED. 
+IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, 
+INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, 
+PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) 
+HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, 
+OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, 
+EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.// Copyright (c) 2015 Xilinx, Inc.
+************************************************/
+#include "../toe.hpp"
+
+using namespace hls;
+
+/** @ingroup tx_pacer
+ *  Pacing gain of 2 in slow start and 1.25 in congestion avoidance, the window is
+ *  sent out within a half and within 4/5 of the RTT respectively
+ */
+static const uint8_t PACING_SLOW_START_SHIFT = 1;
+static const uint8_t PACING_CA_SHIFT = 2;
+static const uint8_t PACING_CA_DIVISOR = 5;
+/** @ingroup tx_pacer
+ *  An idle session collects credit for at most PACING_BURST bytes which are sent back-to-back
+ */
+static const ap_uint<16> PACING_BURST = 2*MSS;
+/** @ingroup tx_pacer
+ *  Number of non-TX application events the pacer buffers, PACER_SLOTS bounds the sessions with waiting events as well
+ */
+static const uint16_t PACER_SLOTS = 256;
+/** @ingroup tx_pacer
+ *  Largest segment released for the merged TX events of a session, with timestamps the padded option
+ *  of the @ref tx_engine has to fit as well
+ */
+static const ap_uint<16> PACER_SEGMENT = (TCP_TIMESTAMPS) ? (ap_uint<16>) (MSS - 16) : MSS;
+
+/** @ingroup tx_pacer
+ *  Queue of a session in the pacer. The TX events are merged into the byte count,
+ *  the other events are linked through their slots
+ */
+struct pacerSession
+{
+	ap_uint<8>	head;
+	ap_uint<8>	tail;
+	bool		queued;
+	ap_uint<32>	bytes;
+};
+
+/** @defgroup tx_pacer TX Pacer
+ *  @ingroup tcp_module
+ *  Delays the TX events of the application, the segments of a session are spread
+ *  over its RTT according to the rate cong_window/SRTT reported by the @ref rx_engine.
+ *  A session that waits does not hold back the events of the others, however many it sent
+ */
+void tx_pacer(	stream<event>&				input,
+				stream<pacerRateUpdate>&	rxEng2pacer_setRate,
+				stream<event>&				output);
@@ -32,7 +32,6 @@ add_files $src_dir/7series/adm7v3
 #}
 #add_files [glob ./ip/*.xcix]
 add_files $ip_dir/mig_7series_0.dcp
-add_files $ip_dir/SmartCamCtl.dcp
 #add_files $ip_dir/SmartCamCtlArp.dcp
 add_files -fileset constrs_1 $constraints_dir/adm7v3.xdc
 
@@ -31,7 +31,6 @@ add_files $src_dir/7series/vc709
 set_property top tcp_ip_top [current_fileset]
 
 add_files $ip_dir/mig_axi_mm_dual.dcp
-add_files $ip_dir/SmartCamCtl.dcp
 add_files -fileset constrs_1 $constraints_dir/vc709.xdc
 
 #create ip directory
@@ -30,7 +30,6 @@ add_files -norecurse $src_dir/ultraplus
 add_files $src_dir/ultraplus/vcu118
 set_property top tcp_ip_top [current_fileset]
 
-add_files $ip_dir/SmartCamCtl.dcp
 add_files -fileset constrs_1 $constraints_dir/vcu118.xdc
 
 #create ip directory
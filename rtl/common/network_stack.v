@@ -255,21 +255,6 @@ wire[7:0]   axi_toe_to_toe_slice_tkeep;
 wire        axi_toe_to_toe_slice_tlast;
 
 
-// TCP Offload SmartCAM signals //
-wire        upd_req_TVALID;
-wire        upd_req_TREADY;
-wire[111:0] upd_req_TDATA; //(1 + 1 + 14 + 96) - 1 = 111
-wire        upd_rsp_TVALID;
-wire        upd_rsp_TREADY;
-wire[15:0]  upd_rsp_TDATA;
-
-wire        lup_req_TVALID;
-wire        lup_req_TREADY;
-wire[97:0]  lup_req_TDATA; //should be 96, also wrong in SmartCam
-wire        lup_rsp_TVALID;
-wire        lup_rsp_TREADY;
-wire[15:0]  lup_rsp_TDATA;
-
 `ifdef RX_DDR_BYPASS
 //RX Buffer bypass data streams
 wire axis_rxbuffer2app_tvalid;
@@ -412,22 +397,6 @@ toe_ip toe_inst (
 .m_axis_txwrite_data_TDATA(m_axis_txwrite_data_TDATA),
 .m_axis_txwrite_data_TKEEP(m_axis_txwrite_data_TKEEP),
 .m_axis_txwrite_data_TLAST(m_axis_txwrite_data_TLAST),
-/// SmartCAM I/F ///
-.m_axis_session_upd_req_TVALID(upd_req_TVALID),
-.m_axis_session_upd_req_TREADY(upd_req_TREADY),
-.m_axis_session_upd_req_TDATA(upd_req_TDATA),
-
-.s_axis_session_upd_rsp_TVALID(upd_rsp_TVALID),
-.s_axis_session_upd_rsp_TREADY(upd_rsp_TREADY),
-.s_axis_session_upd_rsp_TDATA(upd_rsp_TDATA),
-
-.m_axis_session_lup_req_TVALID(lup_req_TVALID),
-.m_axis_session_lup_req_TREADY(lup_req_TREADY),
-.m_axis_session_lup_req_TDATA(lup_req_TDATA),
-.s_axis_session_lup_rsp_TVALID(lup_rsp_TVALID),
-.s_axis_session_lup_rsp_TREADY(lup_rsp_TREADY),
-.s_axis_session_lup_rsp_TDATA(lup_rsp_TDATA),
-
 /* Application Interface */
 // listen&close port
 .s_axis_listen_port_req_TVALID(s_axis_listen_port_TVALID),
@@ -511,33 +480,6 @@ axis_data_fifo_64_d2048 rx_buffer_fifo (
 assign rx_buffer_data_count[31:12] = 20'h0;
 `endif
 
-SmartCamCtl SmartCamCtl_inst
-(
-.clk(aclk),
-.rst(~aresetn),
-.led0(),//(sc_led0),
-.led1(),//(sc_led1),
-.cam_ready(),//(cam_ready),
-
-.lup_req_valid(lup_req_TVALID),
-.lup_req_ready(lup_req_TREADY),
-.lup_req_din(lup_req_TDATA),
-
-.lup_rsp_valid(lup_rsp_TVALID),
-.lup_rsp_ready(lup_rsp_TREADY),
-.lup_rsp_dout(lup_rsp_TDATA),
-
-.upd_req_valid(upd_req_TVALID),
-.upd_req_ready(upd_req_TREADY),
-.upd_req_din(upd_req_TDATA),
-
-.upd_rsp_valid(upd_rsp_TVALID),
-.upd_rsp_ready(upd_rsp_TREADY),
-.upd_rsp_dout(upd_rsp_TDATA),
-
-.debug()
-);
-
 
 `ifndef UDP
 assign axi_udp_to_merge_tvalid = 1'b0;